@@ -0,0 +1,33 @@
+#include "BakedClip.h"
+
+void BakedClip::Clear()
+{
+    numFrames = 0;
+    lastUse = 0;
+    frames.clear();
+    frames.shrink_to_fit();
+}
+
+void BakedClip::Sample(float animationTimeSec, XMFLOAT4X4* out) const
+{
+    float framePos = fmod(animationTimeSec, durationSec) * sampleRate;
+    if (framePos < 0.0f)
+        framePos += durationSec * sampleRate;
+
+    int frame = min((int)framePos, numFrames - 2);
+    float factor = MathHelper::Clamp(framePos - frame, 0.0f, 1.0f);
+
+    const AffineTransform3x4* start = &frames[(size_t)frame * numBones];
+    const AffineTransform3x4* end = start + numBones;
+
+    XMVECTOR t = XMVectorReplicate(factor);
+    for (int i = 0; i < numBones; i++)
+    {
+        for (int r = 0; r < 3; r++) {
+            XMVECTOR a = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(start[i].m[r]));
+            XMVECTOR b = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(end[i].m[r]));
+            XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(out[i].m[r]), XMVectorLerpV(a, b, t));
+        }
+        out[i]._41 = 0.0f; out[i]._42 = 0.0f; out[i]._43 = 0.0f; out[i]._44 = 1.0f;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "d3dUtil.h"
+#include "PoseKernel.h"
+
+using namespace DirectX;
+using namespace std;
+
+// 고정 간격으로 미리 계산해 둔 클립의 최종 뼈 행렬
+// 프레임마다 셰이더로 보내는 전치 행렬의 위 3행(AffineTransform3x4)을 뼈 수만큼 저장하고,
+// 재생할 때는 인접한 두 프레임을 선형 보간만 한다.
+struct BakedClip
+{
+    float sampleRate = 0.0f;    // 초당 프레임 수
+    float durationSec = 0.0f;
+    int numFrames = 0;          // 0이면 구워지지 않은 클립
+    int numBones = 0;
+    unsigned long long lastUse = 0;     // LRU 교체용
+
+    vector<AffineTransform3x4> frames;  // 프레임 * numBones + 뼈
+
+    bool IsBaked() const { return numFrames > 0; }
+    size_t ByteSize() const { return frames.size() * sizeof(AffineTransform3x4); }
+
+    void Clear();
+
+    // 초 단위 시간의 포즈를 out[numBones]에 쓴다. 시간은 클립 길이로 반복된다.
+    void Sample(float animationTimeSec, XMFLOAT4X4* out) const;
+};
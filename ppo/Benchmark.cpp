@@ -0,0 +1,2794 @@
+#include "Benchmark.h"
+#include <cstdarg>
+#include <cfloat>
+#include <random>
+#include <fstream>
+#include <map>
+#include <unordered_set>
+
+double Benchmark::ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void Benchmark::Log(const char* format, ...)
+{
+    char buf[512];
+    va_list args;
+    va_start(args, format);
+    vsprintf_s(buf, sizeof(buf), format, args);
+    va_end(args);
+
+    OutputDebugStringA(buf);
+}
+
+void Benchmark::SkinnedMeshPose(SkinnedMesh& skinnedMesh, int numSamples)
+{
+    vector<XMFLOAT4X4> legacyTransforms;
+    vector<XMFLOAT4X4> transforms;
+
+    Log("[Benchmark] SkinnedMeshPose : %d joints, %d bones, %d samples\n",
+        (int)skinnedMesh.mJoints.size(), skinnedMesh.NumBones(), numSamples);
+
+    for (int clipIndex = 0; clipIndex < (int)skinnedMesh.mAnimations.size(); clipIndex++)
+    {
+        const AnimationClip& clip = skinnedMesh.mAnimations[clipIndex];
+        float durationSec = clip.duration / clip.tickPerSecond;
+
+        if (!clip.hasSourceKeyframes)
+            continue;
+
+        // 같은 시간값들을 두 경로에 똑같이 넣어 비교한다.
+        auto start = Clock::now();
+        for (int i = 0; i < numSamples; i++)
+            skinnedMesh.GetBoneTransformsLegacy(durationSec * i / numSamples, legacyTransforms, clipIndex);
+        double legacyMs = ElapsedMs(start);
+
+        start = Clock::now();
+        for (int i = 0; i < numSamples; i++)
+            skinnedMesh.GetBoneTransforms(durationSec * i / numSamples, transforms, clipIndex);
+        double compiledMs = ElapsedMs(start);
+
+        // 결과가 같은지 확인
+        float maxError = 0.0f;
+        for (int i = 0; i < numSamples; i += 97)
+        {
+            float timeSec = durationSec * i / numSamples;
+            skinnedMesh.GetBoneTransformsLegacy(timeSec, legacyTransforms, clipIndex);
+            skinnedMesh.GetBoneTransforms(timeSec, transforms, clipIndex);
+
+            for (int j = 0; j < (int)transforms.size(); j++)
+                for (int k = 0; k < 16; k++)
+                    maxError = max(maxError, fabsf((&transforms[j]._11)[k] - (&legacyTransforms[j]._11)[k]));
+        }
+
+        Log("[Benchmark]   %-24s legacy %8.3f us/pose, compiled %8.3f us/pose (x%.2f), max error %g\n",
+            clip.name.c_str(), legacyMs * 1000.0 / numSamples, compiledMs * 1000.0 / numSamples, legacyMs / compiledMs, maxError);
+    }
+}
+
+bool Benchmark::KeyframeSampling(SkinnedMesh& skinnedMesh, int numSamples)
+{
+    const float epsilon = 1e-5f;
+    XMVECTOR epsilonVector = XMVectorReplicate(epsilon);
+    std::mt19937 random(1234);
+
+    int numMismatches = 0;
+    double linearMs = 0.0;
+    double cursorMs = 0.0;
+
+    // 선형 탐색은 마지막 키 이후를 처리하지 못하므로 트랙의 키 범위 안에서만 비교한다.
+    auto inRange = [](const auto& keys, float time) {
+        return keys.size() == 1 || (keys.front().timePos <= time && time < keys.back().timePos);
+    };
+
+    for (const AnimationClip& clip : skinnedMesh.mAnimations)
+    {
+        if (!clip.hasSourceKeyframes)
+            continue;
+
+        vector<float> forwardTimes(numSamples);
+        vector<float> seekTimes(numSamples);
+        std::uniform_real_distribution<float> distribution(0.0f, clip.duration);
+        for (int i = 0; i < numSamples; i++) {
+            forwardTimes[i] = clip.duration * i / numSamples;
+            seekTimes[i] = distribution(random);
+        }
+
+        for (const vector<float>* times : { &forwardTimes, &seekTimes })
+        {
+            for (const BoneAnimation& boneAnimation : clip.channels)
+            {
+                AnimationCursor cursor;
+                for (float time : *times)
+                {
+                    XMVECTOR translation = boneAnimation.SampleTranslation(time, cursor.translation);
+                    XMVECTOR scale = boneAnimation.SampleScale(time, cursor.scale);
+                    XMVECTOR rotation = boneAnimation.SampleRotation(time, cursor.rotation);
+
+                    if (inRange(boneAnimation.translation, time) && !XMVector3NearEqual(translation, skinnedMesh.CalcInterpolatedPosition(time, boneAnimation), epsilonVector))
+                        numMismatches++;
+                    if (inRange(boneAnimation.scale, time) && !XMVector3NearEqual(scale, skinnedMesh.CalcInterpolatedScaling(time, boneAnimation), epsilonVector))
+                        numMismatches++;
+                    if (inRange(boneAnimation.rotationQuat, time) && !XMVector4NearEqual(rotation, skinnedMesh.CalcInterpolatedRotation(time, boneAnimation), epsilonVector))
+                        numMismatches++;
+                }
+            }
+        }
+
+        // 순방향 재생 시간 측정
+        XMVECTOR sum = XMVectorZero();
+        auto start = Clock::now();
+        for (float time : forwardTimes)
+            for (const BoneAnimation& boneAnimation : clip.channels)
+                sum += skinnedMesh.CalcInterpolatedPosition(time, boneAnimation) + skinnedMesh.CalcInterpolatedScaling(time, boneAnimation) + skinnedMesh.CalcInterpolatedRotation(time, boneAnimation);
+        linearMs += ElapsedMs(start);
+
+        vector<AnimationCursor> cursors(clip.channels.size());
+        start = Clock::now();
+        for (float time : forwardTimes)
+            for (int i = 0; i < (int)clip.channels.size(); i++)
+                sum += clip.channels[i].SampleTranslation(time, cursors[i].translation) + clip.channels[i].SampleScale(time, cursors[i].scale) + clip.channels[i].SampleRotation(time, cursors[i].rotation);
+        cursorMs += ElapsedMs(start);
+
+        // 최적화로 계산이 지워지지 않도록 결과를 사용한다.
+        volatile float sink = XMVectorGetX(sum);
+        (void)sink;
+    }
+
+    Log("[Benchmark] KeyframeSampling : linear %.3f ms, cursor %.3f ms (x%.2f), %d mismatches -> %s\n",
+        linearMs, cursorMs, linearMs / cursorMs, numMismatches, numMismatches == 0 ? "PASS" : "FAIL");
+    assert(numMismatches == 0);
+
+    return numMismatches == 0;
+}
+
+void Benchmark::ClipCompression(SkinnedMesh& skinnedMesh, int numSamples)
+{
+    for (const AnimationClip& clip : skinnedMesh.mAnimations)
+    {
+        if (!clip.isCompressed || !clip.hasSourceKeyframes) {
+            Log("[Benchmark] ClipCompression : %s skipped (needs SetAnimationCompression(true, true))\n", clip.name.c_str());
+            continue;
+        }
+
+        int numChannels = (int)clip.channels.size();
+        vector<AnimationCursor> sourceCursors(numChannels);
+        vector<AnimationCursor> compressedCursors(numChannels);
+
+        // 키 사이의 시간까지 포함해 원본과의 오차를 잰다.
+        float maxTranslationError = 0.0f;
+        float maxScaleError = 0.0f;
+        float maxRotationError = 0.0f;
+        for (int i = 0; i < numSamples; i++)
+        {
+            float time = clip.duration * i / numSamples;
+            for (int j = 0; j < numChannels; j++)
+            {
+                const BoneAnimation& boneAnimation = clip.channels[j];
+
+                XMVECTOR translationError = XMVectorAbs(boneAnimation.SampleTranslation(time, sourceCursors[j].translation) - clip.compressed.SampleTranslation(j, time, compressedCursors[j].translation));
+                XMVECTOR scaleError = XMVectorAbs(boneAnimation.SampleScale(time, sourceCursors[j].scale) - clip.compressed.SampleScale(j, time, compressedCursors[j].scale));
+                float rotationError = RotationError(boneAnimation.SampleRotation(time, sourceCursors[j].rotation), clip.compressed.SampleRotation(j, time, compressedCursors[j].rotation));
+
+                maxTranslationError = max(maxTranslationError, max(XMVectorGetX(translationError), max(XMVectorGetY(translationError), XMVectorGetZ(translationError))));
+                maxScaleError = max(maxScaleError, max(XMVectorGetX(scaleError), max(XMVectorGetY(scaleError), XMVectorGetZ(scaleError))));
+                maxRotationError = max(maxRotationError, rotationError);
+            }
+        }
+
+        // 순방향 재생 샘플링 시간 비교
+        XMVECTOR sum = XMVectorZero();
+        auto start = Clock::now();
+        for (int i = 0; i < numSamples; i++)
+            for (int j = 0; j < numChannels; j++) {
+                float time = clip.duration * i / numSamples;
+                sum += clip.channels[j].SampleTranslation(time, sourceCursors[j].translation) + clip.channels[j].SampleScale(time, sourceCursors[j].scale) + clip.channels[j].SampleRotation(time, sourceCursors[j].rotation);
+            }
+        double sourceMs = ElapsedMs(start);
+
+        start = Clock::now();
+        for (int i = 0; i < numSamples; i++)
+            for (int j = 0; j < numChannels; j++) {
+                float time = clip.duration * i / numSamples;
+                sum += clip.compressed.SampleTranslation(j, time, compressedCursors[j].translation) + clip.compressed.SampleScale(j, time, compressedCursors[j].scale) + clip.compressed.SampleRotation(j, time, compressedCursors[j].rotation);
+            }
+        double compressedMs = ElapsedMs(start);
+
+        volatile float sink = XMVectorGetX(sum);
+        (void)sink;
+
+        Log("[Benchmark] ClipCompression : %-24s %zu -> %zu bytes, max error T %.5f S %.5f R %.5f rad, sample %.3f ms -> %.3f ms\n",
+            clip.name.c_str(), CompressedClip::SourceByteSize(clip.channels), clip.compressed.ByteSize(),
+            maxTranslationError, maxScaleError, maxRotationError, sourceMs, compressedMs);
+    }
+}
+
+bool Benchmark::PoseBatchScaling(SkinnedMesh& skinnedMesh, int numFrames)
+{
+    if (skinnedMesh.mAnimations.empty())
+        return true;
+
+    const int instanceCounts[] = { 10, 100, 1000 };
+    unsigned int maxThreads = max(1u, thread::hardware_concurrency());
+    int numClips = (int)skinnedMesh.mAnimations.size();
+    const float dt = 1.0f / 60.0f;
+    bool passed = true;
+
+    for (int numInstances : instanceCounts)
+    {
+        vector<unique_ptr<SkinnedModelInstance>> instances;
+        vector<PoseJob> jobs(numInstances);
+        for (int i = 0; i < numInstances; i++) {
+            instances.push_back(make_unique<SkinnedModelInstance>(&skinnedMesh, i % numClips, i * 0.37f));
+            jobs[i].instance = instances[i].get();
+        }
+
+        // 기준 : 한 스레드에서 인스턴스마다 UpdateSkinnedAnimation
+        auto start = Clock::now();
+        for (int frame = 0; frame < numFrames; frame++)
+            for (auto& instance : instances) {
+                instance->Advance(dt);
+                instance->UpdateSkinnedAnimation();
+            }
+        double serialMs = ElapsedMs(start) / numFrames;
+
+        vector<vector<XMFLOAT4X4>> reference;
+        for (auto& instance : instances)
+            reference.push_back(instance->FinalTransforms);
+
+        Log("[Benchmark] PoseBatchScaling : %4d instances, 1 thread %.3f ms/frame\n", numInstances, serialMs);
+
+        for (unsigned int numThreads = 2; numThreads <= maxThreads; numThreads++)
+        {
+            ThreadPool threadPool(numThreads - 1);
+
+            // 같은 시간으로 되돌려 기준과 같은 프레임을 계산한다.
+            for (int i = 0; i < numInstances; i++)
+                instances[i]->SetClip(i % numClips, i * 0.37f);
+
+            start = Clock::now();
+            for (int frame = 0; frame < numFrames; frame++) {
+                for (auto& instance : instances)
+                    instance->Advance(dt);
+                EvaluatePoses(threadPool, jobs.data(), numInstances);
+            }
+            double parallelMs = ElapsedMs(start) / numFrames;
+
+            for (int i = 0; i < numInstances; i++)
+                if (memcmp(reference[i].data(), instances[i]->FinalTransforms.data(), reference[i].size() * sizeof(XMFLOAT4X4)) != 0) {
+                    Log("[Benchmark] PoseBatchScaling : mismatch, instance %d with %u threads\n", i, numThreads);
+                    passed = false;
+                    break;
+                }
+
+            Log("[Benchmark] PoseBatchScaling : %4d instances, %u threads %.3f ms/frame (x%.2f)\n",
+                numInstances, numThreads, parallelMs, serialMs / parallelMs);
+        }
+    }
+
+    assert(passed);
+    return passed;
+}
+
+bool Benchmark::PoseKernelSampling(SkinnedMesh& skinnedMesh, int numSamples)
+{
+    const float tolerance = 1e-4f;     // 행렬 원소의 상대 오차
+    bool passed = true;
+
+    // 1. 커널만 : 임의의 키 쌍 4096개
+    const int numBones = 4096;
+    const int numRepeats = 200;
+    PoseBatch batch;
+    batch.Resize(numBones);
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    vector<XMFLOAT4> starts(numBones), ends(numBones);
+    vector<XMFLOAT3> scales(numBones), translations(numBones);
+    for (int i = 0; i < numBones; i++)
+    {
+        XMVECTOR start = XMQuaternionNormalize(XMVectorSet(distribution(random), distribution(random), distribution(random), distribution(random)));
+        XMVECTOR delta = XMQuaternionRotationRollPitchYaw(distribution(random) * 0.2f, distribution(random) * 0.2f, distribution(random) * 0.2f);
+        XMStoreFloat4(&starts[i], start);
+        XMStoreFloat4(&ends[i], XMQuaternionMultiply(start, delta));
+        scales[i] = XMFLOAT3(1.0f + distribution(random) * 0.1f, 1.0f, 1.0f);
+        translations[i] = XMFLOAT3(distribution(random) * 50.0f, distribution(random) * 50.0f, distribution(random) * 50.0f);
+
+        batch.startRotation[0][i] = starts[i].x; batch.startRotation[1][i] = starts[i].y; batch.startRotation[2][i] = starts[i].z; batch.startRotation[3][i] = starts[i].w;
+        batch.endRotation[0][i] = ends[i].x; batch.endRotation[1][i] = ends[i].y; batch.endRotation[2][i] = ends[i].z; batch.endRotation[3][i] = ends[i].w;
+        batch.scale[0][i] = scales[i].x; batch.scale[1][i] = scales[i].y; batch.scale[2][i] = scales[i].z;
+        batch.translation[0][i] = translations[i].x; batch.translation[1][i] = translations[i].y; batch.translation[2][i] = translations[i].z;
+        batch.factor[i] = (distribution(random) + 1.0f) * 0.5f;
+    }
+
+    vector<XMFLOAT4X4> reference(numBones);
+    auto start = Clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+        for (int i = 0; i < numBones; i++) {
+            XMVECTOR rotationQuat = XMQuaternionSlerp(XMLoadFloat4(&starts[i]), XMLoadFloat4(&ends[i]), batch.factor[i]);
+            XMMATRIX transform = XMMatrixAffineTransformation(XMLoadFloat3(&scales[i]), XMQuaternionIdentity(), rotationQuat, XMLoadFloat3(&translations[i]));
+            XMStoreFloat4x4(&reference[i], XMMatrixTranspose(transform));
+        }
+    double scalarNs = ElapsedMs(start) * 1e6 / ((double)numRepeats * numBones);
+
+    const RotationInterpolation modes[] = { RotationInterpolation::Slerp, RotationInterpolation::Nlerp };
+    for (RotationInterpolation mode : modes)
+    {
+        start = Clock::now();
+        for (int repeat = 0; repeat < numRepeats; repeat++) {
+            PoseKernel::InterpolateRotations(batch, mode);
+            PoseKernel::ComposeAffine(batch);
+        }
+        double kernelNs = ElapsedMs(start) * 1e6 / ((double)numRepeats * numBones);
+
+        float maxError = 0.0f;
+        for (int i = 0; i < numBones; i++)
+            for (int r = 0; r < 3; r++)
+                for (int c = 0; c < 4; c++) {
+                    float expected = reference[i].m[r][c];
+                    maxError = max(maxError, fabsf(batch.local[i].m[r][c] - expected) / max(1.0f, fabsf(expected)));
+                }
+
+        if (mode == RotationInterpolation::Slerp && maxError > tolerance)
+            passed = false;
+
+        Log("[Benchmark] PoseKernelSampling : kernel %s (width %d) %.2f ns/bone, scalar %.2f ns/bone (x%.2f), max error %g\n",
+            (mode == RotationInterpolation::Slerp) ? "slerp" : "nlerp", gPoseKernelWidth, kernelNs, scalarNs, scalarNs / kernelNs, maxError);
+    }
+
+    // 2. 포즈 전체 : 클립마다 각 계산 방식의 관절당 시간과 Scalar 대비 오차
+    PoseEvaluation previous = skinnedMesh.GetPoseEvaluation();
+    int numJoints = max(1, (int)skinnedMesh.mJoints.size());
+
+    for (int clipIndex = 0; clipIndex < (int)skinnedMesh.mAnimations.size(); clipIndex++)
+    {
+        const AnimationClip& clip = skinnedMesh.mAnimations[clipIndex];
+        float durationSec = clip.duration / clip.tickPerSecond;
+
+        const PoseEvaluation poseEvaluations[] = { PoseEvaluation::Scalar, PoseEvaluation::BatchedSlerp, PoseEvaluation::BatchedNlerp };
+        const char* names[] = { "scalar", "slerp", "nlerp" };
+        vector<XMFLOAT4X4> transforms[3];
+        double poseNs[3];
+        float maxError[3] = { 0.0f };
+
+        for (int m = 0; m < 3; m++)
+        {
+            skinnedMesh.SetPoseEvaluation(poseEvaluations[m]);
+            PoseState state;
+
+            start = Clock::now();
+            for (int i = 0; i < numSamples; i++)
+                skinnedMesh.GetBoneTransforms(durationSec * i / numSamples, transforms[m], clipIndex, state);
+            poseNs[m] = ElapsedMs(start) * 1e6 / ((double)numSamples * numJoints);
+        }
+
+        for (int i = 0; i < numSamples; i += 37)
+        {
+            float timeSec = durationSec * i / numSamples;
+            for (int m = 0; m < 3; m++) {
+                skinnedMesh.SetPoseEvaluation(poseEvaluations[m]);
+                skinnedMesh.GetBoneTransforms(timeSec, transforms[m], clipIndex);
+            }
+
+            for (int m = 1; m < 3; m++)
+                for (int j = 0; j < (int)transforms[0].size(); j++)
+                    for (int k = 0; k < 16; k++) {
+                        float expected = (&transforms[0][j]._11)[k];
+                        maxError[m] = max(maxError[m], fabsf((&transforms[m][j]._11)[k] - expected) / max(1.0f, fabsf(expected)));
+                    }
+        }
+
+        if (maxError[1] > tolerance)
+            passed = false;
+
+        Log("[Benchmark]   %-24s %s %.2f ns/joint, %s %.2f ns/joint (error %g), %s %.2f ns/joint (error %g)\n", clip.name.c_str(),
+            names[0], poseNs[0], names[1], poseNs[1], maxError[1], names[2], poseNs[2], maxError[2]);
+    }
+
+    skinnedMesh.SetPoseEvaluation(previous);
+
+    assert(passed);
+    return passed;
+}
+
+bool Benchmark::PoseBlending(SkinnedMesh& skinnedMesh, int numSamples)
+{
+    int numClips = (int)skinnedMesh.mAnimations.size();
+    if (numClips < 2)
+        return true;
+
+    const float tolerance = 1e-4f;
+    bool passed = true;
+
+    auto maxDifference = [](const vector<XMFLOAT4X4>& a, const vector<XMFLOAT4X4>& b) {
+        float maxError = 0.0f;
+        for (int j = 0; j < (int)a.size(); j++)
+            for (int k = 0; k < 16; k++) {
+                float expected = (&a[j]._11)[k];
+                maxError = max(maxError, fabsf((&b[j]._11)[k] - expected) / max(1.0f, fabsf(expected)));
+            }
+        return maxError;
+    };
+
+    int numBones = skinnedMesh.NumBones();
+    vector<XMFLOAT4X4> base(numBones), over(numBones), blended(numBones);
+    PoseState state;
+
+    // 마스크 : 첫 관절의 자식 하나 아래만 덮는다.
+    vector<float> jointWeights;
+    if (skinnedMesh.mNodeHierarchy.size() > 1)
+        skinnedMesh.BuildJointMask(skinnedMesh.mNodeHierarchy[1].first, 1.0f, jointWeights);
+
+    for (int clipIndex = 0; clipIndex + 1 < numClips; clipIndex++)
+    {
+        AnimationLayer layers[2];
+        layers[0].clipIndex = clipIndex;
+        layers[1].clipIndex = clipIndex + 1;
+
+        float maxError = 0.0f;
+        for (int i = 0; i < numSamples; i += 37)
+        {
+            float timeSec = 0.01f * i;
+            layers[0].timePos = layers[1].timePos = timeSec;
+
+            skinnedMesh.GetBoneTransforms(timeSec, base, clipIndex, state);
+            skinnedMesh.GetBoneTransforms(timeSec, over, clipIndex + 1, state);
+
+            layers[1].weight = 0.0f;
+            skinnedMesh.EvaluateBlendedPose(layers, 2, state, blended.data());
+            maxError = max(maxError, maxDifference(base, blended));
+
+            layers[1].weight = 1.0f;
+            skinnedMesh.EvaluateBlendedPose(layers, 2, state, blended.data());
+            maxError = max(maxError, maxDifference(over, blended));
+
+            // 마스크 밖의 관절만 있는 뼈는 바탕 클립과 같아야 한다.
+            if (!jointWeights.empty()) {
+                layers[1].jointWeights = jointWeights.data();
+                skinnedMesh.EvaluateBlendedPose(layers, 2, state, blended.data());
+                layers[1].jointWeights = nullptr;
+
+                for (int j = 0; j < (int)skinnedMesh.mJoints.size(); j++) {
+                    int boneIndex = skinnedMesh.mJoints[j].boneIndex;
+                    if (boneIndex == -1 || jointWeights[j] != 0.0f)
+                        continue;
+                    for (int k = 0; k < 16; k++) {
+                        float expected = (&base[boneIndex]._11)[k];
+                        maxError = max(maxError, fabsf((&blended[boneIndex]._11)[k] - expected) / max(1.0f, fabsf(expected)));
+                    }
+                }
+            }
+        }
+
+        if (maxError > tolerance)
+            passed = false;
+
+        // 시간 : 단독 포즈 대비 두 클립 crossfade 비용
+        auto start = Clock::now();
+        for (int i = 0; i < numSamples; i++)
+            skinnedMesh.EvaluatePose(0.01f * i, clipIndex, state, base.data());
+        double singleUs = ElapsedMs(start) * 1000.0 / numSamples;
+
+        layers[1].weight = 0.5f;
+        start = Clock::now();
+        for (int i = 0; i < numSamples; i++) {
+            layers[0].timePos = layers[1].timePos = 0.01f * i;
+            skinnedMesh.EvaluateBlendedPose(layers, 2, state, blended.data());
+        }
+        double blendedUs = ElapsedMs(start) * 1000.0 / numSamples;
+
+        Log("[Benchmark] PoseBlending : %s + %s single %.3f us/pose, blended %.3f us/pose, max error %g\n",
+            skinnedMesh.mAnimations[clipIndex].name.c_str(), skinnedMesh.mAnimations[clipIndex + 1].name.c_str(), singleUs, blendedUs, maxError);
+    }
+
+    assert(passed);
+    return passed;
+}
+
+bool Benchmark::BakedPoseCache(SkinnedMesh& skinnedMesh, float sampleRate, int numSamples)
+{
+    int numClips = (int)skinnedMesh.mAnimations.size();
+    if (numClips == 0)
+        return true;
+
+    bool passed = true;
+    bool wasEnabled = skinnedMesh.IsPoseCacheEnabled();
+    float previousSampleRate = skinnedMesh.PoseCacheSampleRate();
+    size_t previousBudget = skinnedMesh.PoseCacheBudget();
+
+    int numBones = skinnedMesh.NumBones();
+    vector<XMFLOAT4X4> live(numBones), baked(numBones);
+    PoseState state;
+
+    // 1. 클립별 굽는 시간, 크기, 오차, 재생 시간
+    skinnedMesh.EnablePoseCache(sampleRate, SIZE_MAX);
+    for (int clipIndex = 0; clipIndex < numClips; clipIndex++)
+    {
+        const AnimationClip& clip = skinnedMesh.mAnimations[clipIndex];
+        float durationSec = clip.duration / clip.tickPerSecond;
+
+        auto start = Clock::now();
+        skinnedMesh.PreparePoseCache(clipIndex);
+        double bakeMs = ElapsedMs(start);
+
+        // 프레임 사이 시간까지 실시간 계산과 비교한다. (마지막 프레임 구간은 처음으로 돌아가는 보간이므로 제외)
+        float maxError = 0.0f;
+        for (int i = 0; i < numSamples; i++)
+        {
+            float timeSec = (durationSec - 1.0f / sampleRate) * i / numSamples;
+            skinnedMesh.EvaluatePose(timeSec, clipIndex, state, live.data());
+            skinnedMesh.SampleBakedPose(timeSec, clipIndex, baked.data());
+
+            for (int j = 0; j < numBones; j++)
+                for (int k = 0; k < 16; k++) {
+                    float expected = (&live[j]._11)[k];
+                    maxError = max(maxError, fabsf((&baked[j]._11)[k] - expected) / max(1.0f, fabsf(expected)));
+                }
+        }
+
+        start = Clock::now();
+        for (int i = 0; i < numSamples; i++)
+            skinnedMesh.EvaluatePose(durationSec * i / numSamples, clipIndex, state, live.data());
+        double liveUs = ElapsedMs(start) * 1000.0 / numSamples;
+
+        start = Clock::now();
+        for (int i = 0; i < numSamples; i++)
+            skinnedMesh.SampleBakedPose(durationSec * i / numSamples, clipIndex, baked.data());
+        double bakedUs = ElapsedMs(start) * 1000.0 / numSamples;
+
+        Log("[Benchmark] BakedPoseCache : %-24s bake %.2f ms, live %.3f us/pose, baked %.3f us/pose (x%.2f), max error %g\n",
+            clip.name.c_str(), bakeMs, liveUs, bakedUs, liveUs / bakedUs, maxError);
+    }
+    Log("[Benchmark] BakedPoseCache : %d clips at %.0f Hz, %zu bytes\n", numClips, sampleRate, skinnedMesh.PoseCacheByteSize());
+
+    // 2. LRU : 가장 큰 클립 두 개가 들어가는 예산에서 0, 1, 2, 0 순서로 준비하면 0과 1이 차례로 밀려나야 한다.
+    if (numClips >= 3)
+    {
+        size_t largest = 0;
+        for (int clipIndex = 0; clipIndex < numClips; clipIndex++) {
+            const AnimationClip& clip = skinnedMesh.mAnimations[clipIndex];
+            size_t numFrames = (size_t)(clip.duration / clip.tickPerSecond * sampleRate) + 2;
+            largest = max(largest, numFrames * numBones * sizeof(AffineTransform3x4));
+        }
+
+        skinnedMesh.EnablePoseCache(sampleRate, largest * 2);
+        skinnedMesh.PreparePoseCache(0);
+        skinnedMesh.PreparePoseCache(1);
+        skinnedMesh.PreparePoseCache(2);
+        bool evictedFirst = !skinnedMesh.IsPoseBaked(0) && skinnedMesh.IsPoseBaked(1) && skinnedMesh.IsPoseBaked(2);
+        skinnedMesh.PreparePoseCache(0);
+        bool evictedSecond = skinnedMesh.IsPoseBaked(0) && !skinnedMesh.IsPoseBaked(1) && skinnedMesh.IsPoseBaked(2);
+
+        // 클립 크기가 서로 많이 다르면 두 개 이상 밀려날 수 있으므로 예산 초과만 실패로 본다.
+        if (skinnedMesh.PoseCacheByteSize() > largest * 2)
+            passed = false;
+
+        Log("[Benchmark] BakedPoseCache : LRU budget %zu bytes, evicted 0 then 1 : %s\n",
+            largest * 2, (evictedFirst && evictedSecond) ? "yes" : "no");
+    }
+
+    skinnedMesh.DisablePoseCache();
+    if (wasEnabled)
+        skinnedMesh.EnablePoseCache(previousSampleRate, previousBudget);
+
+    assert(passed);
+    return passed;
+}
+
+template <typename T>
+static bool IsSameArray(const vector<T>& a, const vector<T>& b)
+{
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+bool Benchmark::CookedModelLoad(const vector<string>& sourceFiles, const string& cookedFile, int numSamples)
+{
+    if (sourceFiles.empty())
+        return true;
+
+    const string benchFile = cookedFile + ".bench";
+
+    // 1. FBX : Assimp로 읽고 업로드할 정점까지 만든다.
+    SkinnedMesh fbxMesh;
+    fbxMesh.SetAnimationCompression(true, true);
+    vector<SkinnedVertex> vertices;
+
+    auto start = Clock::now();
+    fbxMesh.LoadMesh(sourceFiles[0]);
+    for (int i = 1; i < (int)sourceFiles.size(); i++)
+        fbxMesh.LoadAnimations(sourceFiles[i]);
+    fbxMesh.BuildSkinnedVertices(vertices);
+    double fbxMs = ElapsedMs(start);
+
+    start = Clock::now();
+    bool saved = fbxMesh.SaveCooked(benchFile, sourceFiles, vertices);
+    double cookMs = ElapsedMs(start);
+
+    // 2. 쿡 파일 : 매핑하고 배열 단위로 복사한다.
+    SkinnedMesh cookedMesh;
+    cookedMesh.SetAnimationCompression(true, true);
+    CookedModelFile file;
+
+    start = Clock::now();
+    bool loaded = saved && cookedMesh.LoadCooked(benchFile, sourceFiles, file);
+    double cookedMs = ElapsedMs(start);
+
+    bool passed = loaded
+        && file.NumVertices() == vertices.size()
+        && memcmp(file.Vertices(), vertices.data(), vertices.size() * sizeof(SkinnedVertex)) == 0
+        && IsSameArray(cookedMesh.mPositions, fbxMesh.mPositions)
+        && IsSameArray(cookedMesh.mNormals, fbxMesh.mNormals)
+        && IsSameArray(cookedMesh.mTexCoords, fbxMesh.mTexCoords)
+        && IsSameArray(cookedMesh.mIndices, fbxMesh.mIndices)
+        && IsSameArray(cookedMesh.mBones, fbxMesh.mBones)
+        && cookedMesh.mBoneNameToIndexMap == fbxMesh.mBoneNameToIndexMap
+        && cookedMesh.mBoneHierarchy == fbxMesh.mBoneHierarchy
+        && cookedMesh.mNodeHierarchy == fbxMesh.mNodeHierarchy
+        && cookedMesh.mSubmeshes.size() == fbxMesh.mSubmeshes.size()
+        && cookedMesh.mJoints.size() == fbxMesh.mJoints.size()
+        && cookedMesh.mAnimations.size() == fbxMesh.mAnimations.size();
+
+    for (int i = 0; passed && i < (int)fbxMesh.mBoneInfo.size(); i++)
+        passed = memcmp(&cookedMesh.mBoneInfo[i].OffsetMatrix, &fbxMesh.mBoneInfo[i].OffsetMatrix, sizeof(XMFLOAT4X4)) == 0;
+
+    // 3. 같은 데이터에서 계산한 포즈이므로 비트 단위로 같아야 한다.
+    int numBones = fbxMesh.NumBones();
+    vector<XMFLOAT4X4> expected(numBones), actual(numBones);
+    PoseState fbxState, cookedState;
+    for (int clipIndex = 0; passed && clipIndex < (int)fbxMesh.mAnimations.size(); clipIndex++)
+    {
+        const AnimationClip& clip = fbxMesh.mAnimations[clipIndex];
+        float durationSec = clip.duration / clip.tickPerSecond;
+        for (int i = 0; passed && i < numSamples; i++)
+        {
+            float timeSec = durationSec * i / numSamples;
+            fbxMesh.EvaluatePose(timeSec, clipIndex, fbxState, expected.data());
+            cookedMesh.EvaluatePose(timeSec, clipIndex, cookedState, actual.data());
+            passed = memcmp(expected.data(), actual.data(), numBones * sizeof(XMFLOAT4X4)) == 0;
+        }
+    }
+
+    uint64_t lastWriteTime = 0, fileSize = 0;
+    GetCookedSourceStamp(benchFile, lastWriteTime, fileSize);
+    file.Close();
+
+    // 4. 압축 허용 오차가 다르면 쿡 파일을 쓰지 않아야 한다.
+    bool isIdentical = passed;
+    SkinnedMesh staleMesh;
+    AnimationCompressionSettings staleSettings;
+    staleSettings.rotationTolerance *= 2.0f;
+    staleMesh.SetAnimationCompression(true, true, staleSettings);
+    CookedModelFile staleFile;
+    bool isStaleRejected = !staleMesh.LoadCooked(benchFile, sourceFiles, staleFile);
+    staleFile.Close();
+    passed = passed && isStaleRejected;
+
+    // 5. 배열 구간은 맞지만 다른 배열을 가리키는 값이 틀린 쿡 파일도 쓰지 않아야 한다. (사본 하나씩 고쳐 읽는다.)
+    vector<char> bytes;
+    {
+        ifstream in(benchFile, ios::binary);
+        bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    CookedModelHeader header;
+    if (bytes.size() >= sizeof(header))
+        memcpy(&header, bytes.data(), sizeof(header));
+    const string corruptFile = cookedFile + ".corrupt";
+    auto isCorruptionRejected = [&](auto corrupt) {
+        vector<char> corrupted = bytes;
+        corrupt(corrupted.data());
+        {
+            ofstream out(corruptFile, ios::binary);
+            out.write(corrupted.data(), corrupted.size());
+        }
+        SkinnedMesh corruptMesh;
+        corruptMesh.SetAnimationCompression(true, true);
+        CookedModelFile corruptFileView;
+        bool rejected = !corruptMesh.LoadCooked(corruptFile, sourceFiles, corruptFileView);
+        corruptFileView.Close();
+        return rejected;
+    };
+    int numCorruptions = 0, numCorruptionsRejected = 0;
+    auto checkCorruption = [&](bool applies, auto corrupt) {
+        if (!applies)
+            return;
+        numCorruptions++;
+        if (isCorruptionRejected(corrupt))
+            numCorruptionsRejected++;
+    };
+    if (passed && bytes.size() >= sizeof(header)) {
+        // 자식 이름을 부모 자신의 이름으로 (부모보다 앞의 노드)
+        int parentNode = -1;
+        const CookedNode* nodes = reinterpret_cast<const CookedNode*>(bytes.data() + header.nodes.offset);
+        for (int i = 0; parentNode < 0 && i < (int)header.nodes.count; i++)
+            if (nodes[i].children.count > 0)
+                parentNode = i;
+        checkCorruption(parentNode >= 0, [&](char* data) {
+            const CookedNode& node = reinterpret_cast<const CookedNode*>(data + header.nodes.offset)[parentNode];
+            reinterpret_cast<CookedString*>(data + header.nodeChildren.offset)[node.children.first] = node.name;
+        });
+        checkCorruption(header.indices.count > 0, [&](char* data) {
+            reinterpret_cast<UINT*>(data + header.indices.offset)[0] = (UINT)header.vertices.count;
+        });
+        checkCorruption(header.vertexBones.count > 0, [&](char* data) {
+            VertexBoneData& bone = reinterpret_cast<VertexBoneData*>(data + header.vertexBones.offset)[0];
+            bone.BoneIDs[0] = (int)header.bones.count;
+            bone.Weights[0] = 1.0f;
+        });
+        checkCorruption(header.boneChildren.count > 0, [&](char* data) {
+            reinterpret_cast<int*>(data + header.boneChildren.offset)[0] = -1;
+        });
+        checkCorruption(header.compressedTracks.count > 0, [&](char* data) {
+            reinterpret_cast<CompressedTrack*>(data + header.compressedTracks.offset)[0].valueOffset = UINT_MAX - 2;
+        });
+    }
+    remove(corruptFile.c_str());
+    remove(benchFile.c_str());
+    bool isCorruptionRejectedAll = numCorruptionsRejected == numCorruptions;
+    passed = passed && isCorruptionRejectedAll;
+
+    Log("[Benchmark] CookedModelLoad : FBX %.2f ms, cook %.2f ms, cooked %.2f ms (x%.1f), %llu bytes, %s, %s, %d / %d corrupted files rejected\n",
+        fbxMs, cookMs, cookedMs, fbxMs / cookedMs, fileSize, isIdentical ? "identical" : "MISMATCH",
+        isStaleRejected ? "other tolerances rejected" : "other tolerances ACCEPTED", numCorruptionsRejected, numCorruptions);
+
+    assert(passed);
+    return passed;
+}
+
+bool Benchmark::LoadSkullModel(const char* filename, vector<Vertex>& vertices, vector<UINT>& indices)
+{
+    ifstream fin(filename);
+    if (!fin)
+        return false;
+
+    UINT vertexCount = 0, triangleCount = 0;
+    string ignore;
+    fin >> ignore >> vertexCount;
+    fin >> ignore >> triangleCount;
+    fin >> ignore >> ignore >> ignore >> ignore;
+
+    vertices.resize(vertexCount);
+    for (UINT i = 0; i < vertexCount; i++)
+    {
+        Vertex& vertex = vertices[i];
+        fin >> vertex.Pos.x >> vertex.Pos.y >> vertex.Pos.z;
+        fin >> vertex.Normal.x >> vertex.Normal.y >> vertex.Normal.z;
+        vertex.TexC = XMFLOAT2(0.0f, 0.0f);
+    }
+
+    fin >> ignore >> ignore >> ignore;
+
+    indices.resize(triangleCount * 3);
+    for (UINT i = 0; i < triangleCount * 3; i++)
+        fin >> indices[i];
+
+    return !fin.fail();
+}
+
+// 메시의 중심을 지나는 임의의 평면들 (중심에서 크기의 10% 안쪽으로 흔든다.)
+static void BuildSlicePlanes(const Vertex* vertices, UINT numVertices, int numPlanes, vector<XMFLOAT4>& planes)
+{
+    XMFLOAT3 minPos = vertices[0].Pos, maxPos = vertices[0].Pos;
+    for (UINT i = 1; i < numVertices; i++)
+    {
+        minPos = XMFLOAT3(min(minPos.x, vertices[i].Pos.x), min(minPos.y, vertices[i].Pos.y), min(minPos.z, vertices[i].Pos.z));
+        maxPos = XMFLOAT3(max(maxPos.x, vertices[i].Pos.x), max(maxPos.y, vertices[i].Pos.y), max(maxPos.z, vertices[i].Pos.z));
+    }
+    XMVECTOR center = (XMLoadFloat3(&minPos) + XMLoadFloat3(&maxPos)) * 0.5f;
+    float extent = XMVectorGetX(XMVector3Length(XMLoadFloat3(&maxPos) - XMLoadFloat3(&minPos)));
+
+    mt19937 random(7);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    planes.resize(numPlanes);
+    for (int i = 0; i < numPlanes; i++)
+    {
+        XMVECTOR normal = XMVectorSet(unit(random), unit(random), unit(random), 0.0f);
+        normal = (XMVectorGetX(XMVector3LengthSq(normal)) > 1e-4f) ? XMVector3Normalize(normal) : XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+        XMVECTOR point = center + normal * (unit(random) * 0.1f * extent);
+        XMStoreFloat4(&planes[i], XMPlaneFromPointNormal(point, normal));
+    }
+}
+
+void Benchmark::MeshSliceThroughput(const Mesh* shapeGeo, const Mesh* terrain, double minDurationMs)
+{
+    // skull.txt는 업로드하지 않는 CPU 사본만 만든다.
+    vector<Vertex> skullVertices;
+    vector<UINT> skullIndices;
+    Mesh skull;
+    bool hasSkull = LoadSkullModel("Models/skull.txt", skullVertices, skullIndices);
+    if (hasSkull) {
+        skull.CreateBlob(skullVertices, skullIndices);
+        skull.AddSubmesh("skull", (UINT)skullIndices.size());
+    }
+
+    struct SliceTarget
+    {
+        const char* name;
+        const Mesh* mesh;
+        Submesh submesh;
+    };
+    vector<SliceTarget> targets;
+    if (shapeGeo)
+        targets.push_back({ "box", shapeGeo, shapeGeo->GetSubmesh("box") });
+    if (hasSkull)
+        targets.push_back({ "skull", &skull, skull.mSubmeshes[0] });
+    if (terrain)
+        targets.push_back({ "terrain", terrain, terrain->mSubmeshes[0] });
+
+    const int numPlanes = 16;
+    vector<XMFLOAT4> planes;
+    for (const SliceTarget& target : targets)
+    {
+        const Vertex* vertices = static_cast<const Vertex*>(target.mesh->mVertexBufferCPU->GetBufferPointer()) + target.submesh.baseVertex;
+        UINT numVertices = (UINT)(target.mesh->mVertexBufferCPU->GetBufferSize() / sizeof(Vertex)) - target.submesh.baseVertex;
+        BuildSlicePlanes(vertices, numVertices, numPlanes, planes);
+
+        // 처음 자를 때는 작업 버퍼를 잡는다.
+        MeshSlice::SliceContext context;
+        auto start = Clock::now();
+        context.Slice(target.mesh, target.submesh, planes[0]);
+        double coldMs = ElapsedMs(start);
+
+        // 같은 컨텍스트로 반복해서 자른다.
+        int numCuts = 0;
+        start = Clock::now();
+        while (numCuts < 3 || ElapsedMs(start) < minDurationMs)
+            context.Slice(target.mesh, target.submesh, planes[numCuts++ % numPlanes]);
+        double contextCutsPerSec = numCuts * 1000.0 / ElapsedMs(start);
+
+        // 매번 새 벡터에 결과를 복사한다.
+        int numLegacyCuts = 0;
+        start = Clock::now();
+        while (numLegacyCuts < 3 || ElapsedMs(start) < minDurationMs)
+        {
+            vector<vector<Vertex>> outVertices;
+            vector<vector<UINT>> outIndices;
+            MeshSlice::MeshCompleteSlice(target.mesh, target.submesh, planes[numLegacyCuts++ % numPlanes], outVertices, outIndices);
+        }
+        double legacyCutsPerSec = numLegacyCuts * 1000.0 / ElapsedMs(start);
+
+        Log("[Benchmark] MeshSlice : %-8s %8u tris, first cut %.2f ms, SliceContext %.1f cuts/s, MeshCompleteSlice %.1f cuts/s (x%.2f), scratch %zu bytes\n",
+            target.name, target.submesh.numIndices / 3, coldMs, contextCutsPerSec, legacyCutsPerSec, contextCutsPerSec / legacyCutsPerSec, context.ScratchByteSize());
+    }
+}
+
+// 위치가 같은 정점을 하나로 합친 뒤, 모든 변을 지나는 면의 수가 방향별로 같은지 확인한다.
+// 절단면 정점은 옆면 정점과 위치가 같고 법선만 다르므로 위치로 합쳐야 한다.
+static bool IsWatertight(span<const Vertex> vertices, span<const UINT> indices)
+{
+    map<array<float, 3>, UINT> weldedIndices;
+    vector<UINT> welded(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        array<float, 3> pos = { vertices[i].Pos.x, vertices[i].Pos.y, vertices[i].Pos.z };
+        welded[i] = weldedIndices.emplace(pos, (UINT)weldedIndices.size()).first->second;
+    }
+
+    unordered_map<uint64_t, int> edgeCounts;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            UINT index0 = welded[indices[i + k]];
+            UINT index1 = welded[indices[i + (k + 1) % 3]];
+            if (index0 != index1)
+                edgeCounts[MeshSlice::EdgeTable::Key(index0, index1)]++;
+        }
+    }
+
+    for (const auto& [key, count] : edgeCounts)
+    {
+        auto reverse = edgeCounts.find((key << 32) | (key >> 32));
+        if (reverse == edgeCounts.end() || reverse->second != count)
+            return false;
+    }
+    return true;
+}
+
+// 절단면 법선을 가진 면이 모두 법선 쪽을 보는지 확인한다. 겹치거나 뒤집힌 절단면 삼각형(오목한 단면, 구멍)이 있으면 false
+static bool IsCapOriented(span<const Vertex> vertices, span<const UINT> indices, const XMFLOAT3& capNormal)
+{
+    XMVECTOR normal = XMLoadFloat3(&capNormal);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const Vertex& v0 = vertices[indices[i]];
+        const Vertex& v1 = vertices[indices[i + 1]];
+        const Vertex& v2 = vertices[indices[i + 2]];
+        bool isCap = true;
+        for (const Vertex* v : { &v0, &v1, &v2 })
+            isCap = isCap && v->Normal.x == capNormal.x && v->Normal.y == capNormal.y && v->Normal.z == capNormal.z;
+        if (!isCap)
+            continue;
+
+        // 거의 한 직선 위에 있는 삼각형은 반올림으로 부호가 바뀔 수 있으므로 변 길이에 비례한 허용 오차를 둔다.
+        XMVECTOR edge0 = XMLoadFloat3(&v1.Pos) - XMLoadFloat3(&v0.Pos);
+        XMVECTOR edge1 = XMLoadFloat3(&v2.Pos) - XMLoadFloat3(&v0.Pos);
+        float tolerance = 1e-5f * XMVectorGetX(XMVector3Length(edge0)) * XMVectorGetX(XMVector3Length(edge1));
+        if (XMVectorGetX(XMVector3Dot(XMVector3Cross(edge0, edge1), normal)) < -tolerance)
+            return false;
+    }
+    return true;
+}
+
+// 안쪽 반지름 innerRadius, 바깥 반지름 outerRadius인 두꺼운 관 (y축, 이음매 없이 닫힌 메시)
+// 축에 수직으로 자르면 구멍이 있는 절단면이 생긴다.
+static void BuildTubeMesh(float innerRadius, float outerRadius, float height, int numSlices, vector<Vertex>& vertices, vector<UINT>& indices)
+{
+    // 정점 : 바깥 위, 바깥 아래, 안쪽 위, 안쪽 아래 고리
+    vertices.resize(numSlices * 4);
+    for (int i = 0; i < numSlices; i++)
+    {
+        float angle = XM_2PI * i / numSlices;
+        float c = cosf(angle), s = sinf(angle);
+        for (int ring = 0; ring < 4; ring++)
+        {
+            float radius = (ring < 2) ? outerRadius : innerRadius;
+            Vertex& vertex = vertices[ring * numSlices + i];
+            vertex.Pos = XMFLOAT3(radius * c, (ring % 2 == 0) ? height * 0.5f : -height * 0.5f, radius * s);
+            vertex.Normal = (ring < 2) ? XMFLOAT3(c, 0.0f, s) : XMFLOAT3(-c, 0.0f, -s);
+            vertex.TexC = XMFLOAT2((float)i / numSlices, (ring % 2 == 0) ? 0.0f : 1.0f);
+        }
+    }
+
+    indices.clear();
+    UINT n = (UINT)numSlices;
+    for (UINT i = 0; i < n; i++)
+    {
+        UINT j = (i + 1) % n;
+        UINT outerTop[2] = { i, j }, outerBottom[2] = { n + i, n + j };
+        UINT innerTop[2] = { n * 2 + i, n * 2 + j }, innerBottom[2] = { n * 3 + i, n * 3 + j };
+
+        for (UINT index : { outerTop[0], outerTop[1], outerBottom[1], outerTop[0], outerBottom[1], outerBottom[0] })
+            indices.push_back(index);
+        for (UINT index : { innerTop[0], innerBottom[1], innerTop[1], innerTop[0], innerBottom[0], innerBottom[1] })
+            indices.push_back(index);
+        for (UINT index : { outerTop[0], innerTop[0], innerTop[1], outerTop[0], innerTop[1], outerTop[1] })
+            indices.push_back(index);
+        for (UINT index : { outerBottom[0], innerBottom[1], innerBottom[0], outerBottom[0], outerBottom[1], innerBottom[1] })
+            indices.push_back(index);
+    }
+}
+
+// 한 변(x = y = 0, z축 방향)만 맞닿은 두 상자 (상자마다 정점 8개를 따로 가진 닫힌 메시)
+// z축에 수직으로 자르면 두 단면 사각형이 꼭짓점 하나에서 만나므로 그 점에서 나가는 절단면 선분이 둘이다.
+static void BuildPinchedBoxesMesh(float size, vector<Vertex>& vertices, vector<UINT>& indices)
+{
+    // 면마다 상자 안 꼭짓점 번호 (bit 0 = x, bit 1 = y, bit 2 = z)와 바깥 법선
+    const UINT faceCorners[6][4] = { { 0, 2, 6, 4 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, { 0, 1, 3, 2 }, { 4, 5, 7, 6 } };
+    const XMFLOAT3 faceNormals[6] = { { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 } };
+
+    vertices.clear();
+    indices.clear();
+    for (float offset : { -size, 0.0f })
+    {
+        UINT base = (UINT)vertices.size();
+        for (UINT corner = 0; corner < 8; corner++)
+        {
+            Vertex vertex;
+            vertex.Pos = XMFLOAT3(offset + ((corner & 1) ? size : 0.0f), offset + ((corner & 2) ? size : 0.0f), (corner & 4) ? size * 0.5f : -size * 0.5f);
+            vertex.Normal = XMFLOAT3(0.0f, 0.0f, 0.0f);
+            vertex.TexC = XMFLOAT2((corner & 1) ? 1.0f : 0.0f, (corner & 2) ? 0.0f : 1.0f);
+            vertices.push_back(vertex);
+        }
+
+        // 면 법선(두 변의 외적)이 바깥을 보도록 순서를 맞춘다. (BuildTubeMesh와 같은 감기 순서)
+        for (int face = 0; face < 6; face++)
+        {
+            const UINT* c = faceCorners[face];
+            XMVECTOR p0 = XMLoadFloat3(&vertices[base + c[0]].Pos);
+            XMVECTOR cross = XMVector3Cross(XMLoadFloat3(&vertices[base + c[1]].Pos) - p0, XMLoadFloat3(&vertices[base + c[2]].Pos) - p0);
+            bool isOutward = XMVectorGetX(XMVector3Dot(cross, XMLoadFloat3(&faceNormals[face]))) > 0.0f;
+            for (UINT k : { 0u, 1u, 2u, 0u, 2u, 3u })
+                indices.push_back(base + c[(isOutward || k == 0) ? k : 4 - k]);
+        }
+    }
+}
+
+// tolerance 안에 있는 정점의 위치를 먼저 나온 정점의 위치로 맞춘다.
+// sphere, cylinder의 이음매처럼 인덱스는 다르고 위치가 거의 같은 정점을 비트 단위로 같게 만든다.
+static void SnapPositions(vector<Vertex>& vertices, float tolerance)
+{
+    vector<UINT> order(vertices.size());
+    for (UINT i = 0; i < (UINT)order.size(); i++)
+        order[i] = i;
+    sort(order.begin(), order.end(), [&](UINT a, UINT b) { return vertices[a].Pos.x < vertices[b].Pos.x; });
+
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const XMFLOAT3& pos = vertices[order[i]].Pos;
+        for (size_t j = i + 1; j < order.size() && vertices[order[j]].Pos.x - pos.x <= tolerance; j++)
+        {
+            XMFLOAT3& other = vertices[order[j]].Pos;
+            if (fabs(other.y - pos.y) <= tolerance && fabs(other.z - pos.z) <= tolerance)
+                other = pos;
+        }
+    }
+}
+
+bool Benchmark::MeshSliceWatertight(const Mesh* shapeGeo, int numPlanes)
+{
+    vector<Vertex> skullVertices;
+    vector<UINT> skullIndices;
+    Mesh skull;
+    if (LoadSkullModel("Models/skull.txt", skullVertices, skullIndices)) {
+        skull.CreateBlob(skullVertices, skullIndices);
+        skull.AddSubmesh("skull", (UINT)skullIndices.size());
+    }
+
+    struct SliceTarget
+    {
+        const char* name;
+        const Mesh* mesh;
+        Submesh submesh;
+    };
+    vector<SliceTarget> targets;
+    if (shapeGeo) {
+        for (const char* name : { "box", "sphere", "cylinder" })
+            targets.push_back({ name, shapeGeo, shapeGeo->GetSubmesh(name) });
+    }
+    if (!skull.mSubmeshes.empty())
+        targets.push_back({ "skull", &skull, skull.mSubmeshes[0] });
+
+    vector<Vertex> tubeVertices;
+    vector<UINT> tubeIndices;
+    Mesh tube;
+    BuildTubeMesh(0.3f, 0.5f, 1.0f, 24, tubeVertices, tubeIndices);
+    tube.CreateBlob(tubeVertices, tubeIndices);
+    tube.AddSubmesh("tube", (UINT)tubeIndices.size());
+    targets.push_back({ "tube", &tube, tube.mSubmeshes[0] });
+
+    vector<Vertex> pinchVertices;
+    vector<UINT> pinchIndices;
+    Mesh pinch;
+    BuildPinchedBoxesMesh(0.5f, pinchVertices, pinchIndices);
+    pinch.CreateBlob(pinchVertices, pinchIndices);
+    pinch.AddSubmesh("pinch", (UINT)pinchIndices.size());
+    targets.push_back({ "pinch", &pinch, pinch.mSubmeshes[0] });
+
+    bool passed = true;
+    MeshSlice::SliceContext context;
+    vector<XMFLOAT4> planes;
+    for (const SliceTarget& target : targets)
+    {
+        const UINT* indices = static_cast<const UINT*>(target.mesh->mIndexBufferCPU->GetBufferPointer()) + target.submesh.baseIndex;
+        UINT numIndices = target.submesh.numIndices;
+        UINT numVertices = 0;
+        for (UINT i = 0; i < numIndices; i++)
+            numVertices = max(numVertices, indices[i] + 1);
+
+        const Vertex* sourceVertices = static_cast<const Vertex*>(target.mesh->mVertexBufferCPU->GetBufferPointer()) + target.submesh.baseVertex;
+        vector<Vertex> snappedVertices(sourceVertices, sourceVertices + numVertices);
+        SnapPositions(snappedVertices, 1e-5f);
+        const Vertex* vertices = snappedVertices.data();
+
+        if (!IsWatertight(span<const Vertex>(vertices, numVertices), span<const UINT>(indices, numIndices))) {
+            Log("[Benchmark] MeshSliceWatertight : %-8s source mesh is not closed, skipped\n", target.name);
+            continue;
+        }
+
+        // 임의 평면 + 정점이 절단면 위에 놓이는 축 평면 (중심, 겉면)
+        BuildSlicePlanes(vertices, numVertices, numPlanes, planes);
+        XMFLOAT3 minPos = vertices[0].Pos, maxPos = vertices[0].Pos;
+        for (UINT i = 1; i < numVertices; i++)
+        {
+            minPos = XMFLOAT3(min(minPos.x, vertices[i].Pos.x), min(minPos.y, vertices[i].Pos.y), min(minPos.z, vertices[i].Pos.z));
+            maxPos = XMFLOAT3(max(maxPos.x, vertices[i].Pos.x), max(maxPos.y, vertices[i].Pos.y), max(maxPos.z, vertices[i].Pos.z));
+        }
+        planes.push_back(XMFLOAT4(1.0f, 0.0f, 0.0f, -(minPos.x + maxPos.x) * 0.5f));
+        planes.push_back(XMFLOAT4(0.0f, 1.0f, 0.0f, -(minPos.y + maxPos.y) * 0.5f));
+        planes.push_back(XMFLOAT4(0.0f, 0.0f, 1.0f, -(minPos.z + maxPos.z) * 0.5f));
+        planes.push_back(XMFLOAT4(1.0f, 0.0f, 0.0f, -maxPos.x));
+        planes.push_back(XMFLOAT4(0.0f, -1.0f, 0.0f, minPos.y));
+
+        int numOpenPieces = 0, numFlippedCaps = 0, numCapLoops = 0, numCapHoles = 0;
+        for (const XMFLOAT4& plane : planes)
+        {
+            int numPieces = context.Slice(vertices, numVertices, indices, numIndices, plane);
+            XMVECTOR normal = XMVector3Normalize(XMVectorSet(plane.x, plane.y, plane.z, 0.0f));
+            for (int piece = 0; piece < numPieces; piece++)
+            {
+                if (!IsWatertight(context.PieceVertices(piece), context.PieceIndices(piece))) {
+                    if (numOpenPieces++ == 0)
+                        Log("[Benchmark] MeshSliceWatertight : %-8s piece %d is open, plane (%f, %f, %f, %f)\n", target.name, piece, plane.x, plane.y, plane.z, plane.w);
+                }
+
+                XMFLOAT3 capNormal;
+                XMStoreFloat3(&capNormal, (piece == 0) ? -normal : normal);
+                if (!IsCapOriented(context.PieceVertices(piece), context.PieceIndices(piece), capNormal)) {
+                    if (numFlippedCaps++ == 0)
+                        Log("[Benchmark] MeshSliceWatertight : %-8s piece %d has flipped cap triangles, plane (%f, %f, %f, %f)\n", target.name, piece, plane.x, plane.y, plane.z, plane.w);
+                }
+                numCapLoops += context.CapLoopCount(piece);
+                numCapHoles += context.CapHoleCount(piece);
+            }
+        }
+        Log("[Benchmark] MeshSliceWatertight : %-8s %zu planes, %d cap loops (%d holes), %d open pieces, %d flipped caps\n",
+            target.name, planes.size(), numCapLoops, numCapHoles, numOpenPieces, numFlippedCaps);
+        passed = passed && numOpenPieces == 0 && numFlippedCaps == 0;
+    }
+    return passed;
+}
+
+// 닫힌 메시의 부피 (원점 기준 사면체 부피의 합)
+static double MeshVolume(span<const Vertex> vertices, span<const UINT> indices)
+{
+    double volume = 0.0;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        XMVECTOR p0 = XMLoadFloat3(&vertices[indices[i]].Pos);
+        XMVECTOR p1 = XMLoadFloat3(&vertices[indices[i + 1]].Pos);
+        XMVECTOR p2 = XMLoadFloat3(&vertices[indices[i + 2]].Pos);
+        volume += XMVectorGetX(XMVector3Dot(p0, XMVector3Cross(p1, p2)));
+    }
+    return volume / 6.0;
+}
+
+// 조각마다 모든 평면을 차례로 SliceContext로 자르고 결과를 조각별 벡터에 복사한다. (MultiSliceContext 이전의 방식)
+static int SliceRepeatedly(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, span<const XMFLOAT4> planes,
+    MeshSlice::SliceContext& context, vector<vector<Vertex>>& pieceVertices, vector<vector<UINT>>& pieceIndices)
+{
+    pieceVertices.assign(1, vector<Vertex>(vertices, vertices + numVertices));
+    pieceIndices.assign(1, vector<UINT>(indices, indices + numIndices));
+    for (const XMFLOAT4& plane : planes)
+    {
+        vector<vector<Vertex>> nextVertices;
+        vector<vector<UINT>> nextIndices;
+        for (size_t i = 0; i < pieceVertices.size(); i++)
+        {
+            int numPieces = context.Slice(pieceVertices[i].data(), (UINT)pieceVertices[i].size(), pieceIndices[i].data(), (UINT)pieceIndices[i].size(), plane);
+            for (int piece = 0; piece < numPieces; piece++)
+            {
+                if (context.PieceIndices(piece).empty())
+                    continue;
+                nextVertices.emplace_back(context.PieceVertices(piece).begin(), context.PieceVertices(piece).end());
+                nextIndices.emplace_back(context.PieceIndices(piece).begin(), context.PieceIndices(piece).end());
+            }
+        }
+        pieceVertices.swap(nextVertices);
+        pieceIndices.swap(nextIndices);
+    }
+    return (int)pieceVertices.size();
+}
+
+bool Benchmark::MeshMultiSlice(const Mesh* shapeGeo, int numRepeats)
+{
+    vector<Vertex> skullVertices;
+    vector<UINT> skullIndices;
+    Mesh skull;
+    if (LoadSkullModel("Models/skull.txt", skullVertices, skullIndices)) {
+        skull.CreateBlob(skullVertices, skullIndices);
+        skull.AddSubmesh("skull", (UINT)skullIndices.size());
+    }
+
+    vector<Vertex> tubeVertices;
+    vector<UINT> tubeIndices;
+    Mesh tube;
+    BuildTubeMesh(0.3f, 0.5f, 1.0f, 24, tubeVertices, tubeIndices);
+    tube.CreateBlob(tubeVertices, tubeIndices);
+    tube.AddSubmesh("tube", (UINT)tubeIndices.size());
+
+    struct SliceTarget
+    {
+        const char* name;
+        const Mesh* mesh;
+        Submesh submesh;
+    };
+    vector<SliceTarget> targets;
+    if (shapeGeo) {
+        for (const char* name : { "box", "sphere" })
+            targets.push_back({ name, shapeGeo, shapeGeo->GetSubmesh(name) });
+    }
+    if (!skull.mSubmeshes.empty())
+        targets.push_back({ "skull", &skull, skull.mSubmeshes[0] });
+    targets.push_back({ "tube", &tube, tube.mSubmeshes[0] });
+
+    bool passed = true;
+    MeshSlice::MultiSliceContext context;
+    MeshSlice::SliceContext repeatedContext;
+    vector<vector<Vertex>> repeatedVertices;
+    vector<vector<UINT>> repeatedIndices;
+    for (const SliceTarget& target : targets)
+    {
+        const UINT* indices = static_cast<const UINT*>(target.mesh->mIndexBufferCPU->GetBufferPointer()) + target.submesh.baseIndex;
+        UINT numIndices = target.submesh.numIndices;
+        UINT numVertices = 0;
+        for (UINT i = 0; i < numIndices; i++)
+            numVertices = max(numVertices, indices[i] + 1);
+
+        const Vertex* sourceVertices = static_cast<const Vertex*>(target.mesh->mVertexBufferCPU->GetBufferPointer()) + target.submesh.baseVertex;
+        vector<Vertex> snappedVertices(sourceVertices, sourceVertices + numVertices);
+        SnapPositions(snappedVertices, 1e-5f);
+        const Vertex* vertices = snappedVertices.data();
+        bool isClosed = IsWatertight(span<const Vertex>(vertices, numVertices), span<const UINT>(indices, numIndices));
+        double volume = MeshVolume(span<const Vertex>(vertices, numVertices), span<const UINT>(indices, numIndices));
+
+        // 격자 : 축마다 바운딩 박스를 3등분하는 평면 2개 (최대 27조각)
+        XMFLOAT3 minPos = vertices[0].Pos, maxPos = vertices[0].Pos;
+        for (UINT i = 1; i < numVertices; i++)
+        {
+            minPos = XMFLOAT3(min(minPos.x, vertices[i].Pos.x), min(minPos.y, vertices[i].Pos.y), min(minPos.z, vertices[i].Pos.z));
+            maxPos = XMFLOAT3(max(maxPos.x, vertices[i].Pos.x), max(maxPos.y, vertices[i].Pos.y), max(maxPos.z, vertices[i].Pos.z));
+        }
+        vector<XMFLOAT4> gridPlanes;
+        for (int i = 1; i <= 2; i++)
+        {
+            float t = i / 3.0f;
+            gridPlanes.push_back(XMFLOAT4(1.0f, 0.0f, 0.0f, -(minPos.x + (maxPos.x - minPos.x) * t)));
+            gridPlanes.push_back(XMFLOAT4(0.0f, 1.0f, 0.0f, -(minPos.y + (maxPos.y - minPos.y) * t)));
+            gridPlanes.push_back(XMFLOAT4(0.0f, 0.0f, 1.0f, -(minPos.z + (maxPos.z - minPos.z) * t)));
+        }
+        vector<XMFLOAT4> randomPlanes;
+        BuildSlicePlanes(vertices, numVertices, 8, randomPlanes);
+
+        for (const auto& [setName, planes] : { make_pair("grid", &gridPlanes), make_pair("random", &randomPlanes) })
+        {
+            int numPieces = context.Slice(vertices, numVertices, indices, numIndices, *planes);
+
+            int numOpenPieces = 0;
+            double pieceVolume = 0.0;
+            for (int piece = 0; piece < numPieces; piece++)
+            {
+                const Submesh& submesh = context.PieceSubmeshes()[piece];
+                span<const UINT> pieceIndices = context.Indices().subspan(submesh.baseIndex, submesh.numIndices);
+                if (isClosed && !IsWatertight(context.Vertices(), pieceIndices))
+                    numOpenPieces++;
+                pieceVolume += MeshVolume(context.Vertices(), pieceIndices);
+            }
+            double volumeError = fabs(pieceVolume - volume) / max(fabs(volume), 1e-12);
+
+            auto start = Clock::now();
+            for (int i = 0; i < numRepeats; i++)
+                context.Slice(vertices, numVertices, indices, numIndices, *planes);
+            double multiMs = ElapsedMs(start) / numRepeats;
+
+            int numRepeatedPieces = 0;
+            start = Clock::now();
+            for (int i = 0; i < numRepeats; i++)
+                numRepeatedPieces = SliceRepeatedly(vertices, numVertices, indices, numIndices, *planes, repeatedContext, repeatedVertices, repeatedIndices);
+            double repeatedMs = ElapsedMs(start) / numRepeats;
+
+            Log("[Benchmark] MeshMultiSlice : %-8s %-6s %zu planes, %d pieces (repeated %d), %d open, volume error %.2e, %.3f ms, repeated %.3f ms (x%.2f), scratch %zu bytes\n",
+                target.name, setName, planes->size(), numPieces, numRepeatedPieces, numOpenPieces, isClosed ? volumeError : 0.0, multiMs, repeatedMs, repeatedMs / multiMs, context.ScratchByteSize());
+            passed = passed && numPieces == numRepeatedPieces && numOpenPieces == 0 && (!isClosed || volumeError < 1e-3);
+        }
+    }
+    return passed;
+}
+
+// 두 컨텍스트의 절단 결과(조각 정점, 인덱스, 원본 정점 번호)가 비트 단위로 같은지 확인한다.
+static bool IsSameSlice(const MeshSlice::SliceContext& a, const MeshSlice::SliceContext& b)
+{
+    if (a.NumPieces() != b.NumPieces())
+        return false;
+
+    for (int piece = 0; piece < a.NumPieces(); piece++)
+    {
+        span<const Vertex> verticesA = a.PieceVertices(piece), verticesB = b.PieceVertices(piece);
+        span<const UINT> indicesA = a.PieceIndices(piece), indicesB = b.PieceIndices(piece);
+        span<const UINT> sourcesA = a.PieceSourceVertices(piece), sourcesB = b.PieceSourceVertices(piece);
+        if (verticesA.size() != verticesB.size() || indicesA.size() != indicesB.size() || sourcesA.size() != sourcesB.size())
+            return false;
+        if (memcmp(verticesA.data(), verticesB.data(), verticesA.size_bytes()) != 0 ||
+            memcmp(indicesA.data(), indicesB.data(), indicesA.size_bytes()) != 0 ||
+            memcmp(sourcesA.data(), sourcesB.data(), sourcesA.size_bytes()) != 0)
+            return false;
+    }
+    return true;
+}
+
+bool Benchmark::MeshSliceScaling(const Mesh* terrain, int numPlanes)
+{
+    vector<Vertex> skullVertices;
+    vector<UINT> skullIndices;
+    Mesh skull;
+    if (LoadSkullModel("Models/skull.txt", skullVertices, skullIndices)) {
+        skull.CreateBlob(skullVertices, skullIndices);
+        skull.AddSubmesh("skull", (UINT)skullIndices.size());
+    }
+
+    struct SliceTarget
+    {
+        const char* name;
+        const Mesh* mesh;
+        Submesh submesh;
+    };
+    vector<SliceTarget> targets;
+    if (!skull.mSubmeshes.empty())
+        targets.push_back({ "skull", &skull, skull.mSubmeshes[0] });
+    if (terrain)
+        targets.push_back({ "terrain", terrain, terrain->mSubmeshes[0] });
+
+    bool passed = true;
+    unsigned int maxThreads = max(1u, thread::hardware_concurrency());
+    vector<XMFLOAT4> planes;
+    MeshSlice::SliceContext reference;
+    MeshSlice::SliceContext context;
+    for (const SliceTarget& target : targets)
+    {
+        const Vertex* vertices = static_cast<const Vertex*>(target.mesh->mVertexBufferCPU->GetBufferPointer()) + target.submesh.baseVertex;
+        UINT numVertices = (UINT)(target.mesh->mVertexBufferCPU->GetBufferSize() / sizeof(Vertex)) - target.submesh.baseVertex;
+        BuildSlicePlanes(vertices, numVertices, numPlanes, planes);
+
+        // 기준 : threadPool 없이 자른다. (작업 버퍼를 미리 잡아 두고 잰다.)
+        reference.Slice(target.mesh, target.submesh, planes[0]);
+        auto start = Clock::now();
+        for (const XMFLOAT4& plane : planes)
+            reference.Slice(target.mesh, target.submesh, plane);
+        double serialMs = ElapsedMs(start) / numPlanes;
+
+        Log("[Benchmark] MeshSliceScaling : %-8s %8u tris, 1 thread %.3f ms/cut\n", target.name, target.submesh.numIndices / 3, serialMs);
+
+        for (unsigned int numThreads = 2; numThreads <= maxThreads; numThreads++)
+        {
+            ThreadPool threadPool(numThreads - 1);
+
+            // 평면마다 기준과 비교한다.
+            for (const XMFLOAT4& plane : planes)
+            {
+                reference.Slice(target.mesh, target.submesh, plane);
+                context.Slice(target.mesh, target.submesh, plane, &threadPool);
+                if (!IsSameSlice(reference, context)) {
+                    Log("[Benchmark] MeshSliceScaling : mismatch, %s with %u threads\n", target.name, numThreads);
+                    passed = false;
+                    break;
+                }
+            }
+
+            start = Clock::now();
+            for (const XMFLOAT4& plane : planes)
+                context.Slice(target.mesh, target.submesh, plane, &threadPool);
+            double parallelMs = ElapsedMs(start) / numPlanes;
+
+            Log("[Benchmark] MeshSliceScaling : %-8s %8u tris, %u threads %.3f ms/cut (x%.2f)\n",
+                target.name, target.submesh.numIndices / 3, numThreads, parallelMs, serialMs / parallelMs);
+        }
+    }
+
+    assert(passed);
+    return passed;
+}
+
+// SliceKernel 이전의 변 보간 : 평면과 직선의 교점을 구하고 두 거리의 비로 t를 구한다.
+static Vertex LegacyInterpolateEdge(const XMVECTOR plane, const Vertex vertex1, const Vertex vertex2)
+{
+    Vertex vertex;
+    XMStoreFloat3(&vertex.Pos, XMPlaneIntersectLine(plane, XMLoadFloat3(&vertex1.Pos), XMLoadFloat3(&vertex2.Pos)));
+
+    float t = Vector3::DistanceBetweenPoints(vertex1.Pos, vertex.Pos) / Vector3::DistanceBetweenPoints(vertex1.Pos, vertex2.Pos);
+
+    vertex.Normal.x = vertex1.Normal.x * (1 - t) + vertex2.Normal.x * t;
+    vertex.Normal.y = vertex1.Normal.y * (1 - t) + vertex2.Normal.y * t;
+    vertex.Normal.z = vertex1.Normal.z * (1 - t) + vertex2.Normal.z * t;
+
+    vertex.TexC.x = vertex1.TexC.x * (1 - t) + vertex2.TexC.x * t;
+    vertex.TexC.y = vertex1.TexC.y * (1 - t) + vertex2.TexC.y * t;
+
+    return vertex;
+}
+
+bool Benchmark::SliceKernels(int numVertices, int numRepeats)
+{
+    // [-1, 1] 상자 안의 임의 정점, 일부는 원점(평면 위)에 놓는다.
+    mt19937 random(3);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const XMFLOAT4 plane(0.48f, -0.6f, 0.64f, 0.0f);
+    vector<Vertex> vertices(numVertices);
+    for (int i = 0; i < numVertices; i++)
+    {
+        Vertex& vertex = vertices[i];
+        vertex.Pos = XMFLOAT3(unit(random), unit(random), unit(random));
+        if (i % 64 == 0)
+            vertex.Pos = XMFLOAT3(0.0f, 0.0f, 0.0f);
+        XMStoreFloat3(&vertex.Normal, XMVector3Normalize(XMVectorSet(unit(random), unit(random), unit(random), 0.0f)));
+        vertex.TexC = XMFLOAT2(unit(random) * 0.5f + 0.5f, unit(random) * 0.5f + 0.5f);
+    }
+    vector<float> x(numVertices), y(numVertices), z(numVertices);
+    for (int i = 0; i < numVertices; i++)
+    {
+        x[i] = vertices[i].Pos.x;
+        y[i] = vertices[i].Pos.y;
+        z[i] = vertices[i].Pos.z;
+    }
+
+    // 1. 분류 : 정점마다 분기하는 기존 방식, AoS 커널, SoA 커널
+    vector<float> scalarDistances(numVertices), aosDistances(numVertices), soaDistances(numVertices);
+    vector<uint8_t> scalarSides(numVertices), aosSides(numVertices), soaSides(numVertices);
+    array<UINT, 2> scalarCounts = { 0, 0 }, aosCounts = {}, soaCounts = {};
+
+    auto start = Clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        scalarCounts = { 0, 0 };
+        for (int i = 0; i < numVertices; i++)
+        {
+            float dp = SliceKernel::PlaneDistance(vertices[i].Pos, plane);
+            scalarDistances[i] = dp;
+            if (dp > 0) {
+                scalarSides[i] = SliceKernel::SideFront;
+                scalarCounts[0]++;
+            }
+            else if (dp < 0) {
+                scalarSides[i] = SliceKernel::SideBack;
+                scalarCounts[1]++;
+            }
+            else {
+                scalarSides[i] = SliceKernel::SideOnPlane;
+                scalarCounts[0]++;
+                scalarCounts[1]++;
+            }
+        }
+    }
+    double scalarNs = ElapsedMs(start) * 1e6 / ((double)numRepeats * numVertices);
+
+    start = Clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+        aosCounts = SliceKernel::ClassifyPositions(&vertices[0].Pos, sizeof(Vertex), numVertices, plane, aosDistances.data(), aosSides.data());
+    double aosNs = ElapsedMs(start) * 1e6 / ((double)numRepeats * numVertices);
+
+    start = Clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+        soaCounts = SliceKernel::ClassifyPositions(x.data(), y.data(), z.data(), numVertices, plane, soaDistances.data(), soaSides.data());
+    double soaNs = ElapsedMs(start) * 1e6 / ((double)numRepeats * numVertices);
+
+    // 거리는 비트 단위로 같아야 같은 쪽으로 분류된다.
+    bool classifyPassed = scalarCounts == aosCounts && scalarCounts == soaCounts && scalarSides == aosSides && scalarSides == soaSides &&
+        memcmp(scalarDistances.data(), aosDistances.data(), numVertices * sizeof(float)) == 0 &&
+        memcmp(scalarDistances.data(), soaDistances.data(), numVertices * sizeof(float)) == 0;
+
+    Log("[Benchmark] SliceKernels : classify %d vertices, scalar %.2f ns, AoS %.2f ns (x%.2f), SoA %.2f ns (x%.2f), %s\n",
+        numVertices, scalarNs, aosNs, scalarNs / aosNs, soaNs, scalarNs / soaNs, classifyPassed ? "match" : "MISMATCH");
+
+    // 2. 변 보간 : 평면 양쪽에 걸친 연속한 정점 쌍
+    vector<array<UINT, 2>> edges;
+    for (int i = 0; i + 1 < numVertices; i++)
+    {
+        if ((scalarSides[i] | scalarSides[i + 1]) == SliceKernel::SideOnPlane && scalarSides[i] != SliceKernel::SideOnPlane && scalarSides[i + 1] != SliceKernel::SideOnPlane)
+            edges.push_back({ (UINT)i, (UINT)i + 1 });
+    }
+    int numEdges = (int)edges.size();
+    vector<Vertex> legacyVertices(numEdges), kernelVertices(numEdges);
+
+    XMVECTOR planeVector = XMLoadFloat4(&plane);
+    start = Clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+        for (int i = 0; i < numEdges; i++)
+            legacyVertices[i] = LegacyInterpolateEdge(planeVector, vertices[edges[i][0]], vertices[edges[i][1]]);
+    double legacyNs = ElapsedMs(start) * 1e6 / ((double)numRepeats * numEdges);
+
+    start = Clock::now();
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+        for (int i = 0; i < numEdges; i++)
+            kernelVertices[i] = SliceKernel::InterpolateEdge(vertices[edges[i][0]], vertices[edges[i][1]], scalarDistances[edges[i][0]], scalarDistances[edges[i][1]]);
+    double kernelNs = ElapsedMs(start) * 1e6 / ((double)numRepeats * numEdges);
+
+    // 보간한 위치의 평면 거리와 기존 방식과의 성분별 차이
+    float maxPlaneDistance = 0.0f, maxDifference = 0.0f;
+    for (int i = 0; i < numEdges; i++)
+    {
+        maxPlaneDistance = max(maxPlaneDistance, fabs(SliceKernel::PlaneDistance(kernelVertices[i].Pos, plane)));
+        const float* a = &legacyVertices[i].Pos.x;
+        const float* b = &kernelVertices[i].Pos.x;
+        for (int k = 0; k < 8; k++)
+            maxDifference = max(maxDifference, fabs(a[k] - b[k]));
+    }
+    bool interpolatePassed = maxPlaneDistance < 1e-5f && maxDifference < 1e-4f;
+
+    Log("[Benchmark] SliceKernels : interpolate %d edges, legacy %.2f ns, d0 / (d0 - d1) %.2f ns (x%.2f), max plane distance %.2e, max difference %.2e\n",
+        numEdges, legacyNs, kernelNs, legacyNs / kernelNs, maxPlaneDistance, maxDifference);
+
+    bool passed = classifyPassed && interpolatePassed;
+    assert(passed);
+    return passed;
+}
+
+// 절단으로 만든 스킨드 정점의 가중치 : 음수가 없고 넷의 합이 1이며, 가중치가 있는 뼈 인덱스는 뼈 수 안에 있어야 한다.
+static bool IsValidSkinning(const SkinnedVertex& vertex, UINT numBones)
+{
+    float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z,
+        1.0f - vertex.BoneWeights.x - vertex.BoneWeights.y - vertex.BoneWeights.z };
+    for (int i = 0; i < 4; i++)
+    {
+        if (weights[i] < -1e-5f || (weights[i] > 0.0f && vertex.BoneIndices[i] >= numBones))
+            return false;
+    }
+    return vertex.BoneWeights.x >= 0.0f && vertex.BoneWeights.y >= 0.0f && vertex.BoneWeights.z >= 0.0f;
+}
+
+// 셰이더와 같은 선형 블렌드 스키닝 (boneTransforms는 전치된 뼈 행렬)
+static XMVECTOR SkinPosition(const SkinnedVertex& vertex, span<const XMFLOAT4X4> boneTransforms)
+{
+    float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z,
+        1.0f - vertex.BoneWeights.x - vertex.BoneWeights.y - vertex.BoneWeights.z };
+    XMVECTOR pos = XMLoadFloat3(&vertex.Pos);
+    XMVECTOR posed = XMVectorZero();
+    for (int i = 0; i < 4; i++)
+    {
+        if (weights[i] != 0.0f)
+            posed += XMVector3TransformCoord(pos, XMMatrixTranspose(XMLoadFloat4x4(&boneTransforms[vertex.BoneIndices[i]]))) * weights[i];
+    }
+    return posed;
+}
+
+// 한 스킨드 메시를 bind pose와 주어진 포즈에서 numPlanes개의 평면으로 잘라 확인한다.
+// bind pose : 위치/법선/텍스처 좌표와 인덱스가 같은 메시를 Vertex로 자른 결과와 비트 단위로 같아야 한다.
+// 포즈 : 원본 정점은 bind pose 정점 그대로이고, 새로 만든 정점은 다시 스키닝하면 절단면 위에 놓여야 한다.
+static bool CheckSkinnedSlice(const char* name, span<const SkinnedVertex> vertices, span<const UINT> indices, span<const XMFLOAT4X4> boneTransforms, int numPlanes)
+{
+    UINT numVertices = (UINT)vertices.size();
+    UINT numIndices = (UINT)indices.size();
+    UINT numBones = (UINT)boneTransforms.size();
+    vector<Vertex> plainVertices(numVertices), posedVertices(numVertices);
+    for (UINT i = 0; i < numVertices; i++)
+    {
+        memcpy(&plainVertices[i], &vertices[i], sizeof(Vertex));
+        posedVertices[i] = plainVertices[i];
+        XMStoreFloat3(&posedVertices[i].Pos, SkinPosition(vertices[i], boneTransforms));
+    }
+
+    bool passed = true;
+    MeshSlice::SliceContext plainContext;
+    MeshSlice::SkinnedSliceContext skinnedContext;
+    vector<XMFLOAT4> planes;
+
+    // 1. bind pose
+    BuildSlicePlanes(plainVertices.data(), numVertices, numPlanes, planes);
+    double plainMs = 0.0, bindMs = 0.0;
+    int numCutVertices = 0;
+    for (const XMFLOAT4& plane : planes)
+    {
+        auto start = Clock::now();
+        plainContext.Slice(plainVertices.data(), numVertices, indices.data(), numIndices, plane);
+        plainMs += ElapsedMs(start);
+        start = Clock::now();
+        skinnedContext.Slice(vertices.data(), numVertices, indices.data(), numIndices, plane);
+        bindMs += ElapsedMs(start);
+
+        for (int piece = 0; piece < plainContext.NumPieces() && passed; piece++)
+        {
+            span<const Vertex> plainPiece = plainContext.PieceVertices(piece);
+            span<const SkinnedVertex> skinnedPiece = skinnedContext.PieceVertices(piece);
+            span<const UINT> sources = skinnedContext.PieceSourceVertices(piece);
+            span<const UINT> plainIndices = plainContext.PieceIndices(piece), skinnedIndices = skinnedContext.PieceIndices(piece);
+            if (plainPiece.size() != skinnedPiece.size() || plainIndices.size() != skinnedIndices.size() ||
+                memcmp(plainIndices.data(), skinnedIndices.data(), plainIndices.size_bytes()) != 0) {
+                passed = false;
+                break;
+            }
+            for (size_t i = 0; i < skinnedPiece.size(); i++)
+            {
+                bool isNew = sources[i] == UINT_MAX;
+                numCutVertices += isNew;
+                if (memcmp(&plainPiece[i], &skinnedPiece[i], sizeof(Vertex)) != 0 || (isNew && !IsValidSkinning(skinnedPiece[i], numBones))) {
+                    passed = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    // 2. 포즈 : 평면은 포즈 공간 기준
+    BuildSlicePlanes(posedVertices.data(), numVertices, numPlanes, planes);
+    XMFLOAT3 minPos = posedVertices[0].Pos, maxPos = posedVertices[0].Pos;
+    for (const Vertex& vertex : posedVertices)
+    {
+        minPos = XMFLOAT3(min(minPos.x, vertex.Pos.x), min(minPos.y, vertex.Pos.y), min(minPos.z, vertex.Pos.z));
+        maxPos = XMFLOAT3(max(maxPos.x, vertex.Pos.x), max(maxPos.y, vertex.Pos.y), max(maxPos.z, vertex.Pos.z));
+    }
+    float extent = XMVectorGetX(XMVector3Length(XMLoadFloat3(&maxPos) - XMLoadFloat3(&minPos)));
+
+    double posedMs = 0.0;
+    float maxPlaneDistance = 0.0f;
+    for (const XMFLOAT4& plane : planes)
+    {
+        auto start = Clock::now();
+        int numPieces = skinnedContext.Slice(vertices.data(), numVertices, indices.data(), numIndices, plane, boneTransforms);
+        posedMs += ElapsedMs(start);
+
+        for (int piece = 0; piece < numPieces; piece++)
+        {
+            span<const SkinnedVertex> pieceVertices = skinnedContext.PieceVertices(piece);
+            span<const UINT> sources = skinnedContext.PieceSourceVertices(piece);
+            for (size_t i = 0; i < pieceVertices.size(); i++)
+            {
+                if (sources[i] != UINT_MAX) {
+                    if (memcmp(&pieceVertices[i], &vertices[sources[i]], sizeof(SkinnedVertex)) != 0)
+                        passed = false;
+                    continue;
+                }
+                if (!IsValidSkinning(pieceVertices[i], numBones))
+                    passed = false;
+
+                XMFLOAT3 posed;
+                XMStoreFloat3(&posed, SkinPosition(pieceVertices[i], boneTransforms));
+                maxPlaneDistance = max(maxPlaneDistance, fabs(SliceKernel::PlaneDistance(posed, plane)));
+            }
+        }
+    }
+    passed = passed && maxPlaneDistance <= 1e-4f * extent;
+
+    Log("[Benchmark] SkinnedMeshSlice : %-8s %6u tris, Vertex %.3f ms, bind pose %.3f ms, posed %.3f ms per cut, %d cut vertices, max posed plane distance %.2e (extent %.1f), %s\n",
+        name, numIndices / 3, plainMs / numPlanes, bindMs / numPlanes, posedMs / numPlanes, numCutVertices, maxPlaneDistance, extent, passed ? "passed" : "FAILED");
+    return passed;
+}
+
+bool Benchmark::SkinnedMeshSlice(const Mesh* skinnedGeo, SkinnedMesh& skinnedMesh, int numPlanes)
+{
+    // 걷는 중간의 포즈
+    SkinnedModelInstance instance(&skinnedMesh, min(1, (int)skinnedMesh.mAnimations.size() - 1), 0.37f);
+    instance.UpdateSkinnedAnimation();
+
+    bool passed = true;
+    for (const Submesh& submesh : skinnedGeo->mSubmeshes)
+    {
+        const SkinnedVertex* vertices = static_cast<const SkinnedVertex*>(skinnedGeo->mVertexBufferCPU->GetBufferPointer()) + submesh.baseVertex;
+        const UINT* indices = static_cast<const UINT*>(skinnedGeo->mIndexBufferCPU->GetBufferPointer()) + submesh.baseIndex;
+        UINT numVertices = 0;
+        for (UINT i = 0; i < submesh.numIndices; i++)
+            numVertices = max(numVertices, indices[i] + 1);
+
+        passed &= CheckSkinnedSlice(submesh.name.c_str(), span<const SkinnedVertex>(vertices, numVertices), span<const UINT>(indices, submesh.numIndices),
+            instance.FinalTransforms, numPlanes);
+    }
+
+    assert(passed);
+    return passed;
+}
+
+struct FrameTimeStats
+{
+    double meanMs;
+    double medianMs;
+    double p99Ms;
+    double maxMs;
+};
+
+static FrameTimeStats ComputeFrameTimeStats(vector<double> frameMs)
+{
+    sort(frameMs.begin(), frameMs.end());
+    double sum = 0.0;
+    for (double ms : frameMs)
+        sum += ms;
+    size_t count = frameMs.size();
+    return { sum / count, frameMs[count / 2], frameMs[min(count - 1, count * 99 / 100)], frameMs.back() };
+}
+
+bool Benchmark::SliceFrameSpikes(const Mesh* shapeGeo, int numFrames, int sliceInterval)
+{
+    // 자를 메시 : skull.txt, 없으면 shapeGeo의 sphere
+    vector<Vertex> skullVertices;
+    vector<UINT> skullIndices;
+    Mesh skull;
+    const Mesh* target = shapeGeo;
+    Submesh targetSubmesh = shapeGeo ? shapeGeo->GetSubmesh("sphere") : Submesh();
+    if (LoadSkullModel("Models/skull.txt", skullVertices, skullIndices)) {
+        skull.CreateBlob(skullVertices, skullIndices);
+        skull.AddSubmesh("skull", (UINT)skullIndices.size());
+        target = &skull;
+        targetSubmesh = skull.mSubmeshes[0];
+    }
+    if (target == nullptr)
+        return false;
+
+    // 'F'와 같이 세 축 평면으로 한 번에 잘라 한 메시로 만든다.
+    const XMFLOAT4 planes[] = { XMFLOAT4(1.0f, 0.0f, 0.0f, 0.0f), XMFLOAT4(0.0f, 1.0f, 0.0f, 0.0f), XMFLOAT4(0.0f, 0.0f, 1.0f, 0.0f) };
+    auto sliceTarget = [&](MeshSlice::MultiSliceContext& context) {
+        context.Slice(target, targetSubmesh, planes);
+        auto mesh = make_unique<Mesh>();
+        mesh->CreateBlob(context.Vertices().data(), (UINT)context.Vertices().size(), context.Indices().data(), (UINT)context.Indices().size());
+        return mesh;
+    };
+
+    // 프레임마다의 고정 작업 : 정점 64K개 변환 (Update의 CPU 작업 대용)
+    vector<XMFLOAT3> framePositions(64 * 1024);
+    for (size_t i = 0; i < framePositions.size(); i++)
+        framePositions[i] = XMFLOAT3((float)(i % 97), (float)(i % 89), (float)(i % 83));
+    auto frameWork = [&](int frame) {
+        XMMATRIX transform = XMMatrixRotationY(frame * 0.01f) * XMMatrixTranslation(1.0f, 2.0f, 3.0f);
+        for (XMFLOAT3& pos : framePositions)
+            XMStoreFloat3(&pos, XMVector3TransformCoord(XMLoadFloat3(&pos), transform));
+    };
+
+    // GPU는 gNumFrameResources - 1 프레임 늦게 끝난다고 본다.
+    const int gpuLatency = 2;
+    const UINT64 heapByteSize = 64 * 1024 * 1024, ringByteSize = 16 * 1024 * 1024;
+    bool passed = true;
+    const char* modeNames[3] = { "none", "sync", "async" };
+    for (int mode = 0; mode < 3; mode++)
+    {
+        MeshSlice::MultiSliceContext context;
+        vector<double> frameMs(numFrames);
+        int numSlices = 0;
+
+        // async : SliceWorker + GeometryHeap과 같은 할당 규칙의 CPU 메모리
+        SliceWorker worker;
+        RangeAllocator heapAllocator;
+        FenceRingAllocator uploadRing;
+        heapAllocator.Reset(heapByteSize);
+        uploadRing.Reset(ringByteSize);
+        vector<BYTE> heapMemory(mode == 2 ? heapByteSize : 0), ringMemory(mode == 2 ? ringByteSize : 0);
+        struct Uploaded
+        {
+            unique_ptr<Mesh> mesh;
+            UINT64 offset;
+            UINT64 byteSize;
+        };
+        vector<Uploaded> uploaded;
+        vector<array<UINT64, 3>> pendingCopies;     // (링 위치, 힙 위치, 크기)
+        deque<SliceResult> uploadQueue;
+
+        for (int frame = 0; frame < numFrames; frame++)
+        {
+            auto start = Clock::now();
+            frameWork(frame);
+            bool sliceFrame = frame % sliceInterval == sliceInterval / 2;
+
+            if (mode == 1 && sliceFrame) {
+                // 기존 'F' : 프레임 안에서 자르고, 메시마다 업로드 버퍼를 새로 만들어 복사한다. (FlushCommandQueue의 GPU 대기는 빠져 있다.)
+                unique_ptr<Mesh> mesh = sliceTarget(context);
+                vector<BYTE> uploadBuffer(mesh->mVertexBufferCPU->GetBufferSize() + mesh->mIndexBufferCPU->GetBufferSize());
+                memcpy(uploadBuffer.data(), mesh->mVertexBufferCPU->GetBufferPointer(), mesh->mVertexBufferCPU->GetBufferSize());
+                memcpy(uploadBuffer.data() + mesh->mVertexBufferCPU->GetBufferSize(), mesh->mIndexBufferCPU->GetBufferPointer(), mesh->mIndexBufferCPU->GetBufferSize());
+                numSlices++;
+            }
+            else if (mode == 2) {
+                if (sliceFrame) {
+                    worker.Submit([&]() {
+                        SliceResult result;
+                        result.mesh = sliceTarget(context);
+                        result.vertexByteStride = sizeof(Vertex);
+                        return result;
+                    });
+                }
+
+                // UploadSliceResults와 같은 순서 : 회수, 결과 꺼내기, 링에 복사
+                uploadRing.Reclaim(frame >= gpuLatency ? frame - gpuLatency : 0);
+                SliceResult result;
+                while (worker.TryPopResult(result))
+                    uploadQueue.push_back(std::move(result));
+                while (!uploadQueue.empty())
+                {
+                    Mesh* mesh = uploadQueue.front().mesh.get();
+                    UINT64 vbByteSize = mesh->mVertexBufferCPU->GetBufferSize();
+                    UINT64 byteSize = vbByteSize + mesh->mIndexBufferCPU->GetBufferSize();
+                    UINT64 destOffset = heapAllocator.Allocate(byteSize, 16);
+                    if (destOffset == RangeAllocator::InvalidOffset) {
+                        passed = false;
+                        uploadQueue.pop_front();
+                        continue;
+                    }
+                    UINT64 sourceOffset = uploadRing.Allocate(byteSize, 16);
+                    if (sourceOffset == RangeAllocator::InvalidOffset) {
+                        heapAllocator.Free(destOffset, byteSize);
+                        break;
+                    }
+                    memcpy(&ringMemory[sourceOffset], mesh->mVertexBufferCPU->GetBufferPointer(), vbByteSize);
+                    memcpy(&ringMemory[sourceOffset + vbByteSize], mesh->mIndexBufferCPU->GetBufferPointer(), byteSize - vbByteSize);
+                    pendingCopies.push_back({ sourceOffset, destOffset, byteSize });
+                    uploaded.push_back({ std::move(uploadQueue.front().mesh), destOffset, byteSize });
+                    uploadQueue.pop_front();
+                    numSlices++;
+                }
+
+                // RecordCopies 대신 바로 복사하고, 프레임 끝의 울타리 값은 프레임 번호 + 1
+                for (const array<UINT64, 3>& copy : pendingCopies)
+                    memcpy(&heapMemory[copy[1]], &ringMemory[copy[0]], copy[2]);
+                pendingCopies.clear();
+                uploadRing.EndFrame(frame + 1);
+            }
+            frameMs[frame] = ElapsedMs(start);
+        }
+
+        if (mode == 2) {
+            // 남은 결과까지 받아 힙 내용이 CPU 사본과 같은지, 모두 반환하면 힙과 링이 비는지 확인한다.
+            worker.WaitIdle();
+            int numSubmitted = 0;
+            for (int frame = 0; frame < numFrames; frame++)
+                numSubmitted += frame % sliceInterval == sliceInterval / 2;
+            SliceResult result;
+            while (worker.TryPopResult(result))
+                numSubmitted--;
+            passed = passed && numSubmitted == numSlices + (int)uploadQueue.size();
+
+            for (const Uploaded& upload : uploaded)
+            {
+                UINT64 vbByteSize = upload.mesh->mVertexBufferCPU->GetBufferSize();
+                passed = passed && memcmp(&heapMemory[upload.offset], upload.mesh->mVertexBufferCPU->GetBufferPointer(), vbByteSize) == 0 &&
+                    memcmp(&heapMemory[upload.offset + vbByteSize], upload.mesh->mIndexBufferCPU->GetBufferPointer(), upload.byteSize - vbByteSize) == 0;
+                heapAllocator.Free(upload.offset, upload.byteSize);
+            }
+            uploadRing.Reclaim(numFrames);
+            passed = passed && heapAllocator.FreeByteSize() == heapByteSize && uploadRing.UsedByteSize() == 0;
+        }
+
+        FrameTimeStats stats = ComputeFrameTimeStats(frameMs);
+        Log("[Benchmark] SliceFrameSpikes : %-5s %d frames, %d slices, mean %.3f ms, median %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            modeNames[mode], numFrames, numSlices, stats.meanMs, stats.medianMs, stats.p99Ms, stats.maxMs);
+    }
+
+    assert(passed);
+    return passed;
+}
+
+// 위치가 같은 정점을 합친 메시의 위상 : 정점/변/면 수, 연결 성분 수
+// 닫힌 메시의 성분마다 구멍(손잡이)이 g개면 V - E + F = 2 * (성분 수) - 2 * (g의 합)이다.
+struct MeshTopology
+{
+    int numVertices = 0;
+    int numEdges = 0;
+    int numFaces = 0;
+    int numComponents = 0;
+
+    int EulerCharacteristic() const { return numVertices - numEdges + numFaces; }
+};
+
+static MeshTopology ComputeTopology(span<const Vertex> vertices, span<const UINT> indices)
+{
+    map<array<float, 3>, UINT> weldedIndices;
+    vector<UINT> welded(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        array<float, 3> pos = { vertices[i].Pos.x, vertices[i].Pos.y, vertices[i].Pos.z };
+        welded[i] = weldedIndices.emplace(pos, (UINT)weldedIndices.size()).first->second;
+    }
+
+    // 연결 성분은 합친 정점의 union-find로 센다.
+    vector<UINT> parents(weldedIndices.size());
+    for (UINT i = 0; i < (UINT)parents.size(); i++)
+        parents[i] = i;
+    auto findRoot = [&](UINT index) {
+        while (parents[index] != index)
+            index = parents[index] = parents[parents[index]];
+        return index;
+    };
+
+    MeshTopology topology;
+    vector<uint8_t> isUsed(weldedIndices.size(), 0);
+    unordered_set<uint64_t> edges;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        UINT face[3] = { welded[indices[i]], welded[indices[i + 1]], welded[indices[i + 2]] };
+        // 합친 뒤 꼭짓점이 겹치는 면은 넓이가 없으므로 세지 않는다.
+        if (face[0] == face[1] || face[1] == face[2] || face[2] == face[0])
+            continue;
+
+        topology.numFaces++;
+        for (int k = 0; k < 3; k++)
+        {
+            isUsed[face[k]] = 1;
+            edges.insert(MeshSlice::EdgeTable::UndirectedKey(face[k], face[(k + 1) % 3]));
+            UINT root0 = findRoot(face[k]), root1 = findRoot(face[(k + 1) % 3]);
+            if (root0 != root1)
+                parents[root0] = root1;
+        }
+    }
+
+    for (UINT i = 0; i < (UINT)isUsed.size(); i++)
+    {
+        if (!isUsed[i])
+            continue;
+        topology.numVertices++;
+        if (findRoot(i) == i)
+            topology.numComponents++;
+    }
+    topology.numEdges = (int)edges.size();
+    return topology;
+}
+
+// 면 넓이의 합, sourceVertices를 주면 원본 정점이 하나라도 있는 면(절단면 삼각형이 아닌 면)만 더한다.
+static double SurfaceArea(span<const Vertex> vertices, span<const UINT> indices, span<const UINT> sourceVertices = {})
+{
+    double area = 0.0;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        if (!sourceVertices.empty() && sourceVertices[indices[i]] == UINT_MAX && sourceVertices[indices[i + 1]] == UINT_MAX && sourceVertices[indices[i + 2]] == UINT_MAX)
+            continue;
+
+        XMVECTOR p0 = XMLoadFloat3(&vertices[indices[i]].Pos);
+        XMVECTOR edge0 = XMLoadFloat3(&vertices[indices[i + 1]].Pos) - p0;
+        XMVECTOR edge1 = XMLoadFloat3(&vertices[indices[i + 2]].Pos) - p0;
+        area += 0.5 * XMVectorGetX(XMVector3Length(XMVector3Cross(edge0, edge1)));
+    }
+    return area;
+}
+
+// 꼭짓점이 축 위에 있는 정팔면체 (정점 6개를 공유하는 닫힌 메시)
+// 축 평면은 정점 4개를, 두 축 사이의 대각 평면은 정점 2개를 지나므로 꼭짓점 하나만 평면 위에 있고 나머지 둘이 양쪽에 있는 면이 생긴다.
+static void BuildOctahedronMesh(float radius, vector<Vertex>& vertices, vector<UINT>& indices)
+{
+    const XMFLOAT3 axes[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    vertices.resize(6);
+    for (int i = 0; i < 6; i++)
+    {
+        vertices[i].Pos = XMFLOAT3(axes[i].x * radius, axes[i].y * radius, axes[i].z * radius);
+        vertices[i].Normal = axes[i];
+        vertices[i].TexC = XMFLOAT2(0.5f + axes[i].x * 0.5f, 0.5f - axes[i].y * 0.5f);
+    }
+
+    // 면 법선(두 변의 외적)이 바깥을 보도록 순서를 맞춘다. (BuildTubeMesh와 같은 감기 순서)
+    indices.clear();
+    for (UINT x : { 0u, 1u })
+    {
+        for (UINT y : { 2u, 3u })
+        {
+            for (UINT z : { 4u, 5u })
+            {
+                XMVECTOR p0 = XMLoadFloat3(&vertices[x].Pos);
+                XMVECTOR cross = XMVector3Cross(XMLoadFloat3(&vertices[y].Pos) - p0, XMLoadFloat3(&vertices[z].Pos) - p0);
+                XMVECTOR outward = p0 + XMLoadFloat3(&vertices[y].Pos) + XMLoadFloat3(&vertices[z].Pos);
+                bool isOutward = XMVectorGetX(XMVector3Dot(cross, outward)) > 0.0f;
+                for (UINT index : { x, isOutward ? y : z, isOutward ? z : y })
+                    indices.push_back(index);
+            }
+        }
+    }
+}
+
+bool Benchmark::MeshSliceValidation(const Mesh* shapeGeo, double minDurationMs)
+{
+    vector<Vertex> skullVertices;
+    vector<UINT> skullIndices;
+    Mesh skull;
+    if (LoadSkullModel("Models/skull.txt", skullVertices, skullIndices)) {
+        skull.CreateBlob(skullVertices, skullIndices);
+        skull.AddSubmesh("skull", (UINT)skullIndices.size());
+    }
+
+    vector<Vertex> tubeVertices, octahedronVertices;
+    vector<UINT> tubeIndices, octahedronIndices;
+    Mesh tube, octahedron;
+    BuildTubeMesh(0.3f, 0.5f, 1.0f, 24, tubeVertices, tubeIndices);
+    tube.CreateBlob(tubeVertices, tubeIndices);
+    tube.AddSubmesh("tube", (UINT)tubeIndices.size());
+    BuildOctahedronMesh(0.5f, octahedronVertices, octahedronIndices);
+    octahedron.CreateBlob(octahedronVertices, octahedronIndices);
+    octahedron.AddSubmesh("octahedron", (UINT)octahedronIndices.size());
+
+    // isConvex : 볼록한 원본은 조각도 볼록하므로 빈 조각이 아니면 연결 성분 하나에 오일러 지표 2여야 한다.
+    struct SliceTarget
+    {
+        const char* name;
+        const Mesh* mesh;
+        Submesh submesh;
+        bool isConvex;
+    };
+    vector<SliceTarget> targets;
+    if (shapeGeo) {
+        for (const char* name : { "box", "sphere", "cylinder" })
+            targets.push_back({ name, shapeGeo, shapeGeo->GetSubmesh(name), true });
+    }
+    targets.push_back({ "octahedron", &octahedron, octahedron.mSubmeshes[0], true });
+    targets.push_back({ "tube", &tube, tube.mSubmeshes[0], false });
+    if (!skull.mSubmeshes.empty())
+        targets.push_back({ "skull", &skull, skull.mSubmeshes[0], false });
+
+    bool passed = true;
+    MeshSlice::SliceContext context;
+    vector<XMFLOAT4> planes;
+    for (const SliceTarget& target : targets)
+    {
+        const UINT* indices = static_cast<const UINT*>(target.mesh->mIndexBufferCPU->GetBufferPointer()) + target.submesh.baseIndex;
+        UINT numIndices = target.submesh.numIndices;
+        UINT numVertices = 0;
+        for (UINT i = 0; i < numIndices; i++)
+            numVertices = max(numVertices, indices[i] + 1);
+
+        const Vertex* sourceVertices = static_cast<const Vertex*>(target.mesh->mVertexBufferCPU->GetBufferPointer()) + target.submesh.baseVertex;
+        vector<Vertex> snappedVertices(sourceVertices, sourceVertices + numVertices);
+        SnapPositions(snappedVertices, 1e-5f);
+        span<const Vertex> vertices(snappedVertices);
+        span<const UINT> sourceIndices(indices, numIndices);
+
+        if (!IsWatertight(vertices, sourceIndices)) {
+            Log("[Benchmark] MeshSliceValidation : %-10s source mesh is not closed, skipped\n", target.name);
+            continue;
+        }
+        MeshTopology sourceTopology = ComputeTopology(vertices, sourceIndices);
+        double sourceVolume = MeshVolume(vertices, sourceIndices);
+        double sourceArea = SurfaceArea(vertices, sourceIndices);
+
+        // 임의 평면 + 정점을 정확히 지나는 평면 : 중심 축 평면, 겉면에 닿는 평면, 두 축 사이의 대각 평면
+        BuildSlicePlanes(vertices.data(), numVertices, 32, planes);
+        XMFLOAT3 minPos = vertices[0].Pos, maxPos = vertices[0].Pos;
+        for (const Vertex& vertex : vertices)
+        {
+            minPos = XMFLOAT3(min(minPos.x, vertex.Pos.x), min(minPos.y, vertex.Pos.y), min(minPos.z, vertex.Pos.z));
+            maxPos = XMFLOAT3(max(maxPos.x, vertex.Pos.x), max(maxPos.y, vertex.Pos.y), max(maxPos.z, vertex.Pos.z));
+        }
+        XMFLOAT3 center((minPos.x + maxPos.x) * 0.5f, (minPos.y + maxPos.y) * 0.5f, (minPos.z + maxPos.z) * 0.5f);
+        float extent = XMVectorGetX(XMVector3Length(XMLoadFloat3(&maxPos) - XMLoadFloat3(&minPos)));
+        planes.push_back(XMFLOAT4(1.0f, 0.0f, 0.0f, -center.x));
+        planes.push_back(XMFLOAT4(0.0f, 1.0f, 0.0f, -center.y));
+        planes.push_back(XMFLOAT4(0.0f, 0.0f, 1.0f, -center.z));
+        planes.push_back(XMFLOAT4(1.0f, 0.0f, 0.0f, -maxPos.x));
+        planes.push_back(XMFLOAT4(0.0f, -1.0f, 0.0f, minPos.y));
+        const float diagonal = 0.70710678f;
+        planes.push_back(XMFLOAT4(diagonal, diagonal, 0.0f, -(center.x + center.y) * diagonal));
+        planes.push_back(XMFLOAT4(diagonal, -diagonal, 0.0f, -(center.x - center.y) * diagonal));
+        planes.push_back(XMFLOAT4(0.0f, diagonal, diagonal, -(center.y + center.z) * diagonal));
+        planes.push_back(XMFLOAT4(diagonal, 0.0f, -diagonal, -(center.x - center.z) * diagonal));
+
+        const float planeTolerance = 1e-5f * extent;
+        int numWrongSide = 0, numOffPlane = 0, numOpenPieces = 0, numBadTopology = 0, numOnPlaneVertices = 0;
+        int minEuler = INT_MAX, maxEuler = INT_MIN;
+        double maxVolumeError = 0.0, maxAreaError = 0.0;
+        for (const XMFLOAT4& plane : planes)
+        {
+            for (UINT i = 0; i < numVertices; i++)
+                numOnPlaneVertices += (SliceKernel::PlaneDistance(vertices[i].Pos, plane) == 0.0f) ? 1 : 0;
+
+            int numPieces = context.Slice(vertices.data(), numVertices, indices, numIndices, plane);
+            double volume = 0.0, area = 0.0;
+            for (int piece = 0; piece < numPieces; piece++)
+            {
+                span<const Vertex> pieceVertices = context.PieceVertices(piece);
+                span<const UINT> pieceIndices = context.PieceIndices(piece);
+                span<const UINT> pieceSources = context.PieceSourceVertices(piece);
+
+                // 원본 정점은 분류와 같은 거리로 조각 0은 법선 쪽(0 이상), 조각 1은 반대쪽(0 이하)에 있어야 하고,
+                // 새 정점(절단 정점, 절단면 정점)은 평면 위에 있어야 한다. 잘못된 변을 보간하면 원본 정점 자리에 남는다.
+                for (size_t i = 0; i < pieceVertices.size(); i++)
+                {
+                    float distance = SliceKernel::PlaneDistance(pieceVertices[i].Pos, plane);
+                    if (pieceSources[i] != UINT_MAX) {
+                        if ((piece == 0) ? distance < 0.0f : distance > 0.0f) {
+                            if (numWrongSide++ == 0)
+                                Log("[Benchmark] MeshSliceValidation : %-10s piece %d vertex %zu on the wrong side (%g), plane (%f, %f, %f, %f)\n",
+                                    target.name, piece, i, distance, plane.x, plane.y, plane.z, plane.w);
+                        }
+                    }
+                    else if (!(fabs(distance) <= planeTolerance)) {
+                        if (numOffPlane++ == 0)
+                            Log("[Benchmark] MeshSliceValidation : %-10s piece %d new vertex %zu is off the plane (%g), plane (%f, %f, %f, %f)\n",
+                                target.name, piece, i, distance, plane.x, plane.y, plane.z, plane.w);
+                    }
+                }
+
+                if (pieceIndices.empty())
+                    continue;
+                if (!IsWatertight(pieceVertices, pieceIndices))
+                    numOpenPieces++;
+
+                MeshTopology topology = ComputeTopology(pieceVertices, pieceIndices);
+                int euler = topology.EulerCharacteristic();
+                minEuler = min(minEuler, euler);
+                maxEuler = max(maxEuler, euler);
+                // 성분마다 g >= 0이므로 지표는 짝수이고 2 * (성분 수)를 넘지 않는다.
+                bool isValidTopology = (euler % 2 == 0) && euler <= topology.numComponents * 2;
+                if (target.isConvex)
+                    isValidTopology = isValidTopology && topology.numComponents == 1 && euler == 2;
+                if (!isValidTopology) {
+                    if (numBadTopology++ == 0)
+                        Log("[Benchmark] MeshSliceValidation : %-10s piece %d V %d E %d F %d, %d components, plane (%f, %f, %f, %f)\n", target.name, piece,
+                            topology.numVertices, topology.numEdges, topology.numFaces, topology.numComponents, plane.x, plane.y, plane.z, plane.w);
+                }
+
+                volume += MeshVolume(pieceVertices, pieceIndices);
+                area += SurfaceArea(pieceVertices, pieceIndices, pieceSources);
+            }
+
+            // 절단면은 두 조각에서 서로 반대 방향이므로 부피의 합은 원본 부피, 절단면을 뺀 겉넓이의 합은 원본 겉넓이다.
+            maxVolumeError = max(maxVolumeError, fabs(volume - sourceVolume) / fabs(sourceVolume));
+            maxAreaError = max(maxAreaError, fabs(area - sourceArea) / sourceArea);
+        }
+
+        bool isTargetPassed = numWrongSide == 0 && numOffPlane == 0 && numOpenPieces == 0 && numBadTopology == 0 && maxVolumeError < 1e-4 && maxAreaError < 1e-4;
+        Log("[Benchmark] MeshSliceValidation : %-10s chi %d, %zu planes (%d on-plane vertices), piece chi [%d, %d], volume error %.2e, area error %.2e, "
+            "%d wrong side, %d off plane, %d open, %d bad topology, %s\n",
+            target.name, sourceTopology.EulerCharacteristic(), planes.size(), numOnPlaneVertices, minEuler, maxEuler, maxVolumeError, maxAreaError,
+            numWrongSide, numOffPlane, numOpenPieces, numBadTopology, isTargetPassed ? "passed" : "FAILED");
+        passed = passed && isTargetPassed;
+
+        // 처리량 : 임의 평면으로 반복해서 자른 입력 삼각형 수와 만든 삼각형 수
+        const int numRandomPlanes = 32;
+        int numCuts = 0;
+        size_t numOutputTriangles = 0;
+        auto start = Clock::now();
+        while (numCuts < 3 || ElapsedMs(start) < minDurationMs)
+        {
+            int numPieces = context.Slice(vertices.data(), numVertices, indices, numIndices, planes[numCuts++ % numRandomPlanes]);
+            for (int piece = 0; piece < numPieces; piece++)
+                numOutputTriangles += context.PieceIndices(piece).size() / 3;
+        }
+        double seconds = ElapsedMs(start) / 1000.0;
+        Log("[Benchmark] MeshSliceValidation : %-10s %8u tris, %.1f cuts/s, %.2f M input tris/s, %.2f M output tris/s\n",
+            target.name, numIndices / 3, numCuts / seconds, (double)numCuts * (numIndices / 3) / seconds / 1e6, numOutputTriangles / seconds / 1e6);
+    }
+
+    assert(passed);
+    return passed;
+}
+
+// 평면마다 SliceContext로 전체를 자르고 안쪽(평면 반대쪽) 조각만 남긴다. (ConvexSliceContext 이전의 방식)
+static void ClipRepeatedly(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, span<const XMFLOAT4> planes,
+    MeshSlice::SliceContext& context, vector<Vertex>& clippedVertices, vector<UINT>& clippedIndices)
+{
+    clippedVertices.assign(vertices, vertices + numVertices);
+    clippedIndices.assign(indices, indices + numIndices);
+    for (const XMFLOAT4& plane : planes)
+    {
+        context.Slice(clippedVertices.data(), (UINT)clippedVertices.size(), clippedIndices.data(), (UINT)clippedIndices.size(), plane);
+        clippedVertices.assign(context.PieceVertices(1).begin(), context.PieceVertices(1).end());
+        clippedIndices.assign(context.PieceIndices(1).begin(), context.PieceIndices(1).end());
+    }
+}
+
+bool Benchmark::ConvexSlice(const Mesh* shapeGeo, int numRepeats)
+{
+    vector<Vertex> skullVertices;
+    vector<UINT> skullIndices;
+    Mesh skull;
+    if (LoadSkullModel("Models/skull.txt", skullVertices, skullIndices)) {
+        skull.CreateBlob(skullVertices, skullIndices);
+        skull.AddSubmesh("skull", (UINT)skullIndices.size());
+    }
+
+    vector<Vertex> tubeVertices;
+    vector<UINT> tubeIndices;
+    Mesh tube;
+    BuildTubeMesh(0.3f, 0.5f, 1.0f, 24, tubeVertices, tubeIndices);
+    tube.CreateBlob(tubeVertices, tubeIndices);
+    tube.AddSubmesh("tube", (UINT)tubeIndices.size());
+
+    struct SliceTarget
+    {
+        const char* name;
+        const Mesh* mesh;
+        Submesh submesh;
+    };
+    vector<SliceTarget> targets;
+    if (shapeGeo) {
+        for (const char* name : { "box", "sphere", "cylinder" })
+            targets.push_back({ name, shapeGeo, shapeGeo->GetSubmesh(name) });
+    }
+    targets.push_back({ "tube", &tube, tube.mSubmeshes[0] });
+    if (!skull.mSubmeshes.empty())
+        targets.push_back({ "skull", &skull, skull.mSubmeshes[0] });
+
+    // 14-DOP 방향 : 축 6개와 대각 8개
+    vector<XMFLOAT3> kDopDirections = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    for (float x : { -1.0f, 1.0f })
+        for (float y : { -1.0f, 1.0f })
+            for (float z : { -1.0f, 1.0f })
+                kDopDirections.push_back(XMFLOAT3(x, y, z));
+
+    bool passed = true;
+    MeshSlice::ConvexSliceContext context;
+    MeshSlice::SliceContext sliceContext;
+    vector<Vertex> clippedVertices;
+    vector<UINT> clippedIndices;
+    for (const SliceTarget& target : targets)
+    {
+        const UINT* indices = static_cast<const UINT*>(target.mesh->mIndexBufferCPU->GetBufferPointer()) + target.submesh.baseIndex;
+        UINT numIndices = target.submesh.numIndices;
+        UINT numVertices = 0;
+        for (UINT i = 0; i < numIndices; i++)
+            numVertices = max(numVertices, indices[i] + 1);
+
+        const Vertex* sourceVertices = static_cast<const Vertex*>(target.mesh->mVertexBufferCPU->GetBufferPointer()) + target.submesh.baseVertex;
+        vector<Vertex> snappedVertices(sourceVertices, sourceVertices + numVertices);
+        SnapPositions(snappedVertices, 1e-5f);
+        const Vertex* vertices = snappedVertices.data();
+        bool isClosed = IsWatertight(span<const Vertex>(vertices, numVertices), span<const UINT>(indices, numIndices));
+        double sourceVolume = isClosed ? MeshVolume(span<const Vertex>(vertices, numVertices), span<const UINT>(indices, numIndices)) : 0.0;
+
+        XMFLOAT3 minPos = vertices[0].Pos, maxPos = vertices[0].Pos;
+        UINT extremeVertex = 0;
+        for (UINT i = 1; i < numVertices; i++)
+        {
+            minPos = XMFLOAT3(min(minPos.x, vertices[i].Pos.x), min(minPos.y, vertices[i].Pos.y), min(minPos.z, vertices[i].Pos.z));
+            maxPos = XMFLOAT3(max(maxPos.x, vertices[i].Pos.x), max(maxPos.y, vertices[i].Pos.y), max(maxPos.z, vertices[i].Pos.z));
+            if (vertices[i].Pos.x > vertices[extremeVertex].Pos.x)
+                extremeVertex = i;
+        }
+        XMFLOAT3 size(maxPos.x - minPos.x, maxPos.y - minPos.y, maxPos.z - minPos.z);
+        float extent = XMVectorGetX(XMVector3Length(XMLoadFloat3(&size)));
+
+        // 볼록 다면체 : 중심 근처에서 기울인 상자, 겉면(x가 가장 큰 정점)에 중심을 둔 14-DOP 크레이터
+        struct ConvexVolume
+        {
+            const char* name;
+            vector<XMFLOAT4> planes;
+        };
+        ConvexVolume volumes[2] = { { "box" }, { "14-DOP" } };
+        BoundingOrientedBox box(XMFLOAT3((minPos.x + maxPos.x) * 0.5f + size.x * 0.1f, (minPos.y + maxPos.y) * 0.5f, (minPos.z + maxPos.z) * 0.5f),
+            XMFLOAT3(size.x * 0.3f, size.y * 0.25f, size.z * 0.35f), XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+        XMStoreFloat4(&box.Orientation, XMQuaternionRotationRollPitchYaw(0.3f, 0.5f, 0.2f));
+        MeshSlice::BuildBoxPlanes(box, volumes[0].planes);
+        MeshSlice::BuildKDopPlanes(vertices[extremeVertex].Pos, kDopDirections, extent * 0.15f, volumes[1].planes);
+
+        for (const ConvexVolume& volume : volumes)
+        {
+            // Clip : 정점이 모두 안쪽에 있고, 볼록 다면체 면 위의 삼각형은 어느 한 평면 위에 있어야 한다.
+            int numClipTriangles = context.Clip(vertices, numVertices, indices, numIndices, volume.planes);
+            const float tolerance = 1e-5f * extent;
+            int numOutsideVertices = 0, numOffCapVertices = 0;
+            for (const Vertex& vertex : context.Vertices())
+            {
+                for (const XMFLOAT4& plane : volume.planes)
+                    numOutsideVertices += (SliceKernel::PlaneDistance(vertex.Pos, plane) > tolerance) ? 1 : 0;
+            }
+            span<const UINT> clipIndices = context.Indices();
+            for (UINT i = context.CapIndexBegin(); i < (UINT)clipIndices.size(); i++)
+            {
+                bool isOnPlane = false;
+                for (const XMFLOAT4& plane : volume.planes)
+                    isOnPlane = isOnPlane || fabs(SliceKernel::PlaneDistance(context.Vertices()[clipIndices[i]].Pos, plane)) <= tolerance;
+                numOffCapVertices += isOnPlane ? 0 : 1;
+            }
+            bool isClipClosed = IsWatertight(context.Vertices(), context.Indices());
+            double clipVolume = MeshVolume(context.Vertices(), context.Indices());
+            UINT numClipCapIndices = (UINT)clipIndices.size() - context.CapIndexBegin();
+
+            // Subtract : 닫혀 있고 부피가 원본 - Clip 부피여야 한다.
+            int numSubtractTriangles = context.Subtract(vertices, numVertices, indices, numIndices, volume.planes);
+            bool isSubtractClosed = IsWatertight(context.Vertices(), context.Indices());
+            double subtractVolume = MeshVolume(context.Vertices(), context.Indices());
+            UINT numWallIndices = (UINT)context.Indices().size() - context.CapIndexBegin();
+
+            // 평면마다 전체를 자르는 방식과 부피, 시간 비교
+            ClipRepeatedly(vertices, numVertices, indices, numIndices, volume.planes, sliceContext, clippedVertices, clippedIndices);
+            double referenceVolume = MeshVolume(clippedVertices, clippedIndices);
+
+            auto start = Clock::now();
+            for (int i = 0; i < numRepeats; i++)
+                context.Clip(vertices, numVertices, indices, numIndices, volume.planes);
+            double clipMs = ElapsedMs(start) / numRepeats;
+            start = Clock::now();
+            for (int i = 0; i < numRepeats; i++)
+                context.Subtract(vertices, numVertices, indices, numIndices, volume.planes);
+            double subtractMs = ElapsedMs(start) / numRepeats;
+            start = Clock::now();
+            for (int i = 0; i < numRepeats; i++)
+                ClipRepeatedly(vertices, numVertices, indices, numIndices, volume.planes, sliceContext, clippedVertices, clippedIndices);
+            double repeatedMs = ElapsedMs(start) / numRepeats;
+
+            double volumeScale = max(fabs(sourceVolume), 1e-12);
+            double volumeError = isClosed ? fabs(clipVolume + subtractVolume - sourceVolume) / volumeScale : 0.0;
+            double referenceError = isClosed ? fabs(clipVolume - referenceVolume) / volumeScale : 0.0;
+            bool isPassed = numOutsideVertices == 0 && numOffCapVertices == 0 && (!isClosed || (isClipClosed && isSubtractClosed && volumeError < 1e-4 && referenceError < 1e-4));
+            Log("[Benchmark] ConvexSlice : %-8s %-6s clip %d tris (%u cap), subtract %d tris (%u wall), volume error %.2e, vs per-plane slices %.2e, "
+                "clip %.3f ms, subtract %.3f ms, per-plane slices %.3f ms (x%.2f), %s\n",
+                target.name, volume.name, numClipTriangles, numClipCapIndices / 3, numSubtractTriangles, numWallIndices / 3, volumeError, referenceError,
+                clipMs, subtractMs, repeatedMs, repeatedMs / clipMs, isPassed ? "passed" : "FAILED");
+            if (!isPassed)
+                Log("[Benchmark] ConvexSlice : %-8s %-6s %d outside vertices, %d cap vertices off the planes, clip %s, subtract %s\n", target.name, volume.name,
+                    numOutsideVertices, numOffCapVertices, isClipClosed ? "closed" : "open", isSubtractClosed ? "closed" : "open");
+            passed = passed && isPassed;
+        }
+    }
+
+    assert(passed);
+    return passed;
+}
+
+bool Benchmark::TerrainVertexFormat(Terrain& terrain, float width, float length, const vector<Vertex>& gridVertices, float maxNormalDegrees)
+{
+    vector<TerrainVertex> vertices;
+    vector<uint16_t> indices;
+    auto start = Clock::now();
+    terrain.CreatePatches(width, length, vertices, indices);
+    double createMs = ElapsedMs(start);
+
+    const vector<TerrainPatch>& patches = terrain.GetPatches();
+    int imageWidth = terrain.GetImageWidth();
+    int imageLength = terrain.GetImageLength();
+    if (patches.empty() || gridVertices.size() != (size_t)imageWidth * imageLength) {
+        Log("[Benchmark] TerrainVertexFormat : no patches or grid size mismatch, skipped\n");
+        return true;
+    }
+
+    // 푼 정점과 원래 격자 정점의 차
+    // 높이는 양자화 간격의 절반에 float 연산 오차(높이의 몇 ulp)만큼 여유를 둔다.
+    float maxHeightError = 0.0f;
+    float maxHeightExcess = 0.0f;
+    float maxQuantizationStep = 0.0f;
+    float maxPlanarError = 0.0f;
+    float maxNormalError = 0.0f;        // 도
+    for (UINT p = 0; p < (UINT)patches.size(); p++)
+    {
+        const TerrainPatch& patch = patches[p];
+        maxQuantizationStep = max(maxQuantizationStep, patch.heightScale);
+
+        for (int v = 0; v < Terrain::NumPatchVertices; v++)
+        {
+            const TerrainVertex& compact = vertices[patch.baseVertex + v];
+            XMFLOAT3 position = terrain.DecodePosition(p, v, compact);
+
+            // 치마 정점은 변 정점과 같은 격자 위치에서 skirtDepth만큼 아래에 있다.
+            bool isSkirt = v >= Terrain::NumPatchGridVertices;
+            int column = (int)lroundf((position.x + 0.5f * width) / width * (imageWidth - 1));
+            int row = (int)lroundf((0.5f * length - position.z) / length * (imageLength - 1));
+            const Vertex& source = gridVertices[row * imageWidth + column];
+
+            float expectedY = source.Pos.y - (isSkirt ? patch.skirtDepth : 0.0f);
+            float heightError = fabsf(position.y - expectedY);
+            float tolerance = 0.5f * patch.heightScale + 4.0f * FLT_EPSILON * (fabsf(source.Pos.y) + patch.skirtDepth);
+            maxHeightError = max(maxHeightError, heightError);
+            maxHeightExcess = max(maxHeightExcess, heightError - tolerance);
+            maxPlanarError = max(maxPlanarError, max(fabsf(position.x - source.Pos.x), fabsf(position.z - source.Pos.z)));
+
+            XMFLOAT3 normal = Terrain::DecodeNormal(compact);
+            float cosAngle = XMVectorGetX(XMVector3Dot(XMLoadFloat3(&normal), XMVector3Normalize(XMLoadFloat3(&source.Normal))));
+            maxNormalError = max(maxNormalError, XMConvertToDegrees(acosf(min(max(cosAngle, -1.0f), 1.0f))));
+        }
+    }
+
+    int numOutOfPatch = 0;
+    for (uint16_t index : indices)
+    {
+        if (index >= Terrain::NumPatchVertices)
+            numOutOfPatch++;
+    }
+
+    // 한 장 격자, 같은 조각을 Vertex + 32비트 인덱스로 둘 때, 압축 정점 + 16비트 인덱스
+    UINT64 gridByteSize = terrain.GetGridByteSize();
+    UINT64 wideByteSize = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(uint32_t);
+    UINT64 compactByteSize = vertices.size() * sizeof(TerrainVertex) + indices.size() * sizeof(uint16_t);
+    const double MB = 1024.0 * 1024.0;
+    Log("[Benchmark] TerrainVertexFormat : full grid %.2f MB, patches with Vertex %.2f MB, compact %.2f MB (%zu vertices x %zu B + %zu indices x 2 B), %.1fx smaller than the grid, create %.1f ms\n",
+        gridByteSize / MB, wideByteSize / MB, compactByteSize / MB, vertices.size(), sizeof(TerrainVertex), indices.size(),
+        (double)gridByteSize / compactByteSize, createMs);
+    Log("[Benchmark] TerrainVertexFormat : height error %g (max step %g), xz error %g, normal error %.3f deg, %d indices out of patch\n",
+        maxHeightError, maxQuantizationStep, maxPlanarError, maxNormalError, numOutOfPatch);
+
+    bool passed = maxHeightExcess <= 0.0f && maxPlanarError <= 1e-3f && maxNormalError <= maxNormalDegrees
+        && numOutOfPatch == 0 && gridByteSize >= 4 * compactByteSize;
+    Log("[Benchmark] TerrainVertexFormat : %s\n", passed ? "passed" : "FAILED");
+
+    assert(passed);
+    return passed;
+}
+
+bool Benchmark::TerrainSmoothing(Terrain& terrain, float width, float length, int numRepeats)
+{
+    vector<Vertex> source;
+    terrain.CreateGridVertices(width, length, source);
+    int imageWidth = terrain.GetImageWidth();
+    int imageLength = terrain.GetImageLength();
+    const int radius = Terrain::SmoothingRadius;
+    if (imageWidth <= 2 * radius + 1 || imageLength <= 2 * radius + 1 || source.size() != (size_t)imageWidth * imageLength) {
+        Log("[Benchmark] TerrainSmoothing : height map too small, skipped\n");
+        return true;
+    }
+
+    // 평탄화 창 : 정점 (i, j)는 [radius - 1, image - radius] 안에서, 표본은 [radius, image - 1 - radius] 안에서만 읽는다.
+    auto smoothVertex = [&](const vector<Vertex>& from, vector<Vertex>& to, int i, int j) {
+        float height = 0.0f;
+        XMFLOAT3 normal(0.0f, 0.0f, 0.0f);
+        int numAdd = 0;
+        for (int y = max(i - radius, radius); y <= min(i + radius, imageLength - 1 - radius); y++)
+            for (int x = max(j - radius, radius); x <= min(j + radius, imageWidth - 1 - radius); x++)
+            {
+                const Vertex& vertex = from[(size_t)y * imageWidth + x];
+                height += vertex.Pos.y;
+                normal = XMFLOAT3(normal.x + vertex.Normal.x, normal.y + vertex.Normal.y, normal.z + vertex.Normal.z);
+                numAdd++;
+            }
+        to[(size_t)i * imageWidth + j].Pos.y = height / numAdd;
+        to[(size_t)i * imageWidth + j].Normal = Vector3::Normalize(normal);
+    };
+
+    // 1. 기존 방식 : 제자리에서 평탄화하므로 앞(위, 왼쪽)의 평탄화한 값을 다시 읽는다.
+    vector<Vertex> inPlace;
+    double inPlaceMs = DBL_MAX;
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        inPlace = source;
+        auto start = Clock::now();
+        for (int i = radius - 1; i <= imageLength - radius; i++)
+            for (int j = radius - 1; j <= imageWidth - radius; j++)
+                smoothVertex(inPlace, inPlace, i, j);
+        inPlaceMs = min(inPlaceMs, ElapsedMs(start));
+    }
+
+    // 2. 원본만 읽는 49탭 기준
+    vector<Vertex> reference = source;
+    auto start = Clock::now();
+    for (int i = radius - 1; i <= imageLength - radius; i++)
+        for (int j = radius - 1; j <= imageWidth - radius; j++)
+            smoothVertex(source, reference, i, j);
+    double referenceMs = ElapsedMs(start);
+
+    auto compare = [&](const vector<Vertex>& result, float& maxHeightError, float& maxNormalError) {
+        maxHeightError = 0.0f;
+        maxNormalError = 0.0f;
+        for (size_t v = 0; v < result.size(); v++)
+        {
+            maxHeightError = max(maxHeightError, fabsf(result[v].Pos.y - reference[v].Pos.y));
+            maxNormalError = max(maxNormalError, max(fabsf(result[v].Normal.x - reference[v].Normal.x),
+                max(fabsf(result[v].Normal.y - reference[v].Normal.y), fabsf(result[v].Normal.z - reference[v].Normal.z))));
+        }
+    };
+
+    float inPlaceHeightError, inPlaceNormalError;
+    compare(inPlace, inPlaceHeightError, inPlaceNormalError);
+    Log("[Benchmark] TerrainSmoothing : %d x %d, in place %.2f ms (differs from the source-only filter by %.3f in height), 49 taps from source %.2f ms\n",
+        imageWidth, imageLength, inPlaceMs, inPlaceHeightError, referenceMs);
+
+    // 3. 분리형 : 1 스레드 결과를 기준으로 스레드 수를 늘린다.
+    bool passed = true;
+    vector<Vertex> serial;
+    double serialMs = DBL_MAX;
+    for (int repeat = 0; repeat < numRepeats; repeat++)
+    {
+        serial = source;
+        start = Clock::now();
+        Terrain::SmoothGridVertices(serial, imageWidth, imageLength);
+        serialMs = min(serialMs, ElapsedMs(start));
+    }
+    float heightError, normalError;
+    compare(serial, heightError, normalError);
+    // 합하는 순서가 다르므로 높이는 float 합의 오차만큼 다를 수 있다.
+    bool isClose = heightError <= 1e-3f && normalError <= 1e-5f;
+    passed = passed && isClose;
+    Log("[Benchmark] TerrainSmoothing : separable 1 thread %.2f ms (x%.1f vs in place), height error %g, normal error %g, %s\n",
+        serialMs, inPlaceMs / serialMs, heightError, normalError, isClose ? "passed" : "FAILED");
+
+    unsigned int maxThreads = max(1u, thread::hardware_concurrency());
+    vector<Vertex> parallel;
+    for (unsigned int numThreads = 2; numThreads <= maxThreads; numThreads++)
+    {
+        ThreadPool threadPool(numThreads - 1);
+        double parallelMs = DBL_MAX;
+        for (int repeat = 0; repeat < numRepeats; repeat++)
+        {
+            parallel = source;
+            start = Clock::now();
+            Terrain::SmoothGridVertices(parallel, imageWidth, imageLength, &threadPool);
+            parallelMs = min(parallelMs, ElapsedMs(start));
+        }
+
+        bool isSame = memcmp(parallel.data(), serial.data(), serial.size() * sizeof(Vertex)) == 0;
+        passed = passed && isSame;
+        Log("[Benchmark] TerrainSmoothing : separable %u threads %.2f ms (x%.1f vs in place, x%.2f vs 1 thread), %s\n",
+            numThreads, parallelMs, inPlaceMs / parallelMs, serialMs / parallelMs, isSame ? "same as 1 thread" : "DIFFERS from 1 thread");
+    }
+
+    assert(passed);
+    return passed;
+}
+
+bool Benchmark::HeightMapTiles(const wchar_t* filepath, int width, int length, float yScale, int numQueries, int syntheticSize, int maxTiles)
+{
+    // 1. 기존 방식 : 파일 전체를 임시 버퍼로 읽고 yScale을 곱해 16비트 버퍼에 다시 담는다.
+    auto start = Clock::now();
+    ifstream file(filepath, ios::binary);
+    vector<uint16_t> raw((size_t)width * length);
+    if (!file.read(reinterpret_cast<char*>(raw.data()), raw.size() * sizeof(uint16_t))) {
+        Log("[Benchmark] HeightMapTiles : failed to read %d x %d samples, skipped\n", width, length);
+        return true;
+    }
+    vector<uint16_t> truncated(raw.size());
+    for (size_t i = 0; i < raw.size(); i++)
+        truncated[i] = (uint16_t)(raw[i] * yScale);
+    double wholeFileMs = ElapsedMs(start);
+
+    float truncationError = 0.0f;
+    for (size_t i = 0; i < raw.size(); i++)
+        truncationError = max(truncationError, raw[i] * yScale - truncated[i]);
+
+    // 2. HeightMapImage : 행 순서로 모두 읽는다.
+    bool passed = true;
+    HeightMapImage image;
+    start = Clock::now();
+    if (!image.LoadHeightMapImage(filepath, width, length, yScale)) {
+        Log("[Benchmark] HeightMapTiles : HeightMapImage failed to load\n");
+        assert(false);
+        return false;
+    }
+    double openMs = ElapsedMs(start);
+
+    vector<float> row(width);
+    start = Clock::now();
+    for (int z = 0; z < length; z++)
+    {
+        image.GetHeightRow(0, z, width, row.data());
+        for (int x = 0; x < width; x++)
+            passed = passed && row[x] == raw[(size_t)z * width + x] * yScale;
+    }
+    double rowMs = ElapsedMs(start);
+    UINT64 rowLoads = image.GetNumTileLoads();
+
+    // 3. 임의 위치 (같은 순서를 미리 만들어 둔다.)
+    mt19937 random(7);
+    vector<pair<int, int>> queries(numQueries);
+    for (pair<int, int>& query : queries)
+        query = { (int)(random() % width), (int)(random() % length) };
+
+    UINT64 loadsBefore = image.GetNumTileLoads(), hitsBefore = image.GetNumTileHits();
+    float sum = 0.0f;
+    start = Clock::now();
+    for (const pair<int, int>& query : queries)
+        sum += image.GetHeightAt(query.first, query.second);
+    double randomMs = ElapsedMs(start);
+    UINT64 randomLoads = image.GetNumTileLoads() - loadsBefore;
+    UINT64 randomHits = image.GetNumTileHits() - hitsBefore;
+
+    float expectedSum = 0.0f;
+    for (const pair<int, int>& query : queries)
+        expectedSum += raw[(size_t)query.second * width + query.first] * yScale;
+    passed = passed && sum == expectedSum;
+
+    Log("[Benchmark] HeightMapTiles : %d x %d, whole file + scale %.2f ms (truncation error up to %.3f), map %.3f ms, rows %.2f ms (%llu tile loads), %d random %.1f ns/query (%.1f%% hits), %s\n",
+        width, length, wholeFileMs, truncationError, openMs, rowMs, rowLoads, numQueries, randomMs * 1e6 / numQueries,
+        100.0 * randomHits / max<UINT64>(randomHits + randomLoads, 1), passed ? "exact" : "MISMATCH");
+
+    // 4. 캐시보다 훨씬 큰 임시 높이 맵 : 표본 값은 위치로 정해지므로 파일을 다시 읽지 않고 확인한다.
+    if (syntheticSize > 0) {
+        auto sampleAt = [](int x, int z) { return (uint16_t)(x * 31 + z * 17); };
+        wstring syntheticFile = wstring(filepath) + L".bench";
+        {
+            ofstream out(syntheticFile, ios::binary);
+            vector<uint16_t> samples(syntheticSize);
+            for (int z = 0; z < syntheticSize; z++)
+            {
+                for (int x = 0; x < syntheticSize; x++)
+                    samples[x] = sampleAt(x, z);
+                out.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(uint16_t));
+            }
+        }
+
+        bool isSyntheticPassed = false;
+        {
+            HeightMapImage large;
+            if (large.LoadHeightMapImage(syntheticFile.c_str(), syntheticSize, syntheticSize, yScale, maxTiles)) {
+                // 지형과 플레이어처럼 가까운 곳을 이어서 읽는 경우(한 번에 최대 8 표본씩 움직이는 걸음)와 캐시가 소용없는 전체 임의 위치
+                isSyntheticPassed = true;
+                const int numRandomQueries = max(numQueries / 64, 1);
+                for (int pattern = 0; pattern < 2; pattern++)
+                {
+                    bool isWalk = pattern == 0;
+                    int count = isWalk ? numQueries : numRandomQueries;
+                    UINT64 loadsBefore = large.GetNumTileLoads(), hitsBefore = large.GetNumTileHits();
+                    int x = syntheticSize / 2, z = syntheticSize / 2;
+                    start = Clock::now();
+                    for (int i = 0; i < count; i++)
+                    {
+                        if (isWalk) {
+                            x = min(max(x + (int)(random() % 17) - 8, 0), syntheticSize - 1);
+                            z = min(max(z + (int)(random() % 17) - 8, 0), syntheticSize - 1);
+                        }
+                        else {
+                            x = (int)(random() % syntheticSize);
+                            z = (int)(random() % syntheticSize);
+                        }
+                        isSyntheticPassed = isSyntheticPassed && large.GetHeightAt(x, z) == sampleAt(x, z) * yScale;
+                    }
+                    double largeMs = ElapsedMs(start);
+                    UINT64 loads = large.GetNumTileLoads() - loadsBefore, hits = large.GetNumTileHits() - hitsBefore;
+                    Log("[Benchmark] HeightMapTiles : synthetic %d x %d (%.0f MB), cache %d tiles (%.1f MB), %d %s %.1f ns/query, %llu tile loads (%.1f%% hits), %s\n",
+                        syntheticSize, syntheticSize, (double)syntheticSize * syntheticSize * sizeof(uint16_t) / (1024.0 * 1024.0),
+                        maxTiles, maxTiles * HeightMapImage::TileSize * HeightMapImage::TileSize * sizeof(uint16_t) / (1024.0 * 1024.0),
+                        count, isWalk ? "walk" : "random", largeMs * 1e6 / count, loads, 100.0 * hits / max<UINT64>(hits + loads, 1),
+                        isSyntheticPassed ? "exact" : "MISMATCH");
+                }
+            }
+            else {
+                Log("[Benchmark] HeightMapTiles : failed to map the synthetic height map\n");
+            }
+        }
+        _wremove(syntheticFile.c_str());
+        passed = passed && isSyntheticPassed;
+    }
+
+    assert(passed);
+    return passed;
+}
+
+bool Benchmark::TerrainGroundQuery(Terrain& terrain, const vector<Vertex>& gridVertices, int numPoints)
+{
+    int imageWidth = terrain.GetImageWidth();
+    int imageLength = terrain.GetImageLength();
+    if (imageWidth < 2 || imageLength < 2 || gridVertices.size() != (size_t)imageWidth * imageLength) {
+        Log("[Benchmark] TerrainGroundQuery : no terrain grid, skipped\n");
+        return true;
+    }
+
+    const XMFLOAT3& origin = gridVertices[0].Pos;
+    float dx = gridVertices[1].Pos.x - origin.x;
+    float dz = gridVertices[imageWidth].Pos.z - origin.z;       // 음수
+    float width = dx * (imageWidth - 1), length = -dz * (imageLength - 1);
+
+    // 기준 : 점이 놓인 칸의 두 삼각형 중 하나를 골라 세 정점으로 높이와 법선을 구한다.
+    // 삼각형 경계(칸의 변과 대각선)에서는 어느 쪽 삼각형이든 맞으므로 법선을 비교하지 않는다. (onEdge)
+    auto reference = [&](float x, float z, XMFLOAT3& normal, bool& onEdge) {
+        float column = min(max((x - origin.x) / dx, 0.0f), (float)(imageWidth - 1));
+        float row = min(max((z - origin.z) / dz, 0.0f), (float)(imageLength - 1));
+        int j = min((int)column, imageWidth - 2), i = min((int)row, imageLength - 2);
+        float u = column - j, v = row - i;
+        onEdge = min(min(min(u, 1.0f - u), min(v, 1.0f - v)), fabsf(u + v - 1.0f)) < 1e-3f;
+        auto at = [&](int r, int c) { return XMLoadFloat3(&gridVertices[(size_t)r * imageWidth + c].Pos); };
+        XMVECTOR p0, p1, p2;
+        if (u + v <= 1.0f) {
+            p0 = at(i, j); p1 = at(i, j + 1); p2 = at(i + 1, j);
+        }
+        else {
+            p0 = at(i + 1, j); p1 = at(i, j + 1); p2 = at(i + 1, j + 1);
+        }
+        XMVECTOR n = XMVector3Normalize(XMVector3Cross(p1 - p0, p2 - p0));
+        if (XMVectorGetY(n) < 0.0f)
+            n = -n;
+        XMStoreFloat3(&normal, n);
+        // 평면 n . (p - p0) = 0에서 y를 구한다.
+        XMFLOAT3 base;
+        XMStoreFloat3(&base, p0);
+        return base.y - (normal.x * (x - base.x) + normal.z * (z - base.z)) / normal.y;
+    };
+
+    // 지형 안(가장자리 포함)의 임의 점과 바깥 점 몇 개, 묶음 폭의 배수가 아니도록 3개를 더한다.
+    mt19937 random(11);
+    uniform_real_distribution<float> insideX(origin.x, origin.x + width), insideZ(origin.z - length, origin.z);
+    vector<XMFLOAT2> points(numPoints + 3);
+    for (XMFLOAT2& point : points)
+        point = XMFLOAT2(insideX(random), insideZ(random));
+    // 지면 높이는 블록 LRU 캐시에서 읽으므로 군중처럼 가까운 점끼리 모아 부르는 경우를 흉내 내 블록 순서로 놓는다.
+    const float blockWidth = dx * Terrain::GroundBlockQuads, blockLength = -dz * Terrain::GroundBlockQuads;
+    auto blockOf = [&](const XMFLOAT2& point) {
+        return make_pair((int)((origin.z - point.y) / blockLength), (int)((point.x - origin.x) / blockWidth));
+    };
+    sort(points.begin(), points.end(), [&](const XMFLOAT2& a, const XMFLOAT2& b) { return blockOf(a) < blockOf(b); });
+
+    vector<float> heights(points.size());
+    vector<XMFLOAT3> normals(points.size());
+    UINT64 firstBlockLoads = terrain.GetNumGroundBlockLoads();
+    terrain.GetGroundHeights(points.data(), (UINT)points.size(), heights.data(), normals.data());
+    UINT64 numBlockLoads = terrain.GetNumGroundBlockLoads() - firstBlockLoads;
+
+    float maxHeightError = 0.0f, maxNormalError = 0.0f;
+    for (size_t p = 0; p < points.size(); p++)
+    {
+        XMFLOAT3 normal;
+        bool onEdge;
+        float height = reference(points[p].x, points[p].y, normal, onEdge);
+        maxHeightError = max(maxHeightError, fabsf(heights[p] - height) / max(1.0f, fabsf(height)));
+        if (!onEdge)
+            maxNormalError = max(maxNormalError, max(fabsf(normals[p].x - normal.x), max(fabsf(normals[p].y - normal.y), fabsf(normals[p].z - normal.z))));
+    }
+
+    // 정점 위에서는 정점 높이, 바깥은 가장 가까운 가장자리 정점 높이
+    // 높이는 상대 오차로 본다. (좌표를 격자로 옮길 때의 반올림에 기울기를 곱한 만큼 다를 수 있다.)
+    const float heightTolerance = 5e-5f;
+    int numVertexMismatches = 0, numOutsideMismatches = 0;
+    for (int i = 0; i < imageLength; i += 7)
+        for (int j = 0; j < imageWidth; j += 7)
+        {
+            const XMFLOAT3& pos = gridVertices[(size_t)i * imageWidth + j].Pos;
+            if (fabsf(terrain.GetGroundHeight(pos.x, pos.z) - pos.y) > heightTolerance * max(1.0f, fabsf(pos.y)))
+                numVertexMismatches++;
+        }
+    const Vertex& lastVertex = gridVertices.back();
+    const pair<XMFLOAT2, float> outside[] = {
+        { XMFLOAT2(origin.x - 100.0f, origin.z + 100.0f), origin.y },
+        { XMFLOAT2(lastVertex.Pos.x + 100.0f, lastVertex.Pos.z - 100.0f), lastVertex.Pos.y },
+        { XMFLOAT2(origin.x - 1e6f, lastVertex.Pos.z - 1e6f), gridVertices[(size_t)(imageLength - 1) * imageWidth].Pos.y },
+    };
+    for (const auto& test : outside)
+        if (fabsf(terrain.GetGroundHeight(test.first.x, test.first.y) - test.second) > 1e-3f)
+            numOutsideMismatches++;
+
+    // 시간 : 묶음, 점 하나씩, 기존 높이 맵 조회 (높이 맵 좌표로 옮겨서)
+    double batchMs = DBL_MAX, singleMs = DBL_MAX, legacyMs = DBL_MAX;
+    float sink = 0.0f;
+    for (int repeat = 0; repeat < 3; repeat++)
+    {
+        auto start = Clock::now();
+        terrain.GetGroundHeights(points.data(), (UINT)points.size(), heights.data());
+        batchMs = min(batchMs, ElapsedMs(start));
+
+        start = Clock::now();
+        for (const XMFLOAT2& point : points)
+            sink += terrain.GetGroundHeight(point.x, point.y);
+        singleMs = min(singleMs, ElapsedMs(start));
+
+        HeightMapImage& image = terrain.GetHeightMapImage();
+        start = Clock::now();
+        for (const XMFLOAT2& point : points)
+            sink += image.GetHeight((point.x - origin.x) / dx, (point.y - origin.z) / dz);
+        legacyMs = min(legacyMs, ElapsedMs(start));
+    }
+
+    double toNs = 1e6 / points.size();
+    bool passed = maxHeightError <= heightTolerance && maxNormalError <= 1e-4f && numVertexMismatches == 0 && numOutsideMismatches == 0;
+    Log("[Benchmark] TerrainGroundQuery : %zu points, %llu ground blocks built (%d cached), batch %.1f ns/point (x%.1f vs one by one %.1f, x%.1f vs HeightMapImage::GetHeight %.1f), height error %g (relative), normal error %g, %d vertex / %d outside mismatches, %s (%g)\n",
+        points.size(), numBlockLoads, Terrain::MaxGroundBlocks, batchMs * toNs, singleMs / batchMs, singleMs * toNs, legacyMs / batchMs, legacyMs * toNs,
+        maxHeightError, maxNormalError, numVertexMismatches, numOutsideMismatches, passed ? "passed" : "FAILED", sink);
+
+    assert(passed);
+    return passed;
+}
+
+bool Benchmark::TerrainLod(const Terrain& terrain, float pixelError, int numRepeats)
+{
+    const vector<TerrainPatch>& patches = terrain.GetPatches();
+    if (patches.empty()) {
+        Log("[Benchmark] TerrainLod : no patches, skipped\n");
+        return true;
+    }
+
+    XMFLOAT3 minPos(FLT_MAX, FLT_MAX, FLT_MAX), maxPos(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (const TerrainPatch& patch : patches)
+    {
+        const BoundingBox& bounds = patch.bounds;
+        minPos = XMFLOAT3(min(minPos.x, bounds.Center.x - bounds.Extents.x), min(minPos.y, bounds.Center.y - bounds.Extents.y), min(minPos.z, bounds.Center.z - bounds.Extents.z));
+        maxPos = XMFLOAT3(max(maxPos.x, bounds.Center.x + bounds.Extents.x), max(maxPos.y, bounds.Center.y + bounds.Extents.y), max(maxPos.z, bounds.Center.z + bounds.Extents.z));
+    }
+    XMFLOAT3 center((minPos.x + maxPos.x) * 0.5f, maxPos.y, (minPos.z + maxPos.z) * 0.5f);
+    float extent = max(maxPos.x - minPos.x, maxPos.z - minPos.z);
+    UINT fullTriangles = (UINT)patches.size() * terrain.GetLodNumIndices(0) / 3;
+
+    // DummyApp 카메라 : 높이 800 뷰포트, fovY = 0.25 pi
+    const float projScale = 800.0f / (2.0f * tanf(0.125f * XM_PI));
+
+    struct CameraCase
+    {
+        const char* name;
+        XMFLOAT3 eye;
+    };
+    // 앞의 셋은 중심 위에서 높이만 올린다.
+    const CameraCase cameras[] = {
+        { "center 10", XMFLOAT3(center.x, center.y + 10.0f, center.z) },
+        { "center 500", XMFLOAT3(center.x, center.y + 500.0f, center.z) },
+        { "center 2000", XMFLOAT3(center.x, center.y + 2000.0f, center.z) },
+        { "edge", XMFLOAT3(minPos.x, center.y + 100.0f, center.z) },
+        { "outside", XMFLOAT3(center.x + extent * 4.0f, center.y + 1000.0f, center.z) },
+    };
+    const int numCenterCameras = 3;
+
+    bool passed = true;
+    vector<TerrainPatchDraw> draws;
+    UINT previousTriangles = UINT_MAX;
+    for (int c = 0; c < (int)size(cameras); c++)
+    {
+        const CameraCase& camera = cameras[c];
+        UINT numTriangles = terrain.SelectPatches(camera.eye, nullptr, projScale, pixelError, draws);
+
+        int lodCounts[Terrain::NumLods] = {};
+        int numOverError = 0;
+        for (const TerrainPatchDraw& draw : draws)
+        {
+            lodCounts[draw.lod]++;
+            const TerrainPatch& patch = patches[draw.patch];
+            if (draw.lod > 0 && patch.lodErrors[draw.lod] * projScale > pixelError * Terrain::DistanceToBox(camera.eye, patch.bounds))
+                numOverError++;
+        }
+        bool isMonotonic = c >= numCenterCameras || numTriangles <= previousTriangles;
+        if (c < numCenterCameras)
+            previousTriangles = numTriangles;
+
+        auto start = Clock::now();
+        for (int i = 0; i < numRepeats; i++)
+            terrain.SelectPatches(camera.eye, nullptr, projScale, pixelError, draws);
+        double selectUs = ElapsedMs(start) * 1000.0 / numRepeats;
+
+        bool isPassed = numOverError == 0 && isMonotonic && draws.size() == patches.size();
+        Log("[Benchmark] TerrainLod : %-11s %zu patches, LOD [%d, %d, %d, %d, %d], %u tris (%.1f%% of %u), select %.2f us, %s\n",
+            camera.name, draws.size(), lodCounts[0], lodCounts[1], lodCounts[2], lodCounts[3], lodCounts[4],
+            numTriangles, 100.0 * numTriangles / fullTriangles, fullTriangles, selectUs, isPassed ? "passed" : "FAILED");
+        if (!isPassed)
+            Log("[Benchmark] TerrainLod : %-11s %d patches over %.1f pixels, %s\n", camera.name, numOverError, pixelError,
+                isMonotonic ? "monotonic" : "more triangles than the lower camera");
+        passed = passed && isPassed;
+    }
+
+    // 오차 0을 요구하면 높이 차가 없는 조각만 거친 LOD로 그릴 수 있다.
+    UINT exactTriangles = terrain.SelectPatches(cameras[0].eye, nullptr, projScale, 0.0f, draws);
+    int numCoarsePatches = 0;
+    for (const TerrainPatchDraw& draw : draws)
+    {
+        if (patches[draw.patch].lodErrors[draw.lod] > 0.0f)
+            numCoarsePatches++;
+    }
+    // 치마는 이웃과의 틈(가장 거친 LOD 오차 이하)보다 깊어야 한다.
+    int numShallowSkirts = 0;
+    for (const TerrainPatch& patch : patches)
+    {
+        if (!(patch.skirtDepth > patch.lodErrors[Terrain::NumLods - 1]))
+            numShallowSkirts++;
+    }
+    Log("[Benchmark] TerrainLod : pixel error 0 %u tris, %d patches with error on a coarse LOD, %d shallow skirts\n",
+        exactTriangles, numCoarsePatches, numShallowSkirts);
+    passed = passed && numCoarsePatches == 0 && numShallowSkirts == 0;
+
+    assert(passed);
+    return passed;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "SkinnedMesh.h"
+#include "SkinnedModelInstance.h"
+#include "MeshSlice.h"
+#include "SliceWorker.h"
+#include "GeometryHeap.h"
+#include "Terrain.h"
+#include <chrono>
+
+// 성능 측정 모음
+// DummyApp.cpp에서 _WITH_BENCHMARK를 정의하면 초기화 과정에서 실행되고, 결과는 출력 창에 기록된다.
+namespace Benchmark
+{
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point start);
+    void Log(const char* format, ...);
+
+    // 이름 기반 재귀 평가(GetBoneTransformsLegacy)와 컴파일된 스켈레톤 평가(GetBoneTransforms) 비교
+    void SkinnedMeshPose(SkinnedMesh& skinnedMesh, int numSamples = 2000);
+
+    // 커서 기반 샘플링(BoneAnimation::Sample*)을 선형 탐색 보간과 비교 검증하고 시간을 잰다.
+    // 순방향 재생과 임의 탐색 두 가지 순서로 확인하며, 불일치가 있으면 false를 반환한다.
+    bool KeyframeSampling(SkinnedMesh& skinnedMesh, int numSamples = 500);
+
+    // 압축 클립과 원본 클립을 키 사이 시간까지 샘플링해 오차와 샘플링 시간을 비교한다.
+    void ClipCompression(SkinnedMesh& skinnedMesh, int numSamples = 500);
+
+    // 인스턴스 10/100/1000개의 포즈를 1~N개 스레드로 일괄 계산(EvaluatePoses)해 단일 스레드 대비 속도를 잰다.
+    // 결과가 단일 스레드 계산(UpdateSkinnedAnimation)과 다르면 false를 반환한다.
+    bool PoseBatchScaling(SkinnedMesh& skinnedMesh, int numFrames = 50);
+
+    // PoseKernel(SoA 회전 보간 + TRS 합성)을 관절별 XMQuaternionSlerp + XMMatrixAffineTransformation과 비교한다.
+    // 커널만 따로 잰 뼈당 시간과 포즈 전체의 뼈당 시간을 기록하고, Slerp 결과가 허용 오차를 넘으면 false를 반환한다.
+    bool PoseKernelSampling(SkinnedMesh& skinnedMesh, int numSamples = 500);
+
+    // 두 클립 블렌딩(EvaluateBlendedPose)을 확인하고 시간을 잰다.
+    // 가중치 0/1은 각 클립 단독 포즈와, 관절 마스크가 0인 관절은 바탕 클립과 같아야 한다.
+    bool PoseBlending(SkinnedMesh& skinnedMesh, int numSamples = 500);
+
+    // 구운 포즈 캐시의 굽는 시간, 크기, 실시간 계산 대비 오차와 포즈당 시간을 기록하고 LRU 교체 순서를 확인한다.
+    // 확인이 끝나면 캐시를 원래 설정으로 비워 둔다.
+    bool BakedPoseCache(SkinnedMesh& skinnedMesh, float sampleRate = 30.0f, int numSamples = 500);
+
+    // FBX(Assimp) 로드와 쿡 파일 로드 시간을 비교한다. 쿡 파일은 cookedFile 옆의 임시 파일에 만들고 지운다.
+    // 두 경로로 읽은 SkinnedMesh의 정점/뼈/클립과 클립마다 numSamples개의 포즈가 같지 않거나, 압축 허용 오차가 다른 설정으로 쿡 파일을 읽을 수 있거나,
+    // 노드 자식 이름, 인덱스, 정점 뼈 id, 자식 뼈 id, 압축 트랙 위치를 하나씩 틀리게 고친 사본을 읽을 수 있으면 false를 반환한다.
+    bool CookedModelLoad(const vector<string>& sourceFiles, const string& cookedFile, int numSamples = 200);
+
+    // skull.txt 형식 (VertexCount, TriangleCount, 위치/법선 목록, 삼각형 목록)을 읽는다. 텍스처 좌표는 0
+    bool LoadSkullModel(const char* filename, vector<Vertex>& vertices, vector<UINT>& indices);
+
+    // shapeGeo의 box, skull.txt, 지형을 중심을 지나는 여러 평면으로 잘라 초당 절단 횟수를 잰다.
+    // 한 SliceContext를 재사용하는 경우와 매번 새 벡터에 복사하는 MeshCompleteSlice를 비교한다.
+    void MeshSliceThroughput(const Mesh* shapeGeo, const Mesh* terrain, double minDurationMs = 500.0);
+
+    // shapeGeo의 닫힌 도형(box, sphere, cylinder), skull.txt, 두꺼운 관, 한 변만 맞닿은 두 상자(절단면 루프가 한 점에서 만남)를 임의 평면, 중심을 지나는 축 평면, 겉면에 닿는 평면으로 잘라
+    // 두 조각이 모두 닫혀 있는지(위치가 같은 정점을 합쳤을 때 모든 변을 두 면이 반대 방향으로 지나는지)와
+    // 절단면 삼각형이 모두 절단면 법선 쪽을 보는지(오목한 단면, 구멍에서 겹치지 않는지) 확인한다.
+    // 닫혀 있지 않은 원본은 건너뛰며, 하나라도 어긋나면 false를 반환한다.
+    bool MeshSliceWatertight(const Mesh* shapeGeo, int numPlanes = 64);
+
+    // box, sphere, cylinder, 정팔면체, 두꺼운 관, skull.txt를 임의 평면과 정점을 정확히 지나는 평면(축, 겉면, 대각)으로 잘라 확인한다.
+    // 원본 정점이 분류한 쪽의 조각에 있는지, 새 정점이 평면 위에 있는지, 조각이 닫혀 있는지, 조각 부피의 합과 절단면을 뺀 겉넓이의 합이
+    // 원본과 같은지, 조각의 오일러 지표가 올바른지(볼록한 원본은 성분 하나에 2) 본다. 하나라도 어긋나면 false를 반환한다.
+    // 도형마다 임의 평면으로 minDurationMs 동안 잘라 초당 입력/출력 삼각형 수도 기록한다.
+    bool MeshSliceValidation(const Mesh* shapeGeo, double minDurationMs = 200.0);
+
+    // MultiSliceContext로 box, sphere, skull.txt, 두꺼운 관을 격자(축마다 평면 2개)와 임의 평면 8개로 한 번에 잘라
+    // 조각이 모두 닫혀 있는지, 조각 부피의 합이 원본 부피와 같은지 확인한다. (닫혀 있지 않은 원본은 시간만 잰다)
+    // 조각마다 SliceContext로 모든 평면을 차례로 잘라 따로 복사하는 방식과 시간, 조각 수를 비교하며, 어긋나면 false를 반환한다.
+    bool MeshMultiSlice(const Mesh* shapeGeo, int numRepeats = 20);
+
+    // ConvexSliceContext로 box, sphere, cylinder, 두꺼운 관, skull.txt를 기울인 상자와 겉면에 둔 14-DOP로 Clip/Subtract한다.
+    // Clip 정점이 모두 볼록 다면체 안에 있는지, 절단면이 볼록 다면체 면 위에 있는지, 닫힌 원본이면 두 결과가 닫혀 있고
+    // 부피의 합이 원본과 같은지, Clip 부피가 평면마다 SliceContext로 전체를 자른 결과와 같은지 확인하고 시간을 비교한다.
+    bool ConvexSlice(const Mesh* shapeGeo, int numRepeats = 20);
+
+    // skull.txt와 지형을 numPlanes개의 평면으로 잘라 SliceContext의 병렬 경로를 1~N개 스레드로 잰다.
+    // 조각 정점/인덱스/원본 정점 번호가 threadPool 없이 자른 결과와 비트 단위로 다르면 false를 반환한다.
+    bool MeshSliceScaling(const Mesh* terrain, int numPlanes = 8);
+
+    // SliceKernel의 정점 분류(AoS, SoA)를 정점마다 분기하는 기존 방식과, 변 보간(t = d0 / (d0 - d1))을
+    // XMPlaneIntersectLine과 거리 두 번으로 t를 구하던 기존 방식과 임의 정점 numVertices개로 비교한다.
+    // 분류 결과와 거리가 비트 단위로 다르거나 보간 결과가 허용 오차를 넘으면 false를 반환한다.
+    bool SliceKernels(int numVertices = 1 << 20, int numRepeats = 20);
+
+    // skinnedGeo의 submesh마다 SkinnedSliceContext로 bind pose와 걷는 포즈에서 자른다.
+    // bind pose 조각은 같은 메시를 Vertex로 자른 결과와 같아야 하고, 새로 만든 정점의 가중치는 음수가 없고 합이 1이어야 하며,
+    // 포즈에서 자른 조각의 새 정점은 같은 포즈로 다시 스키닝하면 절단면 위에 놓여야 한다. 어긋나면 false를 반환한다.
+    bool SkinnedMeshSlice(const Mesh* skinnedGeo, SkinnedMesh& skinnedMesh, int numPlanes = 16);
+
+    // GPU 없이 프레임 루프를 흉내 내어 sliceInterval 프레임마다 skull.txt(없으면 sphere)를 자를 때의 프레임 시간을 잰다.
+    // none : 자르지 않음, sync : 프레임 안에서 자르고 메시마다 업로드 버퍼를 만들어 복사 (기존 'F', GPU 대기 제외),
+    // async : SliceWorker에 맡기고 끝난 결과를 GeometryHeap과 같은 구간/울타리 링 할당으로 올린다. (GPU는 2프레임 늦게 끝난다고 본다.)
+    // async에서 모든 결과가 도착하지 않거나 올린 내용이 다르거나 반환 후 힙과 링이 비지 않으면 false를 반환한다.
+    bool SliceFrameSpikes(const Mesh* shapeGeo, int numFrames = 600, int sliceInterval = 20);
+
+    // 지형 조각 쿼드트리에서 카메라 위치(중심 위 세 높이, 가장자리, 바깥)마다 고른 LOD별 조각 수, 삼각형 수, 선택 시간을 기록한다. (절두체 컬링 없이)
+    // 고른 LOD의 화면 오차가 pixelError를 넘거나, 중심 위에서 높이 올라갈수록 삼각형이 늘거나, pixelError 0에서 오차가 있는 LOD를 고르거나,
+    // 치마가 가장 거친 LOD 오차보다 얕으면 false를 반환한다.
+    bool TerrainLod(const Terrain& terrain, float pixelError = 2.0f, int numRepeats = 200);
+
+    // terrain.CreatePatches로 압축 정점(TerrainVertex)과 16비트 공유 인덱스를 다시 만들어 한 장 격자(Vertex, 32비트 인덱스),
+    // 같은 조각을 Vertex로 둘 때와 바이트 수를 비교하고, 푼 위치와 법선을 gridVertices(같은 크기로 CreateTerrain한 정점)와 비교한다.
+    // 높이(치마는 skirtDepth를 뺀 높이) 차가 양자화 간격의 절반을 넘거나, XZ가 다르거나, 법선이 maxNormalDegrees보다 벗어나거나,
+    // 인덱스가 조각 밖을 가리키거나, 한 장 격자보다 4배 이상 작지 않으면 false를 반환한다.
+    bool TerrainVertexFormat(Terrain& terrain, float width, float length, const vector<Vertex>& gridVertices, float maxNormalDegrees = 1.5f);
+
+    // 평탄화하지 않은 격자에서 기존의 제자리 7 x 7 평탄화(탭 49개, 앞서 바꾼 값을 다시 읽는다), 원본만 읽는 49탭 기준,
+    // Terrain::SmoothGridVertices(1 스레드부터 하드웨어 스레드 수까지)의 시간을 잰다.
+    // SmoothGridVertices가 49탭 기준과 허용 오차 이상 다르거나 스레드 수에 따라 비트 단위로 다르면 false를 반환한다.
+    bool TerrainSmoothing(Terrain& terrain, float width, float length, int numRepeats = 5);
+
+    // .r16 높이 맵을 파일 전체로 읽어 yScale을 곱하고 16비트로 자르던 기존 방식과 HeightMapImage(매핑 + 타일 LRU 캐시)를 비교한다.
+    // 모든 표본이 raw * yScale과 비트 단위로 같지 않으면 false를 반환한다. 행 순서와 임의 순서 읽기 시간, 캐시 적중률을 기록한다.
+    // syntheticSize > 0이면 filepath 옆에 syntheticSize x syntheticSize 임시 높이 맵을 만들어 작은 캐시(maxTiles)로 가까운 곳을 이어 읽는 걸음과 전체 임의 위치를 확인하고 지운다.
+    bool HeightMapTiles(const wchar_t* filepath, int width, int length, float yScale, int numQueries = 1 << 20, int syntheticSize = 8192, int maxTiles = 16);
+
+    // Terrain::GetGroundHeights(SIMD 묶음)를 gridVertices(같은 크기로 CreateTerrain한 평탄화 격자)의 삼각형에서 점마다 구한 기준과 비교하고,
+    // 묶음 질의, 점 하나씩 GetGroundHeight, 기존 HeightMapImage::GetHeight(평탄화 전 높이 맵)의 점당 시간과 새로 만든 지면 블록 수를 잰다. (점은 블록 순서로 놓는다.)
+    // 높이나 법선이 기준과 허용 오차 이상 다르거나, 정점 위의 높이가 정점과 다르거나, 범위 밖의 점이 가장자리 높이가 아니면 false를 반환한다.
+    bool TerrainGroundQuery(Terrain& terrain, const vector<Vertex>& gridVertices, int numPoints = 1 << 20);
+}
@@ -119,7 +119,7 @@ void Camera::SetViewMatrix(const XMMATRIX& viewMatrix)
 
 XMMATRIX Camera::GetView() const
 {
-	// ī޶ ̵ϰų ȸ  Ʈ  
+	// 카메라가 이동하거나 회전한 이후 업데이트되지 않은 경우
 	assert(!mViewDirty);
 	return XMLoadFloat4x4(&mView);
 }
@@ -185,7 +185,7 @@ void Camera::Pitch(float radian)
 
 	mCurrentPitch += XMConvertToDegrees(radian);
 
-	// up, look ͸ right Ϳ  ȸ
+	// up, look 벡터를 right 벡터에 대해 회전
 	XMMATRIX R = XMMatrixRotationAxis(XMLoadFloat3(&mRight), radian);
 
 	XMStoreFloat3(&mUp, XMVector3TransformNormal(XMLoadFloat3(&mUp), R));
@@ -196,7 +196,7 @@ void Camera::Pitch(float radian)
 
 void Camera::RotateY(float radian)
 {
-	// up, look, right   Y࿡  ȸ
+	// up, look, right를 월드 공간 Y축에 대해 회전
 	XMMATRIX R = XMMatrixRotationY(radian);
 
 	XMStoreFloat3(&mRight, XMVector3TransformNormal(XMLoadFloat3(&mRight), R));
@@ -215,13 +215,13 @@ void Camera::UpdateViewMatrix()
 		XMVECTOR L = XMLoadFloat3(&mLook);
 		XMVECTOR P = XMLoadFloat3(&mPosition);
 
-		// ī޶ ͸   Ͱ ǰ Ѵ.
+		// 카메라의 벡터를 서로 직교인 단위벡터가 되게 한다.
 		L = XMVector3Normalize(L);
 		U = XMVector3Normalize(XMVector3Cross(L, R));
 
 		R = XMVector3Cross(U, L);
 
-		// þ  е ä.
+		// 시야 행렬의 성분들을 채운다.
 		float x = -XMVectorGetX(XMVector3Dot(P, R));
 		float y = -XMVectorGetX(XMVector3Dot(P, U));
 		float z = -XMVectorGetX(XMVector3Dot(P, L));
@@ -0,0 +1,423 @@
+#include "CompressedClip.h"
+#include "SkinnedMesh.h"
+#include "CookedModel.h"
+
+// smallest-three : 가장 큰 성분을 빼고 남은 세 성분은 [-1/sqrt(2), 1/sqrt(2)] 범위에 있다.
+static const float SMALLEST_THREE_RANGE = 0.70710678f;
+static const float QUANTIZE_15BIT = 32767.0f;
+static const float QUANTIZE_16BIT = 65535.0f;
+
+// 가장 큰 성분의 인덱스 2비트 + 15비트 성분 3개 = 47비트를 uint16 3개에 담는다.
+static void EncodeQuaternion(const XMFLOAT4& q, uint16_t* out)
+{
+    float c[4] = { q.x, q.y, q.z, q.w };
+
+    int largest = 0;
+    for (int i = 1; i < 4; i++)
+        if (fabsf(c[i]) > fabsf(c[largest]))
+            largest = i;
+
+    // q와 -q는 같은 회전이므로 가장 큰 성분이 양수가 되도록 뒤집는다.
+    float sign = (c[largest] < 0.0f) ? -1.0f : 1.0f;
+
+    uint64_t bits = (uint64_t)largest;
+    int shift = 2;
+    for (int i = 0; i < 4; i++)
+    {
+        if (i == largest)
+            continue;
+
+        float v = MathHelper::Clamp(c[i] * sign / SMALLEST_THREE_RANGE, -1.0f, 1.0f);
+        uint64_t quantized = (uint64_t)lroundf((v * 0.5f + 0.5f) * QUANTIZE_15BIT);
+        bits |= quantized << shift;
+        shift += 15;
+    }
+
+    out[0] = (uint16_t)(bits & 0xffff);
+    out[1] = (uint16_t)((bits >> 16) & 0xffff);
+    out[2] = (uint16_t)((bits >> 32) & 0xffff);
+}
+
+static XMVECTOR DecodeQuaternion(const uint16_t* in)
+{
+    uint64_t bits = (uint64_t)in[0] | ((uint64_t)in[1] << 16) | ((uint64_t)in[2] << 32);
+    int largest = (int)(bits & 3);
+
+    float c[4];
+    float sumSquares = 0.0f;
+    int shift = 2;
+    for (int i = 0; i < 4; i++)
+    {
+        if (i == largest)
+            continue;
+
+        c[i] = ((float)((bits >> shift) & 0x7fff) / QUANTIZE_15BIT * 2.0f - 1.0f) * SMALLEST_THREE_RANGE;
+        sumSquares += c[i] * c[i];
+        shift += 15;
+    }
+    c[largest] = sqrtf(max(0.0f, 1.0f - sumSquares));
+
+    return XMVectorSet(c[0], c[1], c[2], c[3]);
+}
+
+static float MaxComponentError(FXMVECTOR a, FXMVECTOR b)
+{
+    XMFLOAT3 error;
+    XMStoreFloat3(&error, XMVectorAbs(a - b));
+    return max(error.x, max(error.y, error.z));
+}
+
+// 두 단위 쿼터니언이 나타내는 회전의 각도 차이 (라디안)
+// 1에 가까운 값의 acos는 float 정밀도가 부족하므로 두 쿼터니언 사이의 현 길이로 계산한다.
+float RotationError(FXMVECTOR a, FXMVECTOR b)
+{
+    XMVECTOR sameHemisphere = XMVectorLess(XMQuaternionDot(a, b), XMVectorZero());
+    XMVECTOR chord = a - XMVectorSelect(b, -b, sameHemisphere);
+    float halfChord = XMVectorGetX(XMVector4Length(chord)) * 0.5f;
+    return 4.0f * asinf(min(halfChord, 1.0f));
+}
+
+void CompressedClip::Compress(const vector<BoneAnimation>& channels, const AnimationCompressionSettings& settings)
+{
+    mTracks.assign(channels.size() * 3, CompressedTrack());
+    mTimes.clear();
+    mQuantizedValues.clear();
+    mRawValues.clear();
+    mMaxTranslationError = mMaxScaleError = mMaxRotationError = 0.0f;
+    mNumTracks[0] = mNumTracks[1] = mNumTracks[2] = 0;
+
+    vector<float> times;
+    vector<XMFLOAT3> vectorValues;
+    vector<XMFLOAT4> rotationValues;
+
+    for (int i = 0; i < (int)channels.size(); i++)
+    {
+        const BoneAnimation& boneAnimation = channels[i];
+
+        times.clear(); vectorValues.clear();
+        for (const Keyframe<XMFLOAT3>& key : boneAnimation.translation) {
+            times.push_back(key.timePos);
+            vectorValues.push_back(key.value);
+        }
+        CompressVectorTrack(mTracks[i * 3 + Translation], times, vectorValues, settings.translationTolerance, mMaxTranslationError);
+
+        times.clear(); vectorValues.clear();
+        for (const Keyframe<XMFLOAT3>& key : boneAnimation.scale) {
+            times.push_back(key.timePos);
+            vectorValues.push_back(key.value);
+        }
+        CompressVectorTrack(mTracks[i * 3 + Scale], times, vectorValues, settings.scaleTolerance, mMaxScaleError);
+
+        times.clear(); rotationValues.clear();
+        for (const Keyframe<XMFLOAT4>& key : boneAnimation.rotationQuat) {
+            times.push_back(key.timePos);
+            rotationValues.push_back(key.value);
+        }
+        CompressRotationTrack(mTracks[i * 3 + Rotation], times, rotationValues, settings.rotationTolerance, mMaxRotationError);
+    }
+
+    for (const CompressedTrack& track : mTracks)
+        mNumTracks[(int)track.format]++;
+
+    mTimes.shrink_to_fit();
+    mQuantizedValues.shrink_to_fit();
+    mRawValues.shrink_to_fit();
+}
+
+UINT CompressedClip::AddTimes(const vector<float>& times)
+{
+    // 대부분의 트랙은 같은 시간에 키를 가지므로 이미 저장된 시간 배열이 있으면 공유한다.
+    // 압축 중인 트랙은 아직 Constant 상태라 비교 대상에서 빠진다.
+    for (const CompressedTrack& track : mTracks)
+    {
+        if (track.format == TrackFormat::Constant || track.numKeys != times.size())
+            continue;
+        if (memcmp(&mTimes[track.timeOffset], times.data(), times.size() * sizeof(float)) == 0)
+            return track.timeOffset;
+    }
+
+    UINT offset = (UINT)mTimes.size();
+    mTimes.insert(mTimes.end(), times.begin(), times.end());
+    return offset;
+}
+
+void CompressedClip::CompressVectorTrack(CompressedTrack& track, const vector<float>& times, const vector<XMFLOAT3>& values, float tolerance, float& maxError)
+{
+    assert(!values.empty() && times.size() == values.size());
+
+    // 모든 키가 첫 키와 허용 오차 안에 있으면 상수 트랙
+    XMVECTOR first = XMLoadFloat3(&values[0]);
+    XMVECTOR minimum = first;
+    XMVECTOR maximum = first;
+    float constantError = 0.0f;
+    for (const XMFLOAT3& value : values) {
+        XMVECTOR v = XMLoadFloat3(&value);
+        minimum = XMVectorMin(minimum, v);
+        maximum = XMVectorMax(maximum, v);
+        constantError = max(constantError, MaxComponentError(v, first));
+    }
+
+    if (constantError <= tolerance) {
+        track.format = TrackFormat::Constant;
+        track.numKeys = 1;
+        track.valueOffset = (UINT)mRawValues.size();
+        mRawValues.insert(mRawValues.end(), { values[0].x, values[0].y, values[0].z });
+        maxError = max(maxError, constantError);
+        return;
+    }
+
+    track.timeOffset = AddTimes(times);
+    track.numKeys = (UINT)values.size();
+    XMStoreFloat3(&track.rangeMin, minimum);
+    XMStoreFloat3(&track.rangeExtent, maximum - minimum);
+
+    // 범위 양자화 후 키 위치의 오차를 확인한다.
+    vector<uint16_t> quantized(values.size() * 3);
+    const float* rangeMin = &track.rangeMin.x;
+    const float* rangeExtent = &track.rangeExtent.x;
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        const float* v = &values[i].x;
+        for (int c = 0; c < 3; c++) {
+            float normalized = (rangeExtent[c] > 0.0f) ? (v[c] - rangeMin[c]) / rangeExtent[c] : 0.0f;
+            quantized[i * 3 + c] = (uint16_t)lroundf(MathHelper::Clamp(normalized, 0.0f, 1.0f) * QUANTIZE_16BIT);
+        }
+    }
+
+    track.format = TrackFormat::Quantized;
+    track.valueOffset = (UINT)mQuantizedValues.size();
+    mQuantizedValues.insert(mQuantizedValues.end(), quantized.begin(), quantized.end());
+
+    float quantizeError = 0.0f;
+    for (size_t i = 0; i < values.size(); i++)
+        quantizeError = max(quantizeError, MaxComponentError(DecodeVector(track, (int)i), XMLoadFloat3(&values[i])));
+
+    // 허용 오차를 넘으면 원본 그대로 저장한다.
+    if (quantizeError > tolerance) {
+        mQuantizedValues.resize(track.valueOffset);
+        track.format = TrackFormat::Raw;
+        track.valueOffset = (UINT)mRawValues.size();
+        for (const XMFLOAT3& value : values)
+            mRawValues.insert(mRawValues.end(), { value.x, value.y, value.z });
+        quantizeError = 0.0f;
+    }
+
+    maxError = max(maxError, quantizeError);
+}
+
+void CompressedClip::CompressRotationTrack(CompressedTrack& track, const vector<float>& times, const vector<XMFLOAT4>& values, float tolerance, float& maxError)
+{
+    assert(!values.empty() && times.size() == values.size());
+
+    vector<XMFLOAT4> normalized(values.size());
+    for (size_t i = 0; i < values.size(); i++)
+        XMStoreFloat4(&normalized[i], XMQuaternionNormalize(XMLoadFloat4(&values[i])));
+
+    XMVECTOR first = XMLoadFloat4(&normalized[0]);
+    float constantError = 0.0f;
+    for (const XMFLOAT4& value : normalized)
+        constantError = max(constantError, RotationError(XMLoadFloat4(&value), first));
+
+    if (constantError <= tolerance) {
+        track.format = TrackFormat::Constant;
+        track.numKeys = 1;
+        track.valueOffset = (UINT)mRawValues.size();
+        mRawValues.insert(mRawValues.end(), { normalized[0].x, normalized[0].y, normalized[0].z, normalized[0].w });
+        maxError = max(maxError, constantError);
+        return;
+    }
+
+    track.timeOffset = AddTimes(times);
+    track.numKeys = (UINT)values.size();
+    track.format = TrackFormat::Quantized;
+    track.valueOffset = (UINT)mQuantizedValues.size();
+    mQuantizedValues.resize(mQuantizedValues.size() + values.size() * 3);
+    for (size_t i = 0; i < values.size(); i++)
+        EncodeQuaternion(normalized[i], &mQuantizedValues[track.valueOffset + i * 3]);
+
+    float quantizeError = 0.0f;
+    for (size_t i = 0; i < values.size(); i++)
+        quantizeError = max(quantizeError, RotationError(DecodeRotation(track, (int)i), XMLoadFloat4(&normalized[i])));
+
+    if (quantizeError > tolerance) {
+        mQuantizedValues.resize(track.valueOffset);
+        track.format = TrackFormat::Raw;
+        track.valueOffset = (UINT)mRawValues.size();
+        for (const XMFLOAT4& value : normalized)
+            mRawValues.insert(mRawValues.end(), { value.x, value.y, value.z, value.w });
+        quantizeError = 0.0f;
+    }
+
+    maxError = max(maxError, quantizeError);
+}
+
+XMVECTOR CompressedClip::DecodeVector(const CompressedTrack& track, int key) const
+{
+    if (track.format == TrackFormat::Quantized) {
+        const uint16_t* q = &mQuantizedValues[track.valueOffset + key * 3];
+        XMVECTOR normalized = XMVectorSet(q[0], q[1], q[2], 0.0f) / QUANTIZE_16BIT;
+        return XMVectorMultiplyAdd(normalized, XMLoadFloat3(&track.rangeExtent), XMLoadFloat3(&track.rangeMin));
+    }
+
+    return XMLoadFloat3((const XMFLOAT3*)&mRawValues[track.valueOffset + key * 3]);
+}
+
+XMVECTOR CompressedClip::DecodeRotation(const CompressedTrack& track, int key) const
+{
+    if (track.format == TrackFormat::Quantized)
+        return DecodeQuaternion(&mQuantizedValues[track.valueOffset + key * 3]);
+
+    return XMLoadFloat4((const XMFLOAT4*)&mRawValues[track.valueOffset + key * 4]);
+}
+
+int CompressedClip::FindKey(const CompressedTrack& track, float animationTime, int& cursor, float& factor) const
+{
+    const float* times = &mTimes[track.timeOffset];
+    int index = FindKeyIndex((int)track.numKeys, animationTime, cursor, [times](int i) { return times[i]; });
+
+    factor = MathHelper::Clamp((animationTime - times[index]) / (times[index + 1] - times[index]), 0.0f, 1.0f);
+    return index;
+}
+
+XMVECTOR CompressedClip::SampleTranslation(int channelIndex, float animationTime, int& cursor) const
+{
+    const CompressedTrack& track = mTracks[channelIndex * 3 + Translation];
+    if (track.format == TrackFormat::Constant)
+        return DecodeVector(track, 0);
+
+    float factor;
+    int index = FindKey(track, animationTime, cursor, factor);
+    return XMVectorLerp(DecodeVector(track, index), DecodeVector(track, index + 1), factor);
+}
+
+XMVECTOR CompressedClip::SampleScale(int channelIndex, float animationTime, int& cursor) const
+{
+    const CompressedTrack& track = mTracks[channelIndex * 3 + Scale];
+    if (track.format == TrackFormat::Constant)
+        return DecodeVector(track, 0);
+
+    float factor;
+    int index = FindKey(track, animationTime, cursor, factor);
+    return XMVectorLerp(DecodeVector(track, index), DecodeVector(track, index + 1), factor);
+}
+
+XMVECTOR CompressedClip::SampleRotation(int channelIndex, float animationTime, int& cursor) const
+{
+    const CompressedTrack& track = mTracks[channelIndex * 3 + Rotation];
+    if (track.format == TrackFormat::Constant)
+        return DecodeRotation(track, 0);
+
+    float factor;
+    int index = FindKey(track, animationTime, cursor, factor);
+    return XMQuaternionSlerp(DecodeRotation(track, index), DecodeRotation(track, index + 1), factor);
+}
+
+void CompressedClip::SampleRotationKeys(int channelIndex, float animationTime, int& cursor, XMVECTOR& start, XMVECTOR& end, float& factor) const
+{
+    const CompressedTrack& track = mTracks[channelIndex * 3 + Rotation];
+    if (track.format == TrackFormat::Constant) {
+        start = end = DecodeRotation(track, 0);
+        factor = 0.0f;
+        return;
+    }
+
+    int index = FindKey(track, animationTime, cursor, factor);
+    start = DecodeRotation(track, index);
+    end = DecodeRotation(track, index + 1);
+}
+
+template <typename T>
+static CookedSpan AppendStream(vector<T>& dst, const vector<T>& src)
+{
+    CookedSpan span;
+    span.first = (uint32_t)dst.size();
+    span.count = (uint32_t)src.size();
+    dst.insert(dst.end(), src.begin(), src.end());
+    return span;
+}
+
+template <typename T>
+static void AssignStream(vector<T>& dst, const T* src, const CookedSpan& span)
+{
+    dst.assign(src + span.first, src + span.first + span.count);
+}
+
+void CompressedClip::Save(CookedCompressedClip& out, vector<CompressedTrack>& tracks, vector<float>& times, vector<uint16_t>& quantizedValues, vector<float>& rawValues) const
+{
+    out.tracks = AppendStream(tracks, mTracks);
+    out.times = AppendStream(times, mTimes);
+    out.quantizedValues = AppendStream(quantizedValues, mQuantizedValues);
+    out.rawValues = AppendStream(rawValues, mRawValues);
+
+    out.maxTranslationError = mMaxTranslationError;
+    out.maxScaleError = mMaxScaleError;
+    out.maxRotationError = mMaxRotationError;
+    for (int i = 0; i < 3; i++)
+        out.numTracks[i] = mNumTracks[i];
+}
+
+void CompressedClip::Load(const CookedModelFile& file, const CookedCompressedClip& in)
+{
+    const CookedModelHeader& header = file.Header();
+    AssignStream(mTracks, file.Array<CompressedTrack>(header.compressedTracks), in.tracks);
+    AssignStream(mTimes, file.Array<float>(header.compressedTimes), in.times);
+    AssignStream(mQuantizedValues, file.Array<uint16_t>(header.quantizedValues), in.quantizedValues);
+    AssignStream(mRawValues, file.Array<float>(header.rawValues), in.rawValues);
+
+    mMaxTranslationError = in.maxTranslationError;
+    mMaxScaleError = in.maxScaleError;
+    mMaxRotationError = in.maxRotationError;
+    for (int i = 0; i < 3; i++)
+        mNumTracks[i] = in.numTracks[i];
+}
+
+bool CompressedClip::IsValidCooked(const CookedModelFile& file, const CookedCompressedClip& in, UINT numChannels)
+{
+    if ((uint64_t)in.tracks.count != (uint64_t)numChannels * 3)
+        return false;
+
+    const CompressedTrack* tracks = file.Array<CompressedTrack>(file.Header().compressedTracks) + in.tracks.first;
+    for (UINT i = 0; i < in.tracks.count; i++)
+    {
+        const CompressedTrack& track = tracks[i];
+        const uint64_t rawValueCount = (i % 3 == Rotation) ? 4 : 3;     // 키 하나의 float 수
+        switch (track.format)
+        {
+        case TrackFormat::Constant:
+            if (track.valueOffset + rawValueCount > in.rawValues.count)
+                return false;
+            break;
+        case TrackFormat::Quantized:
+        case TrackFormat::Raw:
+        {
+            // 상수가 아닌 트랙은 키 구간(index, index + 1)을 보간하므로 키가 두 개 이상이다.
+            const uint64_t valueCount = (uint64_t)track.numKeys * (track.format == TrackFormat::Quantized ? 3 : rawValueCount);
+            const uint64_t streamCount = (track.format == TrackFormat::Quantized) ? in.quantizedValues.count : in.rawValues.count;
+            if (track.numKeys < 2 || (uint64_t)track.timeOffset + track.numKeys > in.times.count || track.valueOffset + valueCount > streamCount)
+                return false;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t CompressedClip::ByteSize() const
+{
+    return mTracks.size() * sizeof(CompressedTrack) + mTimes.size() * sizeof(float)
+        + mQuantizedValues.size() * sizeof(uint16_t) + mRawValues.size() * sizeof(float);
+}
+
+size_t CompressedClip::SourceByteSize(const vector<BoneAnimation>& channels)
+{
+    size_t byteSize = channels.size() * sizeof(BoneAnimation);
+    for (const BoneAnimation& boneAnimation : channels)
+    {
+        byteSize += boneAnimation.translation.size() * sizeof(Keyframe<XMFLOAT3>);
+        byteSize += boneAnimation.scale.size() * sizeof(Keyframe<XMFLOAT3>);
+        byteSize += boneAnimation.rotationQuat.size() * sizeof(Keyframe<XMFLOAT4>);
+    }
+    return byteSize;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "d3dUtil.h"
+#include <cstdint>
+
+using namespace DirectX;
+using namespace std;
+
+struct BoneAnimation;
+struct CookedCompressedClip;
+class CookedModelFile;
+
+float RotationError(FXMVECTOR a, FXMVECTOR b);
+
+// 압축 허용 오차
+// 키 위치에서의 오차가 허용 오차를 넘는 트랙은 양자화하지 않고 원본 float로 저장한다.
+// 키 사이의 값은 두 키의 보간이므로 오차도 두 키의 오차를 넘지 않는다.
+struct AnimationCompressionSettings
+{
+    float translationTolerance = 0.001f;    // 모델 공간 단위
+    float scaleTolerance = 0.0001f;
+    float rotationTolerance = 0.0005f;      // 라디안
+};
+
+enum class TrackFormat : uint8_t
+{
+    Constant,   // 값 하나 (mRawValues)
+    Quantized,  // 키마다 uint16 3개 (mQuantizedValues)
+    Raw         // 키마다 float 3/4개 (mRawValues)
+};
+
+// 압축된 트랙 하나
+// 시간과 값은 각각 클립 전체가 공유하는 스트림에 연속으로 저장된다. (SoA)
+struct CompressedTrack
+{
+    TrackFormat format = TrackFormat::Constant;
+    UINT numKeys = 0;
+    UINT timeOffset = 0;    // mTimes 시작 위치, 같은 시간 배열을 가진 트랙끼리 공유한다.
+    UINT valueOffset = 0;   // format에 따라 mQuantizedValues 또는 mRawValues 시작 위치
+
+    // 이동/크기 양자화 범위 : value = rangeMin + rangeExtent * q / 65535
+    XMFLOAT3 rangeMin = { 0.0f, 0.0f, 0.0f };
+    XMFLOAT3 rangeExtent = { 0.0f, 0.0f, 0.0f };
+};
+
+// SoA + 양자화로 압축한 애니메이션 클립
+// 회전은 smallest-three 48비트, 이동/크기는 트랙별 범위 16비트로 양자화하고 변하지 않는 트랙은 값 하나만 남긴다.
+class CompressedClip
+{
+public:
+    void Compress(const vector<BoneAnimation>& channels, const AnimationCompressionSettings& settings);
+
+    XMVECTOR SampleTranslation(int channelIndex, float animationTime, int& cursor) const;
+    XMVECTOR SampleScale(int channelIndex, float animationTime, int& cursor) const;
+    XMVECTOR SampleRotation(int channelIndex, float animationTime, int& cursor) const;
+    void SampleRotationKeys(int channelIndex, float animationTime, int& cursor, XMVECTOR& start, XMVECTOR& end, float& factor) const;
+
+    // 쿡 파일 : 스트림을 파일 배열 끝에 이어 붙이고, 읽을 때는 구간을 통째로 복사한다.
+    void Save(CookedCompressedClip& out, vector<CompressedTrack>& tracks, vector<float>& times, vector<uint16_t>& quantizedValues, vector<float>& rawValues) const;
+    void Load(const CookedModelFile& file, const CookedCompressedClip& in);
+    // 쿡 파일의 트랙이 채널마다 세 개이고 시간과 값이 클립의 스트림 구간 안을 가리키는지 (구간 자체는 부르는 쪽에서 확인한다.)
+    static bool IsValidCooked(const CookedModelFile& file, const CookedCompressedClip& in, UINT numChannels);
+
+    size_t ByteSize() const;
+    static size_t SourceByteSize(const vector<BoneAnimation>& channels);
+
+    // 압축 결과 (로그용)
+    float mMaxTranslationError = 0.0f;
+    float mMaxScaleError = 0.0f;
+    float mMaxRotationError = 0.0f;
+    int mNumTracks[3] = { 0 };  // TrackFormat 별 트랙 수
+
+private:
+    enum TrackType { Translation = 0, Scale = 1, Rotation = 2 };
+
+    UINT AddTimes(const vector<float>& times);
+    void CompressVectorTrack(CompressedTrack& track, const vector<float>& times, const vector<XMFLOAT3>& values, float tolerance, float& maxError);
+    void CompressRotationTrack(CompressedTrack& track, const vector<float>& times, const vector<XMFLOAT4>& values, float tolerance, float& maxError);
+
+    XMVECTOR DecodeVector(const CompressedTrack& track, int key) const;
+    XMVECTOR DecodeRotation(const CompressedTrack& track, int key) const;
+    int FindKey(const CompressedTrack& track, float animationTime, int& cursor, float& factor) const;
+
+    vector<CompressedTrack> mTracks;    // 채널 * 3 + TrackType
+    vector<float> mTimes;
+    vector<uint16_t> mQuantizedValues;
+    vector<float> mRawValues;
+};
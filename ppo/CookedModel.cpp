@@ -0,0 +1,159 @@
+#include "CookedModel.h"
+#include <fstream>
+
+static const size_t COOKED_ALIGNMENT = 16;
+
+bool GetCookedSourceStamp(const string& filename, uint64_t& lastWriteTime, uint64_t& fileSize)
+{
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(filename.c_str(), GetFileExInfoStandard, &data))
+        return false;
+
+    lastWriteTime = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+    fileSize = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    return true;
+}
+
+CookedModelWriter::CookedModelWriter()
+{
+    // 헤더 자리
+    mBytes.resize(sizeof(CookedModelHeader));
+}
+
+CookedRange CookedModelWriter::Write(const void* data, size_t count, size_t elementSize)
+{
+    mBytes.resize((mBytes.size() + COOKED_ALIGNMENT - 1) / COOKED_ALIGNMENT * COOKED_ALIGNMENT);
+
+    CookedRange range;
+    range.offset = mBytes.size();
+    range.count = count;
+
+    size_t byteSize = count * elementSize;
+    mBytes.resize(mBytes.size() + byteSize);
+    if (byteSize > 0)
+        memcpy(&mBytes[(size_t)range.offset], data, byteSize);
+
+    return range;
+}
+
+CookedString CookedModelWriter::AddString(const string& str)
+{
+    auto found = mStringTable.find(str);
+    if (found != mStringTable.end())
+        return found->second;
+
+    CookedString cooked;
+    cooked.offset = (uint32_t)mStrings.size();
+    cooked.length = (uint32_t)str.size();
+    mStrings.insert(mStrings.end(), str.begin(), str.end());
+
+    mStringTable[str] = cooked;
+    return cooked;
+}
+
+bool CookedModelWriter::Save(const string& filename, CookedModelHeader& header)
+{
+    header.strings = Write(mStrings);
+    memcpy(mBytes.data(), &header, sizeof(CookedModelHeader));
+
+    // 쓰다가 실패해도 불완전한 파일이 남지 않도록 임시 파일에 쓰고 바꾼다.
+    string tempFilename = filename + ".tmp";
+    bool written = false;
+    {
+        ofstream file(tempFilename, ios::binary | ios::trunc);
+        if (!file)
+            return false;
+        file.write(mBytes.data(), mBytes.size());
+        file.close();
+        written = !file.fail();
+    }
+    if (!written) {
+        remove(tempFilename.c_str());
+        return false;
+    }
+
+    // 기존 파일을 한 번에 바꾼다. (지우고 이름을 바꾸면 그 사이에 파일이 없거나, 이름 바꾸기가 실패하면 기존 파일을 잃는다.)
+    if (!MoveFileExA(tempFilename.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        remove(tempFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+CookedModelFile::~CookedModelFile()
+{
+    Close();
+}
+
+bool CookedModelFile::Open(const string& filename)
+{
+    Close();
+
+    mFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (mFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(mFile, &fileSize) || fileSize.QuadPart < (long long)sizeof(CookedModelHeader)) {
+        Close();
+        return false;
+    }
+    mSize = (uint64_t)fileSize.QuadPart;
+
+    mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping == nullptr) {
+        Close();
+        return false;
+    }
+
+    mView = reinterpret_cast<const BYTE*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+    if (mView == nullptr) {
+        Close();
+        return false;
+    }
+
+    // 나머지 배열은 원소 형식을 아는 쪽(SkinnedMesh::LoadCooked)에서 확인한다.
+    const CookedModelHeader& header = Header();
+    bool valid = header.magic == COOKED_MODEL_MAGIC && header.version == COOKED_MODEL_VERSION
+        && IsValidRange(header.sources, sizeof(CookedSource))
+        && IsValidRange(header.strings, sizeof(char));
+
+    if (!valid) {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void CookedModelFile::Close()
+{
+    if (mView != nullptr)
+        UnmapViewOfFile(mView);
+    if (mMapping != nullptr)
+        CloseHandle(mMapping);
+    if (mFile != INVALID_HANDLE_VALUE)
+        CloseHandle(mFile);
+
+    mView = nullptr;
+    mMapping = nullptr;
+    mFile = INVALID_HANDLE_VALUE;
+    mSize = 0;
+}
+
+string CookedModelFile::String(const CookedString& str) const
+{
+    const CookedRange& strings = Header().strings;
+    if ((uint64_t)str.offset + str.length > strings.count)
+        return string();
+
+    return string(Array<char>(strings) + str.offset, str.length);
+}
+
+bool CookedModelFile::IsValidRange(const CookedRange& range, size_t elementSize) const
+{
+    if (range.count == 0)
+        return true;
+
+    return range.offset % COOKED_ALIGNMENT == 0 && range.offset <= mSize && range.count <= (mSize - range.offset) / elementSize;
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "Mesh.h"
+#include "CompressedClip.h"
+#include <cstdint>
+#include <map>
+
+using namespace DirectX;
+using namespace std;
+
+// 쿡된 스키닝 모델 파일 (.skm)
+// Assimp로 읽은 SkinnedMesh의 상태를 그대로 저장해 두고, 실행할 때는 파일을 메모리에 매핑해 배열 단위로만 복사한다.
+// 모든 배열은 16바이트 정렬된 위치에 원소를 그대로(POD) 저장하며, 구조가 바뀌면 COOKED_MODEL_VERSION을 올린다.
+#define COOKED_MODEL_MAGIC 0x314D4B53      // "SKM1"
+#define COOKED_MODEL_VERSION 2
+
+// 파일 안의 배열 : 파일 시작 기준 바이트 위치와 원소 수
+struct CookedRange
+{
+    uint64_t offset = 0;
+    uint64_t count = 0;
+};
+
+// 파일 배열 안의 일부 구간 (원소 인덱스)
+struct CookedSpan
+{
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
+
+// 문자열 테이블 안의 문자열
+struct CookedString
+{
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+// 쿡할 때 사용한 원본 파일, 바뀌었으면 다시 쿡해야 한다.
+struct CookedSource
+{
+    CookedString path;
+    uint64_t lastWriteTime = 0;
+    uint64_t fileSize = 0;
+};
+
+struct CookedSubmesh
+{
+    CookedString name;
+    UINT baseVertex = 0;
+    UINT baseIndex = 0;
+    UINT numIndices = 0;
+    UINT materialIndex = 0;
+    BoundingBox bounds;
+};
+
+// mNodeHierarchy 원소, 자식 이름은 nodeChildren의 구간
+struct CookedNode
+{
+    CookedString name;
+    CookedSpan children;
+};
+
+// 뼈 id 순서, 자식 뼈 id는 boneChildren의 구간
+struct CookedBone
+{
+    CookedString name;              // mBoneNameToIndexMap의 이름
+    CookedString hierarchyName;     // mBoneHierarchy의 이름
+    CookedSpan children;
+    XMFLOAT4X4 offsetMatrix;
+};
+
+struct CookedChannel
+{
+    CookedString nodeName;
+    CookedSpan translation;     // vectorKeys
+    CookedSpan scale;           // vectorKeys
+    CookedSpan rotation;        // rotationKeys
+};
+
+struct CookedCompressedClip
+{
+    CookedSpan tracks;
+    CookedSpan times;
+    CookedSpan quantizedValues;
+    CookedSpan rawValues;
+
+    float maxTranslationError = 0.0f;
+    float maxScaleError = 0.0f;
+    float maxRotationError = 0.0f;
+    int numTracks[3] = { 0 };
+};
+
+struct CookedClip
+{
+    CookedString name;
+    float tickPerSecond = 0.0f;
+    float duration = 0.0f;
+    uint32_t enableRootMotion = 0;
+    uint32_t isCompressed = 0;
+    uint32_t hasSourceKeyframes = 0;
+    CookedSpan channels;
+    CookedCompressedClip compressed;
+};
+
+// 애니메이션 압축 설정, 지금 설정(플래그와 압축 허용 오차)과 다르게 쿡된 파일은 사용하지 않는다.
+#define COOKED_ANIMATION_COMPRESSED     0x01
+#define COOKED_ANIMATION_KEEP_SOURCE    0x02
+
+struct CookedModelHeader
+{
+    uint32_t magic = COOKED_MODEL_MAGIC;
+    uint32_t version = COOKED_MODEL_VERSION;
+    uint32_t vertexStride = 0;          // sizeof(SkinnedVertex)
+    uint32_t animationFlags = 0;
+
+    // 압축해 쿡했으면 그때의 AnimationCompressionSettings 허용 오차, 아니면 0
+    float translationTolerance = 0.0f;
+    float scaleTolerance = 0.0f;
+    float rotationTolerance = 0.0f;
+    uint32_t padding = 0;
+
+    CookedRange sources;                // CookedSource
+    CookedRange strings;                // char
+    CookedString rootNodeName;
+
+    // 그대로 업로드할 수 있는 정점/인덱스
+    CookedRange vertices;               // SkinnedVertex
+    CookedRange indices;                // UINT
+
+    // Mesh / SkinnedMesh 멤버
+    CookedRange positions;              // XMFLOAT3
+    CookedRange normals;                // XMFLOAT3
+    CookedRange texCoords;              // XMFLOAT2
+    CookedRange vertexBones;            // VertexBoneData
+    CookedRange submeshes;              // CookedSubmesh
+    CookedRange nodes;                  // CookedNode
+    CookedRange nodeChildren;           // CookedString
+    CookedRange bones;                  // CookedBone
+    CookedRange boneChildren;           // int
+
+    // 애니메이션
+    CookedRange clips;                  // CookedClip
+    CookedRange channels;               // CookedChannel
+    CookedRange vectorKeys;             // Keyframe<XMFLOAT3>
+    CookedRange rotationKeys;           // Keyframe<XMFLOAT4>
+    CookedRange compressedTracks;       // CompressedTrack
+    CookedRange compressedTimes;        // float
+    CookedRange quantizedValues;        // uint16_t
+    CookedRange rawValues;              // float
+};
+
+// 원본 파일의 수정 시각과 크기, 파일이 없으면 false
+bool GetCookedSourceStamp(const string& filename, uint64_t& lastWriteTime, uint64_t& fileSize);
+
+// 쿡 파일 쓰기
+// 배열을 파일 끝에 이어 붙이고 헤더는 Save에서 맨 앞에 쓴다.
+class CookedModelWriter
+{
+public:
+    CookedModelWriter();
+
+    template <typename T>
+    CookedRange Write(const vector<T>& data) { return Write(data.data(), data.size(), sizeof(T)); }
+    CookedRange Write(const void* data, size_t count, size_t elementSize);
+
+    // 같은 문자열은 한 번만 저장한다.
+    CookedString AddString(const string& str);
+
+    bool Save(const string& filename, CookedModelHeader& header);
+
+private:
+    vector<char> mBytes;
+    vector<char> mStrings;
+    map<string, CookedString> mStringTable;
+};
+
+// 쿡 파일 읽기
+// 파일 전체를 읽기 전용으로 매핑하며, 반환하는 포인터는 Close 전까지 유효하다.
+class CookedModelFile
+{
+public:
+    CookedModelFile() = default;
+    CookedModelFile(const CookedModelFile& rhs) = delete;
+    CookedModelFile& operator=(const CookedModelFile& rhs) = delete;
+    ~CookedModelFile();
+
+    // 매직, 버전, 원본/문자열 배열 범위를 확인하고 맞지 않으면 false
+    bool Open(const string& filename);
+    void Close();
+    bool IsOpen() const { return mView != nullptr; }
+
+    const CookedModelHeader& Header() const { return *reinterpret_cast<const CookedModelHeader*>(mView); }
+
+    template <typename T>
+    const T* Array(const CookedRange& range) const { return reinterpret_cast<const T*>(mView + range.offset); }
+    string String(const CookedString& str) const;
+
+    const SkinnedVertex* Vertices() const { return Array<SkinnedVertex>(Header().vertices); }
+    UINT NumVertices() const { return (UINT)Header().vertices.count; }
+    const UINT* Indices() const { return Array<UINT>(Header().indices); }
+    UINT NumIndices() const { return (UINT)Header().indices.count; }
+
+    // 배열이 파일 안에 있고 정렬되어 있는지 확인한다.
+    bool IsValidRange(const CookedRange& range, size_t elementSize) const;
+    template <typename T>
+    bool IsValidRange(const CookedRange& range) const { return IsValidRange(range, sizeof(T)); }
+
+private:
+    HANDLE mFile = INVALID_HANDLE_VALUE;
+    HANDLE mMapping = nullptr;
+    const BYTE* mView = nullptr;
+    uint64_t mSize = 0;
+};
@@ -2134,6 +2134,32 @@ HRESULT DirectX::CreateDDSTextureFromFile( ID3D11Device* d3dDevice,
                                        texture, textureView, alphaMode );
 }
 
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::LoadDDSTextureDataFromFile12(const wchar_t* szFileName,
+	std::unique_ptr<uint8_t[]>& ddsData,
+	size_t& ddsDataSize)
+{
+	ddsDataSize = 0;
+
+	if (!szFileName)
+	{
+		return E_INVALIDARG;
+	}
+
+	DDS_HEADER* header = nullptr;
+	uint8_t* bitData = nullptr;
+	size_t bitSize = 0;
+
+	HRESULT hr = LoadTextureDataFromFile(szFileName, ddsData, &header, &bitData, &bitSize);
+	if (SUCCEEDED(hr))
+	{
+		ddsDataSize = (bitData - ddsData.get()) + bitSize;
+	}
+
+	return hr;
+}
+
 HRESULT DirectX::CreateDDSTextureFromFile12(_In_ ID3D12Device* device,
 	_In_ ID3D12GraphicsCommandList* cmdList,
 	_In_z_ const wchar_t* szFileName,
@@ -29,6 +29,7 @@
 #pragma warning(push)
 #pragma warning(disable : 4005)
 #include <stdint.h>
+#include <memory>
 
 #pragma warning(pop)
 
@@ -92,6 +93,13 @@ namespace DirectX
 		                               _Out_opt_ DDS_ALPHA_MODE* alphaMode = nullptr
 		                               );
 
+	// Reads a DDS file and validates its header without touching the device, so it can run on a worker thread.
+	// Pass the result to CreateDDSTextureFromMemory12 to create the texture and record the upload.
+	HRESULT LoadDDSTextureDataFromFile12(_In_z_ const wchar_t* szFileName,
+		                                 _Out_ std::unique_ptr<uint8_t[]>& ddsData,
+		                                 _Out_ size_t& ddsDataSize
+		                                 );
+
     // Standard version with optional auto-gen mipmap support
     HRESULT CreateDDSTextureFromMemory( _In_ ID3D11Device* d3dDevice,
                                         _In_opt_ ID3D11DeviceContext* d3dContext,
@@ -1,8 +1,35 @@
 
 #include "DummyApp.h"
+#include "Benchmark.h"
+
+// 정의하면 초기화할 때 성능 측정을 실행하고 결과를 출력 창에 기록한다.
+//#define _WITH_BENCHMARK
 
 const int gNumFrameResources = 3;
 
+// 플레이어 외에 배치할 애니메이션 캐릭터 수
+const int gNumCrowdCharacters = 16;
+
+// 실행 중에 만드는 오브젝트(잘린 상자와 조각, 파인 구)가 쓸 수 있는 ObjectCB 자리 수
+const int gNumRuntimeObjCBs = 64;
+
+// 실행 중에 만드는 기하(절단 조각)를 올리는 힙과 업로드 링의 크기
+const UINT64 gGeometryHeapByteSize = 64 * 1024 * 1024;
+const UINT64 gGeometryUploadRingByteSize = 16 * 1024 * 1024;
+
+// 스키닝 모델 원본 (메시, 애니메이션 순서)과 쿡 파일
+const std::vector<std::string> gSkinnedModelFiles =
+{
+	"Models/SKM_Quinn_Simple.FBX",
+	"Models/MF_Idle.FBX",
+	"Models/MF_Walk.FBX",
+	"Models/MF_Run.FBX",
+	"Models/MM_Jump.FBX",
+	"Models/MM_Fall.FBX",
+	"Models/MM_Land.FBX"
+};
+const std::string gCookedSkinnedModelFile = "Models/SKM_Quinn_Simple.skm";
+
 DummyApp::DummyApp(HINSTANCE hInstance)
 	: D3DApp(hInstance)
 {
@@ -16,36 +43,38 @@ DummyApp::~DummyApp()
 
 bool DummyApp::Initialize()
 {
+	auto startupStart = Benchmark::Clock::now();
+
 	if (!D3DApp::Initialize())
 		return false;
 
-	// ʱȭ   ɸ 缳ϴ.
+	// 초기화 명령을 위해 명령목록을 재설정하다.
 	ThrowIfFailed(mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr));
 
-	//    ִ   ũ⸦ ɴϴ. ̴ ϵ  ٸ.
+	// 이 힙 유형에 있는 설명자의 증분 크기를 가져옵니다. 이는 하드웨어에 따라 다르다.
 	mCbvSrvDescriptorSize = md3dDevice->
 		GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
-	LoadTextures();
+	LoadAssets();
+	mGeometryHeap.Initialize(md3dDevice.Get(), gGeometryHeapByteSize, gGeometryUploadRingByteSize);
 	BuildRootSignature();
 	BuildDescriptorHeaps();
 	BuildShadersAndInputLayout();
-	BuildShapeGeometry();
-	LoadSkinnedModel();
-	LoadTerrain();
 	BuildMaterials();
 	BuildGameObjects();
 	BuildFrameResources();
 	BuildPSOs();
 
-	// ʱȭ  
+	// 초기화 명령 실행
 	ThrowIfFailed(mCommandList->Close());
 	ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
 	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
-	// ʱȭ ɵ  óǱ ٸ.
+	// 초기화 명령들이 모두 처리되기 기다린다.
 	FlushCommandQueue();
 
+	Benchmark::Log("[Startup] total %.2f ms\n", Benchmark::ElapsedMs(startupStart));
+
 	return true;
 }
 
@@ -53,8 +82,8 @@ void DummyApp::OnResize()
 {
 	D3DApp::OnResize();
 
-	// â ũⰡ Ǿ  Ⱦ ϰ
-	//  ٽ Ѵ.
+	// 창의 크기가 변경되었기 때문에 종횡비를 갱신하고
+	// 투영행렬을 다시 계산한다.
 	if (!mCamera) {
 		mCamera = new Camera;
 	}
@@ -68,12 +97,17 @@ void DummyApp::Update(const GameTimer& gt)
 
 	mPlayer->Update(gt);
 
-	// ȯ ڿ  迭  ҿ Ѵ.
+	// 플레이어가 아닌 캐릭터는 각자의 시간으로 재생한다.
+	for (auto& skinnedModelInst : mSkinnedModelInsts)
+		if (skinnedModelInst.get() != mPlayer->GetSkinnedModelInst())
+			skinnedModelInst->Advance(gt.DeltaTime());
+
+	// 순환적으로 자원 프레임 배열의 다음 원소에 접근한다.
 	mCurrFrameResourceIndex = (mCurrFrameResourceIndex + 1) % gNumFrameResources;
 	mCurrFrameResource = mFrameResources[mCurrFrameResourceIndex].get();
 
-	// GPU   ڿ ɵ  óߴ Ȯ
-	//   ó ʾ GPU  Ÿ  ɵ ó  ٸ.
+	// GPU가 현재 프레임 자원의 명령들을 다 처리했는지 확인
+	// 아직 다 처리하지 않았으면 GPU가 이 울타리 지점까지의 명령들을 처리할 때까지 기다린다.
 	if (mCurrFrameResource->Fence != 0 && mFence->GetCompletedValue() < mCurrFrameResource->Fence)
 	{
 		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
@@ -82,7 +116,12 @@ void DummyApp::Update(const GameTimer& gt)
 		CloseHandle(eventHandle);
 	}
 
-	// mCurrFrameResource ڿ 
+	// 끝난 절단 결과를 올리고 장면에 넣는다. 이번 프레임의 Draw에서 복사한 뒤 그린다.
+	UploadSliceResults();
+
+	UpdateTerrainLod();
+
+	// mCurrFrameResource의 자원 갱신
 	AnimateMaterials(gt);
 	UpdateObjectCBs(gt);
 	UpdateSkinnedCBs(gt);
@@ -94,13 +133,13 @@ void DummyApp::Draw(const GameTimer& gt)
 {
 	auto cmdListAlloc = mCurrFrameResource->CmdListAlloc;
 
-	//  Ͽ õ ޸ Ȱ   Ҵ 缳
-	// 缳 GPU    ó Ŀ Ͼ.
+	// 명령 기록에 관련된 메모리의 재활용을 위해 명령 할당자 재설정
+	// 재설정은 GPU가 명령 목록을 모두 처리한 후에 일어난다.
 	ThrowIfFailed(cmdListAlloc->Reset());
 
-	//   ExecuteCommandList ؼ  ⿭
-	// ߰ߴٸ   缳  ִ. 
-	//   缺ϸ ޸𸮰 Ȱȴ.
+	// 명령 목록을 ExecuteCommandList를 통해서 명령 대기열에
+	// 추가했다면 명령 목록을 재설정할 수 있다. 
+	// 명령 목록을 재성정하면 메모리가 재활용된다.
 	if (mIsWireframe)
 	{
 		ThrowIfFailed(mCommandList->Reset(cmdListAlloc.Get(), mPSOs["opaque_wireframe"].Get()));
@@ -114,19 +153,22 @@ void DummyApp::Draw(const GameTimer& gt)
 		ThrowIfFailed(mCommandList->Reset(cmdListAlloc.Get(), mPSOs["opaque"].Get()));
 	}
 
-	// Ʈ  簢 Ѵ.
+	// 이번 프레임에 올린 기하를 그리기 전에 GeometryHeap으로 복사한다.
+	mGeometryHeap.RecordCopies(mCommandList.Get());
+
+	// 뷰포트와 가위 직사각형을 설정한다.
 	mCommandList->RSSetViewports(1, &mScreenViewport);
 	mCommandList->RSSetScissorRects(1, &mScissorRect);
 
-	// ڿ 뵵 õ  ̸ D3D Ѵ.
+	// 자원 용도에 관련된 상태 전이를 D3D에 통지한다.
 	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
 		D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
 
-	// ĸ ,  ۸ .
+	// 후면 버퍼, 깊이 버퍼를 지운다.
 	mCommandList->ClearRenderTargetView(CurrentBackBufferView(), Colors::LightSteelBlue, 0, nullptr);
 	mCommandList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
 
-	//   ϵ   ۵ Ѵ.
+	// 렌더링 결과가 기록될 렌더 대상 버퍼들을 지정한다.
 	mCommandList->OMSetRenderTargets(1, &CurrentBackBufferView(), true, &DepthStencilView());
 
 
@@ -139,8 +181,8 @@ void DummyApp::Draw(const GameTimer& gt)
 	auto passCB = mCurrFrameResource->PassCB->Resource();
 	mCommandList->SetGraphicsRootConstantBufferView(2, passCB->GetGPUVirtualAddress());
 
-	//  鿡 ̴   ´.
-	//  ۴  ϰ ׳ ϳ Ʈ ڷ   ִ.
+	// 이 장면에 쓰이는 모든 재질을 묶는다.
+	// 구조적 버퍼는 힙을 생략하고 그냥 하나의 루트 서술자로 묶을 수 있다.
 	auto matBuffer = mCurrFrameResource->MaterialBuffer->Resource();
 	mCommandList->SetGraphicsRootShaderResourceView(3, matBuffer->GetGPUVirtualAddress());
 
@@ -149,12 +191,13 @@ void DummyApp::Draw(const GameTimer& gt)
 	mCommandList->SetGraphicsRootDescriptorTable(4, skyTexDescriptor);
 
 
-	//  鿡 ̴  ؽó ´. 
-	// ̺ ù ڸ ϸ ȴ.
-	// ̺   ڰ ִ Ʈ  Ǿ ִ.
+	// 이 장면에 쓰이는 모든 텍스처를 묶는다. 
+	// 테이블의 첫 서술자만 지정하면 된다.
+	// 테이블에 몇 개의 서술자가 있는지는 루트 서명에 설정되어 있다.
 	mCommandList->SetGraphicsRootDescriptorTable(5, mSrvDescriptorHeap->GetGPUDescriptorHandleForHeapStart());
 
 	DrawGameObjects(mCommandList.Get(), mGameObjectLayer[(int)RenderLayer::Opaque]);
+	DrawTerrain(mCommandList.Get());
 
 	mCommandList->SetPipelineState(mPSOs["skinnedOpaque"].Get());
 	DrawGameObjects(mCommandList.Get(), mGameObjectLayer[(int)RenderLayer::SkinnedOpaque]);
@@ -163,28 +206,31 @@ void DummyApp::Draw(const GameTimer& gt)
 	DrawGameObjects(mCommandList.Get(), mGameObjectLayer[(int)RenderLayer::Sky]);
 
 
-	// ڿ 뵵 õ  ̸ D3D Ѵ.
+	// 자원 용도에 관련된 상태 전이를 D3D에 통지한다.
 	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
 		D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
 
-	//   ģ.
+	// 명령 기록을 마친다.
 	ThrowIfFailed(mCommandList->Close());
 
-	//       ⿭ ߰Ѵ.
+	// 명령 실행을 위해 명령 목록을 명령 대기열에 추가한다.
 	ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
 	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
-	// ĸۿ ۸ ٲ۴.
+	// 후면버퍼와 전면버퍼를 바꾼다.
 	ThrowIfFailed(mSwapChain->Present(0, 0));
 	mCurrBackBuffer = (mCurrBackBuffer + 1) % SwapChainBufferCount;
 
-	//  Ÿ  ɵ ǥϵ Ÿ  Ų.
+	// 현재 울타리 지점까지의 명령들을 표시하도록 울타리 값을 전진시킨다.
 	mCurrFrameResource->Fence = ++mCurrentFence;
 
-	//  Ÿ  ϴ  ɴ⿭ ߰Ѵ.
-	//  츮 GPU ð  Ƿ, Ÿ  GPU  Signal() 
-	// ɱ   óϱ   ʴ´.
+	// 새 울타리 지점을 설정하는 명령을 명령대기열에 추가한다.
+	// 지금 우리는 GPU 시간선 상에 있으므로, 새울타리 지점은 GPU가 이 Signal() 
+	// 명령까지의 모든 명령을 처리하기 전까지는 설정되지 않는다.
 	mCommandQueue->Signal(mFence.Get(), mCurrentFence);
+
+	// 이번 프레임에 쓴 업로드 링 구간은 GPU가 이 울타리를 지나면 다시 쓴다.
+	mGeometryHeap.EndFrame(mCurrentFence);
 }
 
 void DummyApp::OnMouseDown(WPARAM btnState, int x, int y)
@@ -248,12 +294,22 @@ bool DummyApp::OnKeyboardMessage(HWND hWnd, UINT nMessageID, WPARAM wParam, LPAR
 			mIsWireframe = false;
 			mIsToonShading = true;
 			return(false);
+		case 'G':
+			SliceCrowdCharacter();
+			return(false);
+		case 'C':
+			CarveCrater();
+			return(false);
 		case 'F':
-			int a = 5;
+			// 상자와 잘린 조각이 ObjectCB 자리를 하나씩 쓴다.
+			if (mNextObjCBIndex + 2 > mNumObjCBs) {
+				OutputDebugStringA("ObjectCB : no slot for a sliced box\n");
+				return(false);
+			}
 			XMFLOAT3 position;
 			XMStoreFloat3(&position, XMLoadFloat3(&mPlayer->GetPosition()) + XMLoadFloat3(&mPlayer->GetLook()) * 100.f);
 			auto gameObject = std::make_unique<GameObject>("box", XMMatrixScaling(50.f, 50.f, 50.f) * XMMatrixTranslation(position.x, position.y + 130.f, position.z), XMMatrixIdentity());
-			gameObject->SetCBIndex(a);
+			gameObject->SetCBIndex(mNextObjCBIndex);
 			gameObject->SetMesh(mMeshes["shapeGeo"].get());
 			gameObject->SetMaterial(mMaterials["tile0"].get());
 			gameObject->AddSubmesh(gameObject->GetMesh()->GetSubmesh("box"));
@@ -265,55 +321,59 @@ bool DummyApp::OnKeyboardMessage(HWND hWnd, UINT nMessageID, WPARAM wParam, LPAR
 			mAllGameObjects.push_back(std::move(gameObject));
 
 
-			vector<vector<Vertex>> vertices;
-			vector<vector<UINT>> indices;
-			int numMeshes = MeshSlice::MeshCompleteSlice(mMeshes["shapeGeo"].get(), mMeshes["shapeGeo"].get()->mSubmeshes[0], XMFLOAT4(1.0f, 0.0f, 0.0f, 0.0f), vertices, indices);
-
-			// ʱȭ   ɸ 缳ϴ.
-			ThrowIfFailed(mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr));
-			for (int i = 0; i < numMeshes; i++)
-			{
-				const UINT vbByteSize = (UINT)vertices[i].size() * sizeof(Vertex);
-				const UINT ibByteSize = (UINT)indices[i].size() * sizeof(UINT);
+			// 상자를 세 축의 중심 평면으로 한 번에 잘라 8조각을 하나의 정점/인덱스 배열로 받는다.
+			// 자르기는 작업 스레드에서 하고, 메시는 끝난 뒤의 Update에서 GeometryHeap으로 올려 장면에 넣는다.
+			Mesh* shapeGeo = mMeshes["shapeGeo"].get();
+			Material* material = mMaterials["tile0"].get();
+			std::string meshName = "slicingMesh" + to_string(mNumSlicingMeshes++);
+			int slicesCBIndex = mNextObjCBIndex++;
+			mSliceWorker.Submit([this, shapeGeo, material, meshName, position, slicesCBIndex]() {
+				const XMFLOAT4 planes[] = { XMFLOAT4(1.0f, 0.0f, 0.0f, 0.0f), XMFLOAT4(0.0f, 1.0f, 0.0f, 0.0f), XMFLOAT4(0.0f, 0.0f, 1.0f, 0.0f) };
+				int numPieces = mMultiSliceContext.Slice(shapeGeo, shapeGeo->GetSubmesh("box"), planes);
+
+				// 조각을 중심에서 바깥쪽으로 벌려 놓은 사본을 한 메시로 만든다.
+				span<const Vertex> pieceVertices = mMultiSliceContext.Vertices();
+				span<const UINT> pieceIndices = mMultiSliceContext.Indices();
+				vector<Vertex> vertices(pieceVertices.begin(), pieceVertices.end());
+				for (int i = 0; i < numPieces; i++)
+				{
+					XMVECTOR offset = XMLoadFloat3(&mMultiSliceContext.PieceSubmeshes()[i].bounds.Center) * 0.5f;
+					size_t baseVertex = mMultiSliceContext.PieceVertices(i).data() - pieceVertices.data();
+					for (size_t j = baseVertex; j < baseVertex + mMultiSliceContext.PieceVertices(i).size(); j++)
+						XMStoreFloat3(&vertices[j].Pos, XMLoadFloat3(&vertices[j].Pos) + offset);
+				}
 
 				auto geo = std::make_unique<Mesh>();
-				geo->mName = "slicingMesh" + to_string(i);
-
-				geo->CreateBlob
-				(vertices[i], indices[i]);
-				geo->UploadBuffer(md3dDevice.Get(), mCommandList.Get(), vertices[i], indices[i]);
-
-				Submesh submesh;
-				submesh.name = "box";
-				submesh.baseVertex = 0;
-				submesh.baseIndex = 0;
-				submesh.numIndices = indices[i].size();
-				geo->mSubmeshes.push_back(submesh);
-
-				mMeshes[geo->mName] = std::move(geo);
-			}
-			// ʱȭ  
-			ThrowIfFailed(mCommandList->Close());
-			ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
-			mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
-
-			// ʱȭ ɵ  óǱ ٸ.
-			FlushCommandQueue();
-
-			for (int i = 0; i < 2; i++)
-			{
-				auto gameObject = std::make_unique<GameObject>("box", XMMatrixScaling(50.f, 50.f, 50.f) * XMMatrixTranslation(position.x + (i + 1) * 150.f, position.y + 130.f, position.z), XMMatrixIdentity());
-				gameObject->SetCBIndex(a);
-				string meshName = "slicingMesh" + to_string(i);
-				gameObject->SetMesh(mMeshes[meshName].get());
-				gameObject->SetMaterial(mMaterials["tile0"].get());
-				gameObject->AddSubmesh(gameObject->GetMesh()->GetSubmesh("box"));
-
-				gameObject->SetFrameDirty();
-
-				mGameObjectLayer[(int)RenderLayer::Opaque].push_back(gameObject.get());
-				mAllGameObjects.push_back(std::move(gameObject));
-			}
+				geo->mName = meshName;
+				geo->CreateBlob(vertices.data(), (UINT)vertices.size(), pieceIndices.data(), (UINT)pieceIndices.size());
+
+				// 전체를 한 번에 그리는 submesh와 조각별 submesh
+				geo->AddSubmesh("slices", (UINT)pieceIndices.size());
+				for (int i = 0; i < numPieces; i++)
+				{
+					Submesh submesh = mMultiSliceContext.PieceSubmeshes()[i];
+					submesh.name = "slice" + to_string(i);
+					geo->mSubmeshes.push_back(submesh);
+				}
+
+				SliceResult result;
+				result.mesh = std::move(geo);
+				result.vertexByteStride = sizeof(Vertex);
+				result.onUploaded = [this, material, position, slicesCBIndex](Mesh* mesh) {
+					int cbIndex = slicesCBIndex;
+					auto slicesGameObject = std::make_unique<GameObject>("box", XMMatrixScaling(50.f, 50.f, 50.f) * XMMatrixTranslation(position.x + 150.f, position.y + 130.f, position.z), XMMatrixIdentity());
+					slicesGameObject->SetCBIndex(cbIndex);
+					slicesGameObject->SetMesh(mesh);
+					slicesGameObject->SetMaterial(material);
+					slicesGameObject->AddSubmesh(mesh->GetSubmesh("slices"));
+
+					slicesGameObject->SetFrameDirty();
+
+					mGameObjectLayer[(int)RenderLayer::Opaque].push_back(slicesGameObject.get());
+					mAllGameObjects.push_back(std::move(slicesGameObject));
+				};
+				return result;
+			});
 			break;
 		}
 		return(false);
@@ -341,8 +401,8 @@ void DummyApp::UpdateObjectCBs(const GameTimer& gt)
 
 	for (auto& e : mAllGameObjects)
 	{
-		//  ٲ  cbuffer ڷḦ Ѵ.
-		// ̷   ڿ ؾѴ.
+		// 상수들이 바뀌었을 때에만 cbuffer 자료를 갱신한다.
+		// 이러한 갱신을 프레임 자원마다 수행해야한다.
 		if (e->GetFramesDirty() > 0)
 		{
 			XMMATRIX world = XMLoadFloat4x4(&e->GetWorld());
@@ -358,7 +418,7 @@ void DummyApp::UpdateObjectCBs(const GameTimer& gt)
 				currObjectCB->CopyData(e->GetObjCBIndex(i), objConstants);
 			}
 
-			//   ڿ Ѿ.
+			// 다음 프레임 자원으로 넘어간다.
 			e->DecreaseFrameDirty();
 		}
 	}
@@ -368,22 +428,23 @@ void DummyApp::UpdateSkinnedCBs(const GameTimer& gt)
 {
 	auto currSkinnedCB = mCurrFrameResource->SkinnedCB.get();
 
-	std::vector<XMFLOAT4X4> boneTransforms;
-	mSkinnedMesh.GetBoneTransforms(mPlayer->GetAnimationTime(), boneTransforms, mPlayer->GetAnimationIndex());
-	SkinnedConstants skinnedConstants;
-
-	int numBones = boneTransforms.size();
-	for (int i = 0; i < numBones; i++)
+	// 각 인스턴스의 포즈를 현재 프레임 자원의 SkinnedCB 슬롯에 바로 계산해 넣는다.
+	mPoseJobs.clear();
+	for (auto& gameObj : mGameObjectLayer[(int)RenderLayer::SkinnedOpaque])
 	{
-		skinnedConstants.BoneTransforms[i] = boneTransforms[i];
-	}
-	// ּ 4  ʱȭ
-	if (numBones < 4) {
-		for (int i = numBones; i < 4; i++)
-			skinnedConstants.BoneTransforms[i] = Matrix4x4::Identity();
+		SkinnedModelInstance* skinnedModelInst = gameObj->GetSkinnedModelInst();
+		if (skinnedModelInst == nullptr)
+			continue;
+
+		assert(skinnedModelInst->SkinnedInfo->NumBones() <= _countof(SkinnedConstants::BoneTransforms));
+
+		PoseJob job;
+		job.instance = skinnedModelInst;
+		job.out = reinterpret_cast<XMFLOAT4X4*>(currSkinnedCB->MappedData(gameObj->GetSkinnedCBIndex()));
+		mPoseJobs.push_back(job);
 	}
 
-	currSkinnedCB->CopyData(0, skinnedConstants);
+	EvaluatePoses(mThreadPool, mPoseJobs.data(), (int)mPoseJobs.size());
 }
 
 void DummyApp::UpdateMaterialCBs(const GameTimer& gt)
@@ -391,8 +452,8 @@ void DummyApp::UpdateMaterialCBs(const GameTimer& gt)
 	auto currMaterialCB = mCurrFrameResource->MaterialBuffer.get();
 	for (auto& e : mMaterials)
 	{
-		//  ٲ  cbuffer ڷḦ Ѵ.
-		// ̷   ڿ ؾѴ.
+		// 상수들이 바뀌었을 때에만 cbuffer 자료를 갱신한다.
+		// 이러한 갱신을 프레임 자원마다 수행해야한다.
 		Material* mat = e.second.get();
 		if (mat->NumFramesDirty > 0)
 		{
@@ -469,8 +530,10 @@ void DummyApp::UpdateMainPassCB(const GameTimer& gt)
 	currPassCB->CopyData(0, mMainPassCB);
 }
 
-void DummyApp::LoadTextures()
+void DummyApp::LoadAssets()
 {
+	StagedAssets assets;
+
 	std::vector<std::string> texNames =
 	{
 		"missing",
@@ -491,29 +554,140 @@ void DummyApp::LoadTextures()
 		L"Textures/grasscube1024.dds"
 	};
 
-	for (int i = 0; i < (int)texNames.size(); ++i)
+	int numTextures = (int)texNames.size();
+	assets.Textures.resize(numTextures);
+	for (int i = 0; i < numTextures; ++i)
 	{
-		//  ̸ ؽó  ʵѴ.
-		if (mTextures.find(texNames[i]) == std::end(mTextures))
+		assets.Textures[i].Name = texNames[i];
+		assets.Textures[i].Filename = texFilenames[i];
+	}
+
+	// 작업마다 한 칸 : 오래 걸리는 스키닝 모델과 지형을 먼저 나눠 준다.
+	enum { SkinnedModelTask, TerrainTask, ShapeGeometryTask, FirstTextureTask };
+	std::vector<AssetLoadTiming> timings(FirstTextureTask + numTextures);
+	timings[SkinnedModelTask].Name = "SkinnedModel";
+	timings[TerrainTask].Name = "Terrain";
+	timings[ShapeGeometryTask].Name = "ShapeGeometry";
+	for (int i = 0; i < numTextures; ++i)
+		timings[FirstTextureTask + i].Name = assets.Textures[i].Name.c_str();
+
+	// 1. CPU 작업 : 각 작업은 자기 자원만 건드리며 GPU 명령은 기록하지 않는다.
+	auto loadStart = Benchmark::Clock::now();
+	mThreadPool.ParallelFor((int)timings.size(), 1, [&](int begin, int end) {
+		for (int i = begin; i < end; ++i)
 		{
-			auto texMap = std::make_unique<Texture>();
-			texMap->Name = texNames[i];
-			texMap->Filename = texFilenames[i];
-			ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-				mCommandList.Get(), texMap->Filename.c_str(),
-				texMap->Resource, texMap->UploadHeap));
-
-			mTextures[texMap->Name] = std::move(texMap);
+			auto start = Benchmark::Clock::now();
+			if (i == SkinnedModelTask)
+				LoadSkinnedModel(assets);
+			else if (i == TerrainTask)
+				LoadTerrain(assets.Terrain);
+			else if (i == ShapeGeometryTask)
+				BuildShapeGeometry(assets.Shapes);
+			else
+				LoadTexture(assets.Textures[i - FirstTextureTask]);
+			timings[i].LoadMs = Benchmark::ElapsedMs(start);
 		}
+	});
+	double loadMs = Benchmark::ElapsedMs(loadStart);
+
+	// 2. 업로드 : 메인 스레드에서 텍스처, 도형, 스키닝 모델, 지형 순서로 명령 목록에 기록한다.
+	auto uploadStart = Benchmark::Clock::now();
+	for (int i = 0; i < numTextures; ++i)
+	{
+		auto start = Benchmark::Clock::now();
+		UploadTexture(assets.Textures[i]);
+		timings[FirstTextureTask + i].UploadMs = Benchmark::ElapsedMs(start);
 	}
+
+	auto start = Benchmark::Clock::now();
+	UploadShapeGeometry(assets.Shapes);
+	timings[ShapeGeometryTask].UploadMs = Benchmark::ElapsedMs(start);
+
+	start = Benchmark::Clock::now();
+	UploadSkinnedModel(assets);
+	timings[SkinnedModelTask].UploadMs = Benchmark::ElapsedMs(start);
+
+	start = Benchmark::Clock::now();
+	UploadTerrain(assets.Terrain);
+	timings[TerrainTask].UploadMs = Benchmark::ElapsedMs(start);
+	double uploadMs = Benchmark::ElapsedMs(uploadStart);
+
+	double serialLoadMs = 0.0;
+	for (const AssetLoadTiming& timing : timings)
+	{
+		serialLoadMs += timing.LoadMs;
+		Benchmark::Log("[Startup] %-20s load %8.2f ms, upload %6.2f ms\n", timing.Name, timing.LoadMs, timing.UploadMs);
+	}
+	Benchmark::Log("[Startup] assets : load %.2f ms on %u threads (%.2f ms serial), upload %.2f ms\n",
+		loadMs, mThreadPool.NumThreads(), serialLoadMs, uploadMs);
+
+#ifdef _WITH_BENCHMARK
+	Benchmark::KeyframeSampling(mSkinnedMesh);
+	Benchmark::SkinnedMeshPose(mSkinnedMesh);
+	Benchmark::ClipCompression(mSkinnedMesh);
+	Benchmark::PoseKernelSampling(mSkinnedMesh);
+	Benchmark::PoseBlending(mSkinnedMesh);
+	Benchmark::BakedPoseCache(mSkinnedMesh);
+	Benchmark::PoseBatchScaling(mSkinnedMesh);
+	Benchmark::CookedModelLoad(gSkinnedModelFiles, gCookedSkinnedModelFile);
+	Benchmark::MeshSliceWatertight(mMeshes["shapeGeo"].get());
+	Benchmark::MeshSliceValidation(mMeshes["shapeGeo"].get());
+	Benchmark::MeshMultiSlice(mMeshes["shapeGeo"].get());
+	Benchmark::ConvexSlice(mMeshes["shapeGeo"].get());
+	Benchmark::SliceKernels();
+	// 지형 벤치마크는 CreateTerrain/CreatePatches로 조각과 지면 블록을 다시 만들므로 그리는 mTerrain 대신 같은 높이 맵으로 따로 만든 지형을 쓴다.
+	// 절단 벤치마크는 조각으로 나누기 전의 한 장 지형을 자른다.
+	Terrain benchTerrain;
+	benchTerrain.LoadHeightMap(L"HeightMap/heightmap.r16", 1025, 1025, 0.02f);
+	Mesh terrainGrid;
+	std::vector<Vertex> gridVertices;
+	std::vector<UINT> gridIndices;
+	benchTerrain.CreateTerrain(4000.0f, 4000.f, gridVertices, gridIndices, &mThreadPool);
+	terrainGrid.CreateBlob(gridVertices, gridIndices);
+	terrainGrid.AddSubmesh("terrain", (UINT)gridIndices.size());
+	Benchmark::HeightMapTiles(L"HeightMap/heightmap.r16", 1025, 1025, 0.02f);
+	Benchmark::TerrainSmoothing(benchTerrain, 4000.0f, 4000.f);
+	Benchmark::TerrainVertexFormat(benchTerrain, 4000.0f, 4000.f, gridVertices);
+	Benchmark::TerrainGroundQuery(benchTerrain, gridVertices);
+	Benchmark::TerrainLod(benchTerrain);
+	Benchmark::MeshSliceScaling(&terrainGrid);
+	Benchmark::SkinnedMeshSlice(mMeshes["skullGeo"].get(), mSkinnedMesh);
+	Benchmark::SliceFrameSpikes(mMeshes["shapeGeo"].get());
+	Benchmark::MeshSliceThroughput(mMeshes["shapeGeo"].get(), &terrainGrid);
+#endif
+}
+
+void DummyApp::LoadTexture(StagedTexture& texture)
+{
+	// 파일 읽기와 DDS 헤더 확인만 한다. 실패는 UploadTexture에서 보고한다.
+	texture.Result = DirectX::LoadDDSTextureDataFromFile12(texture.Filename.c_str(), texture.Data, texture.DataSize);
+}
+
+void DummyApp::UploadTexture(StagedTexture& texture)
+{
+	// 같은 이름의 텍스처가 생기지 않도록한다.
+	if (mTextures.find(texture.Name) != std::end(mTextures))
+		return;
+
+	ThrowIfFailed(texture.Result);
+
+	auto texMap = std::make_unique<Texture>();
+	texMap->Name = texture.Name;
+	texMap->Filename = texture.Filename;
+	ThrowIfFailed(DirectX::CreateDDSTextureFromMemory12(md3dDevice.Get(),
+		mCommandList.Get(), texture.Data.get(), texture.DataSize,
+		texMap->Resource, texMap->UploadHeap));
+
+	mTextures[texMap->Name] = std::move(texMap);
+	texture.Data.reset();
 }
 
 void DummyApp::BuildRootSignature()
 {
-	// Ϲ ̴ α׷ Ư ڿ( , ؽó, ǥ ) Էµȴٰ Ѵ.
-	// Ʈ  ̴ α׷ ϴ ڿ Ѵ.
-	// ̴ α׷  ϳ Լ̰ ̴ ԷµǴ ڿ 
-	// Լ Ű鿡 شϹǷ, Ʈ   Լ  ϴ ̶   ִ.
+	// 일반적으로 셰이더 프로그램은 특정 자원들(상수 버퍼, 텍스처, 표본추출기 등)이 입력된다고 기대한다.
+	// 루트 서명은 셰이더 프로그램이 기대하는 자원들을 정의한다.
+	// 셰이더 프로그램은 본질적으로 하나의 함수이고 셰이더에 입력되는 자원들은 
+	// 함수의 매개변수들에 해당하므로, 루트 서명은 곧 함수 서명을 정의하는 수단이라 할 수 있다.
 
 	CD3DX12_DESCRIPTOR_RANGE texTable0;
 	texTable0.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 0);
@@ -521,27 +695,29 @@ void DummyApp::BuildRootSignature()
 	CD3DX12_DESCRIPTOR_RANGE texTable1;
 	texTable1.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 5, 1, 0);
 
-	// Ʈ Ű  ̺̰ų Ʈ  Ǵ Ʈ ̴.
-	CD3DX12_ROOT_PARAMETER slotRootParameter[6];
+	// 루트 매개변수는 서술자 테이블이거나 루트 서술자 또는 루트 상수이다.
+	CD3DX12_ROOT_PARAMETER slotRootParameter[7];
 
-	// Ʈ CBV Ѵ.
-	//  : 󵵰 Ϳ   迭Ѵ.
+	// 루트 CBV 생성한다.
+	// 성능 팁: 사용빈도가 높은것에서 낮은것 순서대로 배열한다.
 	slotRootParameter[0].InitAsConstantBufferView(0);
 	slotRootParameter[1].InitAsConstantBufferView(1);
 	slotRootParameter[2].InitAsConstantBufferView(2);
 	slotRootParameter[3].InitAsShaderResourceView(0, 1);
 	slotRootParameter[4].InitAsDescriptorTable(1, &texTable0, D3D12_SHADER_VISIBILITY_PIXEL);
 	slotRootParameter[5].InitAsDescriptorTable(1, &texTable1, D3D12_SHADER_VISIBILITY_PIXEL);
+	// 지형 조각마다 바뀌는 조각 상수 (Terrain.hlsl의 cbTerrainPatch)
+	slotRootParameter[6].InitAsConstants(sizeof(TerrainPatchConstants) / 4, 3, 0, D3D12_SHADER_VISIBILITY_VERTEX);
 
 	auto staticSamplers = GetStaticSamplers();
 
-	// Ʈ  Ʈ Ű 迭̴.
-	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(6, slotRootParameter, 
+	// 루트 서명은 루트 매개변수들의 배열이다.
+	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(7, slotRootParameter, 
 		(UINT)staticSamplers.size(), staticSamplers.data(),
 		D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
-	//   ϳ    Ű
-	//  ϳ ̷ Ʈ  Ѵ.
+	// 상수 버퍼 하나로 구성된 서술자 구간을 가리키는
+	// 슬롯 하나로 이루어진 루트 서명을 생성한다.
 	ComPtr<ID3DBlob> serializedRootSig = nullptr;
 	ComPtr<ID3DBlob> errorBlob = nullptr;
 	HRESULT hr = D3D12SerializeRootSignature(&rootSigDesc, D3D_ROOT_SIGNATURE_VERSION_1,
@@ -562,16 +738,16 @@ void DummyApp::BuildRootSignature()
 
 void DummyApp::BuildDescriptorHeaps()
 {
-	// CBV, SRV, UAV Ҽְ, ̴   ִ  
+	// CBV, SRV, UAV를 저장할수있고, 셰이더들이 접근할 수 있는 힙을 생성
 	D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
 	srvHeapDesc.NumDescriptors = 6;
 	srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
 	srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
 	ThrowIfFailed(md3dDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&mSrvDescriptorHeap)));
 
-	// ؽó ڿ ̹ εǾ 
+	// 텍스처 자원이 이미 로드되어 있을때
 
-	//   Ű ͸ ´.
+	// 힙의 시작을 가리키는 포인터를 얻는다.
 	CD3DX12_CPU_DESCRIPTOR_HANDLE hDescriptor(mSrvDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
 
 	auto missingTex = mTextures["missing"]->Resource;
@@ -581,7 +757,7 @@ void DummyApp::BuildDescriptorHeaps()
 	auto terrainTex = mTextures["terrainDiffuseMap"]->Resource;
 	auto skyTex = mTextures["skyCubeMap"]->Resource;
 
-	// ؽó   ڵ տ   Ѵ.
+	// 텍스처에 대한 실제 서술자들을 앞에서 생성한 힙에 생성한다.
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 	srvDesc.Format = missingTex->GetDesc().Format;
@@ -591,35 +767,35 @@ void DummyApp::BuildDescriptorHeaps()
 	srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
 	md3dDevice->CreateShaderResourceView(missingTex.Get(), &srvDesc, hDescriptor);
 
-	//  ڷ Ѿ.
+	// 다음 서술자로 넘어간다.
 	hDescriptor.Offset(1, mCbvSrvDescriptorSize);
 
 	srvDesc.Format = bricksTex->GetDesc().Format;
 	srvDesc.Texture2D.MipLevels = bricksTex->GetDesc().MipLevels;
 	md3dDevice->CreateShaderResourceView(bricksTex.Get(), &srvDesc, hDescriptor);
 
-	//  ڷ Ѿ.
+	// 다음 서술자로 넘어간다.
 	hDescriptor.Offset(1, mCbvSrvDescriptorSize);
 
 	srvDesc.Format = stoneTex->GetDesc().Format;
 	srvDesc.Texture2D.MipLevels = stoneTex->GetDesc().MipLevels;
 	md3dDevice->CreateShaderResourceView(stoneTex.Get(), &srvDesc, hDescriptor);
 
-	//  ڷ Ѿ.
+	// 다음 서술자로 넘어간다.
 	hDescriptor.Offset(1, mCbvSrvDescriptorSize);
 
 	srvDesc.Format = tileTex->GetDesc().Format;
 	srvDesc.Texture2D.MipLevels = tileTex->GetDesc().MipLevels;
 	md3dDevice->CreateShaderResourceView(tileTex.Get(), &srvDesc, hDescriptor);
 
-	//  ڷ Ѿ.
+	// 다음 서술자로 넘어간다.
 	hDescriptor.Offset(1, mCbvSrvDescriptorSize);
 
 	srvDesc.Format = terrainTex->GetDesc().Format;
 	srvDesc.Texture2D.MipLevels = terrainTex->GetDesc().MipLevels;
 	md3dDevice->CreateShaderResourceView(terrainTex.Get(), &srvDesc, hDescriptor);
 
-	//  ڷ Ѿ. skyCubeMap
+	// 다음 서술자로 넘어간다. skyCubeMap
 	hDescriptor.Offset(1, mCbvSrvDescriptorSize);
 
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE;
@@ -651,6 +827,7 @@ void DummyApp::BuildShadersAndInputLayout()
 	mShaders["toonLightingOpaquePS"] = d3dUtil::CompileShader(L"Shaders\\ToonLighting.hlsl", nullptr, "PS", "ps_5_1");
 
 	mShaders["skinnedVS"] = d3dUtil::CompileShader(L"Shaders\\Default.hlsl", skinnedDefines, "VS", "vs_5_1");
+	mShaders["terrainVS"] = d3dUtil::CompileShader(L"Shaders\\Terrain.hlsl", nullptr, "VS", "vs_5_1");
 
 
 	mShaders["skyVS"] = d3dUtil::CompileShader(L"Shaders\\Sky.hlsl", nullptr, "VS", "vs_5_1");
@@ -673,9 +850,15 @@ void DummyApp::BuildShadersAndInputLayout()
 		{ "WEIGHTS", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{ "BONEINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 0, 44, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
+
+	// TerrainVertex : 16비트 높이와 팔면체 법선, XZ와 텍스처 좌표는 셰이더가 SV_VertexID로 만든다.
+	mTerrainInputLayout = {
+		{ "HEIGHT", 0, DXGI_FORMAT_R16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, DXGI_FORMAT_R8G8_SNORM, 0, 2, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+	};
 }
 
-void DummyApp::BuildShapeGeometry()
+void DummyApp::BuildShapeGeometry(StagedGeometry& shapes)
 {
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData box = geoGen.CreateBox(1.0f, 1.0f, 1.0f, 0);
@@ -735,7 +918,8 @@ void DummyApp::BuildShapeGeometry()
 		sphere.Vertices.size() +
 		cylinder.Vertices.size();
 
-	std::vector<Vertex> vertices(totalVertexCount);
+	std::vector<Vertex>& vertices = shapes.Vertices;
+	vertices.resize(totalVertexCount);
 
 	UINT k = 0;
 	for (size_t i = 0; i < box.Vertices.size(); ++i, ++k)
@@ -766,110 +950,76 @@ void DummyApp::BuildShapeGeometry()
 		vertices[k].TexC = cylinder.Vertices[i].TexC;
 	}
 
-	std::vector<UINT> indices;
+	std::vector<UINT>& indices = shapes.Indices;
 	indices.insert(indices.end(), std::begin(box.GetIndices16()), std::end(box.GetIndices16()));
 	indices.insert(indices.end(), std::begin(grid.GetIndices16()), std::end(grid.GetIndices16()));
 	indices.insert(indices.end(), std::begin(sphere.GetIndices16()), std::end(sphere.GetIndices16()));
 	indices.insert(indices.end(), std::begin(cylinder.GetIndices16()), std::end(cylinder.GetIndices16()));
 
-	const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
-	const UINT ibByteSize = (UINT)indices.size() * sizeof(UINT);
+	shapes.Submeshes.resize(4);
+	shapes.Submeshes[0] = boxSubmesh;
+	shapes.Submeshes[1] = gridSubmesh;
+	shapes.Submeshes[2] = sphereSubmesh;
+	shapes.Submeshes[3] = cylinderSubmesh;
+}
 
+void DummyApp::UploadShapeGeometry(StagedGeometry& shapes)
+{
 	auto geo = std::make_unique<Mesh>();
 	geo->mName = "shapeGeo";
-	
-	ThrowIfFailed(D3DCreateBlob(vbByteSize, &geo->mVertexBufferCPU));
-	CopyMemory(geo->mVertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
 
-	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->mIndexBufferCPU));
-	CopyMemory(geo->mIndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+	geo->CreateBlob(shapes.Vertices, shapes.Indices);
+	geo->UploadBuffer(md3dDevice.Get(), mCommandList.Get(), shapes.Vertices, shapes.Indices);
 
-	geo->mVertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->mVertexBufferUploader);
-
-	geo->mIndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->mIndexBufferUploader);
-
-	geo->mVertexByteStride = sizeof(Vertex);
-	geo->mVertexBufferByteSize = vbByteSize;
-	geo->mIndexFormat = DXGI_FORMAT_R32_UINT;
-	geo->mIndexBufferByteSize = ibByteSize;
-
-	geo->mSubmeshes.resize(4);
-	geo->mSubmeshes[0] = boxSubmesh;
-	geo->mSubmeshes[1] = gridSubmesh;
-	geo->mSubmeshes[2] = sphereSubmesh;
-	geo->mSubmeshes[3] = cylinderSubmesh;
+	geo->mSubmeshes = shapes.Submeshes;
 
 	mMeshes[geo->mName] = std::move(geo);
 }
 
-void DummyApp::LoadSkinnedModel()
+void DummyApp::LoadSkinnedModel(StagedAssets& assets)
 {
 	//mSkinnedMesh.LoadMesh("Models/model.dae");
 	
 	mSkinnedMesh.SetOffsetMatrix(XMFLOAT3(0.0f, 1.0f, 0.0f), 180.f, XMFLOAT3(1.0f, 0.0f, 0.0f), -90.f);
-	mSkinnedMesh.LoadMesh("Models/SKM_Quinn_Simple.FBX");
-	mSkinnedMesh.LoadAnimations("Models/MF_Idle.FBX");
-	mSkinnedMesh.LoadAnimations("Models/MF_Walk.FBX");
-	mSkinnedMesh.LoadAnimations("Models/MF_Run.FBX");
-	mSkinnedMesh.LoadAnimations("Models/MM_Jump.FBX");
-	mSkinnedMesh.LoadAnimations("Models/MM_Fall.FBX");
-	mSkinnedMesh.LoadAnimations("Models/MM_Land.FBX");
-
-	UINT vcount = 0;
-	UINT tcount = 0;
-	std::vector<SkinnedVertex> vertices;
-	std::vector<UINT> indices;
-	UINT index;
-	UINT dindex = 0;
-
-	UINT numVertices = mSkinnedMesh.mPositions.size();
-	for (int j = 0; j < numVertices; j++)
-	{
-		SkinnedVertex vertex;
-		vertex.Pos.x = mSkinnedMesh.mPositions[j].x;
-		vertex.Pos.y = mSkinnedMesh.mPositions[j].y;
-		vertex.Pos.z = mSkinnedMesh.mPositions[j].z;
-
-		vertex.Normal.x = mSkinnedMesh.mNormals[j].x;
-		vertex.Normal.y = mSkinnedMesh.mNormals[j].y;
-		vertex.Normal.z = mSkinnedMesh.mNormals[j].z;
-
-		vertex.TexC.x = mSkinnedMesh.mTexCoords[j].x;
-		vertex.TexC.y = mSkinnedMesh.mTexCoords[j].y;
-
-		vertices.push_back(vertex);
-	}
-
-	for (int i = 0; i < numVertices; i++)
-	{
-		vertices[i].BoneIndices[0] = (BYTE)mSkinnedMesh.mBones[i].BoneIDs[0];
-		vertices[i].BoneIndices[1] = (BYTE)mSkinnedMesh.mBones[i].BoneIDs[1];
-		vertices[i].BoneIndices[2] = (BYTE)mSkinnedMesh.mBones[i].BoneIDs[2];
-		vertices[i].BoneIndices[3] = (BYTE)mSkinnedMesh.mBones[i].BoneIDs[3];
-
-		float weights = mSkinnedMesh.mBones[i].Weights[0] + mSkinnedMesh.mBones[i].Weights[1] + mSkinnedMesh.mBones[i].Weights[2] + mSkinnedMesh.mBones[i].Weights[3];
-
-		vertices[i].BoneWeights.x = mSkinnedMesh.mBones[i].Weights[0] / weights;
-		vertices[i].BoneWeights.y = mSkinnedMesh.mBones[i].Weights[1] / weights;
-		vertices[i].BoneWeights.z = mSkinnedMesh.mBones[i].Weights[2] / weights;
+#ifdef _WITH_BENCHMARK
+	mSkinnedMesh.SetAnimationCompression(true, true);
+#else
+	mSkinnedMesh.SetAnimationCompression(true);
+#endif
+	// 쿡 파일이 원본보다 오래됐거나 없으면 FBX를 읽어 다시 쿡한다.
+	assets.IsSkinnedModelCooked = mSkinnedMesh.LoadCooked(gCookedSkinnedModelFile, gSkinnedModelFiles, assets.CookedSkinnedModel);
+	if (!assets.IsSkinnedModelCooked) {
+		mSkinnedMesh.LoadMesh(gSkinnedModelFiles[0]);
+		for (int i = 1; i < (int)gSkinnedModelFiles.size(); i++)
+			mSkinnedMesh.LoadAnimations(gSkinnedModelFiles[i]);
+
+		mSkinnedMesh.BuildSkinnedVertices(assets.SkinnedVertices);
+		if (!mSkinnedMesh.SaveCooked(gCookedSkinnedModelFile, gSkinnedModelFiles, assets.SkinnedVertices))
+			OutputDebugStringA("SkinnedMesh : failed to save cooked model\n");
 	}
 
-	UINT numIndices = mSkinnedMesh.mIndices.size();
-	for (UINT i = 0; i < numIndices; i++)
-	{
-		indices.push_back(mSkinnedMesh.mIndices[i]);
-	}
+	// 군중은 30Hz로 구운 포즈를 재생한다.
+	mSkinnedMesh.EnablePoseCache(30.0f, 8 * 1024 * 1024);
+}
 
+void DummyApp::UploadSkinnedModel(StagedAssets& assets)
+{
 	//
 	// Pack the indices of all the meshes into one index buffer.
 
 	auto geo = std::make_unique<SkinnedMesh>();
 	geo->mName = "skullGeo";
 
-	geo->CreateBlob(vertices, indices);
-	geo->UploadBuffer(md3dDevice.Get(), mCommandList.Get(), vertices, indices);
+	// 쿡 파일에서 읽었으면 매핑된 정점/인덱스를 그대로 올린다.
+	if (assets.IsSkinnedModelCooked) {
+		const CookedModelFile& cooked = assets.CookedSkinnedModel;
+		geo->CreateBlob(cooked.Vertices(), cooked.NumVertices(), cooked.Indices(), cooked.NumIndices());
+		geo->UploadBuffer(md3dDevice.Get(), mCommandList.Get(), cooked.Vertices(), cooked.NumVertices(), cooked.Indices(), cooked.NumIndices());
+	}
+	else {
+		geo->CreateBlob(assets.SkinnedVertices, mSkinnedMesh.mIndices);
+		geo->UploadBuffer(md3dDevice.Get(), mCommandList.Get(), assets.SkinnedVertices, mSkinnedMesh.mIndices);
+	}
 
 	Submesh submesh1 = mSkinnedMesh.mSubmeshes[0];
 	Submesh submesh2 = mSkinnedMesh.mSubmeshes[1];
@@ -880,29 +1030,34 @@ void DummyApp::LoadSkinnedModel()
 	mMeshes[geo->mName] = std::move(geo);
 }
 
-void DummyApp::LoadTerrain()
+void DummyApp::LoadTerrain(StagedTerrain& terrain)
 {
-	mTerrain.LoadHeightMap(L"HeightMap/heightmap.r16", 1025, 1025, 0.02f);
-	
-	UINT vcount = 1025 * 1025;
-	UINT tcount = 1024 * 1024 * 2 * 3;
-	
-	//
-	// Pack the indices of all the meshes into one index buffer.
-	//
-	
-	std::vector<Vertex> vertices(vcount);
-	std::vector<uint32_t> indices(tcount);
+	if (!mTerrain.LoadHeightMap(L"HeightMap/heightmap.r16", 1025, 1025, 0.02f))
+		OutputDebugStringA("[Startup] terrain : failed to map HeightMap/heightmap.r16\n");
 
-	mTerrain.CreateTerrain(4000.0f, 4000.f, vertices, indices);
+	// 65 x 65 정점 조각 16 x 16개의 압축 정점과 모든 조각이 함께 쓰는 LOD별 16비트 인덱스
+	// mThreadPool의 작업 안에서 불리므로 평탄화를 다시 mThreadPool로 나누지 않는다.
+	mTerrain.CreatePatches(4000.0f, 4000.f, terrain.Vertices, terrain.Indices);
+}
 
+void DummyApp::UploadTerrain(StagedTerrain& terrain)
+{
 	auto geo = std::make_unique<Mesh>();
 	geo->mName = "terrain";
 
-	geo->CreateBlob(vertices, indices);
-	geo->UploadBuffer(md3dDevice.Get(), mCommandList.Get(), vertices, indices);
+	// 정점 형식이 Vertex가 아니므로 CPU 복사본(blob)은 두지 않는다. CPU 쪽 높이는 mTerrain의 높이 맵을 쓴다.
+	geo->UploadBuffer(md3dDevice.Get(), mCommandList.Get(), terrain.Vertices.data(), (UINT)terrain.Vertices.size(), sizeof(TerrainVertex),
+		terrain.Indices.data(), (UINT)terrain.Indices.size(), DXGI_FORMAT_R16_UINT);
 
-	geo->AddSubmesh("terrain", indices.size());
+	// 조각은 DrawTerrain에서 고른 LOD의 인덱스 구간으로 그린다. submesh는 LOD 0 구간이다.
+	geo->AddSubmesh("terrain", mTerrain.GetLodNumIndices(0));
+
+	// 한 장 격자(Vertex, 32비트 인덱스)로 올렸을 때와 비교
+	UINT64 gridByteSize = mTerrain.GetGridByteSize();
+	UINT64 patchByteSize = geo->mVertexBufferByteSize + geo->mIndexBufferByteSize;
+	Benchmark::Log("[Startup] terrain : %u vertices + %u indices = %.2f MB (full grid %.2f MB, %.1fx smaller)\n",
+		(UINT)terrain.Vertices.size(), (UINT)terrain.Indices.size(), patchByteSize / (1024.0 * 1024.0), gridByteSize / (1024.0 * 1024.0),
+		(double)gridByteSize / patchByteSize);
 	
 	mMeshes[geo->mName] = std::move(geo);
 }
@@ -977,16 +1132,36 @@ void DummyApp::BuildPSOs()
 	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&toonShadingPsoDesc,
 		IID_PPV_ARGS(&mPSOs["opaque_toonShading"])));
 
+	//
+	// PSO for terrain patches. (opaque, wireframe, toon shading과 같은 픽셀 셰이더를 쓴다.)
+	//
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC terrainPsoDesc = opaquePsoDesc;
+	terrainPsoDesc.InputLayout = { mTerrainInputLayout.data(), (UINT)mTerrainInputLayout.size() };
+	terrainPsoDesc.VS =
+	{
+		reinterpret_cast<BYTE*>(mShaders["terrainVS"]->GetBufferPointer()),
+		mShaders["terrainVS"]->GetBufferSize()
+	};
+	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&terrainPsoDesc, IID_PPV_ARGS(&mPSOs["terrain"])));
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC terrainWireframePsoDesc = terrainPsoDesc;
+	terrainWireframePsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_WIREFRAME;
+	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&terrainWireframePsoDesc, IID_PPV_ARGS(&mPSOs["terrain_wireframe"])));
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC terrainToonShadingPsoDesc = terrainPsoDesc;
+	terrainToonShadingPsoDesc.PS = toonShadingPsoDesc.PS;
+	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&terrainToonShadingPsoDesc, IID_PPV_ARGS(&mPSOs["terrain_toonShading"])));
+
 	//
 	// PSO for sky.
 	//
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC skyPsoDesc = opaquePsoDesc;
 
-	// ī޶ ī ڽ ȿ ֱ⶧ ø ȰȭѴ.
+	// 카메라가 스카이 박스 안에 있기때문에 컬링을 비활성화한다.
 	skyPsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
 
-	//     ̺񱳸 LESS_EQUAL Ѵ.
-	// LESS ƴ :   ۸ 1   z = 1 ȭ ̰   Ѵ.
+	// 깊이 판정 통과를 위해 깊이비교를 LESS_EQUAL로 설정한다.
+	// LESS가 아닌 이유: 만약 깊이 버퍼를 1로 지우는 경우 z = 1에서 정규화된 깊이값이 깊이 판정에 실패한다.
 	skyPsoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
 	skyPsoDesc.pRootSignature = mRootSignature.Get();
 	skyPsoDesc.VS =
@@ -1004,15 +1179,14 @@ void DummyApp::BuildPSOs()
 
 void DummyApp::BuildFrameResources()
 {
-	UINT numObjCBs = 0;
-	for (auto& gameObj : mAllGameObjects)
-		numObjCBs += gameObj.get()->GetNumSubmeshes();
+	// BuildGameObjects가 쓴 자리 뒤에 실행 중에 만드는 오브젝트의 자리를 둔다.
+	mNumObjCBs = mNextObjCBIndex + gNumRuntimeObjCBs;
 
 	for (int i = 0; i < gNumFrameResources; ++i)
 	{
 		mFrameResources.push_back(std::make_unique<FrameResource>(md3dDevice.Get(),
 			1, 
-			numObjCBs + 10,
+			(UINT)mNumObjCBs,
 			(UINT)mGameObjectLayer[(int)RenderLayer::SkinnedOpaque].size(), // skinned obj
 			(UINT)mMaterials.size()));
 	}
@@ -1107,13 +1281,15 @@ void DummyApp::BuildGameObjects()
 	// ------------------------------------------
 	// terrain
 	// ------------------------------------------
-	auto terrainGameObject = std::make_unique<GameObject>("terrain", XMMatrixTranslation(0.0f, -600.0f, 0.0f), XMMatrixIdentity());
+	// 지형 공간을 월드로 옮기는 위치 (플레이어와 군중은 이만큼 옮겨 지면 높이를 구한다.)
+	const XMFLOAT3 terrainOffset(0.0f, -600.0f, 0.0f);
+	auto terrainGameObject = std::make_unique<GameObject>("terrain", XMMatrixTranslation(terrainOffset.x, terrainOffset.y, terrainOffset.z), XMMatrixIdentity());
 	terrainGameObject->SetCBIndex(objCBIndex);
 	terrainGameObject->SetMesh(mMeshes["terrain"].get());
 	terrainGameObject->SetMaterial(mMaterials["terrainMat"].get());
 	terrainGameObject->AddSubmesh(terrainGameObject->GetMesh()->GetSubmesh("terrain"));
 
-	mGameObjectLayer[(int)RenderLayer::Opaque].push_back(terrainGameObject.get());
+	mGameObjectLayer[(int)RenderLayer::Terrain].push_back(terrainGameObject.get());
 	mAllGameObjects.push_back(std::move(terrainGameObject));
 
 	// ------------------------------------------
@@ -1147,19 +1323,282 @@ void DummyApp::BuildGameObjects()
 	// ------------------------------------------
 	// Skinned objects - player
 	// ------------------------------------------
+	mSkinnedModelInsts.push_back(std::make_unique<SkinnedModelInstance>(&mSkinnedMesh));
+
 	auto SkinnedGameObject = std::make_unique<Player>("skinned1", XMMatrixScaling(1.0f, 1.0f, 1.0f) * XMMatrixTranslation(0.0f, 0.0f, 0.0f), XMMatrixIdentity());
 	SkinnedGameObject->SetCBIndex(2, objCBIndex, skinnedCBIndex);
 	SkinnedGameObject->SetMesh(mMeshes["skullGeo"].get());
 	SkinnedGameObject->SetMaterials(2, { mMaterials["bricks0"].get(),  mMaterials["tile0"].get() });
 	SkinnedGameObject->AddSubmesh(SkinnedGameObject->GetMesh()->mSubmeshes[0]);
 	SkinnedGameObject->AddSubmesh(SkinnedGameObject->GetMesh()->mSubmeshes[1]);
+	SkinnedGameObject->SetSkinnedModelInst(mSkinnedModelInsts.back().get());
 
 	mPlayer = SkinnedGameObject.get();
+	mPlayer->SetTerrain(&mTerrain, terrainOffset);
 	mCamera = mPlayer->GetCamera();
 	mCamera->SetLens(0.25 * MathHelper::Pi, AspectRatio());
 
 	mGameObjectLayer[(int)RenderLayer::SkinnedOpaque].push_back(SkinnedGameObject.get());
 	mAllGameObjects.push_back(std::move(SkinnedGameObject));
+
+	// ------------------------------------------
+	// Skinned objects - crowd
+	// 같은 SkinnedMesh를 공유하고 인스턴스마다 클립(Idle/Walk/Run)과 시작 시간만 다르게 한다.
+	// ------------------------------------------
+	const int numCrowdColumns = 4;
+	const float crowdSpacing = 150.0f;
+	std::vector<XMFLOAT2> crowdPoints(gNumCrowdCharacters);
+	for (int i = 0; i < gNumCrowdCharacters; i++)
+	{
+		int row = i / numCrowdColumns;
+		int col = i % numCrowdColumns;
+		crowdPoints[i] = XMFLOAT2((col - (numCrowdColumns - 1) * 0.5f) * crowdSpacing - terrainOffset.x, 300.0f + row * crowdSpacing - terrainOffset.z);
+	}
+	// 군중은 지면 위에 세운다. (한 번에 질의)
+	std::vector<float> crowdGroundHeights(gNumCrowdCharacters);
+	mTerrain.GetGroundHeights(crowdPoints.data(), gNumCrowdCharacters, crowdGroundHeights.data());
+
+	for (int i = 0; i < gNumCrowdCharacters; i++)
+	{
+		float x = crowdPoints[i].x + terrainOffset.x;
+		float y = crowdGroundHeights[i] + terrainOffset.y;
+		float z = crowdPoints[i].y + terrainOffset.z;
+
+		mSkinnedModelInsts.push_back(std::make_unique<SkinnedModelInstance>(&mSkinnedMesh, i % 3, i * 0.37f));
+		mSkinnedModelInsts.back()->UseBakedPose = true;
+
+		auto crowdGameObject = std::make_unique<GameObject>("crowd" + std::to_string(i), XMMatrixTranslation(x, y, z), XMMatrixIdentity());
+		crowdGameObject->SetCBIndex(2, objCBIndex, skinnedCBIndex);
+		crowdGameObject->SetMesh(mMeshes["skullGeo"].get());
+		crowdGameObject->SetMaterials(2, { mMaterials["bricks0"].get(),  mMaterials["tile0"].get() });
+		crowdGameObject->AddSubmesh(crowdGameObject->GetMesh()->mSubmeshes[0]);
+		crowdGameObject->AddSubmesh(crowdGameObject->GetMesh()->mSubmeshes[1]);
+		crowdGameObject->SetSkinnedModelInst(mSkinnedModelInsts.back().get());
+
+		mGameObjectLayer[(int)RenderLayer::SkinnedOpaque].push_back(crowdGameObject.get());
+		mAllGameObjects.push_back(std::move(crowdGameObject));
+	}
+
+	mNextObjCBIndex = objCBIndex;
+}
+
+void DummyApp::SliceCrowdCharacter()
+{
+	// 아직 자르지 않은 다음 군중 캐릭터를 지금 포즈의 모델 공간 x = 0 평면으로 자른다.
+	// 조각은 bind pose 정점이므로 같은 인스턴스로 계속 재생하고, 두 조각을 평면 법선 방향으로 조금 벌려 놓는다.
+	// 포즈는 요청할 때 복사해 두고 자르기는 작업 스레드에서 한다.
+	std::vector<GameObject*>& skinnedGameObjects = mGameObjectLayer[(int)RenderLayer::SkinnedOpaque];
+	if (1 + mNumSlicedCrowd >= (int)skinnedGameObjects.size())
+		return;
+
+	GameObject* crowdGameObject = skinnedGameObjects[1 + mNumSlicedCrowd];
+	SkinnedModelInstance* skinnedModelInst = crowdGameObject->GetSkinnedModelInst();
+	skinnedModelInst->UpdateSkinnedAnimation();
+
+	Mesh* skinnedGeo = mMeshes["skullGeo"].get();
+	std::string meshName = "slicedSkinnedMesh" + to_string(mNumSlicedCrowd++);
+	mSliceWorker.Submit([this, crowdGameObject, skinnedGeo, meshName, boneTransforms = skinnedModelInst->FinalTransforms]() {
+		const XMFLOAT4 plane(1.0f, 0.0f, 0.0f, 0.0f);
+		const float pieceGap = 8.0f;
+
+		// 원본 submesh마다 두 조각을 한 submesh로 묶는다.
+		std::vector<SkinnedVertex> vertices;
+		std::vector<UINT> indices;
+		UINT submeshBaseIndices[2];
+		UINT submeshNumIndices[2];
+		for (int i = 0; i < 2; i++)
+		{
+			submeshBaseIndices[i] = (UINT)indices.size();
+			int numPieces = mSkinnedSliceContext.Slice(skinnedGeo, skinnedGeo->mSubmeshes[i], plane, boneTransforms);
+			for (int piece = 0; piece < numPieces; piece++)
+			{
+				UINT baseVertex = (UINT)vertices.size();
+				XMVECTOR offset = XMVectorSet(plane.x, plane.y, plane.z, 0.0f) * ((piece == 0) ? pieceGap : -pieceGap);
+				for (const SkinnedVertex& pieceVertex : mSkinnedSliceContext.PieceVertices(piece))
+				{
+					vertices.push_back(pieceVertex);
+					XMStoreFloat3(&vertices.back().Pos, XMLoadFloat3(&pieceVertex.Pos) + offset);
+				}
+				for (UINT index : mSkinnedSliceContext.PieceIndices(piece))
+					indices.push_back(baseVertex + index);
+			}
+			submeshNumIndices[i] = (UINT)indices.size() - submeshBaseIndices[i];
+		}
+
+		auto geo = std::make_unique<SkinnedMesh>();
+		geo->mName = meshName;
+		geo->CreateBlob(vertices, indices);
+		for (int i = 0; i < 2; i++)
+			geo->AddSubmesh(skinnedGeo->mSubmeshes[i].name, submeshNumIndices[i], 0, submeshBaseIndices[i]);
+
+		SliceResult result;
+		result.mesh = std::move(geo);
+		result.vertexByteStride = sizeof(SkinnedVertex);
+		result.onUploaded = [crowdGameObject](Mesh* mesh) {
+			crowdGameObject->SetMesh(mesh);
+			crowdGameObject->ClearSubmeshes();
+			for (const Submesh& submesh : mesh->mSubmeshes)
+				crowdGameObject->AddSubmesh(submesh);
+			crowdGameObject->SetFrameDirty();
+		};
+		return result;
+	});
+}
+
+void DummyApp::CarveCrater()
+{
+	// 플레이어 앞에 구를 놓고 윗면에 중심을 둔 14-DOP를 빼서 움푹 팬 자리를 만든다.
+	// 벽면은 잘라 낸 부분의 절단면을 뒤집은 것이므로 구멍 없이 닫혀 있다. 자르기는 작업 스레드에서 한다.
+	if (mNextObjCBIndex >= mNumObjCBs) {
+		OutputDebugStringA("ObjectCB : no slot for a crater\n");
+		return;
+	}
+
+	XMFLOAT3 position;
+	XMStoreFloat3(&position, XMLoadFloat3(&mPlayer->GetPosition()) + XMLoadFloat3(&mPlayer->GetLook()) * 100.f);
+
+	Mesh* shapeGeo = mMeshes["shapeGeo"].get();
+	Material* material = mMaterials["tile0"].get();
+	std::string meshName = "craterMesh" + to_string(mNumSlicingMeshes++);
+	int craterCBIndex = mNextObjCBIndex++;
+	mSliceWorker.Submit([this, shapeGeo, material, meshName, position, craterCBIndex]() {
+		Submesh sphere = shapeGeo->GetSubmesh("sphere");
+		XMFLOAT3 center(sphere.bounds.Center.x, sphere.bounds.Center.y + sphere.bounds.Extents.y, sphere.bounds.Center.z);
+
+		std::vector<XMFLOAT3> directions = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+		for (float x : { -1.0f, 1.0f })
+			for (float y : { -1.0f, 1.0f })
+				for (float z : { -1.0f, 1.0f })
+					directions.push_back(XMFLOAT3(x, y, z));
+		std::vector<XMFLOAT4> planes;
+		MeshSlice::BuildKDopPlanes(center, directions, sphere.bounds.Extents.y * 0.4f, planes);
+
+		mConvexSliceContext.Subtract(shapeGeo, sphere, planes);
+		span<const Vertex> vertices = mConvexSliceContext.Vertices();
+		span<const UINT> indices = mConvexSliceContext.Indices();
+
+		auto geo = std::make_unique<Mesh>();
+		geo->mName = meshName;
+		geo->CreateBlob(vertices.data(), (UINT)vertices.size(), indices.data(), (UINT)indices.size());
+		geo->AddSubmesh("crater", (UINT)indices.size());
+
+		SliceResult result;
+		result.mesh = std::move(geo);
+		result.vertexByteStride = sizeof(Vertex);
+		result.onUploaded = [this, material, position, craterCBIndex](Mesh* mesh) {
+			int cbIndex = craterCBIndex;
+			auto craterGameObject = std::make_unique<GameObject>("crater", XMMatrixScaling(50.f, 50.f, 50.f) * XMMatrixTranslation(position.x, position.y + 130.f, position.z), XMMatrixIdentity());
+			craterGameObject->SetCBIndex(cbIndex);
+			craterGameObject->SetMesh(mesh);
+			craterGameObject->SetMaterial(material);
+			craterGameObject->AddSubmesh(mesh->GetSubmesh("crater"));
+
+			craterGameObject->SetFrameDirty();
+
+			mGameObjectLayer[(int)RenderLayer::Opaque].push_back(craterGameObject.get());
+			mAllGameObjects.push_back(std::move(craterGameObject));
+		};
+		return result;
+	});
+}
+
+void DummyApp::UploadSliceResults()
+{
+	// GPU가 지난 프레임의 업로드 링 구간과 반환한 힙 구간을 다시 쓴다.
+	mGeometryHeap.Reclaim(mFence->GetCompletedValue());
+
+	SliceResult result;
+	while (mSliceWorker.TryPopResult(result))
+		mSliceUploadQueue.push_back(std::move(result));
+
+	// 링에 자리가 없으면 남은 결과는 다음 프레임에 올린다.
+	while (!mSliceUploadQueue.empty())
+	{
+		SliceResult& front = mSliceUploadQueue.front();
+		Mesh* mesh = front.mesh.get();
+		UINT numVertices = (UINT)(mesh->mVertexBufferCPU->GetBufferSize() / front.vertexByteStride);
+		UINT numIndices = (UINT)(mesh->mIndexBufferCPU->GetBufferSize() / sizeof(UINT));
+
+		GeometryHeap::Allocation allocation;
+		if (!mGeometryHeap.Upload(mesh->mVertexBufferCPU->GetBufferPointer(), numVertices, front.vertexByteStride,
+			static_cast<const UINT*>(mesh->mIndexBufferCPU->GetBufferPointer()), numIndices, *mesh, allocation)) {
+			if (!mGeometryHeap.IsUploadRingEmpty())
+				break;
+
+			// 링이 비어 있어도 들어가지 않으면 힙이 가득 찬 것이므로 버린다.
+			OutputDebugStringA(("GeometryHeap : no space for " + mesh->mName + "\n").c_str());
+			mSliceUploadQueue.pop_front();
+			continue;
+		}
+
+		front.onUploaded(mesh);
+		mMeshes[mesh->mName] = std::move(front.mesh);
+		mSliceUploadQueue.pop_front();
+	}
+}
+
+void DummyApp::UpdateTerrainLod()
+{
+	// 카메라를 지형 공간으로 옮겨 이번 프레임에 그릴 조각과 LOD를 고른다.
+	std::vector<GameObject*>& terrainGameObjects = mGameObjectLayer[(int)RenderLayer::Terrain];
+	if (terrainGameObjects.empty())
+		return;
+
+	XMMATRIX world = XMLoadFloat4x4(&terrainGameObjects[0]->GetWorld());
+	XMMATRIX invWorld = XMMatrixInverse(&XMMatrixDeterminant(world), world);
+	XMMATRIX view = mCamera->GetView();
+	XMMATRIX invView = XMMatrixInverse(&XMMatrixDeterminant(view), view);
+
+	BoundingFrustum frustum(mCamera->GetProj());
+	frustum.Transform(frustum, invView * invWorld);
+
+	XMFLOAT3 eye;
+	XMStoreFloat3(&eye, XMVector3TransformCoord(mCamera->GetPosition(), invWorld));
+
+	float projScale = mClientHeight / (2.0f * tanf(0.5f * mCamera->GetFovY()));
+	mTerrain.SelectPatches(eye, &frustum, projScale, mTerrainPixelError, mTerrainPatchDraws);
+}
+
+void DummyApp::DrawTerrain(ID3D12GraphicsCommandList* cmdList)
+{
+	// 고른 조각마다 LOD의 공유 인덱스 구간을 조각의 baseVertex로 그린다. 상수 버퍼와 재질은 지형 물체 하나의 것을 쓴다.
+	std::vector<GameObject*>& terrainGameObjects = mGameObjectLayer[(int)RenderLayer::Terrain];
+	if (terrainGameObjects.empty())
+		return;
+
+	GameObject* terrainGameObject = terrainGameObjects[0];
+	UINT objCBByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(ObjectConstants));
+	auto objectCB = mCurrFrameResource->ObjectCB->Resource();
+
+	if (mIsWireframe)
+		cmdList->SetPipelineState(mPSOs["terrain_wireframe"].Get());
+	else if (mIsToonShading)
+		cmdList->SetPipelineState(mPSOs["terrain_toonShading"].Get());
+	else
+		cmdList->SetPipelineState(mPSOs["terrain"].Get());
+
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView = terrainGameObject->GetMesh()->VertexBufferView();
+	cmdList->IASetIndexBuffer(&terrainGameObject->GetMesh()->IndexBufferView());
+	cmdList->IASetPrimitiveTopology(terrainGameObject->GetPrimitiveType());
+	cmdList->SetGraphicsRootConstantBufferView(1, 0);
+
+	D3D12_GPU_VIRTUAL_ADDRESS objCBAddress = objectCB->GetGPUVirtualAddress() + terrainGameObject->GetObjCBIndex(0) * objCBByteSize;
+	cmdList->SetGraphicsRootConstantBufferView(0, objCBAddress);
+
+	// 셰이더가 SV_VertexID를 조각 안 정점 번호로 쓰도록 조각마다 정점 버퍼 뷰를 조각 시작으로 옮기고 BaseVertexLocation은 0으로 그린다.
+	for (const TerrainPatchDraw& draw : mTerrainPatchDraws)
+	{
+		Submesh submesh = mTerrain.GetPatchSubmesh(draw);
+		D3D12_VERTEX_BUFFER_VIEW patchView = vertexBufferView;
+		patchView.BufferLocation += (UINT64)submesh.baseVertex * vertexBufferView.StrideInBytes;
+		patchView.SizeInBytes = Terrain::NumPatchVertices * vertexBufferView.StrideInBytes;
+		cmdList->IASetVertexBuffers(0, 1, &patchView);
+
+		TerrainPatchConstants constants = mTerrain.GetPatchConstants(draw.patch);
+		cmdList->SetGraphicsRoot32BitConstants(6, sizeof(TerrainPatchConstants) / 4, &constants, 0);
+
+		cmdList->DrawIndexedInstanced(submesh.numIndices, 1, submesh.baseIndex, 0, 0);
+	}
 }
 
 void DummyApp::DrawGameObjects(ID3D12GraphicsCommandList* cmdList, const std::vector<GameObject*>& gameObjects)
@@ -1170,7 +1609,7 @@ void DummyApp::DrawGameObjects(ID3D12GraphicsCommandList* cmdList, const std::ve
 	auto objectCB = mCurrFrameResource->ObjectCB->Resource();
 	auto skinnedCB = mCurrFrameResource->SkinnedCB->Resource();
 
-	//  ׸ :
+	// 각 렌더항목에 대해:
 	for (UINT i = 0; i < gameObjects.size(); ++i)
 	{
 		auto gameObj = gameObjects[i];
@@ -1180,7 +1619,7 @@ void DummyApp::DrawGameObjects(ID3D12GraphicsCommandList* cmdList, const std::ve
 		cmdList->IASetPrimitiveTopology(gameObj->GetPrimitiveType());
 
 		if (gameObj->GetSkinnedCBIndex() != -1) {
-			D3D12_GPU_VIRTUAL_ADDRESS skinnedCBAddress = skinnedCB->GetGPUVirtualAddress() + 0/*gameObj->GetSkinnedCBIndex()*/ * skinnedCBByteSize;
+			D3D12_GPU_VIRTUAL_ADDRESS skinnedCBAddress = skinnedCB->GetGPUVirtualAddress() + gameObj->GetSkinnedCBIndex() * skinnedCBByteSize;
 			cmdList->SetGraphicsRootConstantBufferView(1, skinnedCBAddress);
 		}
 		else {
@@ -1189,7 +1628,7 @@ void DummyApp::DrawGameObjects(ID3D12GraphicsCommandList* cmdList, const std::ve
 
 		for (UINT j = 0; j < gameObj->GetNumSubmeshes(); j++)
 		{
-			//   ڿ   ü  CBV  Ѵ.
+			// 현재 프레임 자원에 대한 이 물체를 위한 CBV의 오프셋을 구한다.
 			D3D12_GPU_VIRTUAL_ADDRESS objCBAddress = objectCB->GetGPUVirtualAddress() + gameObj->GetObjCBIndex(j) * objCBByteSize;
 			cmdList->SetGraphicsRootConstantBufferView(0, objCBAddress);
 
@@ -1200,8 +1639,8 @@ void DummyApp::DrawGameObjects(ID3D12GraphicsCommandList* cmdList, const std::ve
 
 std::array<const CD3DX12_STATIC_SAMPLER_DESC, 6> DummyApp::GetStaticSamplers()
 {
-	// ׷  α׷ ϴ ǥ  ׸  Ƿ,
-	// ̸  Ʈ  Խ д.
+	// 그래픽 응용 프로그램이 사용하는 표본추출기의 수는 그리 많지 않으므로,
+	// 미리 만들어서 루트 서명에 포함시켜 둔다.
 
 	const CD3DX12_STATIC_SAMPLER_DESC pointWrap(
 		0, // shaderRegister
@@ -10,8 +10,11 @@
 #include "Camera.h"
 #include "GameObject.h"
 #include "SkinnedMesh.h"
+#include "SkinnedModelInstance.h"
 #include "Player.h"
 #include "MeshSlice.h"
+#include "SliceWorker.h"
+#include "GeometryHeap.h"
 
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
@@ -19,10 +22,55 @@ using namespace DirectX::PackedVector;
 
 extern const int gNumFrameResources;
 
+// 초기화할 때 작업 스레드에서 CPU 쪽으로 준비해 두는 자원
+// GPU 자원 생성과 업로드 기록은 메인 스레드에서 정해진 순서로 한다.
+struct StagedTexture
+{
+	std::string Name;
+	std::wstring Filename;
+	std::unique_ptr<uint8_t[]> Data;	// DDS 파일 전체 (헤더 확인 완료)
+	size_t DataSize = 0;
+	HRESULT Result = S_OK;
+};
+
+struct StagedGeometry
+{
+	std::vector<Vertex> Vertices;
+	std::vector<UINT> Indices;
+	std::vector<Submesh> Submeshes;
+};
+
+struct StagedTerrain
+{
+	std::vector<TerrainVertex> Vertices;
+	std::vector<uint16_t> Indices;
+};
+
+struct StagedAssets
+{
+	std::vector<StagedTexture> Textures;
+	StagedGeometry Shapes;
+	StagedTerrain Terrain;
+
+	// 쿡 파일에서 읽었으면 매핑된 정점/인덱스를 그대로 올리고, 아니면 SkinnedVertices를 올린다.
+	CookedModelFile CookedSkinnedModel;
+	bool IsSkinnedModelCooked = false;
+	std::vector<SkinnedVertex> SkinnedVertices;
+};
+
+// 자원별 로드 시간 (ms)
+struct AssetLoadTiming
+{
+	const char* Name = "";
+	double LoadMs = 0.0;	// 작업 스레드 : 파일 읽기, 디코딩, 정점 생성
+	double UploadMs = 0.0;	// 메인 스레드 : GPU 자원 생성과 업로드 기록
+};
+
 enum class RenderLayer : int
 {
 	Opaque = 0,
 	SkinnedOpaque,
+	Terrain,
 	Debug,
 	Sky,
 	Count
@@ -56,19 +104,31 @@ private:
 	void UpdateSkinnedCBs(const GameTimer& gt);
 	void UpdateMaterialCBs(const GameTimer& gt);
 	void UpdateMainPassCB(const GameTimer& gt);
+	void UpdateTerrainLod();
 	
-	void LoadTextures();
+	// 독립적인 CPU 작업은 mThreadPool에서 병렬로 처리하고 업로드는 순서대로 기록한다.
+	void LoadAssets();
+	void LoadTexture(StagedTexture& texture);
+	void BuildShapeGeometry(StagedGeometry& shapes);
+	void LoadSkinnedModel(StagedAssets& assets);
+	void LoadTerrain(StagedTerrain& terrain);
+	void UploadTexture(StagedTexture& texture);
+	void UploadShapeGeometry(StagedGeometry& shapes);
+	void UploadSkinnedModel(StagedAssets& assets);
+	void UploadTerrain(StagedTerrain& terrain);
+
 	void BuildRootSignature();
 	void BuildDescriptorHeaps();
 	void BuildShadersAndInputLayout();
-	void BuildShapeGeometry();
-	void LoadSkinnedModel();
-	void LoadTerrain();
 	void BuildPSOs();
 	void BuildFrameResources();
 	void BuildMaterials();
 	void BuildGameObjects();
+	void SliceCrowdCharacter();
+	void CarveCrater();
+	void UploadSliceResults();
 	void DrawGameObjects(ID3D12GraphicsCommandList* cmdList, const std::vector<GameObject*>& ritems);
+	void DrawTerrain(ID3D12GraphicsCommandList* cmdList);
 
 	std::array<const CD3DX12_STATIC_SAMPLER_DESC, 6> GetStaticSamplers();
 
@@ -85,6 +145,9 @@ private:
 	ComPtr<ID3D12DescriptorHeap> mSrvDescriptorHeap = nullptr;
 
 	Terrain mTerrain;
+	// 이번 프레임에 그릴 지형 조각과 LOD, 허용하는 화면 오차(픽셀)
+	std::vector<TerrainPatchDraw> mTerrainPatchDraws;
+	float mTerrainPixelError = 2.0f;
 	std::unordered_map<std::string, std::unique_ptr<Mesh>> mMeshes;
 	std::unordered_map<std::string, std::unique_ptr<Material>> mMaterials;
 	std::unordered_map<std::string, std::unique_ptr<Texture>> mTextures;
@@ -93,6 +156,7 @@ private:
 
 	std::vector<D3D12_INPUT_ELEMENT_DESC> mInputLayout;
 	std::vector<D3D12_INPUT_ELEMENT_DESC> mSkinnedInputLayout;
+	std::vector<D3D12_INPUT_ELEMENT_DESC> mTerrainInputLayout;
 
 	// List of all the render items.
 	//std::vector<std::unique_ptr<RenderItem>> mAllRitems;
@@ -107,6 +171,23 @@ private:
 	bool mIsToonShading = false;
 
 	SkinnedMesh mSkinnedMesh;
+	std::vector<std::unique_ptr<SkinnedModelInstance>> mSkinnedModelInsts;
+	std::vector<PoseJob> mPoseJobs;
+
+	ThreadPool mThreadPool;
+
+	// 절단 컨텍스트는 mSliceWorker의 작업 스레드에서만 쓴다. (mSliceWorker가 먼저 소멸하도록 뒤에 둔다.)
+	MeshSlice::MultiSliceContext mMultiSliceContext;
+	MeshSlice::SkinnedSliceContext mSkinnedSliceContext;
+	MeshSlice::ConvexSliceContext mConvexSliceContext;
+	int mNumSlicingMeshes = 0;
+	// 실행 중에 만드는 오브젝트가 받을 다음 ObjectCB 자리 (BuildGameObjects가 정적 오브젝트와 군중 뒤로 정한다.)와 ObjectCB 크기
+	int mNextObjCBIndex = 0;
+	int mNumObjCBs = 0;
+	int mNumSlicedCrowd = 0;
+	SliceWorker mSliceWorker;
+	std::deque<SliceResult> mSliceUploadQueue;
+	GeometryHeap mGeometryHeap;
 
 	Player* mPlayer = nullptr;
 
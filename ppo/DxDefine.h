@@ -27,6 +27,6 @@ using namespace DirectX;
 
 
 ///////////////////////////
-//  warning C4316 ó  //
+//  warning C4316 처리용  //
 ///////////////////////////
 #include "AlignedAllocationPolicy.h"
@@ -66,24 +66,24 @@ struct Vertex
     DirectX::XMFLOAT3 Normal;
     DirectX::XMFLOAT2 TexC;
 
-    // std::hash ø Ưȭ
+    // std::hash 템플릿 특수화
     struct Hash
     {
         size_t operator()(const Vertex& v) const
         {
             size_t hash = 0;
 
-            // Pos ؽð 
+            // Pos 해시값 계산
             hash_combine(hash, std::hash<float>()(v.Pos.x));
             hash_combine(hash, std::hash<float>()(v.Pos.y));
             hash_combine(hash, std::hash<float>()(v.Pos.z));
 
-            // Normal ؽð 
+            // Normal 해시값 계산
             /*hash_combine(hash, std::hash<float>()(v.Normal.x));
             hash_combine(hash, std::hash<float>()(v.Normal.y));
             hash_combine(hash, std::hash<float>()(v.Normal.z));*/
 
-            // TexC ؽð 
+            // TexC 해시값 계산
             /*hash_combine(hash, std::hash<float>()(v.TexC.x));
             hash_combine(hash, std::hash<float>()(v.TexC.y));*/
 
@@ -91,7 +91,7 @@ struct Vertex
         }
 
     private:
-        // ؽ  Լ
+        // 해시 결합 함수
         template <typename T>
         static void hash_combine(size_t& seed, const T& val)
         {
@@ -121,9 +121,9 @@ struct SkinnedVertex
     BYTE BoneIndices[4];
 };
 
-// CPU    ϵ ϴ  ʿ ڿ ǥϴ Ŭ
-//  α׷ ʿ ڿ ٸ ̹Ƿ,
-// ̷ Ŭ     α׷ ޶  ̴.
+// CPU가 한 프레임의 명령 목록들을 구축하는 데 필요한 자원들을 대표하는 클래스
+// 응용 프로그램마다 필요한 자원이 다를 것이므로,
+// 이런 클래스의 멤버 구성 역시 응용 프로그램마다 달라야 할 것이다.
 struct FrameResource
 {
 public:
@@ -133,19 +133,19 @@ public:
     FrameResource& operator=(const FrameResource& rhs) = delete;
     ~FrameResource();
 
-    //  Ҵڴ GPU ɵ  ó  缳ؾ Ѵ.
-    //  Ӹ Ҵڰ ʿϴ.
+    // 명령 할당자는 GPU가 명령들을 다 처리한 후 재설정해야 한다.
+    // 따라서 프레임마다 할당자가 필요하다.
     Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CmdListAlloc;
 
-    //  ۴ װ ϴ ɵ GPU  ó Ŀ ؾѴ.
-    //  Ӹ Ҵڰ ʿϴ.
+    // 상수 버퍼는 그것을 참조하는 명령들을 GPU가 다 처리한 후에 갱신해야한다.
+    // 따라서 프레임마다 할당자가 필요하다.
     std::unique_ptr<UploadBuffer<PassConstants>> PassCB = nullptr;
     std::unique_ptr<UploadBuffer<ObjectConstants>> ObjectCB = nullptr;
     std::unique_ptr<UploadBuffer<SkinnedConstants>> SkinnedCB = nullptr;
 
     std::unique_ptr<UploadBuffer<MaterialData>> MaterialBuffer = nullptr;
 
-    // Fence  Ÿ  ɵ ǥϴ ̴.
-    //   GPU    ڿ ϰ ִ ϴ 뵵 δ.
+    // Fence는 현재 울타리 지점까지의 명령들을 표시하는 값이다.
+    // 이 값은 GPU가 아직 이 프레임 자원들을 사용하고 있는지 판정하는 용도로 쓰인다.
     UINT64 Fence = 0;
 };
\ No newline at end of file
@@ -5,35 +5,37 @@
 
 #define MAX_NUM_SUBMESHES 4
 
-// ϳ ü ׸  ʿ Ű   ü
+struct SkinnedModelInstance;
+
+// 하나의 물체를 그리는 데 필요한 매개변수들을 담는 가벼운 구조체
 struct RenderItem
 {
 	RenderItem() = default;
 
-	//    ü   ϴ  
-	//     ȿ ü ġ , ũ⸦ 
+	// 세계 공간을 기준으로 물체의 국소 공간을 서술하는 세계 행렬
+	// 이 행렬은 세계 공간 안에서의 물체의 의치와 방행, 크기를 결정
 	XMFLOAT4X4 World = MathHelper::Identity4x4();
 
 	XMFLOAT4X4 TexTransform = MathHelper::Identity4x4();
 
-	// ü ڷᰡ ؼ ۸ ؾ ϴ θ ϴ 'Dirty'÷
-	// FrameResource ü cBuffer Ƿ ü ڷḦ   ݵ
-	// NumFramesDirty = gNumFrameResources ؾ Ѵ.
-	// ׷   ڿ ŵȴ.
+	// 물체의 자료가 변해서 상수버퍼를 갱신해야 하는지의 여부를 뜻하는 'Dirty'플래그
+	// FrameResource마다 물체의 cBuffer가 있으므로 물체의 자료를 수정할 떄는 반드시
+	// NumFramesDirty = gNumFrameResources로 설정해야 한다.
+	// 그래야 각각의 프레임 자원이 갱신된다.
 	int NumFramesDirty = gNumFrameResources;
 
-	//   ׸ ü  ۿ شϴ 
-	// GPU   
+	// 이 렌더 항목의 물체 상수 버퍼에 해당하는 
+	// GPU 상수 버퍼의 색인
 	UINT ObjCBIndex = -1;
 
-	//   ׸  ϱ.  ׸  ϱ   ִ.
+	// 이 렌더 항목에 연관된 기하구조. 여러 렌더항목이 같은 기하구조를 참조할 수 있다.
 	Material* Mat = nullptr;
 	Mesh* Geo = nullptr;
 
 	// Primitive topology.
 	D3D12_PRIMITIVE_TOPOLOGY PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
-	// DrawIndexedInstanced Ű.
+	// DrawIndexedInstanced 매개변수들.
 	UINT IndexCount = 0;
 	UINT StartIndexLocation = 0;
 	int BaseVertexLocation = 0;
@@ -42,7 +44,7 @@ struct RenderItem
 	UINT SkinnedCBIndex = -1;
 
 	// nullptr if this render-item is not animated by skinned mesh.
-	//SkinnedModelInstance* SkinnedModelInst = nullptr;
+	SkinnedModelInstance* SkinnedModelInst = nullptr;
 };
 
 struct DrawIndex
@@ -71,6 +73,7 @@ public:
 	void SetCBIndex(int& objCBIndex, int& skinnedCBIndex);
 	void SetCBIndex(int numObjCBs, int& objCBIndices, int& skinnedCBIndex);
 	void SetPrimitiveType(D3D12_PRIMITIVE_TOPOLOGY primitiveType) { mPrimitiveType = primitiveType; }
+	void SetSkinnedModelInst(SkinnedModelInstance* skinnedModelInst) { mSkinnedModelInst = skinnedModelInst; }
 	void SetFrameDirty() { mNumFramesDirty = gNumFrameResources; }
 	void DecreaseFrameDirty() { mNumFramesDirty--; }
 
@@ -80,6 +83,7 @@ public:
 	D3D12_PRIMITIVE_TOPOLOGY GetPrimitiveType() { return mPrimitiveType; };
 	int GetObjCBIndex(UINT index) { return mObjCBIndex[index]; };
 	int GetSkinnedCBIndex() { return mSkinnedCBIndex; };
+	SkinnedModelInstance* GetSkinnedModelInst() { return mSkinnedModelInst; }
 	UINT GetNumIndices(UINT index) { return mDrawIndex[index].mNumIndices; };
 	UINT GetBaseIndex(UINT index) { return mDrawIndex[index].mBaseIndex; };
 	UINT GetBaseVertex(UINT index) { return mDrawIndex[index].mBaseVertex; };
@@ -87,6 +91,7 @@ public:
 	UINT GetNumSubmeshes() { return mNumSubmeshes; }
 
 	void AddSubmesh(const Submesh& submesh);
+	void ClearSubmeshes() { mNumSubmeshes = 0; }
 	void SetPosition(float x, float y, float z);
 	void SetPosition(XMFLOAT3 position);
 	void SetScale(float x, float y, float z);
@@ -119,23 +124,26 @@ private:
 	XMFLOAT4X4 mWorld = MathHelper::Identity4x4();
 	XMFLOAT4X4 mTexTransform = MathHelper::Identity4x4();
 
-	// ü ڷᰡ ؼ ۸ ؾ ϴ θ ϴ 'Dirty'÷
-	// FrameResource ü cBuffer Ƿ ü ڷḦ   ݵ
-	// NumFramesDirty = gNumFrameResources ؾ Ѵ.
-	// ׷   ڿ ŵȴ.
+	// 물체의 자료가 변해서 상수버퍼를 갱신해야 하는지의 여부를 뜻하는 'Dirty'플래그
+	// FrameResource마다 물체의 cBuffer가 있으므로 물체의 자료를 수정할 떄는 반드시
+	// NumFramesDirty = gNumFrameResources로 설정해야 한다.
+	// 그래야 각각의 프레임 자원이 갱신된다.
 	int mNumFramesDirty = gNumFrameResources;
 
-	//   ׸ ü  ۿ شϴ 
-	// GPU   
+	// 이 렌더 항목의 물체 상수 버퍼에 해당하는 
+	// GPU 상수 버퍼의 색인
 	int mObjCBIndex[MAX_NUM_SUBMESHES] = { -1, };
 	int mSkinnedCBIndex = -1;
+
+	// 스키닝 애니메이션이 없는 물체는 nullptr
+	SkinnedModelInstance* mSkinnedModelInst = nullptr;
 	
 	Material* mMaterials[MAX_NUM_SUBMESHES] = { nullptr, };
 	Mesh* mMesh = nullptr;
 
 	D3D12_PRIMITIVE_TOPOLOGY mPrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
-	// DrawIndexedInstanced Ű
+	// DrawIndexedInstanced 매개변수
 	UINT mNumSubmeshes = 0;
 	DrawIndex mDrawIndex[MAX_NUM_SUBMESHES];
 };
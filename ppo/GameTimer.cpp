@@ -78,15 +78,15 @@ void GameTimer::Tick()
 		return;
 	}
 
-	// ̹  ð Ѵ.
+	// 이번 프레임의 시간을 구한다.
 	__int64 currTime;
 	QueryPerformanceCounter((LARGE_INTEGER*)&currTime);
 	mCurrTime = currTime;
 
-	// ̹ Ӱ   ð Ѵ.
+	// 이번 프레임과 이전 프레임의 시간차를 구한다.
 	mDeltaTime = (mCurrTime - mPrevTime) * mSecondsPerCount;
 
-	//      ð Ѵ.
+	// 다음 프레임을 위해 이전 프레임의 시간을 갱신한다.
 	mPrevTime = mCurrTime;
 
 	if (mDeltaTime < 0.0)
@@ -87,17 +87,17 @@ public:
     MeshData CreateSphere(float radius, uint32 sliceCount, uint32 stackCount);
 
 	///<summary>
-	///  ޽ø Ѵ. numSubdivisions ׼̼  Ѵ.
-	///  20ü   ﰢ  ϳ 4 ﰢ ȭѴ.
-	///    r  Ѵ.
-	/// ۾ numSubdivisionsŭ ݺϿ  ٻѴ.
+	/// 측지구 메시를 생성한다. numSubdivisions는 테셀레이션 정도를 결정한다.
+	/// 정 20면체를 생성한 뒤 삼각형 면 하나를 4개의 삼각형으로 세분화한다.
+	/// 새 정점을 반지름이 r인 구에 투영한다.
+	/// 이작업을 numSubdivisions만큼 반복하여 측지구를 근사한다.
 	///</summary>
     MeshData CreateGeosphere(float radius, uint32 numSubdivisions);
 
 	///<summary>
-	/// Y  ϴ  Ѵ. ߽ ̴.
-	/// sliceCount, stackCount ׼̼  Ѵ.
-	///   ̵  stackCount̸,     sliceCount̴.
+	/// Y축을 축으로 하는 원기둥을 생성한다. 중심은 원점이다.
+	/// sliceCount, stackCount는 테셀레이션 정도를 정한다.
+	/// 층층이 싸인 더미들의 개수가 stackCount이며, 각 고리의 정점 개수는 sliceCount이다.
 	///</summary>
     MeshData CreateCylinder(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount);
 
@@ -0,0 +1,199 @@
+#include "GeometryHeap.h"
+#include <algorithm>
+
+static UINT64 AlignUp(UINT64 value, UINT64 alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void RangeAllocator::Reset(UINT64 capacity)
+{
+    mCapacity = capacity;
+    mFreeRanges.clear();
+    if (capacity > 0)
+        mFreeRanges.push_back({ 0, capacity });
+}
+
+UINT64 RangeAllocator::Allocate(UINT64 byteSize, UINT64 alignment)
+{
+    for (size_t i = 0; i < mFreeRanges.size(); i++)
+    {
+        UINT64 rangeOffset = mFreeRanges[i][0];
+        UINT64 rangeEnd = rangeOffset + mFreeRanges[i][1];
+        UINT64 offset = AlignUp(rangeOffset, alignment);
+        if (offset + byteSize > rangeEnd)
+            continue;
+
+        // 앞쪽 틈과 뒤쪽 나머지를 빈 구간으로 남긴다.
+        UINT64 end = offset + byteSize;
+        if (offset > rangeOffset) {
+            mFreeRanges[i][1] = offset - rangeOffset;
+            if (end < rangeEnd)
+                mFreeRanges.insert(mFreeRanges.begin() + i + 1, { end, rangeEnd - end });
+        }
+        else if (end < rangeEnd) {
+            mFreeRanges[i] = { end, rangeEnd - end };
+        }
+        else {
+            mFreeRanges.erase(mFreeRanges.begin() + i);
+        }
+        return offset;
+    }
+    return InvalidOffset;
+}
+
+void RangeAllocator::Free(UINT64 offset, UINT64 byteSize)
+{
+    auto next = lower_bound(mFreeRanges.begin(), mFreeRanges.end(), offset, [](const array<UINT64, 2>& range, UINT64 value) { return range[0] < value; });
+    next = mFreeRanges.insert(next, { offset, byteSize });
+
+    // 뒤, 앞 순서로 이웃과 합친다.
+    if (next + 1 != mFreeRanges.end() && (*next)[0] + (*next)[1] == (*(next + 1))[0]) {
+        (*next)[1] += (*(next + 1))[1];
+        mFreeRanges.erase(next + 1);
+    }
+    if (next != mFreeRanges.begin() && (*(next - 1))[0] + (*(next - 1))[1] == (*next)[0]) {
+        (*(next - 1))[1] += (*next)[1];
+        mFreeRanges.erase(next);
+    }
+}
+
+UINT64 RangeAllocator::FreeByteSize() const
+{
+    UINT64 byteSize = 0;
+    for (const array<UINT64, 2>& range : mFreeRanges)
+        byteSize += range[1];
+    return byteSize;
+}
+
+void FenceRingAllocator::Reset(UINT64 capacity)
+{
+    mCapacity = capacity;
+    mHead = 0;
+    mAllocatedByteSize = 0;
+    mReclaimedByteSize = 0;
+    mFrames.clear();
+}
+
+UINT64 FenceRingAllocator::Allocate(UINT64 byteSize, UINT64 alignment)
+{
+    // 쓰는 구간은 링 위에서 이어져 있으므로 빈 공간은 mHead부터 (capacity - 사용량)만큼이다.
+    UINT64 offset = AlignUp(mHead, alignment);
+    if (offset + byteSize > mCapacity)
+        offset = 0;
+    UINT64 padding = (offset >= mHead) ? offset - mHead : mCapacity - mHead;
+    if (UsedByteSize() + padding + byteSize > mCapacity)
+        return RangeAllocator::InvalidOffset;
+
+    mAllocatedByteSize += padding + byteSize;
+    mHead = offset + byteSize;
+    return offset;
+}
+
+void FenceRingAllocator::EndFrame(UINT64 fence)
+{
+    if (mFrames.empty() || mFrames.back().allocatedByteSize != mAllocatedByteSize)
+        mFrames.push_back({ fence, mAllocatedByteSize });
+    else
+        mFrames.back().fence = fence;
+}
+
+void FenceRingAllocator::Reclaim(UINT64 completedFence)
+{
+    while (!mFrames.empty() && mFrames.front().fence <= completedFence)
+    {
+        mReclaimedByteSize = mFrames.front().allocatedByteSize;
+        mFrames.pop_front();
+    }
+}
+
+void GeometryHeap::Initialize(ID3D12Device* device, UINT64 heapByteSize, UINT64 uploadRingByteSize)
+{
+    ThrowIfFailed(device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(heapByteSize),
+        ReadState,
+        nullptr,
+        IID_PPV_ARGS(mBuffer.GetAddressOf())));
+
+    ThrowIfFailed(device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(uploadRingByteSize),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(mUploadBuffer.GetAddressOf())));
+
+    // 업로드 링은 끝날 때까지 매핑해 둔다.
+    ThrowIfFailed(mUploadBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mMappedUpload)));
+
+    mHeapAllocator.Reset(heapByteSize);
+    mUploadRing.Reset(uploadRingByteSize);
+}
+
+bool GeometryHeap::Upload(const void* vertices, UINT numVertices, UINT vertexByteStride, const UINT* indices, UINT numIndices, Mesh& mesh, Allocation& allocation)
+{
+    // 인덱스는 4바이트, 정점 버퍼 시작은 정점 크기와 무관하게 16바이트로 맞춘다.
+    const UINT vbByteSize = numVertices * vertexByteStride;
+    const UINT ibByteSize = numIndices * sizeof(UINT);
+    const UINT64 ibOffset = AlignUp(vbByteSize, sizeof(UINT));
+    const UINT64 byteSize = ibOffset + ibByteSize;
+
+    UINT64 destOffset = mHeapAllocator.Allocate(byteSize, 16);
+    if (destOffset == RangeAllocator::InvalidOffset)
+        return false;
+
+    // 아직 GPU가 모르는 구간이므로 링에 자리가 없으면 바로 돌려준다.
+    UINT64 sourceOffset = mUploadRing.Allocate(byteSize, 16);
+    if (sourceOffset == RangeAllocator::InvalidOffset) {
+        mHeapAllocator.Free(destOffset, byteSize);
+        return false;
+    }
+
+    memcpy(mMappedUpload + sourceOffset, vertices, vbByteSize);
+    memcpy(mMappedUpload + sourceOffset + ibOffset, indices, ibByteSize);
+    mPendingCopies.push_back({ sourceOffset, destOffset, byteSize });
+
+    D3D12_GPU_VIRTUAL_ADDRESS address = mBuffer->GetGPUVirtualAddress() + destOffset;
+    mesh.SetBufferLocation(address, vertexByteStride, vbByteSize, address + ibOffset, ibByteSize);
+
+    allocation.offset = destOffset;
+    allocation.byteSize = byteSize;
+    return true;
+}
+
+void GeometryHeap::Free(const Allocation& allocation, UINT64 fence)
+{
+    if (allocation.offset != RangeAllocator::InvalidOffset)
+        mPendingFrees.push_back({ fence, allocation });
+}
+
+void GeometryHeap::RecordCopies(ID3D12GraphicsCommandList* cmdList)
+{
+    if (mPendingCopies.empty())
+        return;
+
+    cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mBuffer.Get(), ReadState, D3D12_RESOURCE_STATE_COPY_DEST));
+    for (const PendingCopy& copy : mPendingCopies)
+        cmdList->CopyBufferRegion(mBuffer.Get(), copy.destOffset, mUploadBuffer.Get(), copy.sourceOffset, copy.byteSize);
+    cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mBuffer.Get(), D3D12_RESOURCE_STATE_COPY_DEST, ReadState));
+
+    mPendingCopies.clear();
+}
+
+void GeometryHeap::EndFrame(UINT64 fence)
+{
+    mUploadRing.EndFrame(fence);
+}
+
+void GeometryHeap::Reclaim(UINT64 completedFence)
+{
+    mUploadRing.Reclaim(completedFence);
+
+    while (!mPendingFrees.empty() && mPendingFrees.front().fence <= completedFence)
+    {
+        mHeapAllocator.Free(mPendingFrees.front().allocation.offset, mPendingFrees.front().allocation.byteSize);
+        mPendingFrees.pop_front();
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "d3dUtil.h"
+#include "Mesh.h"
+#include <deque>
+
+using Microsoft::WRL::ComPtr;
+using namespace std;
+
+// [0, capacity)를 first fit으로 나눠 주는 구간 할당기
+// 반환한 구간은 이웃한 빈 구간과 합친다. 정렬 때문에 생긴 앞쪽 틈은 빈 구간으로 남는다.
+class RangeAllocator
+{
+public:
+    static constexpr UINT64 InvalidOffset = UINT64_MAX;
+
+    void Reset(UINT64 capacity);
+    // 자리가 없으면 InvalidOffset
+    UINT64 Allocate(UINT64 byteSize, UINT64 alignment);
+    void Free(UINT64 offset, UINT64 byteSize);
+
+    UINT64 Capacity() const { return mCapacity; }
+    UINT64 FreeByteSize() const;
+
+private:
+    UINT64 mCapacity = 0;
+    vector<array<UINT64, 2>> mFreeRanges;   // (offset, byteSize), offset 순
+};
+
+// 울타리 값으로 재사용 시점을 정하는 링 할당기
+// 한 프레임 동안 앞 할당 뒤에 이어서 할당하고, EndFrame에서 그 프레임까지 할당한 위치를 울타리 값과 함께 기록해 두었다가
+// GPU가 그 울타리를 지나면(Reclaim) 그 위치까지를 다시 쓴다.
+class FenceRingAllocator
+{
+public:
+    void Reset(UINT64 capacity);
+    // 자리가 없으면 RangeAllocator::InvalidOffset, 끝에 들어가지 않으면 앞으로 돌아가고 남은 끝부분은 버린다.
+    UINT64 Allocate(UINT64 byteSize, UINT64 alignment);
+    void EndFrame(UINT64 fence);
+    void Reclaim(UINT64 completedFence);
+
+    UINT64 Capacity() const { return mCapacity; }
+    UINT64 UsedByteSize() const { return mAllocatedByteSize - mReclaimedByteSize; }
+
+private:
+    struct FrameMark
+    {
+        UINT64 fence;
+        UINT64 allocatedByteSize;   // 이 프레임까지 누적 할당량
+    };
+
+    UINT64 mCapacity = 0;
+    UINT64 mHead = 0;
+    UINT64 mAllocatedByteSize = 0;  // 버린 끝부분 포함, 계속 증가
+    UINT64 mReclaimedByteSize = 0;
+    deque<FrameMark> mFrames;
+};
+
+// 실행 중에 만드는 기하(절단 조각 등)를 프레임을 멈추지 않고 올리는 정점/인덱스 힙
+// 모든 메시가 기본 힙 버퍼 하나를 구간으로 나눠 쓰므로 메시마다 committed resource를 만들지 않는다.
+// 자료는 계속 매핑해 둔 업로드 링에 복사해 두고 다음 Draw의 명령 목록 앞(RecordCopies)에서 기본 힙으로 복사하므로
+// 같은 프레임부터 그릴 수 있다. 링 구간은 그 프레임의 울타리를, 반환한 힙 구간은 반환할 때 준 울타리를 GPU가 지나면 다시 쓴다.
+class GeometryHeap
+{
+public:
+    struct Allocation
+    {
+        UINT64 offset = RangeAllocator::InvalidOffset;
+        UINT64 byteSize = 0;
+    };
+
+    void Initialize(ID3D12Device* device, UINT64 heapByteSize, UINT64 uploadRingByteSize);
+
+    // 정점 다음에 인덱스를 한 구간에 올리고 mesh의 정점/인덱스 버퍼 뷰를 그 구간으로 맞춘다.
+    // 힙이나 링에 자리가 없으면 false를 반환한다. 링은 GPU가 앞 프레임을 끝내면 비므로 다음 프레임에 다시 시도하면 된다.
+    bool Upload(const void* vertices, UINT numVertices, UINT vertexByteStride, const UINT* indices, UINT numIndices, Mesh& mesh, Allocation& allocation);
+    // fence : 이 구간을 마지막으로 그리는 프레임의 울타리 값
+    void Free(const Allocation& allocation, UINT64 fence);
+
+    // Draw에서 이 구간을 그리기 전에 호출한다.
+    void RecordCopies(ID3D12GraphicsCommandList* cmdList);
+    // Draw 끝에서 이 프레임의 울타리 값으로 호출한다.
+    void EndFrame(UINT64 fence);
+    // 프레임 자원을 기다린 뒤 GPU가 지난 울타리 값으로 호출한다.
+    void Reclaim(UINT64 completedFence);
+
+    UINT64 FreeByteSize() const { return mHeapAllocator.FreeByteSize(); }
+    // 업로드 링이 비어 있는데도 Upload가 실패하면 힙에 자리가 없는 것이다.
+    bool IsUploadRingEmpty() const { return mUploadRing.UsedByteSize() == 0; }
+
+private:
+    struct PendingCopy
+    {
+        UINT64 sourceOffset;
+        UINT64 destOffset;
+        UINT64 byteSize;
+    };
+
+    struct PendingFree
+    {
+        UINT64 fence;
+        Allocation allocation;
+    };
+
+    static constexpr D3D12_RESOURCE_STATES ReadState = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER | D3D12_RESOURCE_STATE_INDEX_BUFFER;
+
+    ComPtr<ID3D12Resource> mBuffer;
+    ComPtr<ID3D12Resource> mUploadBuffer;
+    BYTE* mMappedUpload = nullptr;
+
+    RangeAllocator mHeapAllocator;
+    FenceRingAllocator mUploadRing;
+
+    vector<PendingCopy> mPendingCopies;
+    deque<PendingFree> mPendingFrees;
+};
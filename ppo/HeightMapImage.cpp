@@ -1,8 +1,8 @@
 #include "HeightMapImage.h"
+#include <algorithm>
 
 HeightMapImage::HeightMapImage()
 {
-	mHeightMapPixels = nullptr;
 	mWidth = 0;
 	mLength = 0;
 	mYScale = 1.0f;
@@ -10,51 +10,162 @@ HeightMapImage::HeightMapImage()
 
 HeightMapImage::~HeightMapImage()
 {
-	if (mHeightMapPixels) 
-		delete[] mHeightMapPixels;
-	mHeightMapPixels = NULL;
+	Close();
 }
 
-void HeightMapImage::LoadHeightMapImage(const wchar_t* filepath, int width, int length, float yScale)
+bool HeightMapImage::LoadHeightMapImage(const wchar_t* filepath, int width, int length, float yScale, int maxTiles)
 {
+	Close();
+
+	mFile = CreateFileW(filepath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (mFile == INVALID_HANDLE_VALUE) {
+		std::wcerr << L"Failed to open file: " << filepath << std::endl;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	UINT64 expectedSize = (UINT64)width * length * sizeof(uint16_t);
+	if (!GetFileSizeEx(mFile, &fileSize) || (UINT64)fileSize.QuadPart < expectedSize || expectedSize == 0) {
+		char message[256];
+		sprintf_s(message, "HeightMapImage: file is %lld bytes, %d x %d needs %llu\n", (long long)fileSize.QuadPart, width, length, expectedSize);
+		OutputDebugStringA(message);
+		Close();
+		return false;
+	}
+	if ((UINT64)fileSize.QuadPart > expectedSize) {
+		char message[256];
+		sprintf_s(message, "HeightMapImage: file is %lld bytes, using the first %llu (%d x %d)\n", (long long)fileSize.QuadPart, expectedSize, width, length);
+		OutputDebugStringA(message);
+	}
+
+	mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mMapping == nullptr) {
+		Close();
+		return false;
+	}
+
+	mMappedPixels = reinterpret_cast<const uint16_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+	if (mMappedPixels == nullptr) {
+		Close();
+		return false;
+	}
+
 	mWidth = width;
 	mLength = length;
 	mYScale = yScale;
+	mNumTilesX = (width + TileSize - 1) / TileSize;
+	mTiles.resize(std::max<int>(maxTiles, 1));
+	mTileSlots.reserve(mTiles.size());
 
-	std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+	return true;
+}
 
-	if (!file.is_open()) {
-		std::wcerr << L"Failed to open file: " << filepath << std::endl;
-		return;
-	}
+void HeightMapImage::Close()
+{
+	if (mMappedPixels != nullptr)
+		UnmapViewOfFile(mMappedPixels);
+	if (mMapping != nullptr)
+		CloseHandle(mMapping);
+	if (mFile != INVALID_HANDLE_VALUE)
+		CloseHandle(mFile);
 
-	std::streamsize size = file.tellg();
-	file.seekg(0, std::ios::beg);
+	mMappedPixels = nullptr;
+	mMapping = nullptr;
+	mFile = INVALID_HANDLE_VALUE;
+	mWidth = 0;
+	mLength = 0;
+	mNumTilesX = 0;
+	mTiles.clear();
+	mTileSlots.clear();
+	mLastSlot = -1;
+	mUseCounter = 0;
+	mNumTileLoads = 0;
+	mNumTileHits = 0;
+}
+
+const uint16_t* HeightMapImage::LockedGetTile(int tileX, int tileZ)
+{
+	int index = tileZ * mNumTilesX + tileX;
+	++mUseCounter;
 
-	if (size % sizeof(uint16_t) != 0) {
-		std::cerr << "File size is not a multiple of 16-bit values." << std::endl;
-		return;
+	if (mLastSlot >= 0 && mTiles[mLastSlot].index == index) {
+		++mNumTileHits;
+		mTiles[mLastSlot].lastUse = mUseCounter;
+		return mTiles[mLastSlot].samples.data();
 	}
 
-	uint16_t* heightMapPixels = new uint16_t[mWidth * mLength];
-	if (!file.read(reinterpret_cast<char*>(heightMapPixels), size)) {
-		std::cerr << "Failed to read file." << std::endl;
-		return;
+	auto found = mTileSlots.find(index);
+	if (found != mTileSlots.end()) {
+		++mNumTileHits;
+		mLastSlot = found->second;
+		mTiles[mLastSlot].lastUse = mUseCounter;
+		return mTiles[mLastSlot].samples.data();
 	}
 
-	mHeightMapPixels = new uint16_t[mWidth * mLength];
-	for (int y = 0; y < mLength; y++)
+	// 빈 자리가 있으면 쓰고, 없으면 가장 오래 안 쓴 타일을 버린다. (타일 수가 적어 선형 탐색으로 충분하다.)
+	int slot = 0;
+	for (int i = 1; i < (int)mTiles.size() && mTiles[slot].index >= 0; ++i)
 	{
-		for (int x = 0; x < mWidth; x++)
-		{
-			mHeightMapPixels[x + (y * mWidth)] =
-				heightMapPixels[x + (y * mWidth)] * yScale;
-		}
+		if (mTiles[i].index < 0 || mTiles[i].lastUse < mTiles[slot].lastUse)
+			slot = i;
 	}
 
-	delete[] heightMapPixels;
+	Tile& tile = mTiles[slot];
+	if (tile.index >= 0)
+		mTileSlots.erase(tile.index);
+	tile.index = index;
+	tile.lastUse = mUseCounter;
+	tile.samples.resize(TileSize * TileSize);
 
-	return;
+	// 매핑에서 타일 행들을 복사한다. 처음 닿는 페이지만 디스크에서 읽힌다.
+	int x0 = tileX * TileSize;
+	int z0 = tileZ * TileSize;
+	int tileWidth = std::min<int>(TileSize, mWidth - x0);
+	int tileLength = std::min<int>(TileSize, mLength - z0);
+	for (int z = 0; z < tileLength; ++z)
+	{
+		const uint16_t* src = mMappedPixels + (size_t)(z0 + z) * mWidth + x0;
+		std::copy(src, src + tileWidth, tile.samples.data() + z * TileSize);
+	}
+
+	mTileSlots[index] = slot;
+	mLastSlot = slot;
+	++mNumTileLoads;
+	return tile.samples.data();
+}
+
+float HeightMapImage::GetHeightAt(int x, int z)
+{
+	if (mMappedPixels == nullptr)
+		return(0.0f);
+
+	x = std::min<int>(std::max<int>(x, 0), mWidth - 1);
+	z = std::min<int>(std::max<int>(z, 0), mLength - 1);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	const uint16_t* tile = LockedGetTile(x / TileSize, z / TileSize);
+	return(tile[(z % TileSize) * TileSize + (x % TileSize)] * mYScale);
+}
+
+void HeightMapImage::GetHeightRow(int x, int z, int count, float* heights)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	const int tileZ = z / TileSize;
+	const int rowOffset = (z % TileSize) * TileSize;
+	while (count > 0)
+	{
+		const int tileX = x / TileSize;
+		const int column = x % TileSize;
+		const int run = std::min<int>(count, TileSize - column);
+		const uint16_t* samples = LockedGetTile(tileX, tileZ) + rowOffset + column;
+		for (int i = 0; i < run; ++i)
+			heights[i] = samples[i] * mYScale;
+
+		x += run;
+		heights += run;
+		count -= run;
+	}
 }
 
 #define _WITH_APPROXIMATE_OPPOSITE_CORNER
@@ -63,29 +174,30 @@ float HeightMapImage::GetHeight(float fx, float fz)
 {
 	if ((fx < 0.0f) || (fz < 0.0f) || (fx >= mWidth) || (fz >= mLength)) 
 		return(0.0f);
-	//  ǥ  κа Ҽ κ Ѵ. 
+	//높이 맵의 좌표의 정수 부분과 소수 부분을 계산한다. 
 
 	int x = (int)fx;
 	int z = (int)fz;
 	float fxPercent = fx - x;
 	float fzPercent = fz - z;
 
-	float fBottomLeft = (float)mHeightMapPixels[x + (z * mWidth)];
-	float fBottomRight = (float)mHeightMapPixels[(x + 1) + (z * mWidth)];
-	float fTopLeft = (float)mHeightMapPixels[x + ((z + 1) * mWidth)];
-	float fTopRight = (float)mHeightMapPixels[(x + 1) + ((z + 1) * mWidth)];
+	//마지막 행/열에서는 (x + 1), (z + 1)이 가장자리 표본으로 고정된다.
+	float fBottomLeft = GetHeightAt(x, z);
+	float fBottomRight = GetHeightAt(x + 1, z);
+	float fTopLeft = GetHeightAt(x, z + 1);
+	float fTopRight = GetHeightAt(x + 1, z + 1);
 
 #ifdef _WITH_APPROXIMATE_OPPOSITE_CORNER
-	//z-ǥ 1, 3, 5, ...  ε ʿ  ȴ. 
+	//z-좌표가 1, 3, 5, ...인 경우 인덱스가 오른쪽에서 왼쪽으로 나열된다. 
 	bool bRightToLeft = ((z % 2) != 0);
 	if (bRightToLeft)
 	{
-		/* ﰢ ʿ   Ǵ ̴. 
-		 ׸  (fzPercent < fxPercent) ̴. 
-		  TopLeft ȼ  (fTopLeft = fTopRight + (fBottomLeft - fBottomRight)) ٻѴ. 
-		 ׸  (fzPercent  fxPercent) ̴. 
-		  BottomRight ȼ  (fBottomRight = fBottomLeft + (fTopRight - fTopLeft)) ٻѴ.
-		ﰢ ʿ  Ǵ */
+		/*지형의 삼각형들이 오른쪽에서 왼쪽 방향으로 나열되는 경우이다. 
+		다음 그림의 오른쪽은 (fzPercent < fxPercent)인 경우이다. 
+		이 경우 TopLeft의 픽셀 값은 (fTopLeft = fTopRight + (fBottomLeft - fBottomRight))로 근사한다. 
+		다음 그림의 왼쪽은 (fzPercent ≥ fxPercent)인 경우이다. 
+		이 경우 BottomRight의 픽셀 값은 (fBottomRight = fBottomLeft + (fTopRight - fTopLeft))로 근사한다.
+		삼각형이 오른쪽에서 왼쪽으로 나열되는 경우*/
 			if (fzPercent >= fxPercent)
 				fBottomRight = fBottomLeft + (fTopRight - fTopLeft);
 			else
@@ -93,12 +205,12 @@ float HeightMapImage::GetHeight(float fx, float fz)
 	}
 	else
 	{
-		/* ﰢ ʿ   Ǵ ̴. 
-		 ׸  (fzPercent < (1.0f - fxPercent)) ̴. 
-		  TopRight ȼ  (fTopRight = fTopLeft + (fBottomRight - fBottomLeft)) ٻѴ. 
-		 ׸  (fzPercent  (1.0f - fxPercent)) ̴. 
-		  BottomLeft ȼ  (fBottomLeft = fTopLeft + (fBottomRight - fTopRight)) ٻѴ.
-		ﰢ ʿ  Ǵ */
+		/*지형의 삼각형들이 왼쪽에서 오른쪽 방향으로 나열되는 경우이다. 
+		다음 그림의 왼쪽은 (fzPercent < (1.0f - fxPercent))인 경우이다. 
+		이 경우 TopRight의 픽셀 값은 (fTopRight = fTopLeft + (fBottomRight - fBottomLeft))로 근사한다. 
+		다음 그림의 오른쪽은 (fzPercent ≥ (1.0f - fxPercent))인 경우이다. 
+		이 경우 BottomLeft의 픽셀 값은 (fBottomLeft = fTopLeft + (fBottomRight - fTopRight))로 근사한다.
+		삼각형이 왼쪽에서 오른쪽으로 나열되는 경우*/
 			if (fzPercent < (1.0f - fxPercent))
 				fTopRight = fTopLeft + (fBottomRight - fBottomLeft);
 			else
@@ -106,7 +218,7 @@ float HeightMapImage::GetHeight(float fx, float fz)
 	}
 #endif
 
-	//簢   Ͽ (ȼ ) Ѵ. 
+	//사각형의 네 점을 보간하여 높이(픽셀 값)를 계산한다. 
 	float fTopHeight = fTopLeft * (1 - fxPercent) + fTopRight * fxPercent;
 	float fBottomHeight = fBottomLeft * (1 - fxPercent) + fBottomRight * fxPercent;
 	float fHeight = fBottomHeight * (1 - fzPercent) + fTopHeight * fzPercent;
@@ -116,26 +228,30 @@ float HeightMapImage::GetHeight(float fx, float fz)
 
 DirectX::XMFLOAT3 HeightMapImage::GetHeightMapNormal(int x, int z, float dx, float dz)
 {
-	//x-ǥ z-ǥ       ʹ y-  ̴. 
+	//x-좌표와 z-좌표가 높이 맵의 범위를 벗어나면 지형의 법선 벡터는 y-축 방향 벡터이다. 
 	if ((x < 0.0f) || (z < 0.0f) || (x >= mWidth) || (z >= mLength))
 		return(XMFLOAT3(0.0f, 1.0f, 0.0f));
 
-	/* ʿ (x, z) ǥ ȼ      (x+1, z), (z, z+1)
-	 ȼ  Ͽ  ͸ Ѵ.*/
-	int nHeightMapIndex = x + (z * mWidth);
+	/*높이 맵에서 (x, z) 좌표의 픽셀 값과 인접한 두 개의 점 (x+1, z), (z, z+1)에
+	대한 픽셀 값을 사용하여 법선 벡터를 계산한다.*/
 	int xHeightMapAdd = (x < (mWidth - 1)) ? 1 : -1;
-	int zHeightMapAdd = (z < (mLength - 1)) ? mWidth : -mWidth;
+	int zHeightMapAdd = (z < (mLength - 1)) ? 1 : -1;
+
+	//(x, z), (x+1, z), (x, z+1)의 픽셀에서 지형의 높이를 구한다. 
+	float y1 = GetHeightAt(x, z);
+	float y2 = GetHeightAt(x + xHeightMapAdd, z);
+	float y3 = GetHeightAt(x, z + zHeightMapAdd);
 
-	//(x, z), (x+2, z), (z, z+2) ȼ  ̸ Ѵ. 
-	float y1 = (float)mHeightMapPixels[nHeightMapIndex];
-	float y2 = (float)mHeightMapPixels[nHeightMapIndex + xHeightMapAdd];
-	float y3 = (float)mHeightMapPixels[nHeightMapIndex + zHeightMapAdd];
+	return(ComputeNormal(y1, y2, y3, dx, dz));
+}
 
-	//xmf3Edge1 (0, y3, m_xmf3Scale.z) - (0, y1, 0) ̴. 
+DirectX::XMFLOAT3 HeightMapImage::ComputeNormal(float y1, float y2, float y3, float dx, float dz)
+{
+	//xmf3Edge1은 (0, y3, m_xmf3Scale.z) - (0, y1, 0) 벡터이다. 
 	XMFLOAT3 xmf3Edge1 = XMFLOAT3(0.0f, y3 - y1, dz);
-	//xmf3Edge2 (m_xmf3Scale.x, y2, 0) - (0, y1, 0) ̴. 
+	//xmf3Edge2는 (m_xmf3Scale.x, y2, 0) - (0, y1, 0) 벡터이다. 
 	XMFLOAT3 xmf3Edge2 = XMFLOAT3(dx, y2 - y1, 0.0f);
-	// ʹ xmf3Edge1 xmf3Edge2  ȭϸ ȴ. 
+	//법선 벡터는 xmf3Edge1과 xmf3Edge2의 외적을 정규화하면 된다. 
 	XMFLOAT3 xmf3Normal = Vector3::CrossProduct(xmf3Edge1, xmf3Edge2, true);
 
 	return(xmf3Normal);
@@ -2,31 +2,77 @@
 
 #include "d3dUtil.h"
 #include "iostream"
+#include <mutex>
+#include <unordered_map>
 
 using namespace DirectX;
 
+// .r16 높이 맵 (부호 없는 16비트, 행 우선)
+// 파일 전체를 메모리에 읽지 않고 매핑해 두었다가 TileSize x TileSize 타일 단위로 필요할 때 복사해 온다.
+// 타일은 최근에 덜 쓴 것부터 버리는(LRU) 고정 개수의 캐시에 두므로 RAM보다 큰 높이 맵(예 : 16k x 16k)도 표본을 읽을 수 있다.
+// 타일에는 원래 16비트 값을 두고 yScale은 읽을 때 float로 곱한다.
+// 표본을 읽는 함수는 캐시를 바꾸므로 안에서 잠근다. 여러 표본은 GetHeightRow로 타일마다 한 번만 잠그고 읽는다.
 class HeightMapImage
 {
 public:
+	static constexpr int TileSize = 256;
+	static constexpr int DefaultMaxTiles = 64;		// 타일 하나 128KB, 기본 8MB
+
 	HeightMapImage();
 	~HeightMapImage();
+	HeightMapImage(const HeightMapImage& rhs) = delete;
+	HeightMapImage& operator=(const HeightMapImage& rhs) = delete;
+
+	// 파일 크기가 width * length * 2보다 작으면 실패(높이 맵 크기 0)하고, 크면 앞부분만 쓴다.
+	bool LoadHeightMapImage(const wchar_t* filepath, int width, int length, float scale, int maxTiles = DefaultMaxTiles);
+	void Close();
 
-	void LoadHeightMapImage(const wchar_t* filepath, int width, int length, float scale);
+	// 정수 표본 (x, z)의 높이, 범위 밖은 가장 가까운 가장자리 표본
+	float GetHeightAt(int x, int z);
+	// z행의 [x, x + count) 표본 높이 (x, count는 행 안에 있어야 한다.)
+	void GetHeightRow(int x, int z, int count, float* heights);
 
-	//  ̹ (x, z) ġ ȼ    ̸ ȯѴ. 
+	//높이 맵 이미지에서 (x, z) 위치의 픽셀 값에 기반한 지형의 높이를 반환한다.
 	float GetHeight(float x, float z);
-	//  ̹ (x, z) ġ  ͸ ȯѴ. 
+	//높이 맵 이미지에서 (x, z) 위치의 법선 벡터를 반환한다.
 	XMFLOAT3 GetHeightMapNormal(int x, int z, float dx, float dz);
-	
-	uint16_t* GetHeightMapPixels() { return mHeightMapPixels; }
-	int GetHeightMapWidth() { return mWidth; }
-	int GetHeightMapLength() { return mLength; }
+	// (x, z)의 높이 y1, x쪽 이웃 y2, z쪽 이웃 y3로 구하는 법선 (GetHeightMapNormal과 같은 식)
+	static XMFLOAT3 ComputeNormal(float y1, float y2, float y3, float dx, float dz);
+
+	int GetHeightMapWidth() const { return mWidth; }
+	int GetHeightMapLength() const { return mLength; }
+	float GetYScale() const { return mYScale; }
+
+	// 읽은 타일 수와 캐시에서 찾은 횟수 (벤치마크용)
+	UINT64 GetNumTileLoads() const { return mNumTileLoads; }
+	UINT64 GetNumTileHits() const { return mNumTileHits; }
 
 private:
-	uint16_t*	mHeightMapPixels;
+	struct Tile
+	{
+		int index = -1;			// tileZ * mNumTilesX + tileX, 비었으면 -1
+		UINT64 lastUse = 0;
+		std::vector<uint16_t> samples;	// TileSize x TileSize, 가장자리 타일은 앞부분만 쓴다.
+	};
+
+	// 잠근 상태에서 부른다. 타일 (tileX, tileZ)를 캐시에 올리고 그 표본을 반환한다.
+	const uint16_t* LockedGetTile(int tileX, int tileZ);
+
+	HANDLE mFile = INVALID_HANDLE_VALUE;
+	HANDLE mMapping = nullptr;
+	const uint16_t* mMappedPixels = nullptr;
 
 	int			mWidth;
 	int			mLength;
 	float		mYScale;
+
+	int mNumTilesX = 0;
+	std::mutex mMutex;
+	std::vector<Tile> mTiles;
+	std::unordered_map<int, int> mTileSlots;	// 타일 번호 -> mTiles 자리
+	int mLastSlot = -1;							// 마지막으로 쓴 자리 (같은 타일을 연달아 읽는 경우)
+	UINT64 mUseCounter = 0;
+	UINT64 mNumTileLoads = 0;
+	UINT64 mNumTileHits = 0;
 };
 
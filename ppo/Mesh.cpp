@@ -8,7 +8,7 @@ Mesh::~Mesh()
 {
 }
 
-Submesh Mesh::GetSubmesh(string name)
+Submesh Mesh::GetSubmesh(string name) const
 {
 	for (int i = 0; i < mSubmeshes.size(); i++)
 	{
@@ -34,57 +34,86 @@ void Mesh::AddSubmesh(const string name, UINT numIndices, UINT baseVertex, UINT
 
 void Mesh::CreateBlob(const vector<Vertex>& vertices, const vector<UINT>& indices)
 {
-	const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
-	const UINT ibByteSize = (UINT)indices.size() * sizeof(UINT);
+	CreateBlob(vertices.data(), (UINT)vertices.size(), indices.data(), (UINT)indices.size());
+}
+
+void Mesh::CreateBlob(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices)
+{
+	const UINT vbByteSize = numVertices * sizeof(Vertex);
+	const UINT ibByteSize = numIndices * sizeof(UINT);
 
 	ThrowIfFailed(D3DCreateBlob(vbByteSize, &mVertexBufferCPU));
-	CopyMemory(mVertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
+	CopyMemory(mVertexBufferCPU->GetBufferPointer(), vertices, vbByteSize);
 
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &mIndexBufferCPU));
-	CopyMemory(mIndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+	CopyMemory(mIndexBufferCPU->GetBufferPointer(), indices, ibByteSize);
+}
+
+void Mesh::UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList,
+	const vector<Vertex>& vertices, const vector<UINT>& indices)
+{
+	UploadBuffer(d3dDevice, commandList, vertices.data(), (UINT)vertices.size(), indices.data(), (UINT)indices.size());
+}
+
+void Mesh::UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList,
+	const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices)
+{
+	UploadBuffer(d3dDevice, commandList, vertices, numVertices, sizeof(Vertex), indices, numIndices, DXGI_FORMAT_R32_UINT);
 }
 
 void Mesh::UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList,
-	vector<Vertex> vertices, vector<UINT> indices)
+	const void* vertices, UINT numVertices, UINT vertexByteStride, const void* indices, UINT numIndices, DXGI_FORMAT indexFormat)
 {
-	const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
-	const UINT ibByteSize = (UINT)indices.size() * sizeof(UINT);
+	const UINT vbByteSize = numVertices * vertexByteStride;
+	const UINT ibByteSize = numIndices * ((indexFormat == DXGI_FORMAT_R16_UINT) ? sizeof(uint16_t) : sizeof(UINT));
 
 	mVertexBufferGPU = d3dUtil::CreateDefaultBuffer(d3dDevice, commandList, 
-		vertices.data(), vbByteSize, mVertexBufferUploader);
+		vertices, vbByteSize, mVertexBufferUploader);
 
 	mIndexBufferGPU = d3dUtil::CreateDefaultBuffer(d3dDevice, commandList, 
-		indices.data(), ibByteSize, mIndexBufferUploader);
+		indices, ibByteSize, mIndexBufferUploader);
 
-	mVertexByteStride = sizeof(Vertex);
+	mVertexByteStride = vertexByteStride;
 	mVertexBufferByteSize = vbByteSize;
-	mIndexFormat = DXGI_FORMAT_R32_UINT;
+	mIndexFormat = indexFormat;
 	mIndexBufferByteSize = ibByteSize;
 }
 
+void Mesh::SetBufferLocation(D3D12_GPU_VIRTUAL_ADDRESS vertexBuffer, UINT vertexByteStride, UINT vertexBufferByteSize,
+	D3D12_GPU_VIRTUAL_ADDRESS indexBuffer, UINT indexBufferByteSize)
+{
+	mVertexBufferGPU = nullptr;
+	mIndexBufferGPU = nullptr;
+	mVertexBufferLocation = vertexBuffer;
+	mIndexBufferLocation = indexBuffer;
+
+	mVertexByteStride = vertexByteStride;
+	mVertexBufferByteSize = vertexBufferByteSize;
+	mIndexFormat = DXGI_FORMAT_R32_UINT;
+	mIndexBufferByteSize = indexBufferByteSize;
+}
+
 D3D12_VERTEX_BUFFER_VIEW Mesh::VertexBufferView() const
 {
-	if (mVertexBufferGPU != nullptr) {
-		D3D12_VERTEX_BUFFER_VIEW vbv;
-		vbv.BufferLocation = mVertexBufferGPU->GetGPUVirtualAddress();
-		vbv.StrideInBytes = mVertexByteStride;
-		vbv.SizeInBytes = mVertexBufferByteSize;
+	D3D12_VERTEX_BUFFER_VIEW vbv;
+	vbv.BufferLocation = (mVertexBufferGPU != nullptr) ? mVertexBufferGPU->GetGPUVirtualAddress() : mVertexBufferLocation;
+	vbv.StrideInBytes = mVertexByteStride;
+	vbv.SizeInBytes = mVertexBufferByteSize;
 
-		return vbv;
-	}
+	return vbv;
 }
 
 D3D12_INDEX_BUFFER_VIEW Mesh::IndexBufferView() const
 {
 	D3D12_INDEX_BUFFER_VIEW ibv;
-	ibv.BufferLocation = mIndexBufferGPU->GetGPUVirtualAddress();
+	ibv.BufferLocation = (mIndexBufferGPU != nullptr) ? mIndexBufferGPU->GetGPUVirtualAddress() : mIndexBufferLocation;
 	ibv.Format = mIndexFormat;
 	ibv.SizeInBytes = mIndexBufferByteSize;
 
 	return ibv;
 }
 
-// ڷḦ GPU  ø Ŀ ޸𸮸 ص ȴ.
+// 자료를 GPU에 모두 올린 후에는 메모리를 해제해도 된다.
 void Mesh::DisposeUploaders()
 {
 	mVertexBufferUploader = nullptr;
@@ -28,18 +28,18 @@ struct Submesh
 	UINT numIndices = 0;
 	UINT materialIndex = -1;
 
-	// ޽ ٿ ڽ
+	// 서브메쉬의 바운딩 박스
 	BoundingBox bounds;
 };
 
-// ޽ ̸, , ε 
+// 메시의 이름, 정점, 인덱스를 저장
 class Mesh
 {
 public:
 	Mesh();
 	~Mesh();
 
-	// ޽ø ̸ ȸ
+	// 메시를 이름으로 조회
 	string mName;
 
 	UINT mType = 0x00;
@@ -58,8 +58,8 @@ public:
 
 	vector<Material> mMaterials;
 
-	// ý ޸ 纻.
-	// /    Ƿ ID3DBlob Ѵ.
+	// 시스템 메모리 복사본.
+	// 정점/색인 형식이 범용적일 수 있으므로 ID3DBlob을 사용한다.
 	Microsoft::WRL::ComPtr<ID3DBlob> mVertexBufferCPU = nullptr;
 	Microsoft::WRL::ComPtr<ID3DBlob> mIndexBufferCPU = nullptr;
 
@@ -69,24 +69,37 @@ public:
 	Microsoft::WRL::ComPtr<ID3D12Resource> mVertexBufferUploader = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12Resource> mIndexBufferUploader = nullptr;
 
-	// ۵鿡  ڷ
+	// 자기 버퍼 없이 공유 버퍼(GeometryHeap)의 구간을 쓰는 경우의 주소
+	D3D12_GPU_VIRTUAL_ADDRESS mVertexBufferLocation = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS mIndexBufferLocation = 0;
+
+	// 버퍼들에 관한 자료
 	UINT mVertexByteStride = 0;
 	UINT mVertexBufferByteSize = 0;
 
 	DXGI_FORMAT mIndexFormat = DXGI_FORMAT_R32_UINT;
 	unsigned int mIndexBufferByteSize = 0;
 
-	//  Mesh νͽ  / ۿ  ϱ   ִ.
-	// κ ޽õ  ׸  ֵ, submesh ̳ʿ Ƶд.
+	// 한 Mesh 인스터스의 한 정점/색인 버퍼에 여러개의 기하구조를 담을 수 있다.
+	// 부분 메시들을 개별적으로 그릴 수 있도록, submesh를 컨테이너에 담아둔다.
 	vector<Submesh> mSubmeshes;
 public:
-	Submesh GetSubmesh(string name);
+	Submesh GetSubmesh(string name) const;
 
 	void AddSubmesh(const string name, UINT numIndices,
 		UINT baseVertex = 0, UINT baseIndex = 0, UINT materialIndex = 0);
 
 	void CreateBlob(const vector<Vertex>& vertices, const vector<UINT>& indices);
-	void UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList, vector<Vertex> vertices, vector<UINT> indices);
+	void CreateBlob(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices);
+	void UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList, const vector<Vertex>& vertices, const vector<UINT>& indices);
+	void UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList, const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices);
+	// Vertex가 아닌 정점 형식이나 16비트 인덱스(indexFormat = DXGI_FORMAT_R16_UINT)를 쓰는 메시
+	void UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList, const void* vertices, UINT numVertices, UINT vertexByteStride,
+		const void* indices, UINT numIndices, DXGI_FORMAT indexFormat);
+
+	// 정점/인덱스 버퍼를 만들지 않고 이미 올라간 공유 버퍼의 구간을 가리킨다.
+	void SetBufferLocation(D3D12_GPU_VIRTUAL_ADDRESS vertexBuffer, UINT vertexByteStride, UINT vertexBufferByteSize,
+		D3D12_GPU_VIRTUAL_ADDRESS indexBuffer, UINT indexBufferByteSize);
 
 	D3D12_VERTEX_BUFFER_VIEW VertexBufferView()const;
 	D3D12_INDEX_BUFFER_VIEW IndexBufferView()const;
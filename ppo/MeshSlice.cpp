@@ -1,4 +1,5 @@
 #include "MeshSlice.h"
+#include <cfloat>
 
 template<typename VertexType>
 inline void ConvertBlobToVertexVector(std::vector<VertexType>& vertices, ID3DBlob* blob)
@@ -56,277 +57,1559 @@ void ConvertBlobToIndexVector(std::vector<UINT>& indices, const Submesh submesh,
     memcpy(indices.data(), dataBegin + baseIndexSize, submesh.numIndices * sizeof(UINT));
 }
 
-Vertex InterpolationVertexNormalAndTexC(const XMVECTOR plane, const Vertex vertex1, const Vertex vertex2)
+// 위치 사전순 비교, 같은 변을 어느 쪽에서 보간하든 같은 결과를 내도록 순서를 정할 때 쓴다.
+static bool LessPosition(const XMFLOAT3& a, const XMFLOAT3& b)
 {
-    Vertex vertex;
-    XMStoreFloat3(&vertex.Pos, XMPlaneIntersectLine(plane, XMLoadFloat3(&vertex1.Pos), XMLoadFloat3(&vertex2.Pos)));
+    if (a.x != b.x) return a.x < b.x;
+    if (a.y != b.y) return a.y < b.y;
+    return a.z < b.z;
+}
 
-    float t = Vector3::DistanceBetweenPoints(vertex1.Pos, vertex.Pos) / Vector3::DistanceBetweenPoints(vertex1.Pos, vertex2.Pos);
-    
-    vertex.Normal.x = vertex1.Normal.x * (1 - t) + vertex2.Normal.x * t;
-    vertex.Normal.y = vertex1.Normal.y * (1 - t) + vertex2.Normal.y * t;
-    vertex.Normal.z = vertex1.Normal.z * (1 - t) + vertex2.Normal.z * t;
+static float MaxAbsComponent(const XMFLOAT3& pos)
+{
+    return max(fabs(pos.x), max(fabs(pos.y), fabs(pos.z)));
+}
 
-    vertex.TexC.x = vertex1.TexC.x * (1 - t) + vertex2.TexC.x * t;
-    vertex.TexC.y = vertex1.TexC.y * (1 - t) + vertex2.TexC.y * t;
+// 용접 격자 칸 좌표를 축마다 21비트로 묶은 키
+// 칸 크기는 좌표 최댓값의 4e-6 이상이므로 칸 좌표(와 이웃 칸)는 2^20 안에 든다.
+static uint64_t CellKey(int64_t x, int64_t y, int64_t z)
+{
+    const int64_t bias = (int64_t)1 << 20;
+    return ((uint64_t)(x + bias) << 42) | ((uint64_t)(y + bias) << 21) | (uint64_t)(z + bias);
+}
 
-    return vertex;
+// firstPlane 이후 평면마다 pos가 평면 양쪽/반대쪽에 있으면 sides[0]/[1]의 비트를 켠다.
+static array<uint64_t, 2> ClassifyPosition(const XMFLOAT3& pos, span<const XMFLOAT4> planes, int firstPlane, int numPlanes)
+{
+    array<uint64_t, 2> sides = { 0, 0 };
+    for (int plane = firstPlane; plane < numPlanes; plane++)
+    {
+        float dp = SliceKernel::PlaneDistance(pos, planes[plane]);
+        if (dp > 0)
+            sides[0] |= (uint64_t)1 << plane;
+        else if (dp < 0)
+            sides[1] |= (uint64_t)1 << plane;
+    }
+    return sides;
 }
 
-int MeshSlice::MeshCompleteSlice(const Mesh* targetMesh, const Submesh submesh, const XMFLOAT4 plane, vector<vector<Vertex>>& outVertices, vector<vector<UINT>>& outIndices)
+// submesh 인덱스가 가리키는 정점 수 (최대 인덱스 + 1)
+static UINT CountReferencedVertices(const UINT* indices, UINT numIndices)
 {
-    XMVECTOR planeVector = XMLoadFloat4(&plane);
+    UINT numVertices = 0;
+    for (UINT i = 0; i < numIndices; i++)
+        numVertices = max(numVertices, indices[i] + 1);
+    return numVertices;
+}
+
+// 변 위의 절단 정점
+// 두 끝점의 위치 순서로 보간한다.
+// 면마다 정점을 따로 가진 메시(box 등)는 같은 변이 인덱스가 다른 변으로 나뉘는데, 이때도 절단 정점의 위치가 비트 단위로 같다.
+template <typename VertexType>
+static VertexType EdgeCutVertex(const VertexType* vertices, const float* distances, UINT index0, UINT index1)
+{
+    if (LessPosition(vertices[index1].Pos, vertices[index0].Pos))
+        swap(index0, index1);
+    return SliceKernel::InterpolateEdge(vertices[index0], vertices[index1], distances[index0], distances[index1]);
+}
+
+// 면의 인덱스를 추가하고, 절단면 위의 변은 면이 지나는 방향의 반대로 절단면 경계에 추가한다.
+template <typename Corner>
+static void AppendFace(vector<UINT>& indices, vector<array<UINT, 2>>& segments, const Corner& c0, const Corner& c1, const Corner& c2)
+{
+    const Corner* corners[3] = { &c0, &c1, &c2 };
+    for (int k = 0; k < 3; k++)
+    {
+        indices.push_back(corners[k]->vertex);
+
+        UINT cutPoint0 = corners[k]->cutPoint;
+        UINT cutPoint1 = corners[(k + 1) % 3]->cutPoint;
+        if (cutPoint0 != UINT_MAX && cutPoint1 != UINT_MAX && cutPoint0 != cutPoint1)
+            segments.push_back({ cutPoint1, cutPoint0 });
+    }
+}
+
+// 병렬 처리 구간 수
+static int NumChunks(UINT count, UINT chunkSize)
+{
+    return (int)((count + chunkSize - 1) / chunkSize);
+}
+
+void MeshSlice::EdgeTable::Clear()
+{
+    for (Entry& entry : mEntries)
+        entry.key = EmptyKey;
+    mCount = 0;
+}
+
+size_t MeshSlice::EdgeTable::FindSlot(uint64_t key) const
+{
+    // key가 있는 칸 또는 key를 넣을 빈 칸
+    size_t mask = mEntries.size() - 1;
+    size_t i = (size_t)((key * 0x9E3779B97F4A7C15ull) >> mShift);
+    while (mEntries[i].key != key && mEntries[i].key != EmptyKey)
+        i = (i + 1) & mask;
+    return i;
+}
 
-    // targetMesh vertex/index data 
-    vector<Vertex>vertices;
-    vector<UINT>indices;
-    ConvertBlobToIndexVector(indices, submesh, targetMesh->mIndexBufferCPU.Get());
-    int maxIndex = *max_element(indices.begin(), indices.end());
-    ConvertBlobToVertexVector<Vertex>(vertices, submesh, maxIndex, targetMesh->mVertexBufferCPU.Get());
+bool MeshSlice::EdgeTable::Insert(uint64_t key, UINT value, UINT*& slot)
+{
+    // 채움 비율을 1/2 이하로 유지한다.
+    if ((mCount + 1) * 2 > mEntries.size())
+        Grow();
+
+    Entry& entry = mEntries[FindSlot(key)];
+    slot = &entry.value;
+    if (entry.key == key)
+        return false;
+
+    entry.key = key;
+    entry.value = value;
+    mCount++;
+    return true;
+}
 
-    vector<Vertex> slicingVertices[2]; // half space = slicingMesh1, oppoiste half space = slicingMesh2
-    vector<UINT> slicingIndices[2]; // slicingMesh1, slicingMesh2
-    unordered_map<Vertex, array<UINT, 2>, Vertex::Hash> addedVertices;
-    vector<array<UINT, 2>> cuttingSurfaceIndices[2];  // ܸ  и (index, windingOrder   index)
+const UINT* MeshSlice::EdgeTable::Find(uint64_t key) const
+{
+    if (mEntries.empty())
+        return nullptr;
+    const Entry& entry = mEntries[FindSlot(key)];
+    return (entry.key == key) ? &entry.value : nullptr;
+}
 
-    int numVertices = (int)vertices.size();
-    int numIndices = (int)indices.size();
+void MeshSlice::EdgeTable::Grow()
+{
+    vector<Entry> entries(max<size_t>(64, mEntries.size() * 2), Entry{ EmptyKey, 0 });
+    entries.swap(mEntries);
 
-    vector<array<int, 2>> newIndices(numVertices);  // targetMesh index -> slicingMesh1, slicingMesh2 index
-    // slicingMesh index -1   ش ޽ÿ Ե ʴ ̴.
+    int bits = 0;
+    while (((size_t)1 << bits) < mEntries.size())
+        bits++;
+    mShift = 64 - bits;
 
-    //  и
-    for (int i = 0; i < numVertices; i++)
+    for (const Entry& entry : entries)
     {
-        Vertex vertex = vertices[i];
+        if (entry.key != EmptyKey)
+            mEntries[FindSlot(entry.key)] = entry;
+    }
+}
+
+template <typename VertexType>
+int MeshSlice::BasicSliceContext<VertexType>::Slice(const Mesh* targetMesh, const Submesh& submesh, const XMFLOAT4& plane, ThreadPool* threadPool)
+{
+    // targetMesh의 vertex/index data : 인덱스는 submesh.baseVertex 기준이다.
+    const VertexType* vertices = static_cast<const VertexType*>(targetMesh->mVertexBufferCPU->GetBufferPointer()) + submesh.baseVertex;
+    const UINT* indices = static_cast<const UINT*>(targetMesh->mIndexBufferCPU->GetBufferPointer()) + submesh.baseIndex;
+
+    return Slice(vertices, CountReferencedVertices(indices, submesh.numIndices), indices, submesh.numIndices, plane, threadPool);
+}
+
+template <typename VertexType>
+int MeshSlice::BasicSliceContext<VertexType>::Slice(const VertexType* vertices, UINT numVertices, const UINT* indices, UINT numIndices, const XMFLOAT4& plane, ThreadPool* threadPool)
+{
+    Reserve(numVertices, numIndices);
 
-        //     ġ 
-        float dp = vertex.Pos.x * plane.x + vertex.Pos.y * plane.y + vertex.Pos.z * plane.z + plane.w;
-        if (dp > 0) { // half space
-            newIndices[i] = { (int)slicingVertices[0].size(), -1 };
-            slicingVertices[0].push_back(vertex);
+    // 구간이 2개 이상 나올 때만 나눈다. 절단면 채우기는 절단면 경계 크기에 비례하므로 단일 스레드로 처리한다.
+    bool parallel = threadPool && threadPool->NumThreads() > 1;
+    if (parallel && numVertices >= ParallelGrainSize * 2)
+        ClassifyVertices(*threadPool, vertices, numVertices, plane);
+    else
+        ClassifyVertices(vertices, numVertices, plane);
+
+    if (parallel && numIndices / 3 >= ParallelGrainSize * 2)
+        SplitFaces(*threadPool, vertices, indices, numIndices, plane);
+    else
+        SplitFaces(vertices, indices, numIndices, plane);
+    FillCuttingSurface(plane);
+
+    mNumPieces = 2;
+    return mNumPieces;
+}
+
+template <typename VertexType>
+size_t MeshSlice::BasicSliceContext<VertexType>::ScratchByteSize() const
+{
+    size_t byteSize = mNewIndices.capacity() * sizeof(array<int, 2>);
+    byteSize += mCutPointTable.ByteSize() + mCutPoints.capacity() * sizeof(CutPoint) + mWeldTable.ByteSize() + mSegmentTable.ByteSize() + mSegmentNext.capacity() * sizeof(UINT) + mSegmentUsed.capacity();
+    byteSize += (mLoopVertices.capacity() + mLoopEnds.capacity() + mLoopPositions.capacity()) * sizeof(UINT) + mCapPoints.capacity() * sizeof(XMFLOAT2) + mTriangulator.ScratchByteSize();
+    byteSize += mDistances.capacity() * sizeof(float) + mVertexSides.capacity() + mChunkCounts.capacity() * sizeof(array<UINT, 2>) + mSplitChunks.capacity() * sizeof(SplitChunk);
+    for (const SplitChunk& chunk : mSplitChunks)
+    {
+        byteSize += chunk.cutPointTable.ByteSize() + chunk.cutPoints.capacity() * sizeof(typename SplitChunk::LocalCutPoint) + chunk.globalCutPoints.capacity() * sizeof(UINT);
+        for (int space = 0; space < 2; space++)
+            byteSize += chunk.indices[space].capacity() * sizeof(UINT) + chunk.segments[space].capacity() * sizeof(array<UINT, 2>);
+    }
+    for (int space = 0; space < 2; space++)
+    {
+        byteSize += mSlicingVertices[space].capacity() * sizeof(VertexType);
+        byteSize += (mSlicingIndices[space].capacity() + mSourceVertices[space].capacity()) * sizeof(UINT);
+        byteSize += mCuttingSurfaceSegments[space].capacity() * sizeof(array<UINT, 2>);
+    }
+    return byteSize;
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::Reserve(UINT numVertices, UINT numIndices)
+{
+    // 한쪽 조각은 최대 원본 전체와 절단으로 생기는 정점/면을 가진다.
+    // 절단된 면은 정점 2개와 절단면 정점 2개, 면 2개를 추가하므로 원본 크기의 2배를 잡아 두면 대부분 다시 늘어나지 않는다.
+    mNewIndices.resize(numVertices);
+    mDistances.resize(numVertices);
+    mVertexSides.resize(numVertices);
+    mCutPointTable.Clear();
+    mCutPoints.clear();
+    mCutPointScale = 0.0f;
+    for (int space = 0; space < 2; space++)
+    {
+        mSlicingVertices[space].clear();
+        mSlicingIndices[space].clear();
+        mSourceVertices[space].clear();
+        mCuttingSurfaceSegments[space].clear();
+
+        mSlicingVertices[space].reserve((size_t)numVertices * 2);
+        mSlicingIndices[space].reserve((size_t)numIndices * 2);
+        mSourceVertices[space].reserve((size_t)numVertices * 2);
+    }
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::ClassifyVertices(const VertexType* vertices, UINT numVertices, const XMFLOAT4& plane)
+{
+    // 절단 면을 기준으로 정점의 위치를 구분하고, 평면 거리는 변을 자를 때 다시 쓴다.
+    array<UINT, 2> counts = SliceKernel::ClassifyPositions(&vertices[0].Pos, sizeof(VertexType), numVertices, plane, mDistances.data(), mVertexSides.data());
+
+    for (int space = 0; space < 2; space++)
+    {
+        mSlicingVertices[space].resize(counts[space]);
+        mSourceVertices[space].resize(counts[space]);
+    }
+    CompactVertices(vertices, 0, numVertices, { 0, 0 });
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::ClassifyVertices(ThreadPool& threadPool, const VertexType* vertices, UINT numVertices, const XMFLOAT4& plane)
+{
+    // 1. 구간마다 정점이 놓인 쪽을 기록하고 조각별 정점 수를 센다.
+    int numChunks = NumChunks(numVertices, ParallelGrainSize);
+    mChunkCounts.resize(numChunks);
+    threadPool.ParallelFor(numChunks, 1, [&](int beginChunk, int endChunk) {
+        for (int chunk = beginChunk; chunk < endChunk; chunk++)
+        {
+            UINT begin = chunk * ParallelGrainSize;
+            UINT end = min(begin + ParallelGrainSize, numVertices);
+            mChunkCounts[chunk] = SliceKernel::ClassifyPositions(&vertices[begin].Pos, sizeof(VertexType), end - begin, plane, &mDistances[begin], &mVertexSides[begin]);
         }
-        else if (dp < 0) { // oppoiste half space
-            newIndices[i] = { -1, (int)slicingVertices[1].size() };
-            slicingVertices[1].push_back(vertex);
+    });
+
+    // 2. 구간별 정점 수의 누적 합이 각 구간이 쓸 위치가 된다.
+    array<UINT, 2> totals = { 0, 0 };
+    for (array<UINT, 2>& counts : mChunkCounts)
+    {
+        for (int space = 0; space < 2; space++)
+        {
+            UINT count = counts[space];
+            counts[space] = totals[space];
+            totals[space] += count;
         }
-        else {  // ܸ  
-            newIndices[i] = { (int)slicingVertices[0].size(), (int)slicingVertices[1].size() };
-            slicingVertices[0].push_back(vertex);
-            slicingVertices[1].push_back(vertex);
+    }
+    for (int space = 0; space < 2; space++)
+    {
+        mSlicingVertices[space].resize(totals[space]);
+        mSourceVertices[space].resize(totals[space]);
+    }
+
+    // 3. 단일 스레드와 같은 순서로 정점을 복사한다.
+    threadPool.ParallelFor(numChunks, 1, [&](int beginChunk, int endChunk) {
+        for (int chunk = beginChunk; chunk < endChunk; chunk++)
+            CompactVertices(vertices, chunk * ParallelGrainSize, min((chunk + 1) * ParallelGrainSize, numVertices), mChunkCounts[chunk]);
+    });
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::CompactVertices(const VertexType* vertices, UINT begin, UINT end, array<UINT, 2> next)
+{
+    for (UINT i = begin; i < end; i++)
+    {
+        uint8_t side = mVertexSides[i];
+        for (int space = 0; space < 2; space++)
+        {
+            if (side & (1 << space)) {
+                mNewIndices[i][space] = (int)next[space];
+                mSlicingVertices[space][next[space]] = vertices[i];
+                mSourceVertices[space][next[space]] = i;
+                next[space]++;
+            }
+            else
+                mNewIndices[i][space] = -1;
         }
     }
+}
+
+template <typename VertexType>
+UINT MeshSlice::BasicSliceContext<VertexType>::AddVertexCutPoint(UINT index)
+{
+    UINT cutPoint = (UINT)mCutPoints.size();
+    mCutPoints.push_back({ { (UINT)mNewIndices[index][0], (UINT)mNewIndices[index][1] }, { UINT_MAX, UINT_MAX }, UINT_MAX });
+    mCutPointScale = max(mCutPointScale, MaxAbsComponent(CutPointPos(cutPoint)));
+    return cutPoint;
+}
+
+template <typename VertexType>
+UINT MeshSlice::BasicSliceContext<VertexType>::AddEdgeCutPoint(const VertexType& vertex)
+{
+    CutPoint point = { {}, { UINT_MAX, UINT_MAX }, UINT_MAX };
+    for (int space = 0; space < 2; space++)
+    {
+        point.vertex[space] = (UINT)mSlicingVertices[space].size();
+        mSlicingVertices[space].push_back(vertex);
+        mSourceVertices[space].push_back(UINT_MAX);
+    }
+    mCutPoints.push_back(point);
+    mCutPointScale = max(mCutPointScale, MaxAbsComponent(vertex.Pos));
+    return (UINT)mCutPoints.size() - 1;
+}
+
+template <typename VertexType>
+UINT MeshSlice::BasicSliceContext<VertexType>::CutPointOnVertex(UINT index)
+{
+    UINT* cutPoint;
+    if (mCutPointTable.Insert(EdgeTable::Key(index, index), (UINT)mCutPoints.size(), cutPoint))
+        AddVertexCutPoint(index);
+    return *cutPoint;
+}
+
+template <typename VertexType>
+UINT MeshSlice::BasicSliceContext<VertexType>::CutPointOnEdge(const VertexType* vertices, UINT index0, UINT index1)
+{
+    UINT* cutPoint;
+    if (mCutPointTable.Insert(EdgeTable::UndirectedKey(index0, index1), (UINT)mCutPoints.size(), cutPoint))
+        AddEdgeCutPoint(EdgeCutVertex(vertices, mDistances.data(), index0, index1));
+    return *cutPoint;
+}
+
+template <typename VertexType>
+typename MeshSlice::BasicSliceContext<VertexType>::Corner MeshSlice::BasicSliceContext<VertexType>::OriginalCorner(UINT index, int space)
+{
+    bool onPlane = mNewIndices[index][0] != -1 && mNewIndices[index][1] != -1;
+    return { (UINT)mNewIndices[index][space], onPlane ? CutPointOnVertex(index) : UINT_MAX };
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::AddUncutFace(int space, UINT vertex0, UINT vertex1, UINT vertex2)
+{
+    mSlicingIndices[space].push_back(vertex0);
+    mSlicingIndices[space].push_back(vertex1);
+    mSlicingIndices[space].push_back(vertex2);
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::AddFace(int space, const Corner& c0, const Corner& c1, const Corner& c2)
+{
+    AppendFace(mSlicingIndices[space], mCuttingSurfaceSegments[space], c0, c1, c2);
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::SplitChunk::Clear(const array<int, 2>* newIndices, const float* distances)
+{
+    this->newIndices = newIndices;
+    this->distances = distances;
+    cutPointTable.Clear();
+    cutPoints.clear();
+    for (int space = 0; space < 2; space++)
+    {
+        indices[space].clear();
+        segments[space].clear();
+    }
+}
+
+template <typename VertexType>
+UINT MeshSlice::BasicSliceContext<VertexType>::SplitChunk::CutPointOnVertex(UINT index)
+{
+    UINT* cutPoint;
+    uint64_t key = EdgeTable::Key(index, index);
+    if (cutPointTable.Insert(key, (UINT)cutPoints.size(), cutPoint))
+        cutPoints.push_back({ key, index, {} });
+    return *cutPoint;
+}
+
+template <typename VertexType>
+UINT MeshSlice::BasicSliceContext<VertexType>::SplitChunk::CutPointOnEdge(const VertexType* vertices, UINT index0, UINT index1)
+{
+    UINT* cutPoint;
+    uint64_t key = EdgeTable::UndirectedKey(index0, index1);
+    if (cutPointTable.Insert(key, (UINT)cutPoints.size(), cutPoint))
+        cutPoints.push_back({ key, UINT_MAX, EdgeCutVertex(vertices, distances, index0, index1) });
+    return *cutPoint;
+}
 
-    int numFace = numIndices / 3;
-    // targetMesh  鿡 Ե  ġ   иѴ.
-    for (int i = 0; i < numFace; i++)
+template <typename VertexType>
+typename MeshSlice::BasicSliceContext<VertexType>::Corner MeshSlice::BasicSliceContext<VertexType>::SplitChunk::OriginalCorner(UINT index, int space)
+{
+    bool onPlane = newIndices[index][0] != -1 && newIndices[index][1] != -1;
+    return { (UINT)newIndices[index][space], onPlane ? CutPointOnVertex(index) : UINT_MAX };
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::SplitChunk::AddUncutFace(int space, UINT vertex0, UINT vertex1, UINT vertex2)
+{
+    indices[space].push_back(vertex0);
+    indices[space].push_back(vertex1);
+    indices[space].push_back(vertex2);
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::SplitChunk::AddFace(int space, const Corner& c0, const Corner& c1, const Corner& c2)
+{
+    AppendFace(indices[space], segments[space], c0, c1, c2);
+}
+
+template <typename VertexType>
+template <typename Output>
+void MeshSlice::BasicSliceContext<VertexType>::SplitFaceRange(Output& output, const VertexType* vertices, const UINT* indices, UINT beginFace, UINT endFace, const XMVECTOR& planeVector)
+{
+    // targetMesh의 각 면에 포함된 정점의 위치에 따라 정점을 분리한다.
+    for (UINT i = beginFace; i < endFace; i++)
     {
         UINT index[3] = { indices[i * 3], indices[i * 3 + 1], indices[i * 3 + 2] };
-        int vertexPos[3];   //  ġ  з. Ѵ  = 0, slicingMesh1 = 1, slicingMesh2 = 2
+        int vertexPos[3];   // 정점 위치에 따라 분류. 둘다 포함 = 0, slicingMesh1 = 1, slicingMesh2 = 2
+        int numVertexPos[3] = { 0, 0, 0 };
         for (int j = 0; j < 3; j++)
-            vertexPos[j] = (newIndices[index[j]][0] != -1) ? (newIndices[index[j]][1] != -1) ? 0 : 1 : 2;
-
-        // 3     ش   ߰
-        if (vertexPos[0] == vertexPos[1] && vertexPos[1] == vertexPos[2]) {
-            if (vertexPos[0] == 1) { // slicingMesh1
-                slicingIndices[0].push_back(newIndices[index[0]][0]);
-                slicingIndices[0].push_back(newIndices[index[1]][0]);
-                slicingIndices[0].push_back(newIndices[index[2]][0]);
+        {
+            vertexPos[j] = (mNewIndices[index[j]][0] != -1) ? (mNewIndices[index[j]][1] != -1) ? 0 : 1 : 2;
+            numVertexPos[vertexPos[j]]++;
+        }
+
+        // 3점이 같은 공간에 존재할 경우 해당 면을 전부 추가 (대부분의 면)
+        if (numVertexPos[1] == 3 || numVertexPos[2] == 3) {
+            int space = numVertexPos[1] == 3 ? 0 : 1;
+            output.AddUncutFace(space, mNewIndices[index[0]][space], mNewIndices[index[1]][space], mNewIndices[index[2]][space]);
+        }
+        // 한쪽 공간에만 정점이 있으면 (절단면 위의 정점 포함) 면을 그대로 해당 조각에 추가
+        else if (numVertexPos[1] == 0 || numVertexPos[2] == 0) {
+            int space;
+            if (numVertexPos[1] > 0)
+                space = 0;
+            else if (numVertexPos[2] > 0)
+                space = 1;
+            else {
+                // 세 정점이 모두 절단면 위 : 면이 절단면 법선 방향을 보면 oppoiste half space 조각의 겉면이다.
+                XMVECTOR p0 = XMLoadFloat3(&vertices[index[0]].Pos);
+                XMVECTOR faceNormal = XMVector3Cross(XMLoadFloat3(&vertices[index[1]].Pos) - p0, XMLoadFloat3(&vertices[index[2]].Pos) - p0);
+                space = XMVectorGetX(XMVector3Dot(faceNormal, planeVector)) > 0.0f ? 1 : 0;
             }
-            else if (vertexPos[0] == 2) { // slicingMesh2
-                slicingIndices[1].push_back(newIndices[index[0]][1]);
-                slicingIndices[1].push_back(newIndices[index[1]][1]);
-                slicingIndices[1].push_back(newIndices[index[2]][1]);
+            output.AddFace(space, output.OriginalCorner(index[0], space), output.OriginalCorner(index[1], space), output.OriginalCorner(index[2], space));
+        }
+        // 모든 정점이 절단면 위에 존재하지 않으며 한 점이 다른 두점과 서로 다른 공간에 존재 -> 면 절단, 새로운 정점 2개 생성
+        else if (numVertexPos[0] == 0) {
+            int other = (vertexPos[1] == vertexPos[2]) ? 0 : (vertexPos[0] == vertexPos[2]) ? 1 : 2;
+            UINT otherIndex = index[other];
+            UINT sameIndex[2] = { index[(other + 1) % 3], index[(other + 2) % 3] };
+
+            // otherSpace = otherIndex의 정점이 위치한 조각
+            int otherSpace = vertexPos[other] - 1;
+            int space = 1 - otherSpace;
+
+            UINT cutPoint[2] = {
+                output.CutPointOnEdge(vertices, otherIndex, sameIndex[0]),
+                output.CutPointOnEdge(vertices, otherIndex, sameIndex[1]) };
+
+            // otherVertex가 있는 위치의 새로운 면 생성 face = {ohterVertex, newVertex0, newVertex1}
+            output.AddFace(otherSpace, output.OriginalCorner(otherIndex, otherSpace), output.CutCorner(cutPoint[0], otherSpace), output.CutCorner(cutPoint[1], otherSpace));
+
+            // sameVertex가 있는 위치의 새로운 면 생성 
+            // face = {newVertex0, sameVertex1, newVertex1}
+            output.AddFace(space, output.CutCorner(cutPoint[0], space), output.OriginalCorner(sameIndex[1], space), output.CutCorner(cutPoint[1], space));
+            // face = {sameVertex0, sameVertex1, newVertex0}
+            output.AddFace(space, output.OriginalCorner(sameIndex[0], space), output.OriginalCorner(sameIndex[1], space), output.CutCorner(cutPoint[0], space));
+        }
+        // 한 점은 절단면 위, 나머지 두 점은 서로 다른 공간 -> 맞은편 변만 절단, 새로운 정점 1개 생성
+        else {
+            int middle = (vertexPos[0] == 0) ? 0 : (vertexPos[1] == 0) ? 1 : 2;
+            UINT middleIndex = index[middle];
+            UINT otherIndex[2] = { index[(middle + 1) % 3], index[(middle + 2) % 3] };
+
+            // otherSpace[i] = otherIndex[i]의 정점이 위치한 조각
+            int otherSpace[2] = { vertexPos[(middle + 1) % 3] - 1, vertexPos[(middle + 2) % 3] - 1 };
+
+            UINT cutPoint = output.CutPointOnEdge(vertices, otherIndex[0], otherIndex[1]);
+
+            // face = {middleVertex, otherVertex0, newVertex}
+            output.AddFace(otherSpace[0], output.OriginalCorner(middleIndex, otherSpace[0]), output.OriginalCorner(otherIndex[0], otherSpace[0]), output.CutCorner(cutPoint, otherSpace[0]));
+            // face = {middleVertex, newVertex, otherVertex1}
+            output.AddFace(otherSpace[1], output.OriginalCorner(middleIndex, otherSpace[1]), output.CutCorner(cutPoint, otherSpace[1]), output.OriginalCorner(otherIndex[1], otherSpace[1]));
+        }
+    }
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::SplitFaces(const VertexType* vertices, const UINT* indices, UINT numIndices, const XMFLOAT4& plane)
+{
+    SplitFaceRange(*this, vertices, indices, 0, numIndices / 3, XMLoadFloat4(&plane));
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::SplitFaces(ThreadPool& threadPool, const VertexType* vertices, const UINT* indices, UINT numIndices, const XMFLOAT4& plane)
+{
+    XMVECTOR planeVector = XMLoadFloat4(&plane);
+
+    // 1. 구간마다 지역 CutPoint 번호로 면을 나눈다.
+    UINT numFaces = numIndices / 3;
+    int numChunks = NumChunks(numFaces, ParallelGrainSize);
+    if ((int)mSplitChunks.size() < numChunks)
+        mSplitChunks.resize(numChunks);
+    threadPool.ParallelFor(numChunks, 1, [&](int beginChunk, int endChunk) {
+        for (int chunk = beginChunk; chunk < endChunk; chunk++)
+        {
+            SplitChunk& output = mSplitChunks[chunk];
+            output.Clear(mNewIndices.data(), mDistances.data());
+            SplitFaceRange(output, vertices, indices, chunk * ParallelGrainSize, min((chunk + 1) * ParallelGrainSize, numFaces), planeVector);
+        }
+    });
+
+    // 2. 구간 순서대로 CutPoint를 전역 테이블에 넣는다. 처음 만난 순서가 단일 스레드와 같으므로 번호와 절단 정점 위치도 같다.
+    size_t numSlicingIndices[2] = { 0, 0 };
+    size_t numSegments[2] = { 0, 0 };
+    for (int chunk = 0; chunk < numChunks; chunk++)
+    {
+        SplitChunk& output = mSplitChunks[chunk];
+        output.globalCutPoints.resize(output.cutPoints.size());
+        for (size_t i = 0; i < output.cutPoints.size(); i++)
+        {
+            const typename SplitChunk::LocalCutPoint& point = output.cutPoints[i];
+            UINT* cutPoint;
+            if (mCutPointTable.Insert(point.key, (UINT)mCutPoints.size(), cutPoint)) {
+                if (point.index != UINT_MAX)
+                    AddVertexCutPoint(point.index);
+                else
+                    AddEdgeCutPoint(point.vertex);
             }
-            else {  // slicingMesh1 & slicingMesh2
-                slicingIndices[0].push_back(newIndices[index[0]][0]);
-                slicingIndices[0].push_back(newIndices[index[1]][0]);
-                slicingIndices[0].push_back(newIndices[index[2]][0]);
-
-                slicingIndices[1].push_back(newIndices[index[0]][1]);
-                slicingIndices[1].push_back(newIndices[index[1]][1]);
-                slicingIndices[1].push_back(newIndices[index[2]][1]);
+            output.globalCutPoints[i] = *cutPoint;
+        }
+
+        for (int space = 0; space < 2; space++)
+        {
+            output.firstIndex[space] = numSlicingIndices[space];
+            output.firstSegment[space] = numSegments[space];
+            numSlicingIndices[space] += output.indices[space].size();
+            numSegments[space] += output.segments[space].size();
+        }
+    }
+
+    // 3. 지역 번호를 바꿔 가며 구간 결과를 이어 붙인다.
+    for (int space = 0; space < 2; space++)
+    {
+        mSlicingIndices[space].resize(numSlicingIndices[space]);
+        mCuttingSurfaceSegments[space].resize(numSegments[space]);
+    }
+    threadPool.ParallelFor(numChunks, 1, [&](int beginChunk, int endChunk) {
+        for (int chunk = beginChunk; chunk < endChunk; chunk++)
+        {
+            const SplitChunk& output = mSplitChunks[chunk];
+            for (int space = 0; space < 2; space++)
+            {
+                UINT* slicingIndices = mSlicingIndices[space].data() + output.firstIndex[space];
+                for (UINT index : output.indices[space])
+                {
+                    if (index & SplitChunk::LocalCutPointFlag)
+                        index = mCutPoints[output.globalCutPoints[index & ~SplitChunk::LocalCutPointFlag]].vertex[space];
+                    *slicingIndices++ = index;
+                }
+
+                array<UINT, 2>* segments = mCuttingSurfaceSegments[space].data() + output.firstSegment[space];
+                for (const array<UINT, 2>& segment : output.segments[space])
+                    *segments++ = { output.globalCutPoints[segment[0]], output.globalCutPoints[segment[1]] };
             }
         }
-        // 2   
-        else if (vertexPos[0] == vertexPos[1] || vertexPos[0] == vertexPos[2] || vertexPos[1] == vertexPos[2]) {
-            //  ̶ ܸ  ϴ    Ͼ ʴ´.
-            if (vertexPos[0] == 0 || vertexPos[1] == 0 || vertexPos[2] == 0) {
-                if (vertexPos[0] == 1 || vertexPos[1] == 1 || vertexPos[2] == 1) {  // slicingMesh1
-                    slicingIndices[0].push_back(newIndices[index[0]][0]);
-                    slicingIndices[0].push_back(newIndices[index[1]][0]);
-                    slicingIndices[0].push_back(newIndices[index[2]][0]);
+    });
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::WeldCutPoints()
+{
+    // 절단면 경계에 쓰인 CutPoint 중 허용 오차 안에 있는 것끼리 대표 하나로 합친다.
+    // 인덱스가 다른 같은 위치의 정점(box의 모서리 등)을 지나는 선분도 이어지고, 반대 방향 선분도 서로 지울 수 있다.
+    // 앞선 절단면의 거의 한 직선 위에 있는 가는 삼각형을 다시 자르면 서로 다른 변에서 몇 ulp 차이 나는 절단 정점이 생긴다.
+    // 이런 점을 따로 두면 절단면 좌표로 투영할 때 순서가 뒤집혀 삼각분할이 어긋나므로 함께 합치고, 두 조각의 정점 위치도 대표로 맞춘다.
+    // 각 축 거리가 허용 오차 안인 점을 합친다. 칸은 허용 오차의 4배로 잡고, 칸 경계에서 허용 오차 안에 있는 축만 이웃 칸을 찾는다.
+    float tolerance = max(mCutPointScale * 1e-6f, FLT_MIN);
+    float invCellSize = 0.25f / tolerance;
+
+    mWeldTable.Clear();
+    for (int space = 0; space < 2; space++)
+    {
+        for (const array<UINT, 2>& segment : mCuttingSurfaceSegments[space])
+        {
+            for (UINT cutPointIndex : segment)
+            {
+                CutPoint& cutPoint = mCutPoints[cutPointIndex];
+                if (cutPoint.weld != UINT_MAX)
+                    continue;
+
+                XMFLOAT3 pos = CutPointPos(cutPointIndex);
+                float scaled[3] = { pos.x * invCellSize, pos.y * invCellSize, pos.z * invCellSize };
+                int64_t cell[3];
+                int neighbor[3];    // 축마다 함께 찾을 이웃 칸 (-1, +1, 없으면 0)
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    float cellPos = floorf(scaled[axis]);
+                    float fraction = scaled[axis] - cellPos;
+                    cell[axis] = (int64_t)cellPos;
+                    neighbor[axis] = (fraction <= 0.25f) ? -1 : (fraction >= 0.75f) ? 1 : 0;
                 }
-                else {  // slicingMesh2
-                    slicingIndices[1].push_back(newIndices[index[0]][1]);
-                    slicingIndices[1].push_back(newIndices[index[1]][1]);
-                    slicingIndices[1].push_back(newIndices[index[2]][1]);
+
+                // 자기 칸을 먼저 찾는다.
+                UINT weld = UINT_MAX;
+                for (int i = 0; i < 8 && weld == UINT_MAX; i++)
+                {
+                    int offset[3] = { (i & 1) ? neighbor[0] : 0, (i & 2) ? neighbor[1] : 0, (i & 4) ? neighbor[2] : 0 };
+                    if ((i & 1 && offset[0] == 0) || (i & 2 && offset[1] == 0) || (i & 4 && offset[2] == 0))
+                        continue;
+
+                    const UINT* found = mWeldTable.Find(CellKey(cell[0] + offset[0], cell[1] + offset[1], cell[2] + offset[2]));
+                    if (found == nullptr)
+                        continue;
+                    const XMFLOAT3& weldPos = CutPointPos(*found);
+                    if (fabs(weldPos.x - pos.x) <= tolerance && fabs(weldPos.y - pos.y) <= tolerance && fabs(weldPos.z - pos.z) <= tolerance)
+                        weld = *found;
                 }
+
+                if (weld == UINT_MAX) {
+                    // 칸에 허용 오차 밖의 다른 대표가 이미 있으면 넣지 않고 자신만 대표로 쓴다.
+                    UINT* slot;
+                    mWeldTable.Insert(CellKey(cell[0], cell[1], cell[2]), cutPointIndex, slot);
+                    weld = cutPointIndex;
+                }
+                else {
+                    for (int i = 0; i < 2; i++)
+                        mSlicingVertices[i][cutPoint.vertex[i]].Pos = CutPointPos(weld);
+                }
+                cutPoint.weld = weld;
             }
-            //   ܸ      ٸ   ٸ   ->  , ο  2 
-            else {
-                int sameIndex[2], otherIndex;
-                int otherVertexPos = 0;  // otherVertexPos = otherIndex  ġ 
-                (vertexPos[1] == vertexPos[2]) ?    
-                    // otherVertex = index0 -> sameVertex0, 1 = index1, 2
-                    (otherVertexPos = vertexPos[0], otherIndex = index[0], sameIndex[0] = index[1], sameIndex[1] = index[2]) :
-                    (vertexPos[0] == vertexPos[2]) ?    
-                        // otherVertex = index1 -> sameVertex0, 1 = index2, 0
-                        (otherVertexPos = vertexPos[1], otherIndex = index[1], sameIndex[0] = index[2], sameIndex[1] = index[0]) :
-                        // otherVertex = index2 -> sameVertex0, 1 = index0, 1
-                        (otherVertexPos = vertexPos[2], otherIndex = index[2], sameIndex[0] = index[0], sameIndex[1] = index[1]);
-
-                Vertex newVertex[2] = { 
-                    InterpolationVertexNormalAndTexC(planeVector, vertices[otherIndex], vertices[sameIndex[0]]),
-                    InterpolationVertexNormalAndTexC(planeVector, vertices[otherIndex], vertices[sameIndex[1]]) };
-
-                UINT newVertexIndices[2][2]; // vertexId, space 
-
-                bool vertexAdded = false;
-                for (int vi = 0; vi < 2; vi++)
-                {
-                    auto item = addedVertices.find(newVertex[vi]);
-                    // ο  ߰ ʾҴٸ?  ߰ϰ ε οѴ.
-                    if (item == addedVertices.end()) {
-                        vertexAdded = true;
-                        for (int space = 0; space < 2; space++)
-                        {
-                            newVertexIndices[vi][space] = (UINT)slicingVertices[space].size();
-                            slicingVertices[space].push_back(newVertex[vi]);
-                        }
-                        //--
-                        addedVertices[newVertex[vi]] = { newVertexIndices[vi][0], newVertexIndices[vi][1] };
-                    }
-                    // ο  ̹ ߰Ǿ ִٸ? ش  ε ´.
-                    else {
-                        for (int space = 0; space < 2; space++)
-                            newVertexIndices[vi][space] = item->second[space];
-                    }
+        }
+    }
+
+    for (int space = 0; space < 2; space++)
+    {
+        vector<array<UINT, 2>>& segments = mCuttingSurfaceSegments[space];
+        for (array<UINT, 2>& segment : segments)
+        {
+            segment[0] = mCutPoints[segment[0]].weld;
+            segment[1] = mCutPoints[segment[1]].weld;
+        }
+        segments.erase(remove_if(segments.begin(), segments.end(), [](const array<UINT, 2>& segment) { return segment[0] == segment[1]; }), segments.end());
+    }
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::CancelOpposingSegments(int space)
+{
+    // 같은 변을 서로 반대 방향으로 지나는 선분 쌍은 절단면 위에 놓인 두 면 사이의 변이므로 경계가 아니다.
+    vector<array<UINT, 2>>& segments = mCuttingSurfaceSegments[space];
+    mSegmentTable.Clear();
+    for (UINT i = 0; i < (UINT)segments.size(); i++)
+    {
+        UINT* pairedSegment;
+        if (mSegmentTable.Insert(EdgeTable::UndirectedKey(segments[i][0], segments[i][1]), i, pairedSegment))
+            continue;
+
+        if (*pairedSegment == UINT_MAX)
+            *pairedSegment = i;
+        else if (segments[*pairedSegment][0] == segments[i][1]) {
+            segments[*pairedSegment][0] = UINT_MAX;
+            segments[i][0] = UINT_MAX;
+            *pairedSegment = UINT_MAX;
+        }
+    }
+    segments.erase(remove_if(segments.begin(), segments.end(), [](const array<UINT, 2>& segment) { return segment[0] == UINT_MAX; }), segments.end());
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::ExtractCapLoops(int space)
+{
+    // 선분을 끝점으로 이어 닫힌 루프를 만든다. 닫히지 않는 사슬(원본 메시가 열려 있는 경우)은 버린다.
+    const vector<array<UINT, 2>>& segments = mCuttingSurfaceSegments[space];
+    mLoopVertices.clear();
+    mLoopEnds.clear();
+
+    // 같은 점에서 나가는 선분은 그 점의 사슬 앞에 붙인다.
+    mSegmentTable.Clear();
+    mSegmentNext.resize(segments.size());
+    for (UINT i = 0; i < (UINT)segments.size(); i++)
+    {
+        UINT* head;
+        mSegmentNext[i] = UINT_MAX;
+        if (!mSegmentTable.Insert(EdgeTable::Key(segments[i][0], segments[i][0]), i, head)) {
+            mSegmentNext[i] = *head;
+            *head = i;
+        }
+    }
+
+    // mLoopPositions는 호출 사이에 모두 UINT_MAX로 남겨 둔다.
+    if (mLoopPositions.size() < mCutPoints.size())
+        mLoopPositions.resize(mCutPoints.size(), UINT_MAX);
+    mSegmentUsed.assign(segments.size(), 0);
+    for (UINT start = 0; start < (UINT)segments.size(); start++)
+    {
+        if (mSegmentUsed[start])
+            continue;
+
+        size_t loopBegin = mLoopVertices.size();
+        UINT segment = start;
+        while (segment != UINT_MAX)
+        {
+            mSegmentUsed[segment] = 1;
+            mLoopPositions[segments[segment][0]] = (UINT)mLoopVertices.size();
+            mLoopVertices.push_back(segments[segment][0]);
+
+            // 사슬이 지나온 점으로 돌아오면 그 점부터 끝까지가 닫힌 루프다. 시작점이 아닌 점(pinch)이면
+            // 닫힌 부분을 떼어 사슬 앞으로 옮겨 루프로 내보내고, 남은 사슬은 그 점에서 계속 잇는다.
+            UINT end = segments[segment][1];
+            UINT position = mLoopPositions[end];
+            if (position != UINT_MAX) {
+                for (size_t i = position; i < mLoopVertices.size(); i++)
+                    mLoopPositions[mLoopVertices[i]] = UINT_MAX;
+                size_t loopSize = mLoopVertices.size() - position;
+                rotate(mLoopVertices.begin() + loopBegin, mLoopVertices.begin() + position, mLoopVertices.end());
+                if (loopSize >= 3) {
+                    loopBegin += loopSize;
+                    mLoopEnds.push_back((UINT)loopBegin);
                 }
-                
-                // ܸ  
-                if (vertexAdded) {
-                    Vertex cuttingSurfaceNewVertex[2] = { newVertex[0], newVertex[1] };
-                    XMVECTOR normalVector = XMVector4Normalize(XMVectorSet(plane.x, plane.y, plane.z, 0.0f));
-
-                    // otherVertex  ִ  newVertex[1] -> newVertex[0]    
-                    int otherSpace = otherVertexPos == 1 ? 0 : 1;
-                    int space = 1 - otherSpace;
-                    
-                    // otherSpace ܸ  ä
-                    XMStoreFloat3(&cuttingSurfaceNewVertex[0].Normal, normalVector);
-                    XMStoreFloat3(&cuttingSurfaceNewVertex[1].Normal, normalVector);
-                    slicingVertices[otherSpace].push_back(cuttingSurfaceNewVertex[0]);
-                    slicingVertices[otherSpace].push_back(cuttingSurfaceNewVertex[1]);
-                    cuttingSurfaceIndices[otherSpace].push_back({ (UINT)slicingVertices[otherSpace].size() - 1, (UINT)slicingVertices[otherSpace].size() - 2 });
-
-                    // space ܸ  ä
-                    XMStoreFloat3(&cuttingSurfaceNewVertex[0].Normal, -normalVector);
-                    XMStoreFloat3(&cuttingSurfaceNewVertex[1].Normal, -normalVector);
-                    slicingVertices[space].push_back(cuttingSurfaceNewVertex[0]);
-                    slicingVertices[space].push_back(cuttingSurfaceNewVertex[1]);
-                    cuttingSurfaceIndices[space].push_back({ (UINT)slicingVertices[space].size() - 2, (UINT)slicingVertices[space].size() - 1 });
+                else
+                    mLoopVertices.erase(mLoopVertices.begin() + loopBegin, mLoopVertices.begin() + loopBegin + loopSize);
+                for (size_t i = loopBegin; i < mLoopVertices.size(); i++)
+                    mLoopPositions[mLoopVertices[i]] = (UINT)i;
+            }
+
+            // end에서 나가는 선분 중 아직 쓰지 않은 것
+            const UINT* head = mSegmentTable.Find(EdgeTable::Key(end, end));
+            segment = head ? *head : UINT_MAX;
+            while (segment != UINT_MAX && mSegmentUsed[segment])
+                segment = mSegmentNext[segment];
+        }
+
+        for (size_t i = loopBegin; i < mLoopVertices.size(); i++)
+            mLoopPositions[mLoopVertices[i]] = UINT_MAX;
+        mLoopVertices.resize(loopBegin);
+    }
+}
+
+template <typename VertexType>
+void MeshSlice::BasicSliceContext<VertexType>::FillCuttingSurface(const XMFLOAT4& plane)
+{
+    WeldCutPoints();
+
+    // 절단면 좌표계 : u, v는 절단면 위의 직교 축 (u x v = 절단면 법선)
+    // 두 조각의 절단면 법선은 서로 반대이므로 opposite 쪽은 v를 뒤집어 어느 조각이든 바깥 루프가 반시계 방향이 되게 한다.
+    XMVECTOR normalVector = XMVector3Normalize(XMVectorSet(plane.x, plane.y, plane.z, 0.0f));
+    XMVECTOR axis = (fabs(XMVectorGetY(normalVector)) < 0.9f) ? XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f) : XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+    XMVECTOR uAxis = XMVector3Normalize(XMVector3Cross(axis, normalVector));
+    XMVECTOR vAxis = XMVector3Cross(normalVector, uAxis);
+
+    for (int space = 0; space < 2; space++)
+    {
+        mNumCapLoops[space] = 0;
+        mNumCapHoles[space] = 0;
+        mCapIndexBegins[space] = (UINT)mSlicingIndices[space].size();
+
+        CancelOpposingSegments(space);
+        ExtractCapLoops(space);
+        if (mLoopEnds.empty())
+            continue;
+
+        XMFLOAT3 capNormal;
+        XMStoreFloat3(&capNormal, (space == 0) ? -normalVector : normalVector);
+        XMVECTOR capVAxis = (space == 0) ? -vAxis : vAxis;
+
+        // 절단면 정점은 절단면 법선과 평면 투영 텍스처 좌표(모델 공간 단위)를 가지므로 옆면 정점과 따로 CutPoint마다 한 번만 만든다.
+        UINT capBase = (UINT)mSlicingVertices[space].size();
+        mCapPoints.clear();
+        for (UINT& loopVertex : mLoopVertices)
+        {
+            CutPoint& cutPoint = mCutPoints[loopVertex];
+            if (cutPoint.capVertex[space] == UINT_MAX) {
+                VertexType capVertex = mSlicingVertices[space][cutPoint.vertex[space]];
+                XMVECTOR pos = XMLoadFloat3(&capVertex.Pos);
+                capVertex.Normal = capNormal;
+                capVertex.TexC = XMFLOAT2(XMVectorGetX(XMVector3Dot(pos, uAxis)), XMVectorGetX(XMVector3Dot(pos, capVAxis)));
+
+                cutPoint.capVertex[space] = (UINT)mSlicingVertices[space].size();
+                mSlicingVertices[space].push_back(capVertex);
+                mSourceVertices[space].push_back(UINT_MAX);
+                mCapPoints.push_back(capVertex.TexC);
+            }
+            loopVertex = cutPoint.capVertex[space] - capBase;
+        }
+
+        // 부호 있는 넓이가 음수인 루프가 구멍
+        UINT loopBegin = 0;
+        for (UINT loopEnd : mLoopEnds)
+        {
+            float area = 0.0f;
+            for (UINT i = loopBegin; i < loopEnd; i++)
+            {
+                const XMFLOAT2& p0 = mCapPoints[mLoopVertices[i]];
+                const XMFLOAT2& p1 = mCapPoints[mLoopVertices[(i + 1 < loopEnd) ? i + 1 : loopBegin]];
+                area += p0.x * p1.y - p1.x * p0.y;
+            }
+            mNumCapLoops[space]++;
+            if (area < 0.0f)
+                mNumCapHoles[space]++;
+            loopBegin = loopEnd;
+        }
+
+        size_t firstCapIndex = mSlicingIndices[space].size();
+        mTriangulator.Triangulate(mCapPoints, mLoopVertices, mLoopEnds, mSlicingIndices[space]);
+        for (size_t i = firstCapIndex; i < mSlicingIndices[space].size(); i++)
+            mSlicingIndices[space][i] += capBase;
+    }
+}
+
+template class MeshSlice::BasicSliceContext<Vertex>;
+template class MeshSlice::BasicSliceContext<SkinnedVertex>;
+
+// 정점의 가중치로 섞은 뼈 행렬 (행 벡터 기준, 셰이더의 스키닝과 같다)
+static XMMATRIX BlendBoneTransform(const SkinnedVertex& vertex, span<const XMFLOAT4X4> boneTransforms)
+{
+    float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z,
+        1.0f - vertex.BoneWeights.x - vertex.BoneWeights.y - vertex.BoneWeights.z };
+
+    XMMATRIX transform(g_XMZero, g_XMZero, g_XMZero, g_XMZero);
+    for (int i = 0; i < 4; i++)
+    {
+        if (weights[i] != 0.0f)
+            transform += XMMatrixTranspose(XMLoadFloat4x4(&boneTransforms[vertex.BoneIndices[i]])) * weights[i];
+    }
+    return transform;
+}
+
+int MeshSlice::SkinnedSliceContext::Slice(const Mesh* targetMesh, const Submesh& submesh, const XMFLOAT4& plane, span<const XMFLOAT4X4> boneTransforms, ThreadPool* threadPool)
+{
+    const SkinnedVertex* vertices = static_cast<const SkinnedVertex*>(targetMesh->mVertexBufferCPU->GetBufferPointer()) + submesh.baseVertex;
+    const UINT* indices = static_cast<const UINT*>(targetMesh->mIndexBufferCPU->GetBufferPointer()) + submesh.baseIndex;
+
+    return Slice(vertices, CountReferencedVertices(indices, submesh.numIndices), indices, submesh.numIndices, plane, boneTransforms, threadPool);
+}
+
+int MeshSlice::SkinnedSliceContext::Slice(const SkinnedVertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, const XMFLOAT4& plane,
+    span<const XMFLOAT4X4> boneTransforms, ThreadPool* threadPool)
+{
+    mIsPosed = !boneTransforms.empty();
+    if (!mIsPosed)
+        return mSliceContext.Slice(vertices, numVertices, indices, numIndices, plane, threadPool);
+
+    // 현재 포즈로 스키닝한 정점을 자른다.
+    mPosedVertices.resize(numVertices);
+    auto skinVertices = [&](UINT begin, UINT end) {
+        for (UINT i = begin; i < end; i++)
+        {
+            SkinnedVertex& posed = mPosedVertices[i];
+            posed = vertices[i];
+            XMMATRIX transform = BlendBoneTransform(posed, boneTransforms);
+            XMStoreFloat3(&posed.Pos, XMVector3TransformCoord(XMLoadFloat3(&posed.Pos), transform));
+            XMStoreFloat3(&posed.Normal, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&posed.Normal), transform)));
+        }
+    };
+    if (threadPool)
+        threadPool->ParallelFor(numVertices, SkinningGrainSize, skinVertices);
+    else
+        skinVertices(0, numVertices);
+
+    int numPieces = mSliceContext.Slice(mPosedVertices.data(), numVertices, indices, numIndices, plane, threadPool);
+
+    // 원본 정점은 bind pose 정점을 그대로 쓰고, 새로 만든 정점만 섞은 뼈 행렬의 역행렬로 되돌린다.
+    for (int piece = 0; piece < numPieces; piece++)
+    {
+        span<const SkinnedVertex> posedVertices = mSliceContext.PieceVertices(piece);
+        span<const UINT> sources = mSliceContext.PieceSourceVertices(piece);
+        vector<SkinnedVertex>& bindVertices = mBindVertices[piece];
+        bindVertices.resize(posedVertices.size());
+
+        for (size_t i = 0; i < posedVertices.size(); i++)
+        {
+            if (sources[i] != UINT_MAX) {
+                bindVertices[i] = vertices[sources[i]];
+                continue;
+            }
+
+            SkinnedVertex& bind = bindVertices[i];
+            bind = posedVertices[i];
+            XMVECTOR determinant;
+            XMMATRIX inverse = XMMatrixInverse(&determinant, BlendBoneTransform(bind, boneTransforms));
+            // 섞은 행렬이 거의 특이하면 (서로 반대로 도는 뼈를 반씩 섞은 경우 등) 되돌릴 수 없으므로 포즈 공간 정점을 그대로 둔다.
+            if (fabs(XMVectorGetX(determinant)) < 1e-12f)
+                continue;
+            XMStoreFloat3(&bind.Pos, XMVector3TransformCoord(XMLoadFloat3(&bind.Pos), inverse));
+            XMStoreFloat3(&bind.Normal, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&bind.Normal), inverse)));
+        }
+    }
+    return numPieces;
+}
+
+size_t MeshSlice::SkinnedSliceContext::ScratchByteSize() const
+{
+    size_t byteSize = mSliceContext.ScratchByteSize() + mPosedVertices.capacity() * sizeof(SkinnedVertex);
+    for (int piece = 0; piece < 2; piece++)
+        byteSize += mBindVertices[piece].capacity() * sizeof(SkinnedVertex);
+    return byteSize;
+}
+
+int MeshSlice::MultiSliceContext::Slice(const Mesh* targetMesh, const Submesh& submesh, span<const XMFLOAT4> planes, ThreadPool* threadPool)
+{
+    const Vertex* vertices = static_cast<const Vertex*>(targetMesh->mVertexBufferCPU->GetBufferPointer()) + submesh.baseVertex;
+    const UINT* indices = static_cast<const UINT*>(targetMesh->mIndexBufferCPU->GetBufferPointer()) + submesh.baseIndex;
+
+    return Slice(vertices, CountReferencedVertices(indices, submesh.numIndices), indices, submesh.numIndices, planes, threadPool);
+}
+
+int MeshSlice::MultiSliceContext::Slice(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, span<const XMFLOAT4> planes, ThreadPool* threadPool)
+{
+    assert(planes.size() <= MaxPlanes);
+    int numPlanes = (int)min<size_t>(planes.size(), MaxPlanes);
+
+    mWorkVertices.assign(vertices, vertices + numVertices);
+    mWorkIndices.assign(indices, indices + numIndices);
+    // 입력 정점은 SoA로 옮겨 평면마다 SliceKernel로 분류한다.
+    for (int axis = 0; axis < 3; axis++)
+        mPositions[axis].resize(numVertices);
+    for (UINT i = 0; i < numVertices; i++)
+    {
+        mPositions[0][i] = vertices[i].Pos.x;
+        mPositions[1][i] = vertices[i].Pos.y;
+        mPositions[2][i] = vertices[i].Pos.z;
+    }
+    mPlaneDistances.resize(numVertices);
+    mPlaneSides.resize(numVertices);
+    mWorkSides.assign(numVertices, { 0, 0 });
+    for (int plane = 0; plane < numPlanes; plane++)
+    {
+        SliceKernel::ClassifyPositions(mPositions[0].data(), mPositions[1].data(), mPositions[2].data(), numVertices, planes[plane], mPlaneDistances.data(), mPlaneSides.data());
+
+        uint64_t planeBit = (uint64_t)1 << plane;
+        for (UINT i = 0; i < numVertices; i++)
+        {
+            if (mPlaneSides[i] == SliceKernel::SideFront)
+                mWorkSides[i][0] |= planeBit;
+            else if (mPlaneSides[i] == SliceKernel::SideBack)
+                mWorkSides[i][1] |= planeBit;
+        }
+    }
+
+    mNextPieces.clear();
+    AddPiece(0, 0, UINT64_MAX);
+    swap(mPieces, mNextPieces);
+
+    for (int plane = 0; plane < numPlanes; plane++)
+    {
+        uint64_t planeBit = (uint64_t)1 << plane;
+        mNextPieces.clear();
+        for (const Piece& piece : mPieces)
+        {
+            // 평면 한쪽(과 평면 위)에만 정점이 있는 조각은 자르지 않는다.
+            if (!(piece.sides[0] & planeBit) || !(piece.sides[1] & planeBit)) {
+                mNextPieces.push_back(piece);
+                continue;
+            }
+
+            // SliceContext는 Slice 안에서만 입력을 읽으므로 결과를 작업 배열에 추가해도 된다.
+            mSliceContext.Slice(&mWorkVertices[piece.baseVertex], piece.numVertices, &mWorkIndices[piece.baseIndex], piece.numIndices, planes[plane], threadPool);
+            for (int space = 0; space < 2; space++)
+                AppendSlicedPiece(space, piece, planes, plane);
+        }
+        swap(mPieces, mNextPieces);
+        CompactPieces();
+    }
+
+    PackPieces();
+    return NumPieces();
+}
+
+void MeshSlice::MultiSliceContext::AddPiece(UINT baseVertex, UINT baseIndex, uint64_t planeMask)
+{
+    // 작업 배열 끝에 추가된 정점/인덱스가 새 조각이다. 빈 조각(평면에 걸친 쪽에 면이 없는 경우)은 버린다.
+    Piece piece = { baseVertex, (UINT)mWorkVertices.size() - baseVertex, baseIndex, (UINT)mWorkIndices.size() - baseIndex, { 0, 0 } };
+    if (piece.numIndices == 0)
+        return;
+
+    for (UINT i = baseVertex; i < baseVertex + piece.numVertices; i++)
+    {
+        piece.sides[0] |= mWorkSides[i][0];
+        piece.sides[1] |= mWorkSides[i][1];
+    }
+    piece.sides[0] &= planeMask;
+    piece.sides[1] &= planeMask;
+    mNextPieces.push_back(piece);
+}
+
+void MeshSlice::MultiSliceContext::AppendSlicedPiece(int space, const Piece& parent, span<const XMFLOAT4> planes, int plane)
+{
+    span<const Vertex> vertices = mSliceContext.PieceVertices(space);
+    span<const UINT> indices = mSliceContext.PieceIndices(space);
+    span<const UINT> sources = mSliceContext.PieceSourceVertices(space);
+
+    UINT baseVertex = (UINT)mWorkVertices.size();
+    UINT baseIndex = (UINT)mWorkIndices.size();
+    mWorkVertices.insert(mWorkVertices.end(), vertices.begin(), vertices.end());
+    mWorkIndices.insert(mWorkIndices.end(), indices.begin(), indices.end());
+
+    // 원본에서 온 정점은 분류를 물려받고, 절단으로 생긴 정점만 남은 평면으로 분류한다.
+    int numPlanes = (int)min<size_t>(planes.size(), MaxPlanes);
+    mWorkSides.resize(mWorkVertices.size());
+    for (UINT i = 0; i < (UINT)sources.size(); i++)
+    {
+        if (sources[i] == UINT_MAX)
+            mWorkSides[baseVertex + i] = ClassifyPosition(vertices[i].Pos, planes, plane + 1, numPlanes);
+        else
+            mWorkSides[baseVertex + i] = mWorkSides[parent.baseVertex + sources[i]];
+    }
+
+    AddPiece(baseVertex, baseIndex, (plane + 1 < MaxPlanes) ? UINT64_MAX << (plane + 1) : 0);
+}
+
+void MeshSlice::MultiSliceContext::CompactPieces()
+{
+    // 잘린 조각이 남긴 자리가 살아 있는 조각보다 커지면 살아 있는 조각만 다른 작업 배열로 옮긴다.
+    size_t numLiveVertices = 0;
+    for (const Piece& piece : mPieces)
+        numLiveVertices += piece.numVertices;
+    if (mWorkVertices.size() <= numLiveVertices * 2)
+        return;
+
+    mCompactVertices.clear();
+    mCompactIndices.clear();
+    mCompactSides.clear();
+    for (Piece& piece : mPieces)
+    {
+        UINT baseVertex = (UINT)mCompactVertices.size();
+        UINT baseIndex = (UINT)mCompactIndices.size();
+        mCompactVertices.insert(mCompactVertices.end(), mWorkVertices.begin() + piece.baseVertex, mWorkVertices.begin() + piece.baseVertex + piece.numVertices);
+        mCompactSides.insert(mCompactSides.end(), mWorkSides.begin() + piece.baseVertex, mWorkSides.begin() + piece.baseVertex + piece.numVertices);
+        mCompactIndices.insert(mCompactIndices.end(), mWorkIndices.begin() + piece.baseIndex, mWorkIndices.begin() + piece.baseIndex + piece.numIndices);
+        piece.baseVertex = baseVertex;
+        piece.baseIndex = baseIndex;
+    }
+    mWorkVertices.swap(mCompactVertices);
+    mWorkIndices.swap(mCompactIndices);
+    mWorkSides.swap(mCompactSides);
+}
+
+void MeshSlice::MultiSliceContext::PackPieces()
+{
+    mVertices.clear();
+    mIndices.clear();
+    mPieceSubmeshes.clear();
+    mPieceVertexRanges.clear();
+
+    for (const Piece& piece : mPieces)
+    {
+        UINT baseVertex = (UINT)mVertices.size();
+        mVertices.insert(mVertices.end(), mWorkVertices.begin() + piece.baseVertex, mWorkVertices.begin() + piece.baseVertex + piece.numVertices);
+
+        Submesh submesh;
+        submesh.baseIndex = (UINT)mIndices.size();
+        submesh.numIndices = piece.numIndices;
+        for (UINT i = piece.baseIndex; i < piece.baseIndex + piece.numIndices; i++)
+            mIndices.push_back(mWorkIndices[i] + baseVertex);
+        BoundingBox::CreateFromPoints(submesh.bounds, piece.numVertices, &mVertices[baseVertex].Pos, sizeof(Vertex));
+
+        mPieceSubmeshes.push_back(submesh);
+        mPieceVertexRanges.push_back({ baseVertex, piece.numVertices });
+    }
+}
+
+size_t MeshSlice::MultiSliceContext::ScratchByteSize() const
+{
+    size_t byteSize = (mWorkVertices.capacity() + mCompactVertices.capacity() + mVertices.capacity()) * sizeof(Vertex);
+    byteSize += (mWorkIndices.capacity() + mCompactIndices.capacity() + mIndices.capacity()) * sizeof(UINT);
+    byteSize += (mWorkSides.capacity() + mCompactSides.capacity()) * sizeof(array<uint64_t, 2>);
+    byteSize += (mPositions[0].capacity() + mPositions[1].capacity() + mPositions[2].capacity() + mPlaneDistances.capacity()) * sizeof(float) + mPlaneSides.capacity();
+    byteSize += (mPieces.capacity() + mNextPieces.capacity()) * sizeof(Piece);
+    byteSize += mPieceSubmeshes.capacity() * sizeof(Submesh) + mPieceVertexRanges.capacity() * sizeof(array<UINT, 2>);
+    return byteSize + mSliceContext.ScratchByteSize();
+}
+
+int MeshSlice::ConvexSliceContext::Clip(const Mesh* targetMesh, const Submesh& submesh, span<const XMFLOAT4> planes)
+{
+    const Vertex* vertices = static_cast<const Vertex*>(targetMesh->mVertexBufferCPU->GetBufferPointer()) + submesh.baseVertex;
+    const UINT* indices = static_cast<const UINT*>(targetMesh->mIndexBufferCPU->GetBufferPointer()) + submesh.baseIndex;
+
+    return Clip(vertices, CountReferencedVertices(indices, submesh.numIndices), indices, submesh.numIndices, planes);
+}
+
+int MeshSlice::ConvexSliceContext::Clip(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, span<const XMFLOAT4> planes)
+{
+    return Cut(vertices, numVertices, indices, numIndices, planes, false);
+}
+
+int MeshSlice::ConvexSliceContext::Subtract(const Mesh* targetMesh, const Submesh& submesh, span<const XMFLOAT4> planes)
+{
+    const Vertex* vertices = static_cast<const Vertex*>(targetMesh->mVertexBufferCPU->GetBufferPointer()) + submesh.baseVertex;
+    const UINT* indices = static_cast<const UINT*>(targetMesh->mIndexBufferCPU->GetBufferPointer()) + submesh.baseIndex;
+
+    return Subtract(vertices, CountReferencedVertices(indices, submesh.numIndices), indices, submesh.numIndices, planes);
+}
+
+int MeshSlice::ConvexSliceContext::Subtract(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, span<const XMFLOAT4> planes)
+{
+    return Cut(vertices, numVertices, indices, numIndices, planes, true);
+}
+
+int MeshSlice::ConvexSliceContext::Cut(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, span<const XMFLOAT4> planes, bool keepOutside)
+{
+    assert(planes.size() <= MaxPlanes);
+    int numPlanes = (int)min<size_t>(planes.size(), MaxPlanes);
+    uint64_t allPlanes = (numPlanes < MaxPlanes) ? ((uint64_t)1 << numPlanes) - 1 : UINT64_MAX;
+
+    // 1. 입력 정점을 모든 평면으로 분류한다.
+    mNumSourceVertices = numVertices;
+    mWorkVertices.assign(vertices, vertices + numVertices);
+    mWorkIndices.assign(indices, indices + numIndices);
+    mPlaneDistances.resize(numVertices);
+    mPlaneSides.resize(numVertices);
+    mWorkSides.assign(numVertices, { 0, 0 });
+    for (int plane = 0; plane < numPlanes && numVertices > 0; plane++)
+    {
+        SliceKernel::ClassifyPositions(&mWorkVertices[0].Pos, sizeof(Vertex), numVertices, planes[plane], mPlaneDistances.data(), mPlaneSides.data());
+
+        uint64_t planeBit = (uint64_t)1 << plane;
+        for (UINT i = 0; i < numVertices; i++)
+        {
+            if (mPlaneSides[i] == SliceKernel::SideFront)
+                mWorkSides[i][0] |= planeBit;
+            else if (mPlaneSides[i] == SliceKernel::SideBack)
+                mWorkSides[i][1] |= planeBit;
+        }
+    }
+
+    // 2. 모든 평면의 안쪽에만 있는 면은 그대로 안쪽 면으로 둔다.
+    // 어떤 평면의 바깥쪽에만 있는 면도 그 앞의 평면에 닿지 않으면 자르지 않고 바로 바깥 면으로 둔다.
+    // 앞의 평면에 닿는 면은 그 평면의 절단면 루프를 닫는 데 필요하므로 남긴다.
+    UINT numFaces = numIndices / 3;
+    mFaceStates.assign(numFaces, FaceInside);
+    mActiveFaces.clear();
+    for (UINT face = 0; face < numFaces; face++)
+    {
+        const UINT* corners = &mWorkIndices[face * 3];
+        uint64_t front = mWorkSides[corners[0]][0] & mWorkSides[corners[1]][0] & mWorkSides[corners[2]][0] & allPlanes;
+        uint64_t earlierPlanes = (front & (~front + 1)) - 1;
+        if (front && !IsTouchingPlanes(face, earlierPlanes))
+            mFaceStates[face] = keepOutside ? FaceOutside : FaceRemoved;
+        else if (IsTouchingPlanes(face, allPlanes))
+            mActiveFaces.push_back(face);
+    }
+
+    // 3. 평면마다 닿는 면만 모아 자르고, 안쪽 조각(평면 반대쪽)은 다음 평면으로 넘긴다.
+    mStamp = 0;
+    mLocalStamps.clear();
+    for (int plane = 0; plane < numPlanes && !mActiveFaces.empty(); plane++)
+    {
+        uint64_t planeBit = (uint64_t)1 << plane;
+        uint64_t laterPlanes = allPlanes & ~((planeBit << 1) - 1);
+
+        mStamp++;
+        mLocalStamps.resize(mWorkVertices.size(), 0);
+        mLocalIndexOf.resize(mWorkVertices.size());
+        mLocalVertices.clear();
+        mLocalIndices.clear();
+        mLocalToWork.clear();
+        mLocalIsCap.clear();
+        mNextActiveFaces.clear();
+        for (UINT face : mActiveFaces)
+        {
+            if (!IsTouchingPlanes(face, planeBit)) {
+                if (IsTouchingPlanes(face, laterPlanes))
+                    mNextActiveFaces.push_back(face);
+                continue;
+            }
+
+            // 평면 바깥쪽에만 있는 면은 이 평면의 절단면에 선분을 남기지 않으므로 자르지 않고 바깥쪽으로 보낸다.
+            const UINT* corners = &mWorkIndices[face * 3];
+            if (mWorkSides[corners[0]][0] & mWorkSides[corners[1]][0] & mWorkSides[corners[2]][0] & planeBit) {
+                mFaceStates[face] = (keepOutside && mFaceStates[face] == FaceInside) ? FaceOutside : FaceRemoved;
+                continue;
+            }
+
+            // 지역 정점의 겉면/절단면 구분 : 한 정점을 쓰는 면은 모두 같은 쪽이다. (절단면 정점은 겉면 정점과 따로 만든다.)
+            for (int k = 0; k < 3; k++)
+            {
+                UINT vertex = mWorkIndices[face * 3 + k];
+                if (mLocalStamps[vertex] != mStamp) {
+                    mLocalStamps[vertex] = mStamp;
+                    mLocalIndexOf[vertex] = (UINT)mLocalVertices.size();
+                    mLocalVertices.push_back(mWorkVertices[vertex]);
+                    mLocalToWork.push_back(vertex);
+                    mLocalIsCap.push_back(mFaceStates[face] == FaceInsideCap);
                 }
+                mLocalIndices.push_back(mLocalIndexOf[vertex]);
+            }
+            mFaceStates[face] = FaceRemoved;
+        }
+        if (mLocalIndices.empty()) {
+            swap(mActiveFaces, mNextActiveFaces);
+            continue;
+        }
+
+        mSliceContext.Slice(mLocalVertices.data(), (UINT)mLocalVertices.size(), mLocalIndices.data(), (UINT)mLocalIndices.size(), planes[plane]);
+        AppendSlicedPiece(1, planes, plane, laterPlanes);
+        if (keepOutside)
+            AppendSlicedPiece(0, planes, plane, laterPlanes);
+        swap(mActiveFaces, mNextActiveFaces);
+    }
+
+    PackResult(keepOutside);
+    return (int)mIndices.size() / 3;
+}
 
-                int otherSpace = otherVertexPos == 1 ? 0 : 1;
-                int space = 1 - otherSpace;
-
-                // otherVertex ִ ġ ο   face = {ohterVertex, newVertex0, newVertex1}
-                slicingIndices[otherSpace].push_back(newIndices[otherIndex][otherSpace]);
-                slicingIndices[otherSpace].push_back(newVertexIndices[0][otherSpace]);
-                slicingIndices[otherSpace].push_back(newVertexIndices[1][otherSpace]);
-
-                // sameVertex ִ ġ ο   
-                // face = {newVertex0, sameVertex1, newVertex1}
-                slicingIndices[space].push_back(newVertexIndices[0][space]);
-                slicingIndices[space].push_back(newIndices[sameIndex[1]][space]);
-                slicingIndices[space].push_back(newVertexIndices[1][space]);
-                // face = {sameVertex0, sameVertex1, newVertex0}
-                slicingIndices[space].push_back(newIndices[sameIndex[0]][space]);
-                slicingIndices[space].push_back(newIndices[sameIndex[1]][space]);
-                slicingIndices[space].push_back(newVertexIndices[0][space]);
+bool MeshSlice::ConvexSliceContext::IsTouchingPlanes(UINT face, uint64_t planeMask) const
+{
+    // 정점 하나라도 평면의 반대쪽이 아니면(평면 위 포함) 닿는다.
+    const UINT* corners = &mWorkIndices[face * 3];
+    uint64_t back = mWorkSides[corners[0]][1] & mWorkSides[corners[1]][1] & mWorkSides[corners[2]][1];
+    return (~back & planeMask) != 0;
+}
+
+void MeshSlice::ConvexSliceContext::AppendSlicedPiece(int space, span<const XMFLOAT4> planes, int plane, uint64_t laterPlanes)
+{
+    span<const Vertex> vertices = mSliceContext.PieceVertices(space);
+    span<const UINT> indices = mSliceContext.PieceIndices(space);
+    span<const UINT> sources = mSliceContext.PieceSourceVertices(space);
+    UINT capIndexBegin = mSliceContext.PieceCapIndexBegin(space);
+
+    // 원본 정점은 작업 정점 번호를 그대로 쓰므로 닿지 않은 면과 이어진다.
+    mPieceToWork.assign(vertices.size(), UINT_MAX);
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        if (sources[i] != UINT_MAX)
+            mPieceToWork[i] = mLocalToWork[sources[i]];
+    }
+
+    int numPlanes = (int)min<size_t>(planes.size(), MaxPlanes);
+    for (UINT i = 0; i + 2 < (UINT)indices.size(); i += 3)
+    {
+        // 나눈 면에는 원본 정점이 하나 이상 있으므로 그 정점으로 겉면/절단면을 구분한다. 이번 절단면 삼각형은 절단면이다.
+        bool isCap = true;
+        if (i < capIndexBegin) {
+            for (int k = 0; k < 3; k++)
+            {
+                if (sources[indices[i + k]] != UINT_MAX) {
+                    isCap = mLocalIsCap[sources[indices[i + k]]] != 0;
+                    break;
+                }
+            }
+        }
+        // 바깥쪽 조각의 절단면은 두 바깥 조각 사이 또는 이번 절단면이므로 버린다.
+        if (space == 0 && isCap)
+            continue;
+
+        UINT face = (UINT)mFaceStates.size();
+        for (int k = 0; k < 3; k++)
+        {
+            UINT& work = mPieceToWork[indices[i + k]];
+            if (work == UINT_MAX) {
+                work = (UINT)mWorkVertices.size();
+                mWorkVertices.push_back(vertices[indices[i + k]]);
+                mWorkSides.push_back((space == 1) ? ClassifyPosition(vertices[indices[i + k]].Pos, planes, plane + 1, numPlanes) : array<uint64_t, 2>{ 0, 0 });
             }
+            mWorkIndices.push_back(work);
+        }
+
+        if (space == 0) {
+            mFaceStates.push_back(FaceOutside);
         }
-        // 3  ٸ  
         else {
-            int otherIndex[2], middleIndex;
-            int otherVertexPos = 0;  // otherVertexPos = otherIndex[0]  ġ 
-            (vertexPos[0] == 0) ?
-                otherVertexPos = vertexPos[1], middleIndex = index[0], otherIndex[0] = index[1], otherIndex[1] = index[2] :
-                (vertexPos[1] == 0) ?
-                    otherVertexPos = vertexPos[2], middleIndex = index[1], otherIndex[0] = index[2], otherIndex[1] = index[0] :
-                    otherVertexPos = vertexPos[0], middleIndex = index[2], otherIndex[0] = index[0], otherIndex[1] = index[1];
-
-            Vertex newVertex = InterpolationVertexNormalAndTexC(planeVector, vertices[otherIndex[0]], vertices[otherIndex[0]]);
-
-            UINT newVertexIndices[2]; // space
-            auto item = addedVertices.find(newVertex);
-            //ο  ߰ ʾҴٸ?  ߰ϰ ε οѴ.
-            if (item == addedVertices.end()) {
-                for (int space = 0; space < 2; space++)
-                {
-                    newVertexIndices[space] = (UINT)slicingVertices[space].size();
-                    slicingVertices[space].push_back(newVertex);
+            mFaceStates.push_back(isCap ? FaceInsideCap : FaceInside);
+            if (IsTouchingPlanes(face, laterPlanes))
+                mNextActiveFaces.push_back(face);
+        }
+    }
+}
+
+void MeshSlice::ConvexSliceContext::PackResult(bool keepOutside)
+{
+    // 겉면 다음에 볼록 다면체 면 위의 삼각형을 둔다. Subtract의 벽은 파낸 부분의 절단면이므로 감기 순서와 법선을 뒤집는다.
+    mVertices.clear();
+    mIndices.clear();
+    mPackedIsNew.clear();
+    mPackedIndexOf.assign(mWorkVertices.size(), UINT_MAX);
+
+    auto appendFaces = [&](uint8_t state, bool flip) {
+        for (UINT face = 0; face < (UINT)mFaceStates.size(); face++)
+        {
+            if (mFaceStates[face] != state)
+                continue;
+
+            UINT corners[3] = { mWorkIndices[face * 3], mWorkIndices[face * 3 + 1], mWorkIndices[face * 3 + 2] };
+            if (flip)
+                swap(corners[1], corners[2]);
+            for (UINT vertex : corners)
+            {
+                if (mPackedIndexOf[vertex] == UINT_MAX) {
+                    mPackedIndexOf[vertex] = (UINT)mVertices.size();
+                    mVertices.push_back(mWorkVertices[vertex]);
+                    mPackedIsNew.push_back(vertex >= mNumSourceVertices);
+                    if (flip)
+                        XMStoreFloat3(&mVertices.back().Normal, -XMLoadFloat3(&mVertices.back().Normal));
                 }
-                addedVertices[newVertex] = { newVertexIndices[0], newVertexIndices[1] };
-            }
-            // ο  ̹ ߰Ǿ ִٸ? ش  ε ´.
-            else {
-                for (int space = 0; space < 2; space++)
-                    newVertexIndices[space] = item->second[space];
+                mIndices.push_back(mPackedIndexOf[vertex]);
             }
+        }
+    };
+
+    appendFaces(keepOutside ? FaceOutside : FaceInside, false);
+    mCapIndexBegin = (UINT)mIndices.size();
+    appendFaces(FaceInsideCap, keepOutside);
+
+    if (keepOutside)
+        SplitRimEdges();
+}
+
+void MeshSlice::ConvexSliceContext::SplitRimEdges()
+{
+    // 바깥 면은 평면 p에서 잘린 뒤 더 자르지 않으므로, p의 절단 곡선 위의 변 AB를 뒤 평면 q가 안쪽에서 X로 나누면
+    // 벽과 다른 바깥 면은 A-X-B인데 이 바깥 면만 A-B인 T자 이음이 남는다. 이런 변을 찾아 X를 넣고 맞은편 꼭짓점에서 부채꼴로 나눈다.
+    // 이런 변의 양 끝과 X는 모두 절단으로 생긴 정점이므로 그 정점만 위치로 합친다.
+    // 여러 평면이 거의 한 점에서 만나면 다른 평면에서 나온 같은 점이 몇 ulp 어긋나므로 WeldCutPoints와 같은 격자로 허용 오차 안의 점을 합치고 위치도 대표로 맞춘다.
+    float scale = 0.0f;
+    for (UINT i = 0; i < (UINT)mVertices.size(); i++)
+    {
+        if (mPackedIsNew[i])
+            scale = max(scale, MaxAbsComponent(mVertices[i].Pos));
+    }
+    float tolerance = max(scale * 1e-6f, FLT_MIN);
+    float invCellSize = 0.25f / tolerance;
+
+    mRimWelds.assign(mVertices.size(), UINT_MAX);
+    mRimWeldTable.Clear();
+    for (UINT i = 0; i < (UINT)mVertices.size(); i++)
+    {
+        if (!mPackedIsNew[i])
+            continue;
 
-            int space = otherVertexPos == 1 ? 0 : 1;
-            int otherSpace = 1 - space;
+        XMFLOAT3& pos = mVertices[i].Pos;
+        float scaled[3] = { pos.x * invCellSize, pos.y * invCellSize, pos.z * invCellSize };
+        int64_t cell[3];
+        int neighbor[3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float cellPos = floorf(scaled[axis]);
+            float fraction = scaled[axis] - cellPos;
+            cell[axis] = (int64_t)cellPos;
+            neighbor[axis] = (fraction <= 0.25f) ? -1 : (fraction >= 0.75f) ? 1 : 0;
+        }
 
-            slicingIndices[space].push_back(newIndices[space][middleIndex]); // middleIndex
-            slicingIndices[space].push_back(newVertexIndices[space]); // newVertex
-            slicingIndices[space].push_back(newIndices[space][otherIndex[1]]); // index[1]
+        UINT weld = UINT_MAX;
+        for (int k = 0; k < 8 && weld == UINT_MAX; k++)
+        {
+            int offset[3] = { (k & 1) ? neighbor[0] : 0, (k & 2) ? neighbor[1] : 0, (k & 4) ? neighbor[2] : 0 };
+            if ((k & 1 && offset[0] == 0) || (k & 2 && offset[1] == 0) || (k & 4 && offset[2] == 0))
+                continue;
 
-            slicingIndices[otherSpace].push_back(newVertexIndices[otherSpace]); // newVertex
-            slicingIndices[otherSpace].push_back(newIndices[otherSpace][middleIndex]); // middleIndex
-            slicingIndices[otherSpace].push_back(newIndices[otherSpace][otherIndex[0]]); // index[0]
+            const UINT* found = mRimWeldTable.Find(CellKey(cell[0] + offset[0], cell[1] + offset[1], cell[2] + offset[2]));
+            if (found == nullptr)
+                continue;
+            const XMFLOAT3& weldPos = mVertices[*found].Pos;
+            if (fabs(weldPos.x - pos.x) <= tolerance && fabs(weldPos.y - pos.y) <= tolerance && fabs(weldPos.z - pos.z) <= tolerance)
+                weld = *found;
         }
+
+        if (weld == UINT_MAX) {
+            UINT* slot;
+            mRimWeldTable.Insert(CellKey(cell[0], cell[1], cell[2]), i, slot);
+            weld = i;
+        }
+        else {
+            pos = mVertices[weld].Pos;
+        }
+        mRimWelds[i] = weld;
     }
 
-    for (int space = 0; space < 2; space++)
+    // 방향 있는 변의 수를 세어 반대 방향보다 많이 지나는 변을 열린 변으로 모은다.
+    mRimEdgeTable.Clear();
+    mRimEdges.clear();
+    for (size_t i = 0; i < mIndices.size(); i++)
+    {
+        UINT weld0 = mRimWelds[mIndices[i]];
+        UINT weld1 = mRimWelds[mIndices[(i % 3 == 2) ? i - 2 : i + 1]];
+        if (weld0 == UINT_MAX || weld1 == UINT_MAX || weld0 == weld1)
+            continue;
+        UINT* count;
+        if (mRimEdgeTable.Insert(EdgeTable::Key(weld0, weld1), 0, count))
+            mRimEdges.push_back({ weld0, weld1 });
+        (*count)++;
+    }
+    mOpenEdges.clear();
+    for (const array<UINT, 2>& edge : mRimEdges)
     {
-        UINT numCuttingSurfaceFaces = cuttingSurfaceIndices[space].size();
-        Vertex centroidVertex;
-        XMFLOAT3 normalVector;
-        XMStoreFloat3(&normalVector, XMVector4Normalize(XMVectorSet(plane.x, plane.y, plane.z, 0.0f)) * ((space == 0) ? -1 : 1));
-
-        XMFLOAT3 addedPos = XMFLOAT3(0.f, 0.f, 0.f);
-        for (int i = 0; i < numCuttingSurfaceFaces; i++)
-        {  
-            addedPos = Vector3::Add(addedPos, slicingVertices[space][cuttingSurfaceIndices[space][i][0]].Pos);
-            addedPos = Vector3::Add(addedPos, slicingVertices[space][cuttingSurfaceIndices[space][i][1]].Pos);
-        }
-        XMStoreFloat3(&addedPos, XMLoadFloat3(&addedPos) / (numCuttingSurfaceFaces * 2.0f) );
-        centroidVertex.Pos = addedPos;
-        centroidVertex.Normal = normalVector;
-        centroidVertex.TexC.x = 0.5f;
-        centroidVertex.TexC.y = 0.5f;
-
-        UINT centroidIndex = slicingVertices[space].size();
-        slicingVertices[space].push_back(centroidVertex);
-        for (int i = 0; i < numCuttingSurfaceFaces; i++)
+        const UINT* reverse = mRimEdgeTable.Find(EdgeTable::Key(edge[1], edge[0]));
+        if (*mRimEdgeTable.Find(EdgeTable::Key(edge[0], edge[1])) > (reverse ? *reverse : 0))
+            mOpenEdges.push_back(edge);
+    }
+    if (mOpenEdges.empty())
+        return;
+    sort(mOpenEdges.begin(), mOpenEdges.end());
+
+    // 바깥 면의 열린 변 a -> b마다 b에서 열린 변을 따라 선분 ab 위의 점을 지나 a로 돌아오는 사슬을 찾는다.
+    mRepairedIndices.clear();
+    mRimFaceStack.clear();
+    for (UINT i = mCapIndexBegin; i >= 3; i -= 3)
+        mRimFaceStack.push_back({ mIndices[i - 3], mIndices[i - 2], mIndices[i - 1] });
+    while (!mRimFaceStack.empty())
+    {
+        array<UINT, 3> face = mRimFaceStack.back();
+        mRimFaceStack.pop_back();
+
+        bool isSplit = false;
+        for (int k = 0; k < 3 && !isSplit; k++)
         {
-            int index[2] = { cuttingSurfaceIndices[space][i][0], cuttingSurfaceIndices[space][i][1] };
-            slicingVertices[space][index[0]].Normal = normalVector;
-            slicingVertices[space][index[1]].Normal = normalVector;
+            UINT a = face[k], b = face[(k + 1) % 3], c = face[(k + 2) % 3];
+            if (mRimWelds[a] == UINT_MAX || mRimWelds[b] == UINT_MAX || !binary_search(mOpenEdges.begin(), mOpenEdges.end(), array<UINT, 2>{ mRimWelds[a], mRimWelds[b] }))
+                continue;
+            if (!FindRimChain(a, b))
+                continue;
 
-            slicingIndices[space].push_back(index[0]);
-            slicingIndices[space].push_back(index[1]);
-            slicingIndices[space].push_back(centroidIndex);
+            // a, X1, ..., Xn, b를 c에서 부채꼴로 나눈다. X의 속성은 이 면의 a, b 사이에서 보간하고 위치는 사슬의 정점에 맞춘다.
+            XMVECTOR posA = XMLoadFloat3(&mVertices[a].Pos);
+            XMVECTOR edge = XMLoadFloat3(&mVertices[b].Pos) - posA;
+            float invLengthSq = 1.0f / XMVectorGetX(XMVector3LengthSq(edge));
+            UINT previous = a;
+            for (UINT weld : mRimChain)
+            {
+                float t = XMVectorGetX(XMVector3Dot(XMLoadFloat3(&mVertices[weld].Pos) - posA, edge)) * invLengthSq;
+                Vertex vertex = SliceKernel::InterpolateEdge(mVertices[a], mVertices[b], t, t - 1.0f);
+                vertex.Pos = mVertices[weld].Pos;
+                UINT index = (UINT)mVertices.size();
+                mVertices.push_back(vertex);
+                mRimWelds.push_back(weld);
+                mRimFaceStack.push_back({ previous, index, c });
+                previous = index;
+            }
+            mRimFaceStack.push_back({ previous, b, c });
+            isSplit = true;
         }
+        if (!isSplit)
+            mRepairedIndices.insert(mRepairedIndices.end(), face.begin(), face.end());
     }
 
-    outVertices.push_back(slicingVertices[0]);
-    outVertices.push_back(slicingVertices[1]);
+    UINT numCapIndices = (UINT)mIndices.size() - mCapIndexBegin;
+    mRepairedIndices.insert(mRepairedIndices.end(), mIndices.begin() + mCapIndexBegin, mIndices.end());
+    mIndices.swap(mRepairedIndices);
+    mCapIndexBegin = (UINT)mIndices.size() - numCapIndices;
+}
+
+bool MeshSlice::ConvexSliceContext::FindRimChain(UINT a, UINT b)
+{
+    // b에서 시작해 선분 ab 위에서 a 쪽으로 다가가는 열린 변만 따라간 뒤 a 쪽 점부터 오도록 뒤집는다.
+    UINT weldA = mRimWelds[a];
+    XMVECTOR posA = XMLoadFloat3(&mVertices[a].Pos);
+    XMVECTOR edge = XMLoadFloat3(&mVertices[b].Pos) - posA;
+    float lengthSq = XMVectorGetX(XMVector3LengthSq(edge));
+    float tolerance = 1e-5f * sqrtf(lengthSq) + MaxAbsComponent(mVertices[a].Pos) * 1e-6f;
+    // 여러 평면이 거의 한 점에서 만나면 서로 다른 절단 정점이 허용 오차 안에 겹치므로 조금 뒤로 가는 것도 허용한다.
+    float tTolerance = tolerance / sqrtf(lengthSq);
 
-    outIndices.push_back(slicingIndices[0]);
-    outIndices.push_back(slicingIndices[1]);
+    mRimChain.clear();
+    UINT current = mRimWelds[b];
+    float currentT = 1.0f;
+    while (current != weldA && mRimChain.size() < mVertices.size())
+    {
+        auto next = lower_bound(mOpenEdges.begin(), mOpenEdges.end(), array<UINT, 2>{ current, 0 });
+        UINT found = UINT_MAX;
+        float foundT = 0.0f;
+        for (; next != mOpenEdges.end() && (*next)[0] == current; ++next)
+        {
+            UINT candidate = (*next)[1];
+            if (candidate == weldA) {
+                found = candidate;
+                break;
+            }
+            if (candidate == mRimWelds[b] || find(mRimChain.begin(), mRimChain.end(), candidate) != mRimChain.end())
+                continue;
+            XMVECTOR offset = XMLoadFloat3(&mVertices[candidate].Pos) - posA;
+            float t = XMVectorGetX(XMVector3Dot(offset, edge)) / lengthSq;
+            float distance = XMVectorGetX(XMVector3Length(offset - edge * t));
+            if (t > 0.0f && t < currentT + tTolerance && distance <= tolerance && (found == UINT_MAX || t > foundT)) {
+                found = candidate;
+                foundT = t;
+            }
+        }
+        if (found == UINT_MAX)
+            return false;
+        if (found != weldA)
+            mRimChain.push_back(found);
+        current = found;
+        currentT = foundT;
+    }
+    if (current != weldA || mRimChain.empty())
+        return false;
+    reverse(mRimChain.begin(), mRimChain.end());
+    return true;
+}
+
+size_t MeshSlice::ConvexSliceContext::ScratchByteSize() const
+{
+    size_t byteSize = (mWorkVertices.capacity() + mLocalVertices.capacity() + mVertices.capacity()) * sizeof(Vertex);
+    byteSize += mWorkSides.capacity() * sizeof(array<uint64_t, 2>) + mFaceStates.capacity() + mLocalIsCap.capacity() + mPlaneSides.capacity();
+    byteSize += (mWorkIndices.capacity() + mActiveFaces.capacity() + mNextActiveFaces.capacity() + mLocalIndexOf.capacity() + mLocalStamps.capacity()) * sizeof(UINT);
+    byteSize += (mLocalIndices.capacity() + mLocalToWork.capacity() + mPieceToWork.capacity() + mIndices.capacity() + mPackedIndexOf.capacity()) * sizeof(UINT);
+    byteSize += mPlaneDistances.capacity() * sizeof(float) + mPackedIsNew.capacity();
+    byteSize += (mRimWelds.capacity() + mRimChain.capacity() + mRepairedIndices.capacity()) * sizeof(UINT) + mRimWeldTable.ByteSize() + mRimEdgeTable.ByteSize();
+    byteSize += (mRimEdges.capacity() + mOpenEdges.capacity()) * sizeof(array<UINT, 2>) + mRimFaceStack.capacity() * sizeof(array<UINT, 3>);
+    return byteSize + mSliceContext.ScratchByteSize();
+}
+
+void MeshSlice::BuildBoxPlanes(const BoundingOrientedBox& box, vector<XMFLOAT4>& planes)
+{
+    XMVECTOR center = XMLoadFloat3(&box.Center);
+    XMVECTOR orientation = XMLoadFloat4(&box.Orientation);
+    const float extents[3] = { box.Extents.x, box.Extents.y, box.Extents.z };
+
+    planes.clear();
+    for (int axis = 0; axis < 3; axis++)
+    {
+        XMVECTOR normal = XMVector3Rotate(XMVectorSetByIndex(XMVectorZero(), 1.0f, axis), orientation);
+        for (float sign : { 1.0f, -1.0f })
+        {
+            XMFLOAT4 plane;
+            XMStoreFloat4(&plane, XMPlaneFromPointNormal(center + normal * (sign * extents[axis]), normal * sign));
+            planes.push_back(plane);
+        }
+    }
+}
+
+void MeshSlice::BuildFrustumPlanes(const BoundingFrustum& frustum, vector<XMFLOAT4>& planes)
+{
+    // BoundingFrustum::GetPlanes의 평면은 정규화되어 있고 법선이 바깥쪽이다. (near, far, right, left, top, bottom)
+    XMVECTOR frustumPlanes[6];
+    frustum.GetPlanes(&frustumPlanes[0], &frustumPlanes[1], &frustumPlanes[2], &frustumPlanes[3], &frustumPlanes[4], &frustumPlanes[5]);
+
+    planes.resize(6);
+    for (int i = 0; i < 6; i++)
+        XMStoreFloat4(&planes[i], frustumPlanes[i]);
+}
+
+void MeshSlice::BuildKDopPlanes(const XMFLOAT3& center, span<const XMFLOAT3> directions, float radius, vector<XMFLOAT4>& planes)
+{
+    XMVECTOR centerVector = XMLoadFloat3(&center);
+
+    planes.clear();
+    for (const XMFLOAT3& direction : directions)
+    {
+        XMVECTOR normal = XMVector3Normalize(XMLoadFloat3(&direction));
+        XMFLOAT4 plane;
+        XMStoreFloat4(&plane, XMPlaneFromPointNormal(centerVector + normal * radius, normal));
+        planes.push_back(plane);
+    }
+}
+
+int MeshSlice::MeshCompleteSlice(const Mesh* targetMesh, const Submesh submesh, const XMFLOAT4 plane, vector<vector<Vertex>>& outVertices, vector<vector<UINT>>& outIndices)
+{
+    SliceContext context;
+    int numPieces = context.Slice(targetMesh, submesh, plane);
+
+    for (int i = 0; i < numPieces; i++)
+    {
+        outVertices.emplace_back(context.PieceVertices(i).begin(), context.PieceVertices(i).end());
+        outIndices.emplace_back(context.PieceIndices(i).begin(), context.PieceIndices(i).end());
+    }
 
-    return 2;
+    return numPieces;
 }
@@ -1,5 +1,10 @@
 #pragma once
 #include "Mesh.h"
+#include "PolygonTriangulator.h"
+#include "SliceKernel.h"
+#include "ThreadPool.h"
+#include <span>
+#include <cstdint>
 
 template<typename VertexType>
 inline void ConvertBlobToVertexVector(std::vector<VertexType>& vertices, ID3DBlob* blob);
@@ -11,5 +16,365 @@ void ConvertBlobToIndexVector(std::vector<UINT>& indices, const Submesh submesh,
 
 namespace MeshSlice
 {
+    // 두 정점 인덱스를 키로 하는 open addressing 해시 테이블 (선형 탐사)
+    // 칸을 지우지 않고 Clear에서 한 번에 비우며, 용량은 지금까지 쓴 최대 크기로 남아 다음 절단에서 다시 할당하지 않는다.
+    class EdgeTable
+    {
+    public:
+        static uint64_t Key(UINT index0, UINT index1) { return ((uint64_t)index0 << 32) | index1; }
+        static uint64_t UndirectedKey(UINT index0, UINT index1) { return index0 < index1 ? Key(index0, index1) : Key(index1, index0); }
+
+        void Clear();
+        // key가 없으면 value를 넣고 true, 이미 있으면 false를 반환한다. 어느 쪽이든 slot은 저장된 값을 가리킨다.
+        bool Insert(uint64_t key, UINT value, UINT*& slot);
+        // key의 값, 없으면 nullptr
+        const UINT* Find(uint64_t key) const;
+
+        size_t ByteSize() const { return mEntries.capacity() * sizeof(Entry); }
+
+    private:
+        static constexpr uint64_t EmptyKey = UINT64_MAX;
+        struct Entry
+        {
+            uint64_t key;
+            UINT value;
+        };
+
+        size_t FindSlot(uint64_t key) const;
+        void Grow();
+
+        vector<Entry> mEntries;
+        int mShift = 64;
+        size_t mCount = 0;
+    };
+
+    // 메시 절단에 쓰는 작업 버퍼를 가지고 있는 컨텍스트
+    // 버퍼는 입력 크기에 맞춰 늘어나기만 하므로, 한 컨텍스트로 비슷한 크기의 메시를 반복해서 자르면 힙을 건드리지 않는다.
+    // 결과 조각은 컨텍스트의 버퍼를 가리키는 span으로 돌려주며 다음 Slice 호출 전까지 유효하다.
+    // threadPool을 주면 큰 메시의 정점 분류와 면 분할을 구간별로 나눠 병렬로 처리한다. 결과는 단일 스레드와 비트 단위로 같다.
+    // VertexType은 Vertex 또는 SkinnedVertex이며, 절단 정점의 속성은 SliceKernel::InterpolateEdge로 보간한다.
+    template <typename VertexType>
+    class BasicSliceContext
+    {
+    public:
+        // targetMesh의 CPU 사본(blob)에서 submesh 부분을 복사하지 않고 바로 읽는다.
+        int Slice(const Mesh* targetMesh, const Submesh& submesh, const XMFLOAT4& plane, ThreadPool* threadPool = nullptr);
+        // indices는 vertices 기준 인덱스
+        int Slice(const VertexType* vertices, UINT numVertices, const UINT* indices, UINT numIndices, const XMFLOAT4& plane, ThreadPool* threadPool = nullptr);
+
+        int NumPieces() const { return mNumPieces; }
+        span<const VertexType> PieceVertices(int piece) const { return mSlicingVertices[piece]; }
+        span<const UINT> PieceIndices(int piece) const { return mSlicingIndices[piece]; }
+        // 조각 정점마다 입력 정점 인덱스, 절단으로 새로 생긴 정점(절단 정점, 절단면 정점)은 UINT_MAX
+        span<const UINT> PieceSourceVertices(int piece) const { return mSourceVertices[piece]; }
+
+        // 조각의 절단면을 이루는 닫힌 루프 수와 그중 구멍(절단면 법선 기준 시계 방향) 루프 수
+        int CapLoopCount(int piece) const { return mNumCapLoops[piece]; }
+        int CapHoleCount(int piece) const { return mNumCapHoles[piece]; }
+        // 조각 인덱스 중 절단면 삼각형이 시작하는 위치, 그 앞은 입력 면을 그대로 두거나 나눈 면이다.
+        UINT PieceCapIndexBegin(int piece) const { return mCapIndexBegins[piece]; }
+
+        // 작업 버퍼가 잡고 있는 메모리 (바이트)
+        size_t ScratchByteSize() const;
+
+    private:
+        // 병렬 처리 구간 하나의 정점/면 수, 이보다 작은 메시는 단일 스레드로 자른다.
+        static constexpr UINT ParallelGrainSize = 16384;
+
+        void Reserve(UINT numVertices, UINT numIndices);
+        void ClassifyVertices(const VertexType* vertices, UINT numVertices, const XMFLOAT4& plane);
+        void ClassifyVertices(ThreadPool& threadPool, const VertexType* vertices, UINT numVertices, const XMFLOAT4& plane);
+        // mVertexSides에 따라 [begin, end) 정점을 조각에 복사한다. next는 각 조각에서 처음 쓸 위치
+        void CompactVertices(const VertexType* vertices, UINT begin, UINT end, array<UINT, 2> next);
+        void SplitFaces(const VertexType* vertices, const UINT* indices, UINT numIndices, const XMFLOAT4& plane);
+        void SplitFaces(ThreadPool& threadPool, const VertexType* vertices, const UINT* indices, UINT numIndices, const XMFLOAT4& plane);
+        void FillCuttingSurface(const XMFLOAT4& plane);
+
+        // 절단면 위의 점 : 절단면 위에 있던 원본 정점이거나 절단된 원본 변 위의 새 정점
+        struct CutPoint
+        {
+            UINT vertex[2];         // 두 조각에서의 정점 인덱스
+            UINT capVertex[2];      // 두 조각의 절단면 정점 인덱스, 아직 없으면 UINT_MAX
+            UINT weld;              // 위치가 같은 CutPoint 중 대표 인덱스
+        };
+        // 면의 꼭짓점, 절단면 위에 있으면 cutPoint가 CutPoint 인덱스 (아니면 UINT_MAX)
+        struct Corner
+        {
+            UINT vertex;
+            UINT cutPoint;
+        };
+
+        // 병렬 면 분할에서 구간 하나의 결과
+        // CutPoint는 구간 안에서 처음 만난 순서로 지역 번호를 붙이고, 구간 순서대로 전역 번호로 바꾸므로 단일 스레드와 같은 순서가 된다.
+        struct SplitChunk
+        {
+            static constexpr UINT LocalCutPointFlag = 0x80000000;   // indices 값이 지역 CutPoint 번호임을 표시
+
+            struct LocalCutPoint
+            {
+                uint64_t key;       // mCutPointTable 키
+                UINT index;         // 절단면 위의 원본 정점이면 그 인덱스, 변 위의 점이면 UINT_MAX
+                VertexType vertex;      // 변 위의 절단 정점
+            };
+
+            void Clear(const array<int, 2>* newIndices, const float* distances);
+            UINT CutPointOnVertex(UINT index);
+            UINT CutPointOnEdge(const VertexType* vertices, UINT index0, UINT index1);
+            Corner OriginalCorner(UINT index, int space);
+            Corner CutCorner(UINT cutPoint, int space) const { return { LocalCutPointFlag | cutPoint, cutPoint }; }
+            void AddUncutFace(int space, UINT vertex0, UINT vertex1, UINT vertex2);
+            void AddFace(int space, const Corner& c0, const Corner& c1, const Corner& c2);
+
+            const array<int, 2>* newIndices = nullptr;
+            const float* distances = nullptr;
+            EdgeTable cutPointTable;
+            vector<LocalCutPoint> cutPoints;
+            vector<UINT> globalCutPoints;
+            vector<UINT> indices[2];
+            vector<array<UINT, 2>> segments[2];
+            size_t firstIndex[2] = { 0, 0 };        // 합친 배열에서의 시작 위치
+            size_t firstSegment[2] = { 0, 0 };
+        };
+
+        // 면 분할 : Output은 BasicSliceContext 자신(단일 스레드) 또는 SplitChunk
+        template <typename Output>
+        void SplitFaceRange(Output& output, const VertexType* vertices, const UINT* indices, UINT beginFace, UINT endFace, const XMVECTOR& plane);
+
+        UINT AddVertexCutPoint(UINT index);
+        UINT AddEdgeCutPoint(const VertexType& vertex);
+        UINT CutPointOnVertex(UINT index);
+        UINT CutPointOnEdge(const VertexType* vertices, UINT index0, UINT index1);
+        Corner OriginalCorner(UINT index, int space);
+        Corner CutCorner(UINT cutPoint, int space) const { return { mCutPoints[cutPoint].vertex[space], cutPoint }; }
+        void AddUncutFace(int space, UINT vertex0, UINT vertex1, UINT vertex2);
+        void AddFace(int space, const Corner& c0, const Corner& c1, const Corner& c2);
+        const XMFLOAT3& CutPointPos(UINT cutPoint) const { return mSlicingVertices[0][mCutPoints[cutPoint].vertex[0]].Pos; }
+        void WeldCutPoints();
+        void CancelOpposingSegments(int space);
+        void ExtractCapLoops(int space);
+
+        int mNumPieces = 0;
+
+        vector<VertexType> mSlicingVertices[2];     // half space = slicingMesh1, oppoiste half space = slicingMesh2
+        vector<UINT> mSlicingIndices[2];        // slicingMesh1, slicingMesh2
+        vector<UINT> mSourceVertices[2];        // slicingMesh1, slicingMesh2의 index -> targetMesh의 index
+        vector<array<int, 2>> mNewIndices;      // targetMesh의 index -> slicingMesh1, slicingMesh2의 index
+
+        // 정점마다 평면 거리와 놓인 쪽 (SliceKernel::Side)
+        vector<float> mDistances;
+        vector<uint8_t> mVertexSides;
+
+        // 병렬 처리 : 구간별 조각 정점 수와 면 분할 결과
+        vector<array<UINT, 2>> mChunkCounts;
+        vector<SplitChunk> mSplitChunks;
+
+        // 원본 변 (작은 index, 큰 index) 또는 절단면 위의 원본 정점 (index, index) -> mCutPoints 인덱스
+        // 이웃한 두 면이 같은 변을 자르면 같은 CutPoint를 받으므로 절단 정점이 비트 단위로 공유된다.
+        EdgeTable mCutPointTable;
+        vector<CutPoint> mCutPoints;
+        float mCutPointScale = 0.0f;            // CutPoint 좌표 절댓값의 최댓값, 용접 허용 오차의 기준
+        EdgeTable mWeldTable;                   // 위치 해시 -> 대표 CutPoint
+
+        // 조각마다 절단면 경계 선분 (CutPoint 인덱스, windingOrder에 따른 다음 CutPoint 인덱스)
+        // 조각 면이 절단면 위의 변을 지나는 방향의 반대로 저장하며, 서로 반대 방향인 선분 쌍은 조각 안쪽이므로 지운다.
+        vector<array<UINT, 2>> mCuttingSurfaceSegments[2];
+        // 시작 CutPoint -> 그 점에서 나가는 첫 선분, mSegmentNext로 같은 점에서 나가는 나머지 선분을 잇는다.
+        // 두 루프가 한 점에서 만나면(pinch) 그 점에서 나가는 선분이 둘 이상이다.
+        EdgeTable mSegmentTable;
+        vector<UINT> mSegmentNext;
+        vector<uint8_t> mSegmentUsed;
+        vector<UINT> mLoopPositions;            // CutPoint -> 만들고 있는 루프에서의 위치, 없으면 UINT_MAX
+
+        // 절단면 루프 : 선분을 이은 닫힌 루프를 절단면 좌표로 투영해 삼각분할한다.
+        vector<UINT> mLoopVertices;             // CutPoint 인덱스, 삼각분할 전에 절단면 점 인덱스로 바꾼다.
+        vector<UINT> mLoopEnds;
+        vector<XMFLOAT2> mCapPoints;            // 절단면 정점의 절단면 좌표 (텍스처 좌표로도 쓴다)
+        PolygonTriangulator mTriangulator;
+        int mNumCapLoops[2] = { 0, 0 };
+        int mNumCapHoles[2] = { 0, 0 };
+        UINT mCapIndexBegins[2] = { 0, 0 };
+    };
+
+    using SliceContext = BasicSliceContext<Vertex>;
+    extern template class BasicSliceContext<Vertex>;
+    extern template class BasicSliceContext<SkinnedVertex>;
+
+    // 스킨드 메시 절단 : 두 조각 모두 원본 스켈레톤으로 계속 애니메이션할 수 있도록 bind pose 정점으로 돌려준다.
+    // boneTransforms가 비어 있으면 bind pose에서 자르고, SkinnedModelInstance::FinalTransforms(전치된 뼈 행렬)를 주면
+    // 그 포즈로 스키닝한 공간(plane도 이 공간 기준)에서 자른다. 이때 원본 정점은 원래 bind pose 정점을 그대로 쓰고,
+    // 절단/절단면 정점은 보간한 가중치로 섞은 뼈 행렬의 역행렬로 bind pose에 되돌리므로 같은 포즈에서 절단면 위에 다시 놓인다.
+    class SkinnedSliceContext
+    {
+    public:
+        int Slice(const Mesh* targetMesh, const Submesh& submesh, const XMFLOAT4& plane, span<const XMFLOAT4X4> boneTransforms = {}, ThreadPool* threadPool = nullptr);
+        int Slice(const SkinnedVertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, const XMFLOAT4& plane,
+            span<const XMFLOAT4X4> boneTransforms = {}, ThreadPool* threadPool = nullptr);
+
+        int NumPieces() const { return mSliceContext.NumPieces(); }
+        // bind pose 정점
+        span<const SkinnedVertex> PieceVertices(int piece) const { return mIsPosed ? span<const SkinnedVertex>(mBindVertices[piece]) : mSliceContext.PieceVertices(piece); }
+        span<const UINT> PieceIndices(int piece) const { return mSliceContext.PieceIndices(piece); }
+        span<const UINT> PieceSourceVertices(int piece) const { return mSliceContext.PieceSourceVertices(piece); }
+
+        size_t ScratchByteSize() const;
+
+    private:
+        static constexpr UINT SkinningGrainSize = 16384;
+
+        BasicSliceContext<SkinnedVertex> mSliceContext;
+        bool mIsPosed = false;
+        vector<SkinnedVertex> mPosedVertices;
+        vector<SkinnedVertex> mBindVertices[2];
+    };
+
+    // 여러 평면으로 차례로 자른 조각을 하나의 정점/인덱스 배열에 모으는 컨텍스트
+    // 평면마다 지금까지 만든 모든 조각 중 그 평면에 걸친 조각만 자른다. (격자 자르기, 평면 배치로 나뉜 볼록 셀 파편, 반복 절단)
+    // 입력 정점은 처음에 모든 평면에 대해 한 번에 분류해 두고, 조각마다 정점 분류를 OR한 비트 마스크로 평면에 걸쳤는지 판단하므로
+    // 걸치지 않은 조각은 정점을 다시 보지 않고 그대로 넘긴다.
+    class MultiSliceContext
+    {
+    public:
+        static constexpr int MaxPlanes = 64;
+
+        int Slice(const Mesh* targetMesh, const Submesh& submesh, span<const XMFLOAT4> planes, ThreadPool* threadPool = nullptr);
+        int Slice(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, span<const XMFLOAT4> planes, ThreadPool* threadPool = nullptr);
+
+        int NumPieces() const { return (int)mPieceSubmeshes.size(); }
+        // 모든 조각을 이어 붙인 정점/인덱스, 인덱스는 Vertices() 기준이라 한 번에 올리고 한 번에 그릴 수 있다.
+        span<const Vertex> Vertices() const { return mVertices; }
+        span<const UINT> Indices() const { return mIndices; }
+        // 조각마다 인덱스 범위(baseVertex = 0)와 바운딩 박스
+        const vector<Submesh>& PieceSubmeshes() const { return mPieceSubmeshes; }
+        span<const Vertex> PieceVertices(int piece) const { return span<const Vertex>(mVertices).subspan(mPieceVertexRanges[piece][0], mPieceVertexRanges[piece][1]); }
+
+        size_t ScratchByteSize() const;
+
+    private:
+        // 작업 배열 안의 조각, sides[0]/[1] : 평면 양쪽/반대쪽에 정점이 있는 평면 비트
+        struct Piece
+        {
+            UINT baseVertex;
+            UINT numVertices;
+            UINT baseIndex;
+            UINT numIndices;
+            uint64_t sides[2];
+        };
+
+        void AddPiece(UINT baseVertex, UINT baseIndex, uint64_t planeMask);
+        void AppendSlicedPiece(int space, const Piece& parent, span<const XMFLOAT4> planes, int plane);
+        void CompactPieces();
+        void PackPieces();
+
+        // 자르는 동안의 조각은 작업 배열 끝에 계속 추가하고, 잘린 조각의 자리는 CompactPieces에서 한꺼번에 정리한다.
+        vector<Vertex> mWorkVertices;
+        vector<UINT> mWorkIndices;
+        vector<array<uint64_t, 2>> mWorkSides;  // 정점마다 Piece::sides와 같은 비트
+        vector<Vertex> mCompactVertices;
+        vector<UINT> mCompactIndices;
+        vector<array<uint64_t, 2>> mCompactSides;
+        // 입력 정점의 SoA 위치와 평면 하나의 분류 결과 (처음 분류에만 쓴다.)
+        vector<float> mPositions[3];
+        vector<float> mPlaneDistances;
+        vector<uint8_t> mPlaneSides;
+        vector<Piece> mPieces;
+        vector<Piece> mNextPieces;
+        SliceContext mSliceContext;
+
+        vector<Vertex> mVertices;
+        vector<UINT> mIndices;
+        vector<Submesh> mPieceSubmeshes;
+        vector<array<UINT, 2>> mPieceVertexRanges;  // (첫 정점, 정점 수)
+    };
+
+    // 볼록 다면체로 자르는 컨텍스트 : 볼록 다면체는 법선이 바깥을 보는 평면들로 주며 (상자, 절두체, k-DOP), 안쪽은 모든 평면의 반대쪽이다.
+    // Clip은 메시에서 볼록 다면체 안의 부분을, Subtract는 볼록 다면체를 파낸 나머지(크레이터)를 하나의 정점/인덱스 배열로 돌려준다.
+    // 입력이 닫힌 메시면 결과도 닫힌 메시다. (Subtract의 벽은 Clip의 절단면을 뒤집은 것이다.)
+    // 평면마다 지금까지 남은 면 중 그 평면에 닿는 면(정점 하나라도 평면 위나 바깥쪽에 있는 면)만 모아 SliceContext로 자르고,
+    // 닿지 않는 면과 정점은 번호도 바꾸지 않으므로 평면 하나의 비용은 그 평면에 닿는 면 수에 비례한다.
+    // 입력 정점은 처음에 모든 평면으로 한 번 분류해 두고, 절단으로 생긴 정점만 남은 평면으로 분류한다.
+    class ConvexSliceContext
+    {
+    public:
+        static constexpr int MaxPlanes = 64;
+
+        // 결과 삼각형 수를 반환한다.
+        int Clip(const Mesh* targetMesh, const Submesh& submesh, span<const XMFLOAT4> planes);
+        int Clip(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, span<const XMFLOAT4> planes);
+        int Subtract(const Mesh* targetMesh, const Submesh& submesh, span<const XMFLOAT4> planes);
+        int Subtract(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, span<const XMFLOAT4> planes);
+
+        span<const Vertex> Vertices() const { return mVertices; }
+        span<const UINT> Indices() const { return mIndices; }
+        // 볼록 다면체 면 위의 삼각형(Clip의 절단면, Subtract의 벽)이 시작하는 인덱스 위치, 그 앞은 원본 겉면이다.
+        UINT CapIndexBegin() const { return mCapIndexBegin; }
+
+        size_t ScratchByteSize() const;
+
+    private:
+        // 작업 면의 상태 : 볼록 다면체 안쪽 부분의 겉면/절단면, 바깥쪽 겉면, 버린 면
+        enum FaceState : uint8_t
+        {
+            FaceInside = 0,
+            FaceInsideCap = 1,
+            FaceOutside = 2,
+            FaceRemoved = 3,
+        };
+
+        int Cut(const Vertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices, span<const XMFLOAT4> planes, bool keepOutside);
+        // planeMask의 평면 중 이 면이 닿는 평면이 있는지
+        bool IsTouchingPlanes(UINT face, uint64_t planeMask) const;
+        // laterPlanes : 이 평면 다음 평면 비트
+        void AppendSlicedPiece(int space, span<const XMFLOAT4> planes, int plane, uint64_t laterPlanes);
+        void PackResult(bool keepOutside);
+        // Subtract 결과에서 바깥 면과 벽 사이의 T자 이음을 없앤다.
+        void SplitRimEdges();
+        // 열린 변 a -> b를 채우는 b에서 a까지의 열린 변 사슬을 찾아 사이의 점(합친 정점 번호)을 a 쪽부터 mRimChain에 남긴다.
+        bool FindRimChain(UINT a, UINT b);
+
+        vector<Vertex> mWorkVertices;
+        vector<array<uint64_t, 2>> mWorkSides;  // 정점마다 평면 법선 쪽/반대쪽에 있는 평면 비트 (MultiSliceContext와 같다)
+        vector<UINT> mWorkIndices;
+        vector<uint8_t> mFaceStates;
+        vector<UINT> mActiveFaces;              // 안쪽 면 중 아직 남은 평면에 닿는 면
+        vector<UINT> mNextActiveFaces;
+        vector<float> mPlaneDistances;
+        vector<uint8_t> mPlaneSides;
+
+        // 평면에 닿는 면을 모은 지역 메시와 지역 정점 -> 작업 정점 번호
+        vector<UINT> mLocalIndexOf;             // 작업 정점 -> 지역 정점 번호, mLocalStamps가 이번 평면이 아니면 무효
+        vector<UINT> mLocalStamps;
+        UINT mStamp = 0;
+        vector<Vertex> mLocalVertices;
+        vector<UINT> mLocalIndices;
+        vector<UINT> mLocalToWork;
+        vector<uint8_t> mLocalIsCap;            // 지역 정점이 절단면 정점인지
+        vector<UINT> mPieceToWork;              // 조각 정점 -> 작업 정점 번호, 아직 없으면 UINT_MAX
+        SliceContext mSliceContext;
+
+        UINT mNumSourceVertices = 0;
+        vector<Vertex> mVertices;
+        vector<UINT> mIndices;
+        vector<UINT> mPackedIndexOf;
+        vector<uint8_t> mPackedIsNew;           // 절단으로 생긴 정점인지
+        UINT mCapIndexBegin = 0;
+
+        // T자 이음 : 절단으로 생긴 정점을 위치로 합친 번호와 그 번호로 센 변
+        vector<UINT> mRimWelds;
+        EdgeTable mRimWeldTable;
+        EdgeTable mRimEdgeTable;
+        vector<array<UINT, 2>> mRimEdges;
+        vector<array<UINT, 2>> mOpenEdges;
+        vector<UINT> mRimChain;
+        vector<array<UINT, 3>> mRimFaceStack;
+        vector<UINT> mRepairedIndices;
+    };
+
+    // 볼록 다면체 평면 (법선이 바깥쪽)
+    void BuildBoxPlanes(const BoundingOrientedBox& box, vector<XMFLOAT4>& planes);
+    void BuildFrustumPlanes(const BoundingFrustum& frustum, vector<XMFLOAT4>& planes);
+    // center에서 directions(정규화하지 않아도 된다)마다 거리 radius인 평면, 축 6개와 대각 8개면 14-DOP
+    void BuildKDopPlanes(const XMFLOAT3& center, span<const XMFLOAT3> directions, float radius, vector<XMFLOAT4>& planes);
+
+    // 한 번 자르고 결과를 outVertices, outIndices 끝에 복사한다. 반복해서 자를 때는 SliceContext를 사용한다.
     int MeshCompleteSlice(const Mesh* targetMesh, const Submesh submesh, const XMFLOAT4 plane, vector<vector<Vertex>>& outVertices, vector<vector<UINT>>& outIndices);
-}
\ No newline at end of file
+}
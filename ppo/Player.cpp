@@ -1,4 +1,6 @@
 #include "Player.h"
+#include "SkinnedModelInstance.h"
+#include "Terrain.h"
 
 XMFLOAT3 MultipleVelocity(const XMFLOAT3& dir, const XMFLOAT3& scalar)
 {
@@ -22,6 +24,15 @@ void Player::ChangeState(PlayerState* nextState)
 	delete mCurrentState;
 	mCurrentState = nextState;
 	mCurrentState->Enter(*this);
+
+	// 클립을 바로 바꾸지 않고 이전 동작에서 넘어간다.
+	CrossFadeAnimation(mCurrentState->CrossFadeDuration());
+}
+
+void Player::CrossFadeAnimation(float duration)
+{
+	if (SkinnedModelInstance* skinnedModelInst = GetSkinnedModelInst())
+		skinnedModelInst->CrossFade(GetAnimationIndex(), duration, mAnimationTime);
 }
 
 Player::Player(const string name, XMFLOAT4X4 world, XMFLOAT4X4 texTransform) : 
@@ -51,14 +62,14 @@ void Player::Update(const GameTimer& gt)
 {
 	float deltaTime = gt.DeltaTime();
 
-	// ߶
+	// 추락
 	mVelocity.y -= mGravity * deltaTime;
 	float fallSpeed = sqrt(mVelocity.y * mVelocity.y);
 	if ((mVelocity.y * mVelocity.y) > (mMaxVelocityY * mMaxVelocityY) && mVelocity.y < 0) {
 		mVelocity.y = -mMaxVelocityY;
 	}
 
-	// ִ ӵ 
+	// 최대 속도 제한
 	float maxVelocityXZ = mIsRun ? mMaxRunVelocityXZ : mMaxWalkVelocityXZ;
 	float groundSpeed = sqrt(mVelocity.x * mVelocity.x + mVelocity.z * mVelocity.z);
 	if (groundSpeed > maxVelocityXZ) {
@@ -66,7 +77,7 @@ void Player::Update(const GameTimer& gt)
 		mVelocity.z *= maxVelocityXZ / groundSpeed;
 	}
 
-	// 
+	// 마찰
 	XMFLOAT3 friction;
 	XMStoreFloat3(&friction, -XMVector3Normalize(XMVectorSet(mVelocity.x, 0.0f, mVelocity.z, 0.0f)) * mFriction * deltaTime);
 	mVelocity.x = (mVelocity.x >= 0.0f) ? max(0.0f, mVelocity.x + friction.x) : min(0.0f, mVelocity.x + friction.x);
@@ -74,18 +85,31 @@ void Player::Update(const GameTimer& gt)
 
 	SetPosition(Vector3::Add(GetPosition(), mVelocity));
 
-	if (GetPosition().y < 0) {
-		SetPosition(GetPosition().x, 0.0f, GetPosition().z);
+	// 지면 높이 (지형 공간으로 옮겨 묻는다.)
+	XMFLOAT3 position = GetPosition();
+	mGroundHeight = 0.0f;
+	if (mTerrain)
+		mGroundHeight = mTerrain->GetGroundHeight(position.x - mTerrainOffset.x, position.z - mTerrainOffset.z) + mTerrainOffset.y;
+
+	if (position.y < mGroundHeight || (!mIsFalling && position.y < mGroundHeight + mGroundSnapDistance)) {
+		SetPosition(position.x, mGroundHeight, position.z);
 		mVelocity.y = 0.0f;
 		mIsFalling = false;
 	}
 
-	// ī޶ ̵
+	// 카메라 이동
 	UpdateCamera();
 	UpdateState(deltaTime);
 
 	mAnimationTime += deltaTime;
 
+	// 스키닝 인스턴스는 플레이어 상태의 시간으로 재생한다. 클립은 ChangeState에서 crossfade로 바뀐다.
+	// crossfade 중인 이전 클립은 Advance로 계속 진행한다.
+	if (SkinnedModelInstance* skinnedModelInst = GetSkinnedModelInst()) {
+		skinnedModelInst->Advance(deltaTime);
+		skinnedModelInst->TimePos = mAnimationTime;
+	}
+
 	SetFrameDirty();
 }
 
@@ -94,7 +118,7 @@ void Player::UpdateCamera()
 	if (mMode == THIRD_PERSON) {
 		XMVECTOR cameraLook = XMVector3TransformNormal(XMLoadFloat3(&GetLook()), XMMatrixRotationAxis(XMLoadFloat3(&GetRight()), mPitch));
 		XMVECTOR playerPosition = XMLoadFloat3(&GetPosition()) + XMLoadFloat3(&mCameraOffsetPosition) + XMVectorSet(0.0f, 50.0f, 0.f, 0.0f);
-		XMVECTOR cameraPosition = playerPosition - cameraLook * 500.f;// + XMVectorSet(0.0f, 50.0f, 0.f, 0.0f); // distance ī޶ ÷̾  Ÿ
+		XMVECTOR cameraPosition = playerPosition - cameraLook * 500.f;// + XMVectorSet(0.0f, 50.0f, 0.f, 0.0f); // distance는 카메라와 플레이어 사이의 거리
 
 		XMMATRIX viewMatrix = XMMatrixLookAtLH(cameraPosition, playerPosition, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
 		mCamera->LookAt(cameraPosition, playerPosition, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
@@ -102,19 +126,19 @@ void Player::UpdateCamera()
 		mCamera->UpdateViewMatrix();
 	}
 	// if (mMode == FIRST_PERSON) {
-	// 	// ÷̾ ġ  
+	// 	// 플레이어의 위치와 방향을 가져옴
 	// 	XMVECTOR playerPosition = XMLoadFloat3(&GetPosition()) + XMLoadFloat3(&mCameraOffsetPosition);
 	// 	XMVECTOR playerLook = XMLoadFloat3(&GetLook());
 	// 
-	// 	// ī޶ ÷̾ ߽ ȸϵ   ͸ 
-	// 	XMMATRIX rotationMatrix = XMMatrixRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), mPitch); // X ߽ ȸ
+	// 	// 카메라가 플레이어를 중심으로 회전하도록 변형한 방향 벡터를 계산
+	// 	XMMATRIX rotationMatrix = XMMatrixRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), mPitch); // X축을 중심으로 회전
 	// 	XMVECTOR cameraLook = XMVector3Transform(playerLook, rotationMatrix);
 	// 
-	// 	// ÷̾ ߽ ϴ ī޶ ġ 
-	// 	XMVECTOR cameraPosition = playerPosition + cameraLook * 30.0f; // ī޶ ÷̾ ڷ ̵
+	// 	// 플레이어를 중심으로 하는 카메라 위치 계산
+	// 	XMVECTOR cameraPosition = playerPosition + cameraLook * 30.0f; // 카메라를 플레이어 뒤로 이동
 	// 
-	// 	// ī޶   
-	// 	mCamera->SetViewMatrix(XMMatrixLookToLH(cameraPosition, cameraLook, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f))); //  ͸    
+	// 	// 카메라의 뷰 행렬 적용
+	// 	mCamera->SetViewMatrix(XMMatrixLookToLH(cameraPosition, cameraLook, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f))); // 상단 벡터를 기준으로 뷰 행렬 생성
 	// }
 
 	else if (mMode == FIRST_PERSON) {
@@ -130,29 +154,29 @@ void Player::UpdateCamera()
 	}
 
 	// if (mMode == FIRST_PERSON) {
-	// 	// ÷̾ ġ  
+	// 	// 플레이어의 위치와 방향을 가져옴
 	// 	XMVECTOR playerPosition = XMLoadFloat3(&GetPosition()) + XMLoadFloat3(&mCameraOffsetPosition);
 	// 	XMVECTOR playerLook = XMLoadFloat3(&GetLook());
 	// 
-	// 	// ī޶ ÷̾ ߽ ȸϵ   ͸ 
-	// 	XMMATRIX rotationMatrix = XMMatrixRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), mPitch); // X ߽ ȸ
+	// 	// 카메라가 플레이어를 중심으로 회전하도록 변형한 방향 벡터를 계산
+	// 	XMMATRIX rotationMatrix = XMMatrixRotationAxis(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), mPitch); // X축을 중심으로 회전
 	// 	XMVECTOR cameraLook = XMVector3Transform(playerLook, rotationMatrix);
 	// 
-	// 	// ÷̾ ߽ ϴ ī޶ ġ 
-	// 	XMVECTOR cameraPosition = playerPosition + cameraLook * 30.0f; // ī޶ ÷̾ ڷ ̵
+	// 	// 플레이어를 중심으로 하는 카메라 위치 계산
+	// 	XMVECTOR cameraPosition = playerPosition + cameraLook * 30.0f; // 카메라를 플레이어 뒤로 이동
 	// 
-	// 	// ī޶ ־ ŭ ¿ ȸ
-	// 	float rotationAngle = 0.1f; //  
-	// 	mCamera->RotateY(rotationAngle); // ȸ  ϴ  ؾ մϴ.
+	// 	// 카메라를 주어진 각도만큼 좌우로 회전
+	// 	float rotationAngle = 0.1f; // 예시 각도
+	// 	mCamera->RotateY(rotationAngle); // 회전 각도를 원하는 값으로 설정해야 합니다.
 	// 
-	// 	// ī޶   
-	// 	mCamera->SetViewMatrix(XMMatrixLookToLH(cameraPosition, cameraLook, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f))); //  ͸    
+	// 	// 카메라의 뷰 행렬 적용
+	// 	mCamera->SetViewMatrix(XMMatrixLookToLH(cameraPosition, cameraLook, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f))); // 상단 벡터를 기준으로 뷰 행렬 생성
 	// }
 }
 
 void Player::UpdateState(const float deltaTime)
 {
-	if (GetPosition().y > 0 && !mIsFalling) {
+	if (GetPosition().y > mGroundHeight && !mIsFalling) {
 		mIsFalling = true;
 		ChangeState(new PlayerStateFall);
 	}
@@ -192,59 +216,59 @@ void Player::KeyboardInput(float dt)
 	if (GetAsyncKeyState('W') & 0x8000) {
 		if (!mIsFalling && !isPlayingW && !isPlayingA && !isPlayingS && !isPlayingD) {
 			isPlayingW = true;
-			// Ҹ ϴ  
+			// 소리를 재생하는 스레드 시작
 			std::thread soundThread([this]() {
-				while (isPlayingW) { // isPlayingW true  ݺ
+				while (isPlayingW) { // isPlayingW이 true일 때까지 반복
 					PlaySoundThread(L"Sound/walk1.wav");
 				}
 				});
-			soundThread.detach(); // 带     			
+			soundThread.detach(); // 스레드를 떼어내어 메인 스레드와 독립적으로 실행			
 		}
 		mVelocity = Vector3::Add(mVelocity, MultipleVelocity(GetLook(), velocity));
 	}
 	else {
 		if (isPlayingW) {
-			// W Ű  ʾ  Ҹ  ̸ 
-			// HRESULT hr = stopSound(); // Ҹ  			
+			// W 키가 눌리지 않았을 때 소리 재생 중이면 종료
+			// HRESULT hr = stopSound(); // 소리 재생 중지			
 			isPlayingW = false;
 		}
 	}
 	if (GetAsyncKeyState('S') & 0x8000) {
 		if (!mIsFalling && !isPlayingW && !isPlayingA && !isPlayingS && !isPlayingD) {
 			isPlayingS = true;
-			// Ҹ ϴ  
+			// 소리를 재생하는 스레드 시작
 			std::thread soundThread([this]() {
-				while (isPlayingS) { // isPlayingS true  ݺ
+				while (isPlayingS) { // isPlayingS이 true일 때까지 반복
 					PlaySoundThread(L"Sound/walk1.wav");
 				}
 				});
-			soundThread.detach(); // 带     			
+			soundThread.detach(); // 스레드를 떼어내어 메인 스레드와 독립적으로 실행			
 		}
 		mVelocity = Vector3::Add(mVelocity, MultipleVelocity(Vector3::ScalarProduct(GetLook(), -1), velocity));
 	}
 	else {
 		if (isPlayingS) {
-			// S Ű  ʾ  Ҹ  ̸ 
-			HRESULT hr = stopSound(); // Ҹ  			
+			// S 키가 눌리지 않았을 때 소리 재생 중이면 종료
+			HRESULT hr = stopSound(); // 소리 재생 중지			
 			isPlayingS = false;
 		}
 	}
 	if (GetAsyncKeyState('D') & 0x8000) {
 		if (!mIsFalling && !isPlayingW && !isPlayingA && !isPlayingS && !isPlayingD) {
 			isPlayingD = true;
-			// Ҹ ϴ  
+			// 소리를 재생하는 스레드 시작
 			std::thread soundThread([this]() {
-				while (isPlayingD)  // isPlayingD true  ݺ
+				while (isPlayingD)  // isPlayingD이 true일 때까지 반복
 					PlaySoundThread(L"Sound/walk1.wav");
 				});
-			soundThread.detach(); // 带     			
+			soundThread.detach(); // 스레드를 떼어내어 메인 스레드와 독립적으로 실행			
 		}
 		mVelocity = Vector3::Add(mVelocity, MultipleVelocity(GetRight(), velocity));
 	}
 	else {
 		if (isPlayingD) {
-			// D Ű  ʾ  Ҹ  ̸ 
-			HRESULT hr = stopSound(); // Ҹ  			
+			// D 키가 눌리지 않았을 때 소리 재생 중이면 종료
+			HRESULT hr = stopSound(); // 소리 재생 중지			
 			isPlayingD = false;
 		}
 	}
@@ -252,19 +276,19 @@ void Player::KeyboardInput(float dt)
 	if (GetAsyncKeyState('A') & 0x8000) {
 		if (!mIsFalling && !isPlayingW && !isPlayingA && !isPlayingS && !isPlayingD) {
 			isPlayingA = true;
-			// Ҹ ϴ  
+			// 소리를 재생하는 스레드 시작
 			std::thread soundThread([this]() {
-				while (isPlayingA) // isPlayingA true  ݺ
+				while (isPlayingA) // isPlayingA이 true일 때까지 반복
 					PlaySoundThread(L"Sound/walk1.wav");
 				});
-			soundThread.detach(); // 带     			
+			soundThread.detach(); // 스레드를 떼어내어 메인 스레드와 독립적으로 실행			
 		}
 		mVelocity = Vector3::Add(mVelocity, MultipleVelocity(Vector3::ScalarProduct(GetRight(), -1), velocity));		
 	}
 	else {
 		if (isPlayingA) {
-			// A Ű  ʾ  Ҹ  ̸ 
-			// HRESULT hr = stopSound(); // Ҹ  			
+			// A 키가 눌리지 않았을 때 소리 재생 중이면 종료
+			// HRESULT hr = stopSound(); // 소리 재생 중지			
 			isPlayingA = false;
 		}
 	}
@@ -294,7 +318,7 @@ void Player::OnKeyboardMessage(UINT nMessageID, WPARAM wParam)
 		{
 		case VK_SPACE:
 			if (!mIsFalling) {
-				HRESULT hr = stopSound(); // Ҹ  
+				HRESULT hr = stopSound(); // 소리 재생 중지
 				mVelocity.y += mJumpForce;
 				mIsFalling = true;
 				ChangeState(new PlayerStateJump);				
@@ -372,15 +396,15 @@ HRESULT Player::playSound(LPCWSTR szFilename)
 
 HRESULT Player::stopSound()
 {
-	// Ҹ ϱ  Ҹ  ʱȭǾ Ȯմϴ.
+	// 소리를 재생하기 전에 소리 엔진이 초기화되었는지 확인합니다.
 	if (!m_pXAudio2 || !m_pMasteringVoice)
 	{
-		// Ҹ  ʱȭ ʾ  ȯմϴ.
+		// 소리 엔진이 초기화되지 않았으면 오류를 반환합니다.
 		return E_FAIL;
 	}
 
-	//  Ҹ   ҽ ̽ մϴ.
-	//  ÿ ܼ  ҽ ̽ ŵϴ.
+	// 현재 소리를 재생 중인 소스 보이스를 중지합니다.
+	// 이 예시에서는 단순히 모든 소스 보이스를 중지시킵니다.
 	m_pXAudio2->StopEngine();
 
 	return S_OK;
@@ -388,7 +412,7 @@ HRESULT Player::stopSound()
 
 void Player::PlaySoundThread(LPCWSTR szFilename)
 {
-	HRESULT hr = InitializeXAudio2(); // XAudio2 ʱȭ
+	HRESULT hr = InitializeXAudio2(); // XAudio2 초기화
 	hr = playSound(szFilename);
 }
 
@@ -402,7 +426,7 @@ void Player::StopAllSounds()
 		SetIsPlayingS(false);
 	if (isPlayingD)
 		SetIsPlayingD(false);
-	HRESULT hr = stopSound(); // Ҹ  
+	HRESULT hr = stopSound(); // 소리 재생 중지
 }
 
 void Player::StartAllSounds()
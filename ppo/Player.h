@@ -8,6 +8,7 @@
 #define MAX_PLAYER_CAMERA_PITCH 85.0f
 
 class Player;
+class Terrain;
 
 enum class StateId : UINT
 {
@@ -34,12 +35,14 @@ public:
 	~PlayerState() {}
 
 	StateId ID() { return mId; }
+	float CrossFadeDuration() { return mCrossFadeDuration; }
 
 	virtual void Enter(Player& player) {};
 	virtual void Update(Player& player, const float deltaTime) {};
 	virtual void Exit(Player& player) {};
 protected:
 	StateId mId = StateId::Defalut;
+	float mCrossFadeDuration = 0.2f;	// 이 상태에 들어올 때 이전 동작에서 넘어오는 시간 (초)
 };
 
 class Player : public GameObject
@@ -52,7 +55,7 @@ public:
 
 	virtual void Update(const GameTimer& gt);
 	void UpdateCamera();
-	void UpdateState(const float deltaTime);		// PlayerState ȯ
+	void UpdateState(const float deltaTime);		// PlayerState 변환
 
 	void KeyboardInput(float dt);
 	void OnKeyboardMessage(UINT nMessageID, WPARAM wParam);
@@ -66,11 +69,16 @@ public:
 	void SetAnimationTime() { mAnimationTime = 0.0f; }
 	float GetAnimationTime() { return mAnimationTime; }
 	UINT GetAnimationIndex() { return mAnimationIndex[GetStateId()]; }
+	void CrossFadeAnimation(float duration);	// 현재 상태의 클립으로 crossfade
 
 	bool IsFalling() { return mIsFalling; }
 
 	void SetZoomFactor(float zoom) { mZoomFactor = zoom; }
 
+	// 지면 : terrain(지형 공간)을 terrainOffset만큼 옮겨 그린 면, terrain이 없으면 y = 0 평면
+	void SetTerrain(Terrain* terrain, const XMFLOAT3& terrainOffset) { mTerrain = terrain; mTerrainOffset = terrainOffset; }
+	float GetGroundHeight() { return mGroundHeight; }
+
 	HRESULT InitializeXAudio2();
 	HRESULT playSound(LPCWSTR szFilename);
 	HRESULT stopSound();
@@ -101,6 +109,11 @@ private:
 	bool mIsFalling = false;
 	float mMaxVelocityY = 10.0f;
 	float mFriction = 10.0f;
+	float mGroundSnapDistance = 10.0f;	// 땅에 서 있을 때 이만큼 아래의 지면까지는 떨어지지 않고 붙어 내려간다. (내리막)
+
+	Terrain* mTerrain = nullptr;
+	XMFLOAT3 mTerrainOffset = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	float mGroundHeight = 0.0f;
 	
 	float mZoomFactor = 100.f;
 
@@ -155,16 +168,16 @@ public:
 class PlayerStateLand : public PlayerState
 {
 public:
-	PlayerStateLand() { mId = StateId::Land; }
+	PlayerStateLand() { mId = StateId::Land; mCrossFadeDuration = 0.1f; }
 
 	virtual void Enter(Player& player) override
 	{
 		player.StopAllSounds();
-		// Ҹ ϴ  
+		// 소리를 재생하는 스레드 시작
 		std::thread soundThread([&player]() {
 			player.PlaySoundThread(L"Sound/landingSound.wav");
 			});
-		soundThread.detach(); // 带     
+		soundThread.detach(); // 스레드를 떼어내어 메인 스레드와 독립적으로 실행
 		player.SetAnimationTime();
 		std::this_thread::sleep_for(std::chrono::milliseconds(100));
 	}
@@ -197,18 +210,18 @@ public:
 class PlayerStateJump : public PlayerState
 {
 public:
-	PlayerStateJump() { mId = StateId::Jump; }
+	PlayerStateJump() { mId = StateId::Jump; mCrossFadeDuration = 0.1f; }
 
 	virtual void Enter(Player& player) override
 	{
 		player.StopAllSounds();
-		// Ҹ ϴ  
+		// 소리를 재생하는 스레드 시작
 		std::thread soundThread([&player]() {
 			player.PlaySoundThread(L"Sound/JumpSound.wav");
 			});
-		soundThread.detach(); // 带     
+		soundThread.detach(); // 스레드를 떼어내어 메인 스레드와 독립적으로 실행
 		player.SetAnimationTime();		
-		// 尡    
+		// 스레드가 실행 중일 때까지 대기
 		if (soundThread.joinable())
 			soundThread.join();
 	}
@@ -0,0 +1,391 @@
+#include "PolygonTriangulator.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+// (b - a) x (c - a), 반시계면 양수
+static float Orient(const XMFLOAT2& a, const XMFLOAT2& b, const XMFLOAT2& c)
+{
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+int PolygonTriangulator::Triangulate(span<const XMFLOAT2> points, span<const UINT> loopVertices, span<const UINT> loopEnds, vector<UINT>& triangles)
+{
+    mPoints = points;
+    mLoopVertices = loopVertices;
+    size_t numTriangleIndices = triangles.size();
+
+    UINT numVertices = (UINT)loopVertices.size();
+    mPrev.resize(numVertices);
+    mNext.resize(numVertices);
+    UINT loopBegin = 0;
+    for (UINT loopEnd : loopEnds)
+    {
+        for (UINT i = loopBegin; i < loopEnd; i++)
+        {
+            mPrev[i] = (i == loopBegin) ? loopEnd - 1 : i - 1;
+            mNext[i] = (i + 1 == loopEnd) ? loopBegin : i + 1;
+        }
+        loopBegin = loopEnd;
+    }
+
+    mOrder.resize(numVertices);
+    for (UINT i = 0; i < numVertices; i++)
+        mOrder[i] = i;
+    sort(mOrder.begin(), mOrder.end(), [this](UINT a, UINT b) { return Above(a, b); });
+    mRank.resize(numVertices);
+    for (UINT i = 0; i < numVertices; i++)
+        mRank[mOrder[i]] = i;
+
+    MakeMonotone();
+    BuildFaces();
+
+    // 대각선으로 나뉜 면은 모두 y 단조 다각형이다.
+    fill(mVisited.begin(), mVisited.end(), 0);
+    for (UINT start = 0; start < (UINT)mHalfEdges.size(); start++)
+    {
+        if (mVisited[start])
+            continue;
+
+        mFace.clear();
+        UINT halfEdge = start;
+        // 잘못된 입력(교차하는 루프 등)에서도 끝나도록 half edge 수만큼만 따라간다.
+        for (size_t step = 0; step < mHalfEdges.size() && !mVisited[halfEdge]; step++)
+        {
+            mVisited[halfEdge] = 1;
+            mFace.push_back(mHalfEdges[halfEdge][0]);
+            halfEdge = NextHalfEdge(halfEdge);
+        }
+        TriangulateMonotone(mFace, triangles);
+    }
+
+    return (int)((triangles.size() - numTriangleIndices) / 3);
+}
+
+size_t PolygonTriangulator::ScratchByteSize() const
+{
+    size_t byteSize = (mPrev.capacity() + mNext.capacity() + mOrder.capacity() + mRank.capacity()) * sizeof(UINT);
+    byteSize += mTypes.capacity() * sizeof(VertexType);
+    // 트리 노드 크기는 구현마다 다르므로 값과 포인터 세 개, 색으로 어림한다.
+    byteSize += mMaxStatusSize * (sizeof(UINT) + 4 * sizeof(void*)) + mStatusPositions.capacity() * sizeof(StatusSet::iterator) + mInStatus.capacity();
+    byteSize += mHelper.capacity() * sizeof(UINT) + mDiagonals.capacity() * sizeof(array<UINT, 2>);
+    byteSize += mHalfEdges.capacity() * sizeof(array<UINT, 2>) + (mOutgoingOffsets.capacity() + mOutgoing.capacity() + mFace.capacity()) * sizeof(UINT);
+    byteSize += mVisited.capacity() + mLeftChain.capacity() + (mSorted.capacity() + mStack.capacity()) * sizeof(UINT);
+    return byteSize;
+}
+
+bool PolygonTriangulator::Above(UINT a, UINT b) const
+{
+    const XMFLOAT2& pa = Point(a);
+    const XMFLOAT2& pb = Point(b);
+    if (pa.y != pb.y) return pa.y > pb.y;
+    if (pa.x != pb.x) return pa.x < pb.x;
+    return a < b;
+}
+
+void PolygonTriangulator::MakeMonotone()
+{
+    UINT numVertices = (UINT)mOrder.size();
+
+    // 정점 분류 (내부는 변의 왼쪽)
+    mTypes.resize(numVertices);
+    for (UINT v = 0; v < numVertices; v++)
+    {
+        bool prevAbove = Above(mPrev[v], v);
+        bool nextAbove = Above(mNext[v], v);
+        bool convex = Orient(Point(mPrev[v]), Point(v), Point(mNext[v])) >= 0.0f;
+        if (!prevAbove && !nextAbove)
+            mTypes[v] = convex ? VertexType::Start : VertexType::Split;
+        else if (prevAbove && nextAbove)
+            mTypes[v] = convex ? VertexType::End : VertexType::Merge;
+        else
+            mTypes[v] = VertexType::Regular;
+    }
+
+    mStatus.clear();
+    mStatusPositions.resize(numVertices);
+    mInStatus.assign(numVertices, 0);
+    mHelper.resize(numVertices);
+    mDiagonals.clear();
+
+    for (UINT v : mOrder)
+    {
+        UINT prevEdge = mPrev[v];
+        switch (mTypes[v])
+        {
+        case VertexType::Start:
+            InsertEdge(v, v);
+            break;
+
+        case VertexType::End:
+            if (mTypes[mHelper[prevEdge]] == VertexType::Merge)
+                AddDiagonal(v, mHelper[prevEdge]);
+            RemoveEdge(prevEdge);
+            break;
+
+        case VertexType::Split:
+        {
+            UINT left = FindLeftEdge(v);
+            if (left != UINT_MAX) {
+                AddDiagonal(v, mHelper[left]);
+                mHelper[left] = v;
+            }
+            InsertEdge(v, v);
+            break;
+        }
+
+        case VertexType::Merge:
+        {
+            if (mTypes[mHelper[prevEdge]] == VertexType::Merge)
+                AddDiagonal(v, mHelper[prevEdge]);
+            RemoveEdge(prevEdge);
+
+            UINT left = FindLeftEdge(v);
+            if (left != UINT_MAX) {
+                if (mTypes[mHelper[left]] == VertexType::Merge)
+                    AddDiagonal(v, mHelper[left]);
+                mHelper[left] = v;
+            }
+            break;
+        }
+
+        case VertexType::Regular:
+            // 이전 정점이 위에 있으면 내부가 정점의 오른쪽 (왼쪽 경계)
+            if (Above(mPrev[v], v)) {
+                if (mTypes[mHelper[prevEdge]] == VertexType::Merge)
+                    AddDiagonal(v, mHelper[prevEdge]);
+                RemoveEdge(prevEdge);
+                InsertEdge(v, v);
+            }
+            else {
+                UINT left = FindLeftEdge(v);
+                if (left != UINT_MAX) {
+                    if (mTypes[mHelper[left]] == VertexType::Merge)
+                        AddDiagonal(v, mHelper[left]);
+                    mHelper[left] = v;
+                }
+            }
+            break;
+        }
+    }
+}
+
+float PolygonTriangulator::EdgeXAt(UINT edge, float y) const
+{
+    // 상태에 있는 변은 위 정점에서 아래 정점으로 향한다. 수평 변은 위(왼쪽) 정점의 x
+    const XMFLOAT2& a = Point(edge);
+    const XMFLOAT2& b = Point(mNext[edge]);
+    if (a.y == b.y)
+        return a.x;
+    return a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+}
+
+bool PolygonTriangulator::StatusLess::operator()(UINT a, UINT b) const
+{
+    if (a == b)
+        return false;
+    float xa = owner->EdgeXAt(a, owner->mSweepY);
+    float xb = owner->EdgeXAt(b, owner->mSweepY);
+    if (xa != xb)
+        return xa < xb;
+
+    // 같은 점을 지나면 아래로 내려갈수록 x가 더 작아지는(dx / dy가 큰) 변이 왼쪽, 수평 변은 오른쪽으로 뻗으므로 맨 오른쪽
+    auto inverseSlope = [this](UINT edge) {
+        const XMFLOAT2& p = owner->Point(edge);
+        const XMFLOAT2& q = owner->Point(owner->mNext[edge]);
+        return (p.y == q.y) ? -FLT_MAX : (q.x - p.x) / (q.y - p.y);
+    };
+    float slopeA = inverseSlope(a), slopeB = inverseSlope(b);
+    if (slopeA != slopeB)
+        return slopeA > slopeB;
+    return a < b;
+}
+
+UINT PolygonTriangulator::FindLeftEdge(UINT vertex)
+{
+    const XMFLOAT2& p = Point(vertex);
+    mSweepY = p.y;
+    auto right = mStatus.upper_bound(p.x);
+    return (right == mStatus.begin()) ? UINT_MAX : *prev(right);
+}
+
+void PolygonTriangulator::InsertEdge(UINT edge, UINT vertex)
+{
+    mSweepY = Point(vertex).y;
+    mStatusPositions[edge] = mStatus.insert(edge).first;
+    mInStatus[edge] = 1;
+    mHelper[edge] = vertex;
+    mMaxStatusSize = max(mMaxStatusSize, mStatus.size());
+}
+
+void PolygonTriangulator::RemoveEdge(UINT edge)
+{
+    // 넣을 때의 트리 위치로 지우므로 다시 x를 계산해 찾지 않는다. (잘못된 입력에서는 없는 변일 수 있다.)
+    if (!mInStatus[edge])
+        return;
+    mStatus.erase(mStatusPositions[edge]);
+    mInStatus[edge] = 0;
+}
+
+void PolygonTriangulator::AddDiagonal(UINT a, UINT b)
+{
+    // 이미 변으로 이어진 정점 사이의 대각선은 면을 나누지 않는다.
+    if (a == b || mNext[a] == b || mNext[b] == a)
+        return;
+    mDiagonals.push_back({ a, b });
+}
+
+void PolygonTriangulator::BuildFaces()
+{
+    UINT numVertices = (UINT)mOrder.size();
+
+    mHalfEdges.resize(numVertices);
+    for (UINT v = 0; v < numVertices; v++)
+        mHalfEdges[v] = { v, mNext[v] };
+    for (const array<UINT, 2>& diagonal : mDiagonals)
+    {
+        mHalfEdges.push_back({ diagonal[0], diagonal[1] });
+        mHalfEdges.push_back({ diagonal[1], diagonal[0] });
+    }
+
+    mOutgoingOffsets.assign(numVertices + 1, 0);
+    for (const array<UINT, 2>& halfEdge : mHalfEdges)
+        mOutgoingOffsets[halfEdge[0] + 1]++;
+    for (UINT v = 0; v < numVertices; v++)
+        mOutgoingOffsets[v + 1] += mOutgoingOffsets[v];
+
+    mOutgoing.resize(mHalfEdges.size());
+    mStack.assign(mOutgoingOffsets.begin(), mOutgoingOffsets.end() - 1);
+    for (UINT i = 0; i < (UINT)mHalfEdges.size(); i++)
+        mOutgoing[mStack[mHalfEdges[i][0]]++] = i;
+
+    mVisited.resize(mHalfEdges.size());
+}
+
+UINT PolygonTriangulator::NextHalfEdge(UINT halfEdge) const
+{
+    UINT from = mHalfEdges[halfEdge][0];
+    UINT to = mHalfEdges[halfEdge][1];
+    UINT begin = mOutgoingOffsets[to];
+    UINT end = mOutgoingOffsets[to + 1];
+    if (end - begin == 1)
+        return mOutgoing[begin];
+
+    // 대각선이 있는 정점 : 들어온 방향의 반대(to -> from)에서 시계 방향으로 가장 가까운 half edge
+    const XMFLOAT2& center = Point(to);
+    auto Angle = [&](UINT vertex) { const XMFLOAT2& p = Point(vertex); return atan2f(p.y - center.y, p.x - center.x); };
+    float reference = Angle(from);
+
+    UINT best = UINT_MAX, largest = UINT_MAX;
+    float bestAngle = 0.0f, largestAngle = 0.0f;
+    for (UINT i = begin; i < end; i++)
+    {
+        UINT candidate = mOutgoing[i];
+        if (mHalfEdges[candidate][1] == from)
+            continue;
+
+        float angle = Angle(mHalfEdges[candidate][1]);
+        if (angle < reference && (best == UINT_MAX || angle > bestAngle)) {
+            best = candidate;
+            bestAngle = angle;
+        }
+        if (largest == UINT_MAX || angle > largestAngle) {
+            largest = candidate;
+            largestAngle = angle;
+        }
+    }
+    if (best != UINT_MAX)
+        return best;
+    return (largest != UINT_MAX) ? largest : mOutgoing[begin];
+}
+
+void PolygonTriangulator::TriangulateMonotone(span<const UINT> face, vector<UINT>& triangles)
+{
+    size_t numVertices = face.size();
+    if (numVertices < 3)
+        return;
+    if (numVertices == 3) {
+        AddTriangle(face[0], face[1], face[2], triangles);
+        return;
+    }
+
+    // 맨 위 정점에서 반시계로 맨 아래 정점까지가 왼쪽 사슬
+    // 삼각형의 감기 순서는 좌표로 다시 계산하지 않고 사슬에서 정한다. (거의 한 직선 위의 세 점은 계산 순서에 따라 부호가 바뀐다)
+    size_t top = 0, bottom = 0;
+    for (size_t i = 1; i < numVertices; i++)
+    {
+        if (mRank[face[i]] < mRank[face[top]]) top = i;
+        if (mRank[face[i]] > mRank[face[bottom]]) bottom = i;
+    }
+    mLeftChain.resize(mOrder.size());
+    for (size_t i = top; ; i = (i + 1) % numVertices)
+    {
+        mLeftChain[face[i]] = (i != bottom) ? 1 : 0;
+        if (i == bottom)
+            break;
+    }
+    for (size_t i = (bottom + 1) % numVertices; i != top; i = (i + 1) % numVertices)
+        mLeftChain[face[i]] = 0;
+
+    mSorted.assign(face.begin(), face.end());
+    sort(mSorted.begin(), mSorted.end(), [this](UINT a, UINT b) { return mRank[a] < mRank[b]; });
+
+    mStack.clear();
+    mStack.push_back(mSorted[0]);
+    mStack.push_back(mSorted[1]);
+    for (size_t j = 2; j + 1 < numVertices; j++)
+    {
+        UINT v = mSorted[j];
+        if (mLeftChain[v] != mLeftChain[mStack.back()]) {
+            // 반대쪽 사슬 : 스택의 모든 정점과 잇는다.
+            for (size_t k = 0; k + 1 < mStack.size(); k++)
+            {
+                if (mLeftChain[v])
+                    AddTriangle(v, mStack[k + 1], mStack[k], triangles);
+                else
+                    AddTriangle(v, mStack[k], mStack[k + 1], triangles);
+            }
+            UINT previous = mSorted[j - 1];
+            mStack.clear();
+            mStack.push_back(previous);
+            mStack.push_back(v);
+        }
+        else {
+            // 같은 사슬 : 대각선이 다각형 안에 있는 동안 잇는다.
+            UINT last = mStack.back();
+            mStack.pop_back();
+            while (!mStack.empty())
+            {
+                float orient = Orient(Point(mStack.back()), Point(last), Point(v));
+                bool inside = mLeftChain[v] ? orient > 0.0f : orient < 0.0f;
+                if (!inside)
+                    break;
+                if (mLeftChain[v])
+                    AddTriangle(mStack.back(), last, v, triangles);
+                else
+                    AddTriangle(v, last, mStack.back(), triangles);
+                last = mStack.back();
+                mStack.pop_back();
+            }
+            mStack.push_back(last);
+            mStack.push_back(v);
+        }
+    }
+
+    UINT lowest = mSorted[numVertices - 1];
+    bool leftChain = mLeftChain[mStack.back()];
+    for (size_t k = 0; k + 1 < mStack.size(); k++)
+    {
+        if (leftChain)
+            AddTriangle(mStack[k], mStack[k + 1], lowest, triangles);
+        else
+            AddTriangle(lowest, mStack[k + 1], mStack[k], triangles);
+    }
+}
+
+void PolygonTriangulator::AddTriangle(UINT a, UINT b, UINT c, vector<UINT>& triangles)
+{
+    triangles.push_back(mLoopVertices[a]);
+    triangles.push_back(mLoopVertices[b]);
+    triangles.push_back(mLoopVertices[c]);
+}
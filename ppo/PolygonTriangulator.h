@@ -0,0 +1,99 @@
+#pragma once
+
+#include "d3dUtil.h"
+#include <vector>
+#include <array>
+#include <span>
+#include <cstdint>
+#include <set>
+#include <memory_resource>
+
+using namespace DirectX;
+using namespace std;
+
+// 구멍이 있는 평면 다각형 삼각분할
+// 스윕 라인으로 y 단조 다각형으로 나눈 뒤 (대각선 추가) 각 단조 다각형을 스택으로 삼각분할한다. O(n log n)
+// 스윕 상태는 균형 이진 트리(std::set)이므로 변 삽입/삭제/왼쪽 변 찾기가 O(log n)이다.
+// 외곽 루프는 반시계 방향, 구멍 루프는 시계 방향이어야 하며 루프끼리 교차하지 않아야 한다. (구멍 속의 섬도 외곽 루프)
+// 작업 버퍼는 멤버로 남겨 두고 다음 호출에서 다시 쓴다. (트리 노드도 멤버 풀에서 다시 쓴다.)
+class PolygonTriangulator
+{
+public:
+    PolygonTriangulator() = default;
+    // 스윕 상태의 비교 함수가 이 객체를 가리키므로 복사하지 않는다.
+    PolygonTriangulator(const PolygonTriangulator& rhs) = delete;
+    PolygonTriangulator& operator=(const PolygonTriangulator& rhs) = delete;
+
+    // loopVertices : 루프마다 points 인덱스를 순서대로 이어 붙인 배열, loopEnds : 각 루프가 끝나는 loopVertices 위치
+    // 삼각형(반시계)의 points 인덱스를 triangles 끝에 추가하고 추가한 삼각형 수를 반환한다.
+    int Triangulate(span<const XMFLOAT2> points, span<const UINT> loopVertices, span<const UINT> loopEnds, vector<UINT>& triangles);
+
+    size_t ScratchByteSize() const;
+
+private:
+    enum class VertexType : uint8_t { Start, End, Split, Merge, Regular };
+
+    const XMFLOAT2& Point(UINT vertex) const { return mPoints[mLoopVertices[vertex]]; }
+    // 스윕 순서 : y가 크고, 같으면 x가 작은 정점이 먼저
+    bool Above(UINT a, UINT b) const;
+
+    void MakeMonotone();
+    float EdgeXAt(UINT edge, float y) const;
+    // 정점 왼쪽에서 가장 가까운 상태의 변, 없으면 UINT_MAX
+    UINT FindLeftEdge(UINT vertex);
+    void InsertEdge(UINT edge, UINT vertex);
+    void RemoveEdge(UINT edge);
+    void AddDiagonal(UINT a, UINT b);
+
+    void BuildFaces();
+    UINT NextHalfEdge(UINT halfEdge) const;
+    void TriangulateMonotone(span<const UINT> face, vector<UINT>& triangles);
+    // 반시계 순서로 받은 정점을 points 인덱스로 바꿔 추가한다.
+    void AddTriangle(UINT a, UINT b, UINT c, vector<UINT>& triangles);
+
+    span<const XMFLOAT2> mPoints;
+    span<const UINT> mLoopVertices;
+
+    // 정점 = loopVertices 위치, 변 i = 정점 i -> mNext[i]
+    vector<UINT> mPrev;
+    vector<UINT> mNext;
+    vector<UINT> mOrder;        // 스윕 순서로 정렬한 정점
+    vector<UINT> mRank;         // 정점의 스윕 순서
+    vector<VertexType> mTypes;
+
+    // 스윕 상태의 변 순서 : 스윕 높이 mSweepY에서의 x, 같으면 아래로 내려가며 더 왼쪽인 변이 먼저
+    // x(float)로도 찾을 수 있다. (FindLeftEdge)
+    struct StatusLess
+    {
+        using is_transparent = void;
+        const PolygonTriangulator* owner = nullptr;
+
+        bool operator()(UINT a, UINT b) const;
+        bool operator()(float x, UINT edge) const { return x < owner->EdgeXAt(edge, owner->mSweepY); }
+        bool operator()(UINT edge, float x) const { return owner->EdgeXAt(edge, owner->mSweepY) < x; }
+    };
+    using StatusSet = std::pmr::set<UINT, StatusLess>;
+
+    // 스윕 상태 : 스윕 라인과 만나는 왼쪽 경계 변을 x 순서로 둔 트리, 변마다의 트리 위치와 helper 정점
+    // 트리 노드는 mStatusPool에서 받고 돌려주므로 두 번째 호출부터는 새로 할당하지 않는다.
+    float mSweepY = 0.0f;
+    std::pmr::unsynchronized_pool_resource mStatusPool;
+    StatusSet mStatus{ StatusLess{ this }, &mStatusPool };
+    vector<StatusSet::iterator> mStatusPositions;
+    vector<uint8_t> mInStatus;
+    size_t mMaxStatusSize = 0;
+    vector<UINT> mHelper;
+    vector<array<UINT, 2>> mDiagonals;
+
+    // 다각형 변 + 대각선 양방향의 half edge (시작 정점, 끝 정점), 정점마다 나가는 half edge 목록 (CSR)
+    vector<array<UINT, 2>> mHalfEdges;
+    vector<UINT> mOutgoingOffsets;
+    vector<UINT> mOutgoing;
+    vector<uint8_t> mVisited;
+    vector<UINT> mFace;
+
+    // 단조 다각형 삼각분할
+    vector<UINT> mSorted;
+    vector<uint8_t> mLeftChain;
+    vector<UINT> mStack;
+};
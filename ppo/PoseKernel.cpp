@@ -0,0 +1,276 @@
+#include "PoseKernel.h"
+#include <immintrin.h>
+#include <cassert>
+
+namespace
+{
+    // gPoseKernelWidth 폭의 float 벡터 연산
+    // 커널은 아래 함수만 사용하므로 SSE와 AVX2에서 같은 코드를 쓴다.
+#if defined(__AVX2__)
+    using FloatV = __m256;
+
+    inline FloatV Load(const float* p) { return _mm256_loadu_ps(p); }
+    inline void Store(float* p, FloatV v) { _mm256_storeu_ps(p, v); }
+    inline FloatV Set(float f) { return _mm256_set1_ps(f); }
+    inline FloatV Add(FloatV a, FloatV b) { return _mm256_add_ps(a, b); }
+    inline FloatV Sub(FloatV a, FloatV b) { return _mm256_sub_ps(a, b); }
+    inline FloatV Mul(FloatV a, FloatV b) { return _mm256_mul_ps(a, b); }
+    inline FloatV Div(FloatV a, FloatV b) { return _mm256_div_ps(a, b); }
+    inline FloatV Sqrt(FloatV a) { return _mm256_sqrt_ps(a); }
+    inline FloatV ReciprocalSqrtEst(FloatV a) { return _mm256_rsqrt_ps(a); }
+    inline FloatV Min(FloatV a, FloatV b) { return _mm256_min_ps(a, b); }
+    inline FloatV Max(FloatV a, FloatV b) { return _mm256_max_ps(a, b); }
+    inline FloatV And(FloatV a, FloatV b) { return _mm256_and_ps(a, b); }
+    inline FloatV AndNot(FloatV a, FloatV b) { return _mm256_andnot_ps(a, b); }
+    inline FloatV Xor(FloatV a, FloatV b) { return _mm256_xor_ps(a, b); }
+    inline FloatV GreaterOrEqual(FloatV a, FloatV b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    inline FloatV Select(FloatV a, FloatV b, FloatV mask) { return _mm256_blendv_ps(a, b, mask); }
+#else
+    using FloatV = __m128;
+
+    inline FloatV Load(const float* p) { return _mm_loadu_ps(p); }
+    inline void Store(float* p, FloatV v) { _mm_storeu_ps(p, v); }
+    inline FloatV Set(float f) { return _mm_set1_ps(f); }
+    inline FloatV Add(FloatV a, FloatV b) { return _mm_add_ps(a, b); }
+    inline FloatV Sub(FloatV a, FloatV b) { return _mm_sub_ps(a, b); }
+    inline FloatV Mul(FloatV a, FloatV b) { return _mm_mul_ps(a, b); }
+    inline FloatV Div(FloatV a, FloatV b) { return _mm_div_ps(a, b); }
+    inline FloatV Sqrt(FloatV a) { return _mm_sqrt_ps(a); }
+    inline FloatV ReciprocalSqrtEst(FloatV a) { return _mm_rsqrt_ps(a); }
+    inline FloatV Min(FloatV a, FloatV b) { return _mm_min_ps(a, b); }
+    inline FloatV Max(FloatV a, FloatV b) { return _mm_max_ps(a, b); }
+    inline FloatV And(FloatV a, FloatV b) { return _mm_and_ps(a, b); }
+    inline FloatV AndNot(FloatV a, FloatV b) { return _mm_andnot_ps(a, b); }
+    inline FloatV Xor(FloatV a, FloatV b) { return _mm_xor_ps(a, b); }
+    inline FloatV GreaterOrEqual(FloatV a, FloatV b) { return _mm_cmpge_ps(a, b); }
+    inline FloatV Select(FloatV a, FloatV b, FloatV mask) { return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b)); }   // mask ? b : a
+#endif
+
+    inline FloatV MulAdd(FloatV a, FloatV b, FloatV c) { return Add(Mul(a, b), c); }
+
+    // acos(x), x는 [0, 1] (XMScalarACos와 같은 7차 근사)
+    inline FloatV ACosPositive(FloatV x)
+    {
+        FloatV root = Sqrt(Max(Sub(Set(1.0f), x), Set(0.0f)));
+        FloatV result = Set(-0.0012624911f);
+        result = MulAdd(result, x, Set(0.0066700901f));
+        result = MulAdd(result, x, Set(-0.0170881256f));
+        result = MulAdd(result, x, Set(0.0308918810f));
+        result = MulAdd(result, x, Set(-0.0501743046f));
+        result = MulAdd(result, x, Set(0.0889789874f));
+        result = MulAdd(result, x, Set(-0.2145988016f));
+        result = MulAdd(result, x, Set(1.5707963050f));
+        return Mul(result, root);
+    }
+
+    // sin(x), x는 [-pi/2, pi/2] (XMScalarSin과 같은 11차 근사, 범위를 줄이는 과정은 생략)
+    inline FloatV SinHalfPi(FloatV x)
+    {
+        FloatV x2 = Mul(x, x);
+        FloatV result = Set(-2.3889859e-08f);
+        result = MulAdd(result, x2, Set(2.7525562e-06f));
+        result = MulAdd(result, x2, Set(-0.00019840874f));
+        result = MulAdd(result, x2, Set(0.0083333310f));
+        result = MulAdd(result, x2, Set(-0.16666667f));
+        result = MulAdd(result, x2, Set(1.0f));
+        return Mul(result, x);
+    }
+
+    void FillTail(vector<float>& stream, int count, int capacity, float value)
+    {
+        stream.resize(capacity);
+        for (int i = count; i < capacity; i++)
+            stream[i] = value;
+    }
+}
+
+void PoseBatch::Resize(int newCount)
+{
+    count = newCount;
+    int capacity = (count + gPoseKernelWidth - 1) / gPoseKernelWidth * gPoseKernelWidth;
+
+    // 남는 칸은 단위 변환으로 채워 계산 결과가 NaN이 되지 않게 한다.
+    for (int i = 0; i < 4; i++) {
+        FillTail(startRotation[i], count, capacity, (i == 3) ? 1.0f : 0.0f);
+        FillTail(endRotation[i], count, capacity, (i == 3) ? 1.0f : 0.0f);
+        FillTail(rotation[i], count, capacity, (i == 3) ? 1.0f : 0.0f);
+    }
+    for (int i = 0; i < 3; i++) {
+        FillTail(translation[i], count, capacity, 0.0f);
+        FillTail(scale[i], count, capacity, 1.0f);
+    }
+    FillTail(factor, count, capacity, 0.0f);
+    local.resize(capacity);
+}
+
+void PoseKernel::InterpolateRotations(PoseBatch& batch, RotationInterpolation mode)
+{
+    const FloatV signMask = Set(-0.0f);
+    const FloatV one = Set(1.0f);
+
+    for (int i = 0; i < batch.count; i += gPoseKernelWidth)
+    {
+        FloatV ax = Load(&batch.startRotation[0][i]);
+        FloatV ay = Load(&batch.startRotation[1][i]);
+        FloatV az = Load(&batch.startRotation[2][i]);
+        FloatV aw = Load(&batch.startRotation[3][i]);
+        FloatV bx = Load(&batch.endRotation[0][i]);
+        FloatV by = Load(&batch.endRotation[1][i]);
+        FloatV bz = Load(&batch.endRotation[2][i]);
+        FloatV bw = Load(&batch.endRotation[3][i]);
+        FloatV t = Load(&batch.factor[i]);
+
+        // 내적이 음수면 짧은 경로로 가도록 끝 쿼터니언의 부호를 뒤집는다.
+        FloatV cosOmega = MulAdd(ax, bx, MulAdd(ay, by, MulAdd(az, bz, Mul(aw, bw))));
+        FloatV sign = And(cosOmega, signMask);
+        cosOmega = Xor(cosOmega, sign);
+
+        FloatV s0, s1;
+        if (mode == RotationInterpolation::Slerp) {
+            // 거의 같은 방향이면 sin(omega)가 0에 가까우므로 선형 보간한다. (XMQuaternionSlerp와 같은 기준)
+            FloatV linear = GreaterOrEqual(cosOmega, Set(1.0f - 0.00001f));
+            FloatV omega = ACosPositive(Min(cosOmega, one));
+            FloatV invSinOmega = Div(one, Max(SinHalfPi(omega), Set(1e-30f)));
+
+            s0 = Mul(SinHalfPi(Mul(Sub(one, t), omega)), invSinOmega);
+            s1 = Mul(SinHalfPi(Mul(t, omega)), invSinOmega);
+            s0 = Select(s0, Sub(one, t), linear);
+            s1 = Select(s1, t, linear);
+        }
+        else {
+            // 각도에 따라 t를 보정해 nlerp의 속도 변화를 slerp에 가깝게 맞춘다.
+            // k = A(d) * (t - 0.5)^2 + B(d), t' = t + t(t - 0.5)(t - 1)k
+            FloatV d = cosOmega;
+            FloatV A = MulAdd(d, MulAdd(d, MulAdd(d, Set(-1.43519f), Set(3.55645f)), Set(-3.2452f)), Set(1.0904f));
+            FloatV B = MulAdd(d, MulAdd(d, Set(0.215638f), Set(-1.06021f)), Set(0.848013f));
+            FloatV centered = Sub(t, Set(0.5f));
+            FloatV k = MulAdd(Mul(A, centered), centered, B);
+            FloatV correctedT = MulAdd(Mul(Mul(t, centered), Sub(t, one)), k, t);
+
+            s0 = Sub(one, correctedT);
+            s1 = correctedT;
+        }
+        s1 = Xor(s1, sign);
+
+        FloatV x = MulAdd(ax, s0, Mul(bx, s1));
+        FloatV y = MulAdd(ay, s0, Mul(by, s1));
+        FloatV z = MulAdd(az, s0, Mul(bz, s1));
+        FloatV w = MulAdd(aw, s0, Mul(bw, s1));
+
+        if (mode == RotationInterpolation::Nlerp) {
+            // rsqrt 추정값에 뉴턴-랩슨 한 번 : r' = r * (1.5 - 0.5 * len2 * r * r)
+            FloatV lengthSq = MulAdd(x, x, MulAdd(y, y, MulAdd(z, z, Mul(w, w))));
+            FloatV r = ReciprocalSqrtEst(lengthSq);
+            r = Mul(r, Sub(Set(1.5f), Mul(Mul(Set(0.5f), lengthSq), Mul(r, r))));
+            x = Mul(x, r);
+            y = Mul(y, r);
+            z = Mul(z, r);
+            w = Mul(w, r);
+        }
+
+        Store(&batch.rotation[0][i], x);
+        Store(&batch.rotation[1][i], y);
+        Store(&batch.rotation[2][i], z);
+        Store(&batch.rotation[3][i], w);
+    }
+}
+
+void PoseKernel::ComposeAffine(PoseBatch& batch)
+{
+    const FloatV one = Set(1.0f);
+    const FloatV two = Set(2.0f);
+
+    for (int i = 0; i < batch.count; i += gPoseKernelWidth)
+    {
+        FloatV x = Load(&batch.rotation[0][i]);
+        FloatV y = Load(&batch.rotation[1][i]);
+        FloatV z = Load(&batch.rotation[2][i]);
+        FloatV w = Load(&batch.rotation[3][i]);
+        FloatV sx = Load(&batch.scale[0][i]);
+        FloatV sy = Load(&batch.scale[1][i]);
+        FloatV sz = Load(&batch.scale[2][i]);
+
+        FloatV x2 = Mul(x, two), y2 = Mul(y, two), z2 = Mul(z, two);
+        FloatV xx = Mul(x, x2), yy = Mul(y, y2), zz = Mul(z, z2);
+        FloatV xy = Mul(x, y2), xz = Mul(x, z2), yz = Mul(y, z2);
+        FloatV wx = Mul(w, x2), wy = Mul(w, y2), wz = Mul(w, z2);
+
+        // 행 벡터 행렬 S * R * T의 열 = 결과의 행
+        float columns[3][4][gPoseKernelWidth];
+        Store(columns[0][0], Mul(sx, Sub(one, Add(yy, zz))));
+        Store(columns[0][1], Mul(sy, Sub(xy, wz)));
+        Store(columns[0][2], Mul(sz, Add(xz, wy)));
+        Store(columns[1][0], Mul(sx, Add(xy, wz)));
+        Store(columns[1][1], Mul(sy, Sub(one, Add(xx, zz))));
+        Store(columns[1][2], Mul(sz, Sub(yz, wx)));
+        Store(columns[2][0], Mul(sx, Sub(xz, wy)));
+        Store(columns[2][1], Mul(sy, Add(yz, wx)));
+        Store(columns[2][2], Mul(sz, Sub(one, Add(xx, yy))));
+        for (int r = 0; r < 3; r++)
+            Store(columns[r][3], Load(&batch.translation[r][i]));
+
+        // SoA -> 뼈별 행렬
+        for (int lane = 0; lane < gPoseKernelWidth; lane++) {
+            AffineTransform3x4& out = batch.local[i + lane];
+            for (int r = 0; r < 3; r++)
+                for (int c = 0; c < 4; c++)
+                    out.m[r][c] = columns[r][c][lane];
+        }
+    }
+}
+
+void PoseKernel::BlendPoses(PoseBatch& dst, const PoseBatch& src, float weight, const float* jointWeights)
+{
+    assert(src.count >= dst.count);
+
+    const FloatV signMask = Set(-0.0f);
+    const FloatV one = Set(1.0f);
+
+    for (int i = 0; i < dst.count; i += gPoseKernelWidth)
+    {
+        FloatV w = Set(weight);
+        if (jointWeights != nullptr) {
+            // 마지막 묶음은 jointWeights 범위를 넘어 읽지 않도록 복사해서 쓴다.
+            float tail[gPoseKernelWidth] = { 0.0f };
+            const float* weights = jointWeights + i;
+            if (i + gPoseKernelWidth > dst.count) {
+                for (int lane = 0; lane < dst.count - i; lane++)
+                    tail[lane] = weights[lane];
+                weights = tail;
+            }
+            w = Mul(w, Load(weights));
+        }
+        FloatV invW = Sub(one, w);
+
+        for (int c = 0; c < 3; c++) {
+            Store(&dst.translation[c][i], MulAdd(Load(&dst.translation[c][i]), invW, Mul(Load(&src.translation[c][i]), w)));
+            Store(&dst.scale[c][i], MulAdd(Load(&dst.scale[c][i]), invW, Mul(Load(&src.scale[c][i]), w)));
+        }
+
+        FloatV ax = Load(&dst.rotation[0][i]);
+        FloatV ay = Load(&dst.rotation[1][i]);
+        FloatV az = Load(&dst.rotation[2][i]);
+        FloatV aw = Load(&dst.rotation[3][i]);
+        FloatV bx = Load(&src.rotation[0][i]);
+        FloatV by = Load(&src.rotation[1][i]);
+        FloatV bz = Load(&src.rotation[2][i]);
+        FloatV bw = Load(&src.rotation[3][i]);
+
+        FloatV sign = And(MulAdd(ax, bx, MulAdd(ay, by, MulAdd(az, bz, Mul(aw, bw)))), signMask);
+        FloatV s1 = Xor(w, sign);
+
+        FloatV x = MulAdd(ax, invW, Mul(bx, s1));
+        FloatV y = MulAdd(ay, invW, Mul(by, s1));
+        FloatV z = MulAdd(az, invW, Mul(bz, s1));
+        FloatV qw = MulAdd(aw, invW, Mul(bw, s1));
+
+        FloatV lengthSq = MulAdd(x, x, MulAdd(y, y, MulAdd(z, z, Mul(qw, qw))));
+        FloatV r = ReciprocalSqrtEst(lengthSq);
+        r = Mul(r, Sub(Set(1.5f), Mul(Mul(Set(0.5f), lengthSq), Mul(r, r))));
+
+        Store(&dst.rotation[0][i], Mul(x, r));
+        Store(&dst.rotation[1][i], Mul(y, r));
+        Store(&dst.rotation[2][i], Mul(z, r));
+        Store(&dst.rotation[3][i], Mul(qw, r));
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+// 한 번에 처리하는 뼈 수 (AVX2로 빌드하면 8, 아니면 SSE 4)
+#if defined(__AVX2__)
+constexpr int gPoseKernelWidth = 8;
+#else
+constexpr int gPoseKernelWidth = 4;
+#endif
+
+enum class RotationInterpolation
+{
+    Slerp,  // XMQuaternionSlerp와 같은 결과 (허용 오차 내)
+    Nlerp   // 보정된 nlerp, 더 빠르지만 오차가 조금 더 크다.
+};
+
+// 전치된 아핀 행렬의 위 3행 (셰이더로 보내는 뼈 행렬과 같은 배치)
+// m[i]는 행 벡터 기준 4x4 행렬의 i번째 열이다.
+struct AffineTransform3x4
+{
+    float m[3][4];
+};
+
+// 뼈 여러 개의 로컬 변환을 SoA로 모아 한 번에 보간/합성하기 위한 작업 버퍼
+// 모든 배열은 gPoseKernelWidth의 배수 길이를 가지며, 남는 칸은 단위 변환으로 채운다.
+struct PoseBatch
+{
+    void Resize(int count);
+    int Size() const { return count; }
+
+    int count = 0;
+
+    // 회전 보간 입력 : 두 키의 쿼터니언 (x, y, z, w)과 보간 비율
+    vector<float> startRotation[4];
+    vector<float> endRotation[4];
+    vector<float> factor;
+
+    // 보간 결과와 합성 입력
+    vector<float> rotation[4];
+    vector<float> translation[3];
+    vector<float> scale[3];
+
+    vector<AffineTransform3x4> local;
+};
+
+namespace PoseKernel
+{
+    // startRotation, endRotation, factor로 rotation을 채운다.
+    void InterpolateRotations(PoseBatch& batch, RotationInterpolation mode);
+
+    // scale * rotation * translation을 local에 쓴다. (XMMatrixAffineTransformation과 같은 행렬)
+    void ComposeAffine(PoseBatch& batch);
+
+    // dst의 로컬 포즈(rotation, translation, scale) 위에 src를 weight 비율로 섞는다.
+    // jointWeights가 있으면 칸마다 weight * jointWeights[i]를 사용한다. (길이는 dst.count 이상)
+    // 회전은 짧은 경로로 nlerp 한다.
+    void BlendPoses(PoseBatch& dst, const PoseBatch& src, float weight, const float* jointWeights = nullptr);
+}
@@ -0,0 +1,108 @@
+//***************************************************************************************
+// Terrain.hlsl
+// Draws terrain patches from the compact TerrainVertex (16-bit height + octahedral normal).
+// XZ and texture coordinates are rebuilt from the patch constants and SV_VertexID, so the
+// vertex buffer view must start at the patch and the draw must use BaseVertexLocation = 0.
+//***************************************************************************************
+
+// Defaults for number of lights.
+#ifndef NUM_DIR_LIGHTS
+    #define NUM_DIR_LIGHTS 3
+#endif
+
+#ifndef NUM_POINT_LIGHTS
+    #define NUM_POINT_LIGHTS 0
+#endif
+
+#ifndef NUM_SPOT_LIGHTS
+    #define NUM_SPOT_LIGHTS 0
+#endif
+
+#include "Common.hlsl"
+
+// Must match Terrain::PatchVertexCount.
+#define PATCH_VERTEX_COUNT 65
+#define PATCH_GRID_VERTICES (PATCH_VERTEX_COUNT * PATCH_VERTEX_COUNT)
+
+// Root constants, same layout as TerrainPatchConstants.
+cbuffer cbTerrainPatch : register(b3)
+{
+    float2 gPatchOrigin;
+    float gPatchMinHeight;
+    float gPatchHeightScale;
+    float2 gGridSpacing;
+    float2 gTexSpacing;
+    float2 gPatchTexOrigin;
+    uint gPatchLastColumn;
+    uint gPatchLastRow;
+    float gSkirtDepth;
+};
+
+struct VertexIn
+{
+    float Height   : HEIGHT;
+    float2 Normal  : NORMAL;
+    uint VertexID  : SV_VertexID;
+};
+
+struct VertexOut
+{
+    float4 PosH    : SV_POSITION;
+    float3 PosW    : POSITION;
+    float3 NormalW : NORMAL;
+    float2 TexC    : TEXCOORD;
+};
+
+// Octahedral normal with +y as the pole; the lower hemisphere is folded onto the outer triangles.
+float3 DecodeOctahedral(float2 e)
+{
+    float3 n = float3(e.x, 1.0f - abs(e.x) - abs(e.y), e.y);
+    if (n.y < 0.0f)
+    {
+        n.xz = (1.0f - abs(e.yx)) * (e >= 0.0f ? 1.0f : -1.0f);
+    }
+    return normalize(n);
+}
+
+VertexOut VS(VertexIn vin)
+{
+    VertexOut vout = (VertexOut)0.0f;
+
+    MaterialData matData = gMaterialData[gMaterialIndex];
+
+    // Grid vertices first, then the four skirts (top, bottom, left, right) of PATCH_VERTEX_COUNT each.
+    uint row, column;
+    float depth = 0.0f;
+    if (vin.VertexID < PATCH_GRID_VERTICES)
+    {
+        row = vin.VertexID / PATCH_VERTEX_COUNT;
+        column = vin.VertexID % PATCH_VERTEX_COUNT;
+    }
+    else
+    {
+        uint side = (vin.VertexID - PATCH_GRID_VERTICES) / PATCH_VERTEX_COUNT;
+        uint t = (vin.VertexID - PATCH_GRID_VERTICES) % PATCH_VERTEX_COUNT;
+        row = (side < 2) ? (side == 0 ? 0 : PATCH_VERTEX_COUNT - 1) : t;
+        column = (side < 2) ? t : (side == 2 ? 0 : PATCH_VERTEX_COUNT - 1);
+        depth = gSkirtDepth;
+    }
+    column = min(column, gPatchLastColumn);
+    row = min(row, gPatchLastRow);
+
+    // HEIGHT is R16_UNORM, so the quantized value arrives divided by 65535.
+    float3 posL;
+    posL.x = gPatchOrigin.x + column * gGridSpacing.x;
+    posL.y = gPatchMinHeight + vin.Height * 65535.0f * gPatchHeightScale - depth;
+    posL.z = gPatchOrigin.y + row * gGridSpacing.y;
+    float2 texC = gPatchTexOrigin + float2(column, row) * gTexSpacing;
+
+    float4 posW = mul(float4(posL, 1.0f), gWorld);
+    vout.PosW = posW.xyz;
+    vout.NormalW = mul(DecodeOctahedral(vin.Normal), (float3x3)gWorld);
+    vout.PosH = mul(posW, gViewProj);
+
+    float4 tex = mul(float4(texC, 0.0f, 1.0f), gTexTransform);
+    vout.TexC = mul(tex, matData.MatTransform).xy;
+
+    return vout;
+}
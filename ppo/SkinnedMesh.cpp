@@ -1,5 +1,62 @@
 #include "SkinnedMesh.h"
 
+XMVECTOR BoneAnimation::SampleTranslation(float animationTime, int& cursor) const
+{
+    // 보간을 위해선 적어도 2개의 값이 필요하다.
+    if (translation.size() == 1)
+        return XMLoadFloat3(&translation[0].value);
+
+    int index = FindKeyframeIndex(translation, animationTime, cursor);
+    const Keyframe<XMFLOAT3>& start = translation[index];
+    const Keyframe<XMFLOAT3>& end = translation[index + 1];
+    float factor = MathHelper::Clamp((animationTime - start.timePos) / (end.timePos - start.timePos), 0.0f, 1.0f);
+
+    return XMVectorLerp(XMLoadFloat3(&start.value), XMLoadFloat3(&end.value), factor);
+}
+
+XMVECTOR BoneAnimation::SampleScale(float animationTime, int& cursor) const
+{
+    if (scale.size() == 1)
+        return XMLoadFloat3(&scale[0].value);
+
+    int index = FindKeyframeIndex(scale, animationTime, cursor);
+    const Keyframe<XMFLOAT3>& start = scale[index];
+    const Keyframe<XMFLOAT3>& end = scale[index + 1];
+    float factor = MathHelper::Clamp((animationTime - start.timePos) / (end.timePos - start.timePos), 0.0f, 1.0f);
+
+    return XMVectorLerp(XMLoadFloat3(&start.value), XMLoadFloat3(&end.value), factor);
+}
+
+XMVECTOR BoneAnimation::SampleRotation(float animationTime, int& cursor) const
+{
+    if (rotationQuat.size() == 1)
+        return XMLoadFloat4(&rotationQuat[0].value);
+
+    int index = FindKeyframeIndex(rotationQuat, animationTime, cursor);
+    const Keyframe<XMFLOAT4>& start = rotationQuat[index];
+    const Keyframe<XMFLOAT4>& end = rotationQuat[index + 1];
+    float factor = MathHelper::Clamp((animationTime - start.timePos) / (end.timePos - start.timePos), 0.0f, 1.0f);
+
+    return XMQuaternionSlerp(XMLoadFloat4(&start.value), XMLoadFloat4(&end.value), factor);
+}
+
+void BoneAnimation::SampleRotationKeys(float animationTime, int& cursor, XMVECTOR& start, XMVECTOR& end, float& factor) const
+{
+    if (rotationQuat.size() == 1) {
+        start = end = XMLoadFloat4(&rotationQuat[0].value);
+        factor = 0.0f;
+        return;
+    }
+
+    int index = FindKeyframeIndex(rotationQuat, animationTime, cursor);
+    const Keyframe<XMFLOAT4>& startKey = rotationQuat[index];
+    const Keyframe<XMFLOAT4>& endKey = rotationQuat[index + 1];
+    factor = MathHelper::Clamp((animationTime - startKey.timePos) / (endKey.timePos - startKey.timePos), 0.0f, 1.0f);
+
+    start = XMLoadFloat4(&startKey.value);
+    end = XMLoadFloat4(&endKey.value);
+}
+
 SkinnedMesh::~SkinnedMesh()
 {
     Clear();
@@ -10,19 +67,19 @@ bool SkinnedMesh::LoadMesh(const std::string& Filename)
     Clear();
 
     /*
-        aiProcess_JoinIdenticalVertices |        //   , ε ȭ
-        aiProcess_ValidateDataStructure |        // δ  
-        aiProcess_ImproveCacheLocality |        //   ĳġ 
-        aiProcess_RemoveRedundantMaterials |    // ߺ ͸ 
-        aiProcess_GenUVCoords |                    // , ,      UV ȯ
-        aiProcess_TransformUVCoords |            // UV ȯ ó (ϸ, ȯ...)
-        aiProcess_FindInstances |                // νϽ Ž ˻Ͽ ϳ Ϳ   
-        aiProcess_LimitBoneWeights |            //   ġ ִ 4 
-        aiProcess_OptimizeMeshes |                //    Ž 
-        aiProcess_GenSmoothNormals |            // ε巯 븻() 
-        aiProcess_SplitLargeMeshes |            // Ŵ ϳ Ž Ž Ȱ()
-        aiProcess_Triangulate |                    // 3 ̻ 𼭸  ٰ  ﰢ 
-        aiProcess_ConvertToLeftHanded |            // D3D ޼ǥ ȯ
+        aiProcess_JoinIdenticalVertices |        // 동일한 꼭지점 결합, 인덱싱 최적화
+        aiProcess_ValidateDataStructure |        // 로더의 출력을 검증
+        aiProcess_ImproveCacheLocality |        // 출력 정점의 캐쉬위치를 개선
+        aiProcess_RemoveRedundantMaterials |    // 중복된 매터리얼 제거
+        aiProcess_GenUVCoords |                    // 구형, 원통형, 상자 및 평면 매핑을 적절한 UV로 변환
+        aiProcess_TransformUVCoords |            // UV 변환 처리기 (스케일링, 변환...)
+        aiProcess_FindInstances |                // 인스턴스된 매쉬를 검색하여 하나의 마스터에 대한 참조로 제거
+        aiProcess_LimitBoneWeights |            // 정점당 뼈의 가중치를 최대 4개로 제한
+        aiProcess_OptimizeMeshes |                // 가능한 경우 작은 매쉬를 조인
+        aiProcess_GenSmoothNormals |            // 부드러운 노말벡터(법선벡터) 생성
+        aiProcess_SplitLargeMeshes |            // 거대한 하나의 매쉬를 하위매쉬들로 분활(나눔)
+        aiProcess_Triangulate |                    // 3개 이상의 모서리를 가진 다각형 면을 삼각형으로 나눔
+        aiProcess_ConvertToLeftHanded |            // D3D의 왼손좌표계로 변환
     */
     Assimp::Importer importer;
     const aiScene* pScene = importer.ReadFile(Filename.c_str(),
@@ -71,15 +128,62 @@ bool SkinnedMesh::LoadAnimations(const std::string& Filename)
 void SkinnedMesh::SetOffsetMatrix(XMFLOAT3 axis1, float degree1, XMFLOAT3 axis2, float degree2)
 {
     XMStoreFloat4x4(&mOffsetMatrix, XMMatrixRotationAxis(XMLoadFloat3(&axis1), XMConvertToRadians(degree1)) * XMMatrixRotationAxis(XMLoadFloat3(&axis2), XMConvertToRadians(degree2)));
+    ClearPoseCache();
+}
+
+void SkinnedMesh::SetAnimationCompression(bool enable, bool keepSource, const AnimationCompressionSettings& settings)
+{
+    mCompressAnimations = enable;
+    mKeepSourceAnimations = keepSource;
+    mCompressionSettings = settings;
 }
 
 void SkinnedMesh::GetBoneTransforms(float timeInSeconds, vector<XMFLOAT4X4>& transforms, int animationIndex)
+{
+    GetBoneTransforms(timeInSeconds, transforms, animationIndex, mPoseState);
+}
+
+void SkinnedMesh::GetBoneTransforms(float timeInSeconds, vector<XMFLOAT4X4>& transforms, int animationIndex, PoseState& state) const
 {
     if (mAnimations.empty())
         return;
 
-    XMMATRIX Identity = XMMatrixIdentity();
-    
+    transforms.resize(mBoneInfo.size());
+    EvaluatePose(timeInSeconds, animationIndex, state, transforms.data());
+}
+
+void SkinnedMesh::EvaluatePose(float timeInSeconds, int animationIndex, PoseState& state, XMFLOAT4X4* boneTransforms) const
+{
+    if (mAnimations.empty())
+        return;
+
+    const AnimationClip& clip = mAnimations[animationIndex];
+
+    float animationTimeTicks = ClipTicks(clip, timeInSeconds);
+
+    // 다른 클립의 커서가 남아 있어도 Sample*에서 구간을 다시 찾으므로 크기만 맞춘다.
+    if (state.cursors.size() < clip.channels.size())
+        state.cursors.resize(clip.channels.size());
+    if (state.jointTransforms.size() < mJoints.size())
+        state.jointTransforms.resize(mJoints.size());
+
+    if (mPoseEvaluation == PoseEvaluation::Scalar)
+        EvaluateClip(animationTimeTicks, clip, state, boneTransforms);
+    else
+        EvaluateClipBatched(animationTimeTicks, clip, state, boneTransforms);
+}
+
+void SkinnedMesh::GetBoneTransformsLegacy(float timeInSeconds, vector<XMFLOAT4X4>& transforms, int animationIndex)
+{
+    if (mAnimations.empty())
+        return;
+
+    // 원본 키프레임을 버린 압축 클립은 이름 기반 경로로 평가할 수 없다.
+    if (!mAnimations[animationIndex].hasSourceKeyframes) {
+        GetBoneTransforms(timeInSeconds, transforms, animationIndex);
+        return;
+    }
+
     float ticksPerSecond = mAnimations[animationIndex].tickPerSecond;
     float timeInTicks = timeInSeconds * ticksPerSecond;
     float animationTimeTicks = fmod(timeInTicks, mAnimations[animationIndex].duration);
@@ -87,8 +191,6 @@ void SkinnedMesh::GetBoneTransforms(float timeInSeconds, vector<XMFLOAT4X4>& tra
     ReadBoneHierarchy(animationTimeTicks, rootNodeName, animationIndex, XMLoadFloat4x4(&mOffsetMatrix));
     transforms.resize(mBoneInfo.size());
 
-    //mBoneInfo[GetBoneId("root")].FinalTransformation = Matrix4x4::Identity();
-
     for (int i = 0; i < mBoneInfo.size(); i++) {
         transforms[i] = mBoneInfo[i].FinalTransformation;
     }
@@ -96,26 +198,36 @@ void SkinnedMesh::GetBoneTransforms(float timeInSeconds, vector<XMFLOAT4X4>& tra
 
 void SkinnedMesh::CreateBlob(const vector<SkinnedVertex>& vertices, const vector<UINT>& indices)
 {
-    const UINT vbByteSize = (UINT)vertices.size() * sizeof(SkinnedVertex);
-    const UINT ibByteSize = (UINT)indices.size() * sizeof(UINT);
+    CreateBlob(vertices.data(), (UINT)vertices.size(), indices.data(), (UINT)indices.size());
+}
+
+void SkinnedMesh::CreateBlob(const SkinnedVertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices)
+{
+    const UINT vbByteSize = numVertices * sizeof(SkinnedVertex);
+    const UINT ibByteSize = numIndices * sizeof(UINT);
 
     ThrowIfFailed(D3DCreateBlob(vbByteSize, &mVertexBufferCPU));
-    CopyMemory(mVertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
+    CopyMemory(mVertexBufferCPU->GetBufferPointer(), vertices, vbByteSize);
 
     ThrowIfFailed(D3DCreateBlob(ibByteSize, &mIndexBufferCPU));
-    CopyMemory(mIndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
+    CopyMemory(mIndexBufferCPU->GetBufferPointer(), indices, ibByteSize);
 }
 
-void SkinnedMesh::UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList, vector<SkinnedVertex> vertices, vector<UINT> indices)
+void SkinnedMesh::UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList, const vector<SkinnedVertex>& vertices, const vector<UINT>& indices)
 {
-    const UINT vbByteSize = (UINT)vertices.size() * sizeof(SkinnedVertex);
-    const UINT ibByteSize = (UINT)indices.size() * sizeof(UINT);
+    UploadBuffer(d3dDevice, commandList, vertices.data(), (UINT)vertices.size(), indices.data(), (UINT)indices.size());
+}
+
+void SkinnedMesh::UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList, const SkinnedVertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices)
+{
+    const UINT vbByteSize = numVertices * sizeof(SkinnedVertex);
+    const UINT ibByteSize = numIndices * sizeof(UINT);
 
     mVertexBufferGPU = d3dUtil::CreateDefaultBuffer(d3dDevice, commandList,
-        vertices.data(), vbByteSize, mVertexBufferUploader);
+        vertices, vbByteSize, mVertexBufferUploader);
 
     mIndexBufferGPU = d3dUtil::CreateDefaultBuffer(d3dDevice, commandList,
-        indices.data(), ibByteSize, mIndexBufferUploader);
+        indices, ibByteSize, mIndexBufferUploader);
 
     mVertexByteStride = sizeof(SkinnedVertex);
     mVertexBufferByteSize = vbByteSize;
@@ -135,7 +247,7 @@ bool SkinnedMesh::InitFromScene(const aiScene* pScene, const std::string& Filena
 
     rootNodeName = pScene->mRootNode->mName.C_Str();
 
-    //   ε  ϱ
+    // 모든 정점과 인덱스 개수 구하기
     unsigned int NumVertices = 0;
     unsigned int NumIndices = 0;
     
@@ -171,6 +283,11 @@ bool SkinnedMesh::InitFromScene(const aiScene* pScene, const std::string& Filena
     mBoneHierarchy.resize(NumBones());
     LoadBoneHierarchy(pScene->mRootNode);
 
+    // 메쉬보다 먼저 로드된 애니메이션이 있다면 채널을 다시 연결한다.
+    BuildSkeleton();
+    for (AnimationClip& clip : mAnimations)
+        ResolveChannels(clip);
+
     if (!InitMaterials(pScene, Filename)) {
         return false;
     }
@@ -214,7 +331,7 @@ void SkinnedMesh::InitAllAnimations(const aiScene* pScene)
             BoneAnimation boneAnimation;
             string boneName = pChannel->mNodeName.C_Str();
 
-            // PositionKeyframe ä
+            // PositionKeyframe 채우기
             int numPositionKeys = pChannel->mNumPositionKeys;
             boneAnimation.translation.resize(numPositionKeys);
             for (int k = 0; k < numPositionKeys; k++)
@@ -233,7 +350,7 @@ void SkinnedMesh::InitAllAnimations(const aiScene* pScene)
                 boneAnimation.translation[k] = translation;
             }
 
-            // RotationKeyframe ä
+            // RotationKeyframe 채우기
             int numRotationKeys = pChannel->mNumRotationKeys;
             boneAnimation.rotationQuat.resize(numRotationKeys);
             for (int k = 0; k < numRotationKeys; k++)
@@ -252,7 +369,7 @@ void SkinnedMesh::InitAllAnimations(const aiScene* pScene)
                 boneAnimation.rotationQuat[k] = rotationQuat;
             }
 
-            // ScaleKeyframe ä
+            // ScaleKeyframe 채우기
             int numScaleKeys = pChannel->mNumScalingKeys;
             boneAnimation.scale.resize(numScaleKeys);
             for (int k = 0; k < numScaleKeys; k++)
@@ -264,16 +381,21 @@ void SkinnedMesh::InitAllAnimations(const aiScene* pScene)
                 boneAnimation.scale[k] = scale;
             }
 
-            animationClip.boneAnimations[boneName] = boneAnimation;
+            animationClip.channelIndexMap[boneName] = (int)animationClip.channels.size();
+            animationClip.channels.push_back(boneAnimation);
         }
 
+        if (mCompressAnimations)
+            CompressAnimation(animationClip);
+
+        ResolveChannels(animationClip);
         mAnimations.push_back(animationClip);
     }
 }
 
 void SkinnedMesh::InitSingleMesh(int MeshIndex, const aiMesh* paiMesh, int baseVertex, int baseIndex)
 {
-    //   ä
+    // 정점 정보 채우기
     int numVertices = paiMesh->mNumVertices;
     int numFace = paiMesh->mNumFaces;
 
@@ -295,7 +417,7 @@ void SkinnedMesh::InitSingleMesh(int MeshIndex, const aiMesh* paiMesh, int baseV
 
     LoadMeshBones(MeshIndex, paiMesh);
 
-    // ε  ä
+    // 인덱스 정보 채우기
     for (UINT i = 0; i < numFace; i++)
     {
         UINT base = baseIndex + 3 * i;
@@ -468,7 +590,7 @@ int SkinnedMesh::GetBoneId(const aiBone* pBone)
     string boneName(pBone->mName.C_Str());
 
     if (mBoneNameToIndexMap.find(boneName) == mBoneNameToIndexMap.end()) {
-        // ο  
+        // 새로운 뼈 저장
         boneIndex = (int)mBoneNameToIndexMap.size();
         mBoneNameToIndexMap[boneName] = boneIndex;
     }
@@ -501,7 +623,7 @@ int SkinnedMesh::GetNodeId(const string nodeName)
 
 void SkinnedMesh::CalcInterpolatedScaling(aiVector3D& Out, float AnimationTime, const aiNodeAnim* pNodeAnim)
 {
-    //  ؼ  2  ʿϴ.
+    // 보간을 위해선 적어도 2개의 값이 필요하다.
     if (pNodeAnim->mNumScalingKeys == 1) {
         Out = pNodeAnim->mScalingKeys[0].mValue;
         return;
@@ -565,9 +687,9 @@ void SkinnedMesh::CalcInterpolatedPosition(aiVector3D& Out, float AnimationTime,
     Out = Start + Factor * Delta;
 }
 
-XMVECTOR SkinnedMesh::CalcInterpolatedScaling(const float AnimationTime, const BoneAnimation boneAnimation)
+XMVECTOR SkinnedMesh::CalcInterpolatedScaling(const float AnimationTime, const BoneAnimation& boneAnimation)
 {
-    //  ؼ  2  ʿϴ.
+    // 보간을 위해선 적어도 2개의 값이 필요하다.
     if (boneAnimation.scale.size() == 1) {
         return XMLoadFloat3(&boneAnimation.scale[0].value);
     }
@@ -589,9 +711,9 @@ XMVECTOR SkinnedMesh::CalcInterpolatedScaling(const float AnimationTime, const B
     return (start + (delta * Factor));
 }
 
-XMVECTOR SkinnedMesh::CalcInterpolatedRotation(const float AnimationTime, const BoneAnimation boneAnimation)
+XMVECTOR SkinnedMesh::CalcInterpolatedRotation(const float AnimationTime, const BoneAnimation& boneAnimation)
 {
-    //  ؼ  2  ʿϴ.
+    // 보간을 위해선 적어도 2개의 값이 필요하다.
     if (boneAnimation.rotationQuat.size() == 1) {
         return XMLoadFloat4(&boneAnimation.rotationQuat[0].value);
     }
@@ -617,14 +739,14 @@ XMVECTOR SkinnedMesh::CalcInterpolatedRotation(const float AnimationTime, const
     return rotationQuat;
 }
 
-XMVECTOR SkinnedMesh::CalcInterpolatedPosition(const float AnimationTime, const BoneAnimation boneAnimation)
+XMVECTOR SkinnedMesh::CalcInterpolatedPosition(const float AnimationTime, const BoneAnimation& boneAnimation)
 {
-    //  ؼ  2  ʿϴ.
+    // 보간을 위해선 적어도 2개의 값이 필요하다.
     if (boneAnimation.translation.size() == 1) {
         return XMLoadFloat3(&boneAnimation.translation[0].value);
     }
 
-    int translationIndex = FindScaleIndex(AnimationTime, boneAnimation);
+    int translationIndex = FindPositionIndex(AnimationTime, boneAnimation);
     int nextTranslationIndex = translationIndex + 1;
     assert(nextTranslationIndex < boneAnimation.translation.size());
 
@@ -655,7 +777,7 @@ int SkinnedMesh::FindScaling(float AnimationTime, const aiNodeAnim* pNodeAnim)
     return 0;
 }
 
-int SkinnedMesh::FindScaleIndex(float animationTime, BoneAnimation boneAnimation)
+int SkinnedMesh::FindScaleIndex(float animationTime, const BoneAnimation& boneAnimation)
 {
     int numScaleKeyframes = boneAnimation.scale.size();
     assert(numScaleKeyframes > 0);
@@ -684,7 +806,7 @@ int SkinnedMesh::FindRotation(float AnimationTime, const aiNodeAnim* pNodeAnim)
     return 0;
 }
 
-int SkinnedMesh::FindRotationIndex(float animationTime, BoneAnimation boneAnimation)
+int SkinnedMesh::FindRotationIndex(float animationTime, const BoneAnimation& boneAnimation)
 {
     int numRotationKeyframes = boneAnimation.rotationQuat.size();
     assert(numRotationKeyframes > 0);
@@ -711,7 +833,7 @@ int SkinnedMesh::FindPosition(float AnimationTime, const aiNodeAnim* pNodeAnim)
     return 0;
 }
 
-int SkinnedMesh::FindPositionIndex(float animationTime, BoneAnimation boneAnimation)
+int SkinnedMesh::FindPositionIndex(float animationTime, const BoneAnimation& boneAnimation)
 {
     int numPositionKeyframes = boneAnimation.translation.size();
     assert(numPositionKeyframes > 0);
@@ -743,14 +865,14 @@ void SkinnedMesh::LoadNodeHierarchy(const aiNode* pNode)
 {
     string nodeName(pNode->mName.data);
     vector<string> children;
-    // bone ִ  
+    // bone이 있는 노드면 저장
     for (int i = 0; i < pNode->mNumChildren; i++)
     {
         children.push_back(pNode->mChildren[i]->mName.C_Str());
     }
     mNodeNameToIndexMap[nodeName] = mNodeHierarchy.size();
     mNodeHierarchy.push_back(make_pair(nodeName, children));
-    //  ڽ 忡   ȣ
+    // 모든 자식 노드에 대해 재귀 호출
     for (int i = 0; i < pNode->mNumChildren; i++) {
         LoadNodeHierarchy(pNode->mChildren[i]);
     }
@@ -760,14 +882,14 @@ void SkinnedMesh::LoadBoneHierarchy(const aiNode* pNode)
 {
     string nodeName(pNode->mName.data);
 
-    // bone ִ  
+    // bone이 있는 노드면 저장
     if (mBoneNameToIndexMap.find(nodeName) != mBoneNameToIndexMap.end()) {
         vector<int> children;
         LoadChildren(children, pNode);
         mBoneHierarchy[GetBoneId(nodeName)] = make_pair(nodeName, children);
     }
 
-    //  ڽ 忡   ȣ
+    // 모든 자식 노드에 대해 재귀 호출
     for (int i = 0; i < pNode->mNumChildren; i++) {
         LoadBoneHierarchy(pNode->mChildren[i]);
     }
@@ -778,10 +900,10 @@ void SkinnedMesh::LoadChildren(vector<int>& children, const aiNode* pNode)
     for (int i = 0; i < pNode->mNumChildren; i++)
     {
         string childName = pNode->mChildren[i]->mName.C_Str();
-        // ڽ 尡 Bone ϰ ڽ 
+        // 자식 노드가 Bone 노드일경우 자식으로 저장
         if (mBoneNameToIndexMap.find(childName) != mBoneNameToIndexMap.end())
             children.push_back(GetBoneId(childName));
-        // ڽ 尡 Bone 尡 ƴ   Ž
+        // 자식 노드가 Bone 노드가 아닐 경우 계속 탐색
         else {
             LoadChildren(children, pNode->mChildren[i]);
         }
@@ -801,9 +923,9 @@ void SkinnedMesh::ReadNodeHierarchy(float AnimationTimeTicks, const aiNode* pNod
 
     const aiNodeAnim* pNodeAnim = FindNodeAnim(pAnimation, NodeName);
 
-    // ִϸ̼  ִٸ
+    // 애니메이션 정보가 있다면
     if (pNodeAnim) {
-        // ִϸ̼ ð ̿ ȯ Ѵ
+        // 애니매이션 시간을 이용해 변환을 보간한다
         aiVector3D Scaling;
         CalcInterpolatedScaling(Scaling, AnimationTimeTicks, pNodeAnim);
         XMMATRIX ScalingM = DirectX::XMMatrixScaling(Scaling.x, Scaling.y, Scaling.z);
@@ -823,14 +945,14 @@ void SkinnedMesh::ReadNodeHierarchy(float AnimationTimeTicks, const aiNode* pNod
 
     XMMATRIX GlobalTransformation = NodeTransformation * ParentTransform;
 
-    // bone ִ 忡 ؼ bone Transform 
+    // bone이 있는 노드에 대해서만 bone Transform을 저장
     if (mBoneNameToIndexMap.find(NodeName) != mBoneNameToIndexMap.end()) {
         int BoneIndex = mBoneNameToIndexMap[NodeName];
         XMMATRIX finalTransformation = XMLoadFloat4x4(&mBoneInfo[BoneIndex].OffsetMatrix) * GlobalTransformation * XMLoadFloat4x4(&m_GlobalInverseTransform);
         XMStoreFloat4x4(&mBoneInfo[BoneIndex].FinalTransformation, XMMatrixTranspose(finalTransformation));
     }
 
-    //  ڽ 忡   ȣ
+    // 모든 자식 노드에 대해 재귀 호출
     for (int i = 0; i < pNode->mNumChildren; i++) {
         ReadNodeHierarchy(AnimationTimeTicks, pNode->mChildren[i], GlobalTransformation);
     }
@@ -839,13 +961,16 @@ void SkinnedMesh::ReadNodeHierarchy(float AnimationTimeTicks, const aiNode* pNod
 void SkinnedMesh::ReadBoneHierarchy(float AnimationTimeTicks, const int boneId, const int animationId, const XMMATRIX& ParentTransform)
 {
     string boneName = mBoneHierarchy[boneId].first;
-    BoneAnimation boneAnimation = mAnimations[animationId].boneAnimations[boneName];
+    const AnimationClip& clip = mAnimations[animationId];
+    auto channel = clip.channelIndexMap.find(boneName);
     
     XMMATRIX NodeTransformation = XMMatrixIdentity();
     XMMATRIX GlobalTransformation = XMMatrixIdentity();
 
-    if (boneId == GetBoneId(boneName)) {
-        // ִϸ̼ ð ̿ ȯ Ѵ
+    if (channel != clip.channelIndexMap.end()) {
+        BoneAnimation boneAnimation = clip.channels[channel->second];
+
+        // 애니매이션 시간을 이용해 변환을 보간한다
         XMVECTOR scaling = CalcInterpolatedScaling(AnimationTimeTicks, boneAnimation);
         XMVECTOR rotationQuat = CalcInterpolatedRotation(AnimationTimeTicks, boneAnimation);
         XMVECTOR translation = CalcInterpolatedPosition(AnimationTimeTicks, boneAnimation);
@@ -867,7 +992,7 @@ void SkinnedMesh::ReadBoneHierarchy(float AnimationTimeTicks, const int boneId,
         XMStoreFloat4x4(&mBoneInfo[BoneIndex].FinalTransformation, XMMatrixTranspose(finalTransformation));
     }
 
-    //  ڽ 忡   ȣ
+    // 모든 자식 노드에 대해 재귀 호출
     int numChildren = mBoneHierarchy[boneId].second.size();
     for (int i = 0; i < numChildren; i++) {
         ReadBoneHierarchy(AnimationTimeTicks, mBoneHierarchy[boneId].second[i], animationId, GlobalTransformation);
@@ -880,15 +1005,16 @@ void SkinnedMesh::ReadBoneHierarchy(float AnimationTimeTicks, const string name,
     int nodeId = GetNodeId(nodeName);
     int numChildren = mNodeHierarchy[nodeId].second.size();
 
-    // Ʈ    
+    // 루트 모션을 사용하지 않을 경우
     if (!mAnimations[animationId].enableRootMotion && nodeName == "root") {
         for (int i = 0; i < numChildren; i++)
             ReadBoneHierarchy(AnimationTimeTicks, mNodeHierarchy[nodeId].second[i], animationId, ParentTransform);
         return;
     }
 
-    // ִϸ̼ǿ ϵ   
-    if (mAnimations[animationId].boneAnimations.find(nodeName) == mAnimations[animationId].boneAnimations.end()) {
+    // 애니메이션에 등록되지 않은 노드일 경우
+    auto channel = mAnimations[animationId].channelIndexMap.find(nodeName);
+    if (channel == mAnimations[animationId].channelIndexMap.end()) {
         for (int i = 0; i < numChildren; i++)
             ReadBoneHierarchy(AnimationTimeTicks, mNodeHierarchy[nodeId].second[i], animationId, ParentTransform);
         return;
@@ -897,9 +1023,9 @@ void SkinnedMesh::ReadBoneHierarchy(float AnimationTimeTicks, const string name,
     XMMATRIX GlobalTransformation = XMMatrixIdentity();
     XMMATRIX NodeTransformation = XMMatrixIdentity();
 
-    BoneAnimation boneAnimation = mAnimations[animationId].boneAnimations[nodeName];
+    BoneAnimation boneAnimation = mAnimations[animationId].channels[channel->second];
 
-    // ִϸ̼ ð ̿ ȯ Ѵ
+    // 애니매이션 시간을 이용해 변환을 보간한다
     XMVECTOR scaling = CalcInterpolatedScaling(AnimationTimeTicks, boneAnimation);
     XMVECTOR rotationQuat = CalcInterpolatedRotation(AnimationTimeTicks, boneAnimation);
     XMVECTOR translation = CalcInterpolatedPosition(AnimationTimeTicks, boneAnimation);
@@ -909,15 +1035,778 @@ void SkinnedMesh::ReadBoneHierarchy(float AnimationTimeTicks, const string name,
 
     GlobalTransformation = NodeTransformation * ParentTransform;
 
-    // node bone Ǿִٸ finalTransformation Ѵ.
+    // node가 bone에 저장되어있다면 finalTransformation을 저장한다.
     if (GetBoneId(nodeName) != -1) {
         int BoneIndex = mBoneNameToIndexMap[nodeName];
         XMMATRIX finalTransformation = XMLoadFloat4x4(&mBoneInfo[BoneIndex].OffsetMatrix) * GlobalTransformation;
         XMStoreFloat4x4(&mBoneInfo[BoneIndex].FinalTransformation, XMMatrixTranspose(finalTransformation));
     }
 
-    //  ڽ 忡   ȣ
+    // 모든 자식 노드에 대해 재귀 호출
     for (int i = 0; i < numChildren; i++) {
         ReadBoneHierarchy(AnimationTimeTicks, mNodeHierarchy[nodeId].second[i], animationId, GlobalTransformation);
     }
 }
+
+void SkinnedMesh::CompressAnimation(AnimationClip& clip)
+{
+    size_t sourceByteSize = CompressedClip::SourceByteSize(clip.channels);
+
+    clip.compressed.Compress(clip.channels, mCompressionSettings);
+    clip.isCompressed = true;
+
+    size_t compressedByteSize = clip.compressed.ByteSize();
+
+    char buf[512];
+    sprintf_s(buf, sizeof(buf), "[SkinnedMesh] %s : %zu -> %zu bytes (%.1f%% saved), tracks constant %d / quantized %d / raw %d, max error T %.5f S %.5f R %.5f rad\n",
+        clip.name.c_str(), sourceByteSize, compressedByteSize, 100.0 * (1.0 - (double)compressedByteSize / sourceByteSize),
+        clip.compressed.mNumTracks[(int)TrackFormat::Constant], clip.compressed.mNumTracks[(int)TrackFormat::Quantized], clip.compressed.mNumTracks[(int)TrackFormat::Raw],
+        clip.compressed.mMaxTranslationError, clip.compressed.mMaxScaleError, clip.compressed.mMaxRotationError);
+    OutputDebugStringA(buf);
+
+    // 채널 이름과 순서는 관절 연결에 필요하므로 키프레임만 비운다.
+    if (!mKeepSourceAnimations) {
+        for (BoneAnimation& boneAnimation : clip.channels)
+            boneAnimation = BoneAnimation();
+        clip.hasSourceKeyframes = false;
+    }
+}
+
+void SkinnedMesh::BuildSkeleton()
+{
+    // mNodeHierarchy는 전위 순회로 채워지므로 이미 부모가 자식보다 앞에 있다.
+    int numNodes = (int)mNodeHierarchy.size();
+    mJoints.assign(numNodes, SkeletonJoint());
+
+    for (int i = 0; i < numNodes; i++)
+    {
+        mJoints[i].boneIndex = GetBoneId(mNodeHierarchy[i].first);
+
+        for (const string& childName : mNodeHierarchy[i].second) {
+            int childIndex = GetNodeId(childName);
+            assert(childIndex > i);
+            mJoints[childIndex].parentIndex = i;
+        }
+    }
+}
+
+void SkinnedMesh::ResolveChannels(AnimationClip& clip)
+{
+    int numJoints = (int)mJoints.size();
+    clip.jointChannels.assign(numJoints, -1);
+
+    for (int i = 0; i < numJoints; i++)
+    {
+        const string& nodeName = mNodeHierarchy[i].first;
+
+        // 루트 모션을 사용하지 않을 경우 root 노드는 부모 변환을 그대로 전달한다.
+        if (!clip.enableRootMotion && nodeName == "root")
+            continue;
+
+        auto channel = clip.channelIndexMap.find(nodeName);
+        if (channel != clip.channelIndexMap.end())
+            clip.jointChannels[i] = channel->second;
+    }
+}
+
+void SkinnedMesh::EvaluateClip(float animationTimeTicks, const AnimationClip& clip, PoseState& state, XMFLOAT4X4* boneTransforms) const
+{
+    AnimationCursor* cursors = state.cursors.data();
+    XMFLOAT4X4* jointTransforms = state.jointTransforms.data();
+
+    XMMATRIX offsetMatrix = XMLoadFloat4x4(&mOffsetMatrix);
+
+    int numJoints = (int)mJoints.size();
+    for (int i = 0; i < numJoints; i++)
+    {
+        const SkeletonJoint& joint = mJoints[i];
+        XMMATRIX ParentTransform = (joint.parentIndex == -1) ? offsetMatrix : XMLoadFloat4x4(&jointTransforms[joint.parentIndex]);
+        XMMATRIX GlobalTransformation = ParentTransform;
+
+        // 채널이 없는 관절은 부모 변환을 그대로 전달한다.
+        int channelIndex = clip.jointChannels[i];
+        if (channelIndex != -1) {
+            AnimationCursor& cursor = cursors[channelIndex];
+            XMVECTOR scaling, rotationQuat, translation;
+
+            // 애니매이션 시간을 이용해 변환을 보간한다
+            if (clip.isCompressed) {
+                scaling = clip.compressed.SampleScale(channelIndex, animationTimeTicks, cursor.scale);
+                rotationQuat = clip.compressed.SampleRotation(channelIndex, animationTimeTicks, cursor.rotation);
+                translation = clip.compressed.SampleTranslation(channelIndex, animationTimeTicks, cursor.translation);
+            }
+            else {
+                const BoneAnimation& boneAnimation = clip.channels[channelIndex];
+                scaling = boneAnimation.SampleScale(animationTimeTicks, cursor.scale);
+                rotationQuat = boneAnimation.SampleRotation(animationTimeTicks, cursor.rotation);
+                translation = boneAnimation.SampleTranslation(animationTimeTicks, cursor.translation);
+            }
+
+            XMMATRIX NodeTransformation = XMMatrixAffineTransformation(scaling, XMQuaternionIdentity(), rotationQuat, translation);
+            GlobalTransformation = NodeTransformation * ParentTransform;
+        }
+
+        XMStoreFloat4x4(&jointTransforms[i], GlobalTransformation);
+
+        if (joint.boneIndex != -1) {
+            XMMATRIX finalTransformation = XMLoadFloat4x4(&mBoneInfo[joint.boneIndex].OffsetMatrix) * GlobalTransformation;
+            XMStoreFloat4x4(&boneTransforms[joint.boneIndex], XMMatrixTranspose(finalTransformation));
+        }
+    }
+}
+
+void SkinnedMesh::EvaluateClipBatched(float animationTimeTicks, const AnimationClip& clip, PoseState& state, XMFLOAT4X4* boneTransforms) const
+{
+    SampleLocalPose(animationTimeTicks, clip, state.cursors.data(), state.batch);
+    EvaluateHierarchy(state.batch, state, boneTransforms);
+}
+
+void SkinnedMesh::EvaluateBlendedPose(const AnimationLayer* layers, int numLayers, PoseState& state, XMFLOAT4X4* boneTransforms) const
+{
+    if (mAnimations.empty() || numLayers <= 0)
+        return;
+
+    assert(numLayers <= MAX_ANIMATION_LAYERS);
+
+    if (state.jointTransforms.size() < mJoints.size())
+        state.jointTransforms.resize(mJoints.size());
+
+    // 첫 레이어를 바탕으로 다음 레이어들을 차례로 섞는다. 모두 로컬 공간에서 섞은 뒤 계층을 한 번만 순회한다.
+    for (int i = 0; i < numLayers; i++)
+    {
+        const AnimationLayer& layer = layers[i];
+        if (i > 0 && layer.weight <= 0.0f)
+            continue;
+
+        const AnimationClip& clip = mAnimations[layer.clipIndex];
+        vector<AnimationCursor>& cursors = state.layerCursors[i];
+        if (cursors.size() < clip.channels.size())
+            cursors.resize(clip.channels.size());
+
+        PoseBatch& target = (i == 0) ? state.batch : state.blendBatch;
+        SampleLocalPose(ClipTicks(clip, layer.timePos), clip, cursors.data(), target);
+
+        if (i > 0)
+            PoseKernel::BlendPoses(state.batch, state.blendBatch, layer.weight, layer.jointWeights);
+    }
+
+    EvaluateHierarchy(state.batch, state, boneTransforms);
+}
+
+void SkinnedMesh::BuildJointMask(const string& nodeName, float weight, vector<float>& jointWeights) const
+{
+    int numJoints = (int)mJoints.size();
+    jointWeights.assign(numJoints, 0.0f);
+
+    auto node = mNodeNameToIndexMap.find(nodeName);
+    if (node == mNodeNameToIndexMap.end())
+        return;
+
+    // 관절 배열은 전위 순서이므로 부모가 하위 트리에 있으면 자식도 하위 트리에 있다.
+    int rootIndex = node->second;
+    vector<bool> inSubtree(numJoints, false);
+    inSubtree[rootIndex] = true;
+    jointWeights[rootIndex] = weight;
+    for (int i = rootIndex + 1; i < numJoints; i++) {
+        int parentIndex = mJoints[i].parentIndex;
+        if (parentIndex != -1 && inSubtree[parentIndex]) {
+            inSubtree[i] = true;
+            jointWeights[i] = weight;
+        }
+    }
+}
+
+float SkinnedMesh::ClipTicks(const AnimationClip& clip, float timeInSeconds) const
+{
+    float timeInTicks = timeInSeconds * clip.tickPerSecond;
+    return fmod(timeInTicks, clip.duration);
+}
+
+void SkinnedMesh::SampleLocalPose(float animationTimeTicks, const AnimationClip& clip, AnimationCursor* cursors, PoseBatch& batch) const
+{
+    // 관절 하나가 한 칸을 차지하고, 채널이 없는 관절은 단위 변환으로 두어 부모 변환을 그대로 전달한다.
+    int numJoints = (int)mJoints.size();
+    batch.Resize(numJoints);
+
+    for (int i = 0; i < numJoints; i++)
+    {
+        int channelIndex = clip.jointChannels[i];
+        if (channelIndex == -1) {
+            for (int c = 0; c < 4; c++)
+                batch.startRotation[c][i] = batch.endRotation[c][i] = (c == 3) ? 1.0f : 0.0f;
+            for (int c = 0; c < 3; c++) {
+                batch.scale[c][i] = 1.0f;
+                batch.translation[c][i] = 0.0f;
+            }
+            batch.factor[i] = 0.0f;
+            continue;
+        }
+
+        AnimationCursor& cursor = cursors[channelIndex];
+        XMVECTOR scaling, translation, startRotation, endRotation;
+        float factor;
+
+        if (clip.isCompressed) {
+            scaling = clip.compressed.SampleScale(channelIndex, animationTimeTicks, cursor.scale);
+            translation = clip.compressed.SampleTranslation(channelIndex, animationTimeTicks, cursor.translation);
+            clip.compressed.SampleRotationKeys(channelIndex, animationTimeTicks, cursor.rotation, startRotation, endRotation, factor);
+        }
+        else {
+            const BoneAnimation& boneAnimation = clip.channels[channelIndex];
+            scaling = boneAnimation.SampleScale(animationTimeTicks, cursor.scale);
+            translation = boneAnimation.SampleTranslation(animationTimeTicks, cursor.translation);
+            boneAnimation.SampleRotationKeys(animationTimeTicks, cursor.rotation, startRotation, endRotation, factor);
+        }
+
+        XMFLOAT4 start, end;
+        XMFLOAT3 s, t;
+        XMStoreFloat4(&start, startRotation);
+        XMStoreFloat4(&end, endRotation);
+        XMStoreFloat3(&s, scaling);
+        XMStoreFloat3(&t, translation);
+
+        batch.startRotation[0][i] = start.x; batch.startRotation[1][i] = start.y; batch.startRotation[2][i] = start.z; batch.startRotation[3][i] = start.w;
+        batch.endRotation[0][i] = end.x; batch.endRotation[1][i] = end.y; batch.endRotation[2][i] = end.z; batch.endRotation[3][i] = end.w;
+        batch.scale[0][i] = s.x; batch.scale[1][i] = s.y; batch.scale[2][i] = s.z;
+        batch.translation[0][i] = t.x; batch.translation[1][i] = t.y; batch.translation[2][i] = t.z;
+        batch.factor[i] = factor;
+    }
+
+    // 회전 보간은 gPoseKernelWidth개씩 처리한다.
+    PoseKernel::InterpolateRotations(batch, (mPoseEvaluation == PoseEvaluation::BatchedNlerp) ? RotationInterpolation::Nlerp : RotationInterpolation::Slerp);
+}
+
+void SkinnedMesh::EvaluateHierarchy(PoseBatch& batch, PoseState& state, XMFLOAT4X4* boneTransforms) const
+{
+    PoseKernel::ComposeAffine(batch);
+
+    XMFLOAT4X4* jointTransforms = state.jointTransforms.data();
+    XMMATRIX offsetMatrix = XMLoadFloat4x4(&mOffsetMatrix);
+
+    int numJoints = (int)mJoints.size();
+    for (int i = 0; i < numJoints; i++)
+    {
+        const SkeletonJoint& joint = mJoints[i];
+        XMMATRIX ParentTransform = (joint.parentIndex == -1) ? offsetMatrix : XMLoadFloat4x4(&jointTransforms[joint.parentIndex]);
+
+        const AffineTransform3x4& local = batch.local[i];
+        XMMATRIX transposed(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(local.m[0])),
+            XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(local.m[1])),
+            XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(local.m[2])),
+            g_XMIdentityR3);
+        XMMATRIX GlobalTransformation = XMMatrixTranspose(transposed) * ParentTransform;
+
+        XMStoreFloat4x4(&jointTransforms[i], GlobalTransformation);
+
+        if (joint.boneIndex != -1) {
+            XMMATRIX finalTransformation = XMLoadFloat4x4(&mBoneInfo[joint.boneIndex].OffsetMatrix) * GlobalTransformation;
+            XMStoreFloat4x4(&boneTransforms[joint.boneIndex], XMMatrixTranspose(finalTransformation));
+        }
+    }
+}
+
+void SkinnedMesh::EnablePoseCache(float sampleRate, size_t budgetBytes)
+{
+    ClearPoseCache();
+
+    mPoseCacheEnabled = true;
+    mBakeSampleRate = sampleRate;
+    mBakeBudget = budgetBytes;
+}
+
+void SkinnedMesh::DisablePoseCache()
+{
+    ClearPoseCache();
+    mPoseCacheEnabled = false;
+}
+
+void SkinnedMesh::ClearPoseCache()
+{
+    for (BakedClip& baked : mBakedClips)
+        baked.Clear();
+    mBakedBytes = 0;
+}
+
+bool SkinnedMesh::PreparePoseCache(int animationIndex)
+{
+    if (!mPoseCacheEnabled || animationIndex < 0 || animationIndex >= (int)mAnimations.size())
+        return false;
+
+    if (mBakedClips.size() < mAnimations.size())
+        mBakedClips.resize(mAnimations.size());
+
+    BakedClip& baked = mBakedClips[animationIndex];
+    if (baked.IsBaked()) {
+        baked.lastUse = ++mBakeUseCounter;
+        return true;
+    }
+
+    // 굽기 전에 크기를 확인해 예산보다 큰 클립은 실시간 계산에 맡긴다.
+    const AnimationClip& clip = mAnimations[animationIndex];
+    float durationSec = clip.duration / clip.tickPerSecond;
+    size_t numFrames = (size_t)(durationSec * mBakeSampleRate) + 2;
+    size_t byteSize = numFrames * NumBones() * sizeof(AffineTransform3x4);
+    if (byteSize > mBakeBudget)
+        return false;
+
+    // LRU : 예산 안에 들어올 때까지 가장 오래 사용하지 않은 클립을 버린다.
+    while (mBakedBytes + byteSize > mBakeBudget)
+    {
+        int oldest = -1;
+        for (int i = 0; i < (int)mBakedClips.size(); i++)
+            if (mBakedClips[i].IsBaked() && (oldest == -1 || mBakedClips[i].lastUse < mBakedClips[oldest].lastUse))
+                oldest = i;
+
+        mBakedBytes -= mBakedClips[oldest].ByteSize();
+        mBakedClips[oldest].Clear();
+    }
+
+    BakeClip(animationIndex, baked);
+    baked.lastUse = ++mBakeUseCounter;
+    mBakedBytes += baked.ByteSize();
+
+    return true;
+}
+
+bool SkinnedMesh::IsPoseBaked(int animationIndex) const
+{
+    return animationIndex >= 0 && animationIndex < (int)mBakedClips.size() && mBakedClips[animationIndex].IsBaked();
+}
+
+bool SkinnedMesh::SampleBakedPose(float timeInSeconds, int animationIndex, XMFLOAT4X4* boneTransforms) const
+{
+    if (!IsPoseBaked(animationIndex))
+        return false;
+
+    mBakedClips[animationIndex].Sample(timeInSeconds, boneTransforms);
+    return true;
+}
+
+void SkinnedMesh::BakeClip(int animationIndex, BakedClip& baked) const
+{
+    const AnimationClip& clip = mAnimations[animationIndex];
+
+    baked.sampleRate = mBakeSampleRate;
+    baked.durationSec = clip.duration / clip.tickPerSecond;
+    baked.numFrames = (int)(baked.durationSec * mBakeSampleRate) + 2;
+    baked.numBones = NumBones();
+    baked.frames.resize((size_t)baked.numFrames * baked.numBones);
+
+    // 마지막 프레임은 클립 길이를 넘을 수 있으며, 실시간 계산처럼 처음으로 돌아간 시간으로 계산된다.
+    PoseState state;
+    vector<XMFLOAT4X4> boneTransforms(baked.numBones);
+    for (int frame = 0; frame < baked.numFrames; frame++)
+    {
+        EvaluatePose(frame / mBakeSampleRate, animationIndex, state, boneTransforms.data());
+
+        AffineTransform3x4* out = &baked.frames[(size_t)frame * baked.numBones];
+        for (int i = 0; i < baked.numBones; i++)
+            memcpy(out[i].m, boneTransforms[i].m, sizeof(AffineTransform3x4));
+    }
+
+    char buf[256];
+    sprintf_s(buf, sizeof(buf), "[SkinnedMesh] baked %s : %d frames, %zu bytes\n", clip.name.c_str(), baked.numFrames, baked.ByteSize());
+    OutputDebugStringA(buf);
+}
+
+void SkinnedMesh::BuildSkinnedVertices(vector<SkinnedVertex>& vertices) const
+{
+    UINT numVertices = (UINT)mPositions.size();
+    vertices.resize(numVertices);
+
+    for (UINT i = 0; i < numVertices; i++)
+    {
+        SkinnedVertex& vertex = vertices[i];
+        vertex.Pos = mPositions[i];
+        vertex.Normal = mNormals[i];
+        vertex.TexC = mTexCoords[i];
+
+        const VertexBoneData& bones = mBones[i];
+        for (int j = 0; j < MAX_NUM_BONES_PER_VERTEX; j++)
+            vertex.BoneIndices[j] = (BYTE)bones.BoneIDs[j];
+
+        // 네 번째 가중치는 셰이더에서 1 - (x + y + z)로 구한다.
+        float weights = bones.Weights[0] + bones.Weights[1] + bones.Weights[2] + bones.Weights[3];
+        vertex.BoneWeights.x = bones.Weights[0] / weights;
+        vertex.BoneWeights.y = bones.Weights[1] / weights;
+        vertex.BoneWeights.z = bones.Weights[2] / weights;
+    }
+}
+
+static uint32_t CookedAnimationFlags(bool compress, bool keepSource)
+{
+    return (compress ? COOKED_ANIMATION_COMPRESSED : 0) | (compress && keepSource ? COOKED_ANIMATION_KEEP_SOURCE : 0);
+}
+
+// 압축하지 않으면 허용 오차는 쓰지 않으므로 0으로 둔다.
+static void GetCookedTolerances(bool compress, const AnimationCompressionSettings& settings, float tolerances[3])
+{
+    tolerances[0] = compress ? settings.translationTolerance : 0.0f;
+    tolerances[1] = compress ? settings.scaleTolerance : 0.0f;
+    tolerances[2] = compress ? settings.rotationTolerance : 0.0f;
+}
+
+template <typename T>
+static CookedSpan AppendCooked(vector<T>& dst, const vector<T>& src)
+{
+    CookedSpan span;
+    span.first = (uint32_t)dst.size();
+    span.count = (uint32_t)src.size();
+    dst.insert(dst.end(), src.begin(), src.end());
+    return span;
+}
+
+static bool IsValidSpan(const CookedSpan& span, const CookedRange& range)
+{
+    return (uint64_t)span.first + span.count <= range.count;
+}
+
+bool SkinnedMesh::SaveCooked(const string& filename, const vector<string>& sourceFiles, const vector<SkinnedVertex>& vertices) const
+{
+    CookedModelWriter writer;
+    CookedModelHeader header;
+    header.vertexStride = sizeof(SkinnedVertex);
+    header.animationFlags = CookedAnimationFlags(mCompressAnimations, mKeepSourceAnimations);
+    float tolerances[3];
+    GetCookedTolerances(mCompressAnimations, mCompressionSettings, tolerances);
+    header.translationTolerance = tolerances[0];
+    header.scaleTolerance = tolerances[1];
+    header.rotationTolerance = tolerances[2];
+    header.rootNodeName = writer.AddString(rootNodeName);
+
+    vector<CookedSource> sources;
+    for (const string& sourceFile : sourceFiles)
+    {
+        CookedSource source;
+        source.path = writer.AddString(sourceFile);
+        if (!GetCookedSourceStamp(sourceFile, source.lastWriteTime, source.fileSize))
+            return false;
+        sources.push_back(source);
+    }
+    header.sources = writer.Write(sources);
+
+    header.vertices = writer.Write(vertices);
+    header.indices = writer.Write(mIndices);
+    header.positions = writer.Write(mPositions);
+    header.normals = writer.Write(mNormals);
+    header.texCoords = writer.Write(mTexCoords);
+    header.vertexBones = writer.Write(mBones);
+
+    vector<CookedSubmesh> submeshes;
+    for (const Submesh& submesh : mSubmeshes)
+    {
+        CookedSubmesh cooked;
+        cooked.name = writer.AddString(submesh.name);
+        cooked.baseVertex = submesh.baseVertex;
+        cooked.baseIndex = submesh.baseIndex;
+        cooked.numIndices = submesh.numIndices;
+        cooked.materialIndex = submesh.materialIndex;
+        cooked.bounds = submesh.bounds;
+        submeshes.push_back(cooked);
+    }
+    header.submeshes = writer.Write(submeshes);
+
+    vector<CookedNode> nodes;
+    vector<CookedString> nodeChildren;
+    for (const auto& node : mNodeHierarchy)
+    {
+        CookedNode cooked;
+        cooked.name = writer.AddString(node.first);
+        cooked.children.first = (uint32_t)nodeChildren.size();
+        cooked.children.count = (uint32_t)node.second.size();
+        for (const string& childName : node.second)
+            nodeChildren.push_back(writer.AddString(childName));
+        nodes.push_back(cooked);
+    }
+    header.nodes = writer.Write(nodes);
+    header.nodeChildren = writer.Write(nodeChildren);
+
+    // 뼈 id 순서로 저장한다.
+    vector<CookedBone> bones(mBoneInfo.size());
+    vector<int> boneChildren;
+    for (const auto& bone : mBoneNameToIndexMap)
+        if (bone.second < (int)bones.size())
+            bones[bone.second].name = writer.AddString(bone.first);
+    for (int i = 0; i < (int)bones.size(); i++)
+    {
+        bones[i].offsetMatrix = mBoneInfo[i].OffsetMatrix;
+        if (i < (int)mBoneHierarchy.size()) {
+            bones[i].hierarchyName = writer.AddString(mBoneHierarchy[i].first);
+            bones[i].children = AppendCooked(boneChildren, mBoneHierarchy[i].second);
+        }
+    }
+    header.bones = writer.Write(bones);
+    header.boneChildren = writer.Write(boneChildren);
+
+    vector<CookedClip> clips;
+    vector<CookedChannel> channels;
+    vector<Keyframe<XMFLOAT3>> vectorKeys;
+    vector<Keyframe<XMFLOAT4>> rotationKeys;
+    vector<CompressedTrack> compressedTracks;
+    vector<float> compressedTimes;
+    vector<uint16_t> quantizedValues;
+    vector<float> rawValues;
+    for (const AnimationClip& clip : mAnimations)
+    {
+        CookedClip cooked;
+        cooked.name = writer.AddString(clip.name);
+        cooked.tickPerSecond = clip.tickPerSecond;
+        cooked.duration = clip.duration;
+        cooked.enableRootMotion = clip.enableRootMotion;
+        cooked.isCompressed = clip.isCompressed;
+        cooked.hasSourceKeyframes = clip.hasSourceKeyframes;
+
+        // channels는 channelIndexMap의 인덱스 순서이므로 이름을 인덱스 자리에 채운다.
+        cooked.channels.first = (uint32_t)channels.size();
+        cooked.channels.count = (uint32_t)clip.channels.size();
+        channels.resize(channels.size() + clip.channels.size());
+        for (const auto& channel : clip.channelIndexMap)
+            channels[cooked.channels.first + channel.second].nodeName = writer.AddString(channel.first);
+
+        for (int i = 0; i < (int)clip.channels.size(); i++)
+        {
+            CookedChannel& cookedChannel = channels[cooked.channels.first + i];
+            cookedChannel.translation = AppendCooked(vectorKeys, clip.channels[i].translation);
+            cookedChannel.scale = AppendCooked(vectorKeys, clip.channels[i].scale);
+            cookedChannel.rotation = AppendCooked(rotationKeys, clip.channels[i].rotationQuat);
+        }
+
+        if (clip.isCompressed)
+            clip.compressed.Save(cooked.compressed, compressedTracks, compressedTimes, quantizedValues, rawValues);
+
+        clips.push_back(cooked);
+    }
+    header.clips = writer.Write(clips);
+    header.channels = writer.Write(channels);
+    header.vectorKeys = writer.Write(vectorKeys);
+    header.rotationKeys = writer.Write(rotationKeys);
+    header.compressedTracks = writer.Write(compressedTracks);
+    header.compressedTimes = writer.Write(compressedTimes);
+    header.quantizedValues = writer.Write(quantizedValues);
+    header.rawValues = writer.Write(rawValues);
+
+    return writer.Save(filename, header);
+}
+
+bool SkinnedMesh::LoadCooked(const string& filename, const vector<string>& sourceFiles, CookedModelFile& file)
+{
+    if (!file.Open(filename))
+        return false;
+
+    const CookedModelHeader& header = file.Header();
+
+    // 형식과 설정 확인 (허용 오차가 바뀌면 클립을 다시 양자화해야 하므로 다시 쿡한다.)
+    float tolerances[3];
+    GetCookedTolerances(mCompressAnimations, mCompressionSettings, tolerances);
+    bool valid = header.vertexStride == sizeof(SkinnedVertex)
+        && header.animationFlags == CookedAnimationFlags(mCompressAnimations, mKeepSourceAnimations)
+        && header.translationTolerance == tolerances[0]
+        && header.scaleTolerance == tolerances[1]
+        && header.rotationTolerance == tolerances[2]
+        && header.sources.count == sourceFiles.size()
+        && file.IsValidRange<SkinnedVertex>(header.vertices)
+        && file.IsValidRange<UINT>(header.indices)
+        && file.IsValidRange<XMFLOAT3>(header.positions)
+        && file.IsValidRange<XMFLOAT3>(header.normals)
+        && file.IsValidRange<XMFLOAT2>(header.texCoords)
+        && file.IsValidRange<VertexBoneData>(header.vertexBones)
+        && file.IsValidRange<CookedSubmesh>(header.submeshes)
+        && file.IsValidRange<CookedNode>(header.nodes)
+        && file.IsValidRange<CookedString>(header.nodeChildren)
+        && file.IsValidRange<CookedBone>(header.bones)
+        && file.IsValidRange<int>(header.boneChildren)
+        && file.IsValidRange<CookedClip>(header.clips)
+        && file.IsValidRange<CookedChannel>(header.channels)
+        && file.IsValidRange<Keyframe<XMFLOAT3>>(header.vectorKeys)
+        && file.IsValidRange<Keyframe<XMFLOAT4>>(header.rotationKeys)
+        && file.IsValidRange<CompressedTrack>(header.compressedTracks)
+        && file.IsValidRange<float>(header.compressedTimes)
+        && file.IsValidRange<uint16_t>(header.quantizedValues)
+        && file.IsValidRange<float>(header.rawValues);
+
+    // 원본이 바뀌었으면 다시 쿡해야 한다.
+    const CookedSource* sources = file.Array<CookedSource>(header.sources);
+    for (int i = 0; valid && i < (int)sourceFiles.size(); i++)
+    {
+        uint64_t lastWriteTime, fileSize;
+        valid = file.String(sources[i].path) == sourceFiles[i]
+            && GetCookedSourceStamp(sourceFiles[i], lastWriteTime, fileSize)
+            && sources[i].lastWriteTime == lastWriteTime && sources[i].fileSize == fileSize;
+    }
+
+    // 정점 배열은 모두 같은 수이고, 인덱스는 (submesh의 baseVertex를 더해도) 정점 안을 가리킨다.
+    const uint64_t numVertices = header.vertices.count;
+    valid = valid && header.positions.count == numVertices && header.normals.count == numVertices
+        && header.texCoords.count == numVertices && header.vertexBones.count == numVertices;
+
+    const UINT* indices = file.Array<UINT>(header.indices);
+    for (uint64_t i = 0; valid && i < header.indices.count; i++)
+        valid = indices[i] < numVertices;
+
+    const CookedSubmesh* submeshes = file.Array<CookedSubmesh>(header.submeshes);
+    for (int i = 0; valid && i < (int)header.submeshes.count; i++)
+    {
+        const CookedSubmesh& submesh = submeshes[i];
+        valid = (uint64_t)submesh.baseIndex + submesh.numIndices <= header.indices.count && submesh.baseVertex <= numVertices;
+        for (UINT j = 0; valid && j < submesh.numIndices; j++)
+            valid = indices[submesh.baseIndex + j] < numVertices - submesh.baseVertex;
+    }
+
+    // 노드 : 자식 이름은 있는 노드이고 그 노드가 부모보다 뒤에 있어야 한다. (BuildSkeleton은 부모가 앞에 있다고 보고 확인 없이 mJoints를 쓴다.)
+    // 이름이 겹치면 불러올 때처럼 뒤의 노드를 쓴다.
+    const CookedNode* nodes = file.Array<CookedNode>(header.nodes);
+    const CookedString* nodeChildren = file.Array<CookedString>(header.nodeChildren);
+    for (int i = 0; valid && i < (int)header.nodes.count; i++)
+        valid = IsValidSpan(nodes[i].children, header.nodeChildren);
+
+    map<string, int> nodeIds;
+    for (int i = 0; valid && i < (int)header.nodes.count; i++)
+        nodeIds[file.String(nodes[i].name)] = i;
+    for (int i = 0; valid && i < (int)header.nodes.count; i++)
+    {
+        for (UINT j = 0; valid && j < nodes[i].children.count; j++)
+        {
+            auto child = nodeIds.find(file.String(nodeChildren[nodes[i].children.first + j]));
+            valid = child != nodeIds.end() && child->second > i;
+        }
+    }
+
+    // 뼈 : 자식 뼈 id와 정점의 뼈 id는 뼈 배열 안 (정점의 빈 자리는 가중치 0, 뼈 id 0)
+    const CookedBone* bones = file.Array<CookedBone>(header.bones);
+    for (int i = 0; valid && i < (int)header.bones.count; i++)
+        valid = IsValidSpan(bones[i].children, header.boneChildren);
+
+    const int* boneChildren = file.Array<int>(header.boneChildren);
+    for (uint64_t i = 0; valid && i < header.boneChildren.count; i++)
+        valid = boneChildren[i] >= 0 && (uint64_t)boneChildren[i] < header.bones.count;
+
+    const VertexBoneData* vertexBones = file.Array<VertexBoneData>(header.vertexBones);
+    for (uint64_t i = 0; valid && i < header.vertexBones.count; i++)
+    {
+        for (int k = 0; valid && k < MAX_NUM_BONES_PER_VERTEX; k++)
+        {
+            int boneId = vertexBones[i].BoneIDs[k];
+            valid = boneId >= 0 && ((uint64_t)boneId < header.bones.count || vertexBones[i].Weights[k] == 0.0f);
+        }
+    }
+
+    const CookedClip* clips = file.Array<CookedClip>(header.clips);
+    const CookedChannel* channels = file.Array<CookedChannel>(header.channels);
+    for (int i = 0; valid && i < (int)header.clips.count; i++)
+    {
+        const CookedClip& clip = clips[i];
+        valid = IsValidSpan(clip.channels, header.channels)
+            && IsValidSpan(clip.compressed.tracks, header.compressedTracks)
+            && IsValidSpan(clip.compressed.times, header.compressedTimes)
+            && IsValidSpan(clip.compressed.quantizedValues, header.quantizedValues)
+            && IsValidSpan(clip.compressed.rawValues, header.rawValues);
+
+        for (UINT j = 0; valid && j < clip.channels.count; j++) {
+            const CookedChannel& channel = channels[clip.channels.first + j];
+            valid = IsValidSpan(channel.translation, header.vectorKeys) && IsValidSpan(channel.scale, header.vectorKeys)
+                && IsValidSpan(channel.rotation, header.rotationKeys);
+            // 원본 키로 재생하는 채널은 키가 하나 이상 있어야 한다.
+            if (valid && (!clip.isCompressed || clip.hasSourceKeyframes))
+                valid = channel.translation.count > 0 && channel.scale.count > 0 && channel.rotation.count > 0;
+        }
+
+        if (valid && clip.isCompressed)
+            valid = CompressedClip::IsValidCooked(file, clip.compressed, clip.channels.count);
+    }
+
+    if (!valid) {
+        file.Close();
+        return false;
+    }
+
+    // 정점 정보 : 배열 단위로 복사
+    mPositions.assign(file.Array<XMFLOAT3>(header.positions), file.Array<XMFLOAT3>(header.positions) + header.positions.count);
+    mNormals.assign(file.Array<XMFLOAT3>(header.normals), file.Array<XMFLOAT3>(header.normals) + header.normals.count);
+    mTexCoords.assign(file.Array<XMFLOAT2>(header.texCoords), file.Array<XMFLOAT2>(header.texCoords) + header.texCoords.count);
+    mBones.assign(file.Array<VertexBoneData>(header.vertexBones), file.Array<VertexBoneData>(header.vertexBones) + header.vertexBones.count);
+    mIndices.assign(file.Indices(), file.Indices() + file.NumIndices());
+
+    mSubmeshes.clear();
+    for (int i = 0; i < (int)header.submeshes.count; i++)
+    {
+        Submesh submesh;
+        submesh.name = file.String(submeshes[i].name);
+        submesh.baseVertex = submeshes[i].baseVertex;
+        submesh.baseIndex = submeshes[i].baseIndex;
+        submesh.numIndices = submeshes[i].numIndices;
+        submesh.materialIndex = submeshes[i].materialIndex;
+        submesh.bounds = submeshes[i].bounds;
+        mSubmeshes.push_back(submesh);
+    }
+
+    // 계층 구조
+    rootNodeName = file.String(header.rootNodeName);
+
+    mNodeHierarchy.clear();
+    mNodeNameToIndexMap.clear();
+    for (int i = 0; i < (int)header.nodes.count; i++)
+    {
+        vector<string> children;
+        for (UINT j = 0; j < nodes[i].children.count; j++)
+            children.push_back(file.String(nodeChildren[nodes[i].children.first + j]));
+
+        string nodeName = file.String(nodes[i].name);
+        mNodeNameToIndexMap[nodeName] = i;
+        mNodeHierarchy.push_back(make_pair(nodeName, children));
+    }
+
+    mBoneInfo.clear();
+    mBoneHierarchy.clear();
+    mBoneNameToIndexMap.clear();
+    for (int i = 0; i < (int)header.bones.count; i++)
+    {
+        const CookedBone& bone = bones[i];
+        mBoneNameToIndexMap[file.String(bone.name)] = i;
+        mBoneInfo.push_back(BoneInfo(bone.offsetMatrix));
+
+        vector<int> children(boneChildren + bone.children.first, boneChildren + bone.children.first + bone.children.count);
+        mBoneHierarchy.push_back(make_pair(file.String(bone.hierarchyName), children));
+    }
+
+    BuildSkeleton();
+
+    // 애니메이션
+    mAnimations.clear();
+    const Keyframe<XMFLOAT3>* vectorKeys = file.Array<Keyframe<XMFLOAT3>>(header.vectorKeys);
+    const Keyframe<XMFLOAT4>* rotationKeys = file.Array<Keyframe<XMFLOAT4>>(header.rotationKeys);
+    for (int i = 0; i < (int)header.clips.count; i++)
+    {
+        const CookedClip& cooked = clips[i];
+
+        AnimationClip clip;
+        clip.name = file.String(cooked.name);
+        clip.tickPerSecond = cooked.tickPerSecond;
+        clip.duration = cooked.duration;
+        clip.enableRootMotion = cooked.enableRootMotion != 0;
+        clip.isCompressed = cooked.isCompressed != 0;
+        clip.hasSourceKeyframes = cooked.hasSourceKeyframes != 0;
+
+        clip.channels.resize(cooked.channels.count);
+        for (UINT j = 0; j < cooked.channels.count; j++)
+        {
+            const CookedChannel& channel = channels[cooked.channels.first + j];
+            BoneAnimation& boneAnimation = clip.channels[j];
+            boneAnimation.translation.assign(vectorKeys + channel.translation.first, vectorKeys + channel.translation.first + channel.translation.count);
+            boneAnimation.scale.assign(vectorKeys + channel.scale.first, vectorKeys + channel.scale.first + channel.scale.count);
+            boneAnimation.rotationQuat.assign(rotationKeys + channel.rotation.first, rotationKeys + channel.rotation.first + channel.rotation.count);
+
+            clip.channelIndexMap[file.String(channel.nodeName)] = j;
+        }
+
+        if (clip.isCompressed)
+            clip.compressed.Load(file, cooked.compressed);
+
+        ResolveChannels(clip);
+        mAnimations.push_back(std::move(clip));
+    }
+
+    mPoseState = PoseState();
+    ClearPoseCache();
+
+    return true;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #define MAX_NUM_BONES_PER_VERTEX 4
+#define MAX_ANIMATION_LAYERS 4
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -8,12 +9,16 @@
 #include <assimp\cimport.h>
 #include "d3dUtil.h"
 #include "Mesh.h"
+#include "CompressedClip.h"
+#include "PoseKernel.h"
+#include "BakedClip.h"
+#include "CookedModel.h"
 #include <map>
 
 using namespace DirectX;
 using namespace std;
 
-// ִϸ̼  
+// 애니메이션의 한 프레임
 template <typename TXMFLOAT>
 struct Keyframe
 {
@@ -22,17 +27,98 @@ struct Keyframe
     TXMFLOAT value;
 };
 
-// Keyframe Ʈ
-// ð ̿ 2 keyframe  İ .
+// 트랙별 키프레임 커서
+// 마지막으로 사용한 키프레임 인덱스를 기억해 순방향 재생에서는 다음 키를 O(1)에 찾는다.
+// 시간이 뒤로 가거나 크게 건너뛰면 이진 탐색으로 다시 찾는다.
+struct AnimationCursor
+{
+    int translation = 0;
+    int scale = 0;
+    int rotation = 0;
+};
+
+// 포즈 계산에 필요한 인스턴스별 상태
+// SkinnedMesh는 읽기만 하므로 서로 다른 PoseState를 쓰면 여러 인스턴스의 포즈를 동시에 계산할 수 있다.
+struct PoseState
+{
+    vector<AnimationCursor> cursors;        // 채널별 키프레임 커서
+    vector<XMFLOAT4X4> jointTransforms;     // 관절 순서의 모델 공간 변환 (작업 버퍼)
+    PoseBatch batch;                        // 관절별 로컬 변환 (일괄 계산용 작업 버퍼)
+
+    // 블렌딩용 : 레이어마다 다른 클립을 재생하므로 커서도 따로 가진다.
+    vector<AnimationCursor> layerCursors[MAX_ANIMATION_LAYERS];
+    PoseBatch blendBatch;                   // 위에 섞을 레이어의 로컬 변환
+};
+
+// 블렌딩할 클립 하나
+// 레이어는 순서대로 섞이며, 첫 레이어는 바탕 포즈이므로 weight를 사용하지 않는다.
+// 이후 레이어는 지금까지의 결과를 weight (* jointWeights[관절]) 비율로 덮는다.
+struct AnimationLayer
+{
+    int clipIndex = 0;
+    float timePos = 0.0f;                   // 초
+    float weight = 1.0f;
+    const float* jointWeights = nullptr;    // 관절별 가중치 (SkinnedMesh::BuildJointMask), nullptr이면 모두 1
+};
+
+// Keyframe의 리스트
+// 시간값을 이용해 2개의 keyframe을 보간한 행렬값을 구함.
 struct BoneAnimation
 {   
     vector<Keyframe<XMFLOAT3>> translation;
     vector<Keyframe<XMFLOAT3>> scale;
     vector<Keyframe<XMFLOAT4>> rotationQuat;
+
+    XMVECTOR SampleTranslation(float animationTime, int& cursor) const;
+    XMVECTOR SampleScale(float animationTime, int& cursor) const;
+    XMVECTOR SampleRotation(float animationTime, int& cursor) const;
+
+    // 보간하지 않고 두 키와 비율만 구한다. (여러 뼈를 모아 한 번에 보간할 때 사용)
+    void SampleRotationKeys(float animationTime, int& cursor, XMVECTOR& start, XMVECTOR& end, float& factor) const;
 };
 
-// ϳ ִϸ̼ Ÿ. ("޸", "" )
-//    BoneAnimation Ʈ
+// time이 속한 구간 [timeAt(i), timeAt(i + 1)]의 i를 반환한다. (키가 2개 이상이어야 함)
+// 범위를 벗어난 시간은 처음/마지막 구간으로 고정된다.
+// timeAt(i)는 i번째 키의 시간을 반환하며, AoS(Keyframe)와 SoA(시간 배열) 저장 형식에서 함께 사용한다.
+template <typename TimeAt>
+int FindKeyIndex(int numKeys, float time, int& cursor, TimeAt timeAt)
+{
+    int lastSegment = numKeys - 2;
+    int i = cursor;
+
+    // 커서 구간 또는 바로 다음 구간이면 탐색하지 않는다.
+    if (i >= 0 && i <= lastSegment && timeAt(i) <= time) {
+        if (i == lastSegment || time < timeAt(i + 1))
+            return i;
+        if (i + 1 == lastSegment || time < timeAt(i + 2)) {
+            cursor = i + 1;
+            return cursor;
+        }
+    }
+
+    // time < timeAt(j)를 만족하는 첫 j를 [1, numKeys - 1] 에서 찾는다.
+    int low = 1;
+    int high = numKeys - 1;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (time < timeAt(mid))
+            high = mid;
+        else
+            low = mid + 1;
+    }
+
+    cursor = low - 1;
+    return cursor;
+}
+
+template <typename TXMFLOAT>
+int FindKeyframeIndex(const vector<Keyframe<TXMFLOAT>>& keys, float time, int& cursor)
+{
+    return FindKeyIndex((int)keys.size(), time, cursor, [&keys](int i) { return keys[i].timePos; });
+}
+
+// 하나의 애니메이션을 나타낸다. ("달리기", "대기" 등)
+// 모든 뼈에 대한 BoneAnimation의 리스트
 struct AnimationClip
 {
     string name;
@@ -40,11 +126,26 @@ struct AnimationClip
     float duration = 0.0f;
     bool enableRootMotion = false;
 
-    std::map<string, BoneAnimation> boneAnimations;
+    vector<BoneAnimation> channels;
+    std::map<string, int> channelIndexMap;  // 노드 이름 -> channels 인덱스 (로드할 때만 사용)
+    vector<int> jointChannels;              // 관절 인덱스 -> channels 인덱스, 채널이 없으면 -1
+
+    // 압축을 사용하면 키프레임은 compressed에서 읽고, 원본을 유지하지 않으면 channels의 키는 비워진다.
+    bool isCompressed = false;
+    bool hasSourceKeyframes = true;
+    CompressedClip compressed;
+};
+
+// 컴파일된 스켈레톤의 관절
+// 관절 배열은 부모가 항상 자식보다 앞에 오도록 정렬되어 있어 한 번의 순회로 포즈를 계산할 수 있다.
+struct SkeletonJoint
+{
+    int parentIndex = -1;   // 부모 관절 인덱스, 루트는 -1
+    int boneIndex = -1;     // mBoneInfo 인덱스, 뼈가 없는 노드는 -1
 };
 
-//    ִϸ̼ǿ 󸶳  ޴ ġ 
-//   ִ MAX_NUM_BONES_PER_VERTEX    ޴´.
+// 각 정점이 뼈 애니메이션에 얼마나 영향을 받는지 가중치를 저장
+// 모든 정점은 최대 MAX_NUM_BONES_PER_VERTEX 개의 뼈에 영향을 받는다.
 struct VertexBoneData
 {
     int BoneIDs[MAX_NUM_BONES_PER_VERTEX] = { 0 };
@@ -93,6 +194,15 @@ struct BasicMeshEntry {
     unsigned int MaterialIndex;
 };
 
+// 포즈 계산 방식
+// Batched*는 채널이 있는 관절을 모아 회전 보간과 TRS 합성을 SIMD로 한 번에 처리한다.
+enum class PoseEvaluation
+{
+    Scalar,         // 관절마다 XMQuaternionSlerp + XMMatrixAffineTransformation (기준)
+    BatchedSlerp,
+    BatchedNlerp
+};
+
 class SkinnedMesh : public Mesh
 {
 public:
@@ -101,31 +211,89 @@ public:
 
     bool LoadMesh(const std::string& Filename);
     bool LoadAnimations(const std::string& Filename);
-    void SetOffsetMatrix(XMFLOAT4X4 offsetMatrix) { mOffsetMatrix = offsetMatrix; }
+    void SetOffsetMatrix(XMFLOAT4X4 offsetMatrix) { mOffsetMatrix = offsetMatrix; ClearPoseCache(); }
     void SetOffsetMatrix(XMFLOAT3 axis1, float degree1, XMFLOAT3 axis2, float degree2);
+    // 이후에 LoadAnimations로 읽는 클립을 압축한다. keepSource가 true면 비교용으로 원본 키프레임도 남긴다.
+    void SetAnimationCompression(bool enable, bool keepSource = false, const AnimationCompressionSettings& settings = AnimationCompressionSettings());
+
+    void SetPoseEvaluation(PoseEvaluation poseEvaluation) { mPoseEvaluation = poseEvaluation; }
+    PoseEvaluation GetPoseEvaluation() const { return mPoseEvaluation; }
 
     int NumBones() const { return (int)mBoneNameToIndexMap.size(); }
 
     //const Material& GetMaterial();
 
     void GetBoneTransforms(float animationTimeSec, vector<XMFLOAT4X4>& transforms, int animationIndex);
+    void GetBoneTransforms(float animationTimeSec, vector<XMFLOAT4X4>& transforms, int animationIndex, PoseState& state) const;
+
+    // 최종 뼈 변환(전치된 offset * global)을 boneTransforms[NumBones()]에 바로 쓴다.
+    void EvaluatePose(float animationTimeSec, int animationIndex, PoseState& state, XMFLOAT4X4* boneTransforms) const;
+    // 여러 클립을 로컬 공간에서 섞은 포즈를 계산한다. (numLayers <= MAX_ANIMATION_LAYERS)
+    // 작업 버퍼는 state에 남아 있으므로 같은 state를 계속 쓰면 매 프레임 할당하지 않는다.
+    void EvaluateBlendedPose(const AnimationLayer* layers, int numLayers, PoseState& state, XMFLOAT4X4* boneTransforms) const;
+    // nodeName 노드와 그 하위 관절은 weight, 나머지는 0인 관절별 가중치를 만든다. (상체만 덮는 레이어 등)
+    void BuildJointMask(const string& nodeName, float weight, vector<float>& jointWeights) const;
+    // 구운 포즈 캐시 : 클립을 sampleRate 간격의 최종 뼈 행렬로 미리 계산해 두고 두 프레임 보간만으로 재생한다.
+    // 구운 클립의 총 크기가 budgetBytes를 넘으면 가장 오래 사용하지 않은 클립부터 버린다.
+    void EnablePoseCache(float sampleRate = 30.0f, size_t budgetBytes = 8 * 1024 * 1024);
+    void DisablePoseCache();
+    bool IsPoseCacheEnabled() const { return mPoseCacheEnabled; }
+    // 클립이 구워져 있지 않으면 굽고 사용 시각을 갱신한다. 예산에 들어가지 않으면 false
+    // 캐시를 바꾸므로 SampleBakedPose와 동시에 호출하면 안 된다. (프레임마다 포즈 계산 전에 한 스레드에서 호출)
+    bool PreparePoseCache(int animationIndex);
+    // 구워진 클립이면 out[NumBones()]에 쓰고 true, 아니면 false (읽기 전용이라 여러 스레드에서 호출할 수 있다.)
+    bool SampleBakedPose(float animationTimeSec, int animationIndex, XMFLOAT4X4* boneTransforms) const;
+    bool IsPoseBaked(int animationIndex) const;
+    size_t PoseCacheByteSize() const { return mBakedBytes; }
+    float PoseCacheSampleRate() const { return mBakeSampleRate; }
+    size_t PoseCacheBudget() const { return mBakeBudget; }
+
+    void GetBoneTransformsLegacy(float animationTimeSec, vector<XMFLOAT4X4>& transforms, int animationIndex);   // 이름 기반 재귀 평가 (비교용)
 
     void CreateBlob(const vector<SkinnedVertex>& vertices, const vector<UINT>& indices);
-    void UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList, const vector<SkinnedVertex> vertices, const vector<UINT> indices);
+    void CreateBlob(const SkinnedVertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices);
+    void UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList, const vector<SkinnedVertex>& vertices, const vector<UINT>& indices);
+    void UploadBuffer(ID3D12Device* d3dDevice, ID3D12GraphicsCommandList* commandList, const SkinnedVertex* vertices, UINT numVertices, const UINT* indices, UINT numIndices);
+
+    // 읽은 정점 정보로 GPU에 올릴 SkinnedVertex를 만든다. (가중치는 합이 1이 되도록 정규화)
+    void BuildSkinnedVertices(vector<SkinnedVertex>& vertices) const;
+
+    // 쿡 파일 (.skm)
+    // sourceFiles는 LoadMesh, LoadAnimations에 넘긴 순서대로의 원본 파일이며, 수정 시각과 크기를 함께 저장한다.
+    bool SaveCooked(const string& filename, const vector<string>& sourceFiles, const vector<SkinnedVertex>& vertices) const;
+    // 원본 파일과 애니메이션 압축 설정이 쿡할 때와 같을 때만 읽는다.
+    // 정점/인덱스는 복사하지 않으며 file이 열려 있는 동안 file.Vertices(), file.Indices()로 바로 업로드할 수 있다.
+    bool LoadCooked(const string& filename, const vector<string>& sourceFiles, CookedModelFile& file);
 
     vector<VertexBoneData> mBones;
 
     string rootNodeName;
     map<string, int> mBoneNameToIndexMap;
     map<string, int> mNodeNameToIndexMap;
-    vector<pair<string, vector<int>>> mBoneHierarchy;   // θ ڽ ε  ִ. Ʈ 0
-    vector<pair<string, vector<string>>> mNodeHierarchy;   // θ ڽ ε  ִ. Ʈ 0
+    vector<pair<string, vector<int>>> mBoneHierarchy;   // 부모는 자식의 인덱스를 가지고 있다. 루트는 0
+    vector<pair<string, vector<string>>> mNodeHierarchy;   // 부모는 자식의 인덱스를 가지고 있다. 루트는 0
     vector<BoneInfo> mBoneInfo;
 
     vector<AnimationClip> mAnimations;
+
+    vector<SkeletonJoint> mJoints;
+
+    // 처음부터 선형 탐색하는 기준 보간 (BoneAnimation::Sample* 검증용)
+    XMVECTOR CalcInterpolatedScaling(const float animationTime, const BoneAnimation& boneAnimation);
+    XMVECTOR CalcInterpolatedRotation(const float animationTime, const BoneAnimation& boneAnimation);
+    XMVECTOR CalcInterpolatedPosition(const float animationTime, const BoneAnimation& boneAnimation);
 private:
     void Clear();
 
+    void CompressAnimation(AnimationClip& clip);
+    void BuildSkeleton();
+    void ResolveChannels(AnimationClip& clip);
+    void EvaluateClip(float animationTimeTicks, const AnimationClip& clip, PoseState& state, XMFLOAT4X4* boneTransforms) const;
+    void EvaluateClipBatched(float animationTimeTicks, const AnimationClip& clip, PoseState& state, XMFLOAT4X4* boneTransforms) const;
+    float ClipTicks(const AnimationClip& clip, float animationTimeSec) const;
+    void SampleLocalPose(float animationTimeTicks, const AnimationClip& clip, AnimationCursor* cursors, PoseBatch& batch) const;
+    void EvaluateHierarchy(PoseBatch& batch, PoseState& state, XMFLOAT4X4* boneTransforms) const;
+
     bool InitFromScene(const aiScene* pScene, const std::string& Filename);
 
     void InitAllMeshes(const aiScene* pScene);
@@ -143,9 +311,9 @@ private:
     void LoadNodeHierarchy(const aiNode* pNode);
     void LoadBoneHierarchy(const aiNode* pNode);
     void LoadChildren(vector<int>& children, const aiNode* pNode);
-    int GetBoneId(const aiBone* pBone);     //    ο index ߰.
-    int GetBoneId(const string boneName);   //    -1 ȯ
-    int GetNodeId(const string nodeName);   //    -1 ȯ
+    int GetBoneId(const aiBone* pBone);     // 없는 값이 오면 새로운 index를 추가함.
+    int GetBoneId(const string boneName);   // 없는 값이 오면 -1 반환
+    int GetNodeId(const string nodeName);   // 없는 값이 오면 -1 반환
     //string GetBoneName(const int boneId);
 
     void CalcInterpolatedScaling(aiVector3D& Out, float AnimationTime, const aiNodeAnim* pNodeAnim);
@@ -153,16 +321,12 @@ private:
     void CalcInterpolatedPosition(aiVector3D& Out, float AnimationTime, const aiNodeAnim* pNodeAnim);
 
     int FindScaling(float AnimationTime, const aiNodeAnim* pNodeAnim);
-    int FindScaleIndex(float AnimationTime, BoneAnimation boneAnimation);
+    int FindScaleIndex(float AnimationTime, const BoneAnimation& boneAnimation);
     int FindRotation(float AnimationTime, const aiNodeAnim* pNodeAnim);
 
-    XMVECTOR CalcInterpolatedScaling(const float animationTime, const BoneAnimation boneAnimation);
-    XMVECTOR CalcInterpolatedRotation(const float animationTime, const BoneAnimation boneAnimation);
-    XMVECTOR CalcInterpolatedPosition(const float animationTime, const BoneAnimation boneAnimation);
-
-    int FindRotationIndex(float AnimationTime, BoneAnimation boneAnimation);
+    int FindRotationIndex(float AnimationTime, const BoneAnimation& boneAnimation);
     int FindPosition(float AnimationTime, const aiNodeAnim* pNodeAnim);
-    int FindPositionIndex(float AnimationTime, BoneAnimation boneAnimation);
+    int FindPositionIndex(float AnimationTime, const BoneAnimation& boneAnimation);
     const aiNodeAnim* FindNodeAnim(const aiAnimation* pAnimation, const string& NodeName);
 
     //void ReadNodeHierarchy(float AnimationTimeTicks, const aiNode* pNode, const XMMATRIX& ParentTransform);
@@ -170,5 +334,22 @@ private:
     void ReadBoneHierarchy(float AnimationTimeTicks, const string boneName, const int animationId, const XMMATRIX& ParentTransform);
     
     XMFLOAT4X4 mOffsetMatrix = Matrix4x4::Identity();
+    PoseState mPoseState;   // PoseState를 넘기지 않는 GetBoneTransforms가 사용한다.
+
+    bool mCompressAnimations = false;
+    bool mKeepSourceAnimations = false;
+    AnimationCompressionSettings mCompressionSettings;
+
+    PoseEvaluation mPoseEvaluation = PoseEvaluation::BatchedSlerp;
+
+    void BakeClip(int animationIndex, BakedClip& baked) const;
+    void ClearPoseCache();
+
+    vector<BakedClip> mBakedClips;      // mAnimations와 같은 인덱스
+    bool mPoseCacheEnabled = false;
+    float mBakeSampleRate = 30.0f;
+    size_t mBakeBudget = 0;
+    size_t mBakedBytes = 0;
+    unsigned long long mBakeUseCounter = 0;
 };
 
@@ -0,0 +1,113 @@
+#include "SkinnedModelInstance.h"
+
+SkinnedModelInstance::SkinnedModelInstance(SkinnedMesh* skinnedInfo, int clipIndex, float timePos)
+{
+    SkinnedInfo = skinnedInfo;
+    ClipIndex = clipIndex;
+    TimePos = timePos;
+    FinalTransforms.resize(skinnedInfo->NumBones(), Matrix4x4::Identity());
+}
+
+void SkinnedModelInstance::UpdateSkinnedAnimation()
+{
+    if (SkinnedInfo == nullptr || SkinnedInfo->mAnimations.empty())
+        return;
+
+    FinalTransforms.resize(SkinnedInfo->NumBones());
+    PreparePoseCache();
+    EvaluatePose(FinalTransforms.data());
+}
+
+void SkinnedModelInstance::PreparePoseCache()
+{
+    if (UseBakedPose && FadeClipIndex == -1)
+        SkinnedInfo->PreparePoseCache(ClipIndex);
+}
+
+void SkinnedModelInstance::Advance(float dt)
+{
+    TimePos += dt;
+
+    if (FadeClipIndex != -1) {
+        FadeTimePos += dt;
+        FadeTime += dt;
+        if (FadeTime >= FadeDuration)
+            FadeClipIndex = -1;
+    }
+}
+
+void SkinnedModelInstance::CrossFade(int clipIndex, float duration, float timePos)
+{
+    if (clipIndex == ClipIndex)
+        return;
+
+    if (duration <= 0.0f) {
+        SetClip(clipIndex, timePos);
+        return;
+    }
+
+    // crossfade 도중에 다시 바뀌면 비중이 더 큰 쪽을 이전 클립으로 삼는다.
+    if (FadeClipIndex == -1 || FadeTime >= FadeDuration * 0.5f) {
+        FadeClipIndex = ClipIndex;
+        FadeTimePos = TimePos;
+    }
+
+    ClipIndex = clipIndex;
+    TimePos = timePos;
+    FadeTime = 0.0f;
+    FadeDuration = duration;
+}
+
+void SkinnedModelInstance::EvaluatePose(XMFLOAT4X4* out)
+{
+    if (FadeClipIndex == -1) {
+        if (UseBakedPose && SkinnedInfo->SampleBakedPose(TimePos, ClipIndex, out))
+            return;
+        SkinnedInfo->EvaluatePose(TimePos, ClipIndex, State, out);
+        return;
+    }
+
+    AnimationLayer layers[2];
+    layers[0].clipIndex = FadeClipIndex;
+    layers[0].timePos = FadeTimePos;
+    layers[1].clipIndex = ClipIndex;
+    layers[1].timePos = TimePos;
+    layers[1].weight = MathHelper::Clamp(FadeTime / FadeDuration, 0.0f, 1.0f);
+    SkinnedInfo->EvaluateBlendedPose(layers, 2, State, out);
+}
+
+void EvaluatePoses(ThreadPool& threadPool, PoseJob* jobs, int numJobs)
+{
+    // 캐시를 바꾸는 준비 단계는 병렬 계산 전에 끝낸다.
+    for (int i = 0; i < numJobs; i++) {
+        SkinnedModelInstance* instance = jobs[i].instance;
+        if (instance->SkinnedInfo != nullptr && !instance->SkinnedInfo->mAnimations.empty())
+            instance->PreparePoseCache();
+    }
+
+    // 한 인스턴스의 포즈 계산은 수 마이크로초라서 스레드마다 여러 구간을 가져가도록 나눈다.
+    int grainSize = max(1, numJobs / (int)(threadPool.NumThreads() * 8));
+
+    threadPool.ParallelFor(numJobs, grainSize, [jobs](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            PoseJob& job = jobs[i];
+            SkinnedModelInstance* instance = job.instance;
+            if (instance->SkinnedInfo == nullptr || instance->SkinnedInfo->mAnimations.empty())
+                continue;
+
+            int numBones = instance->SkinnedInfo->NumBones();
+            XMFLOAT4X4* out = job.out;
+            if (out == nullptr) {
+                instance->FinalTransforms.resize(numBones);
+                out = instance->FinalTransforms.data();
+            }
+
+            instance->EvaluatePose(out);
+
+            // 최소한 4개의 행렬을 초기화함
+            for (int j = numBones; j < 4 && job.out != nullptr; j++)
+                out[j] = Matrix4x4::Identity();
+        }
+    });
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "SkinnedMesh.h"
+#include "ThreadPool.h"
+
+// 공유 SkinnedMesh 애셋을 재생하는 가벼운 인스턴스
+// 재생 시간, 클립, 키프레임 커서, 포즈 버퍼를 인스턴스마다 따로 가지므로
+// 하나의 SkinnedMesh로 여러 캐릭터를 각자 다른 동작으로 그릴 수 있다.
+struct SkinnedModelInstance
+{
+    SkinnedModelInstance() = default;
+    SkinnedModelInstance(SkinnedMesh* skinnedInfo, int clipIndex = 0, float timePos = 0.0f);
+
+    SkinnedMesh* SkinnedInfo = nullptr;
+
+    int ClipIndex = 0;
+    float TimePos = 0.0f;
+
+    // 최종 뼈 변환 (셰이더로 보낼 전치 행렬)
+    vector<XMFLOAT4X4> FinalTransforms;
+
+    PoseState State;
+
+    // SkinnedMesh의 구운 포즈 캐시로 재생한다. (군중 등 정확도보다 비용이 중요한 경우)
+    // 클립이 구워지지 않았거나 crossfade 중이면 실시간으로 계산한다.
+    bool UseBakedPose = false;
+
+    // crossfade 중에는 이전 클립도 계속 재생하면서 FadeTime / FadeDuration 비율로 새 클립을 덮는다.
+    int FadeClipIndex = -1;     // 이전 클립, crossfade 중이 아니면 -1
+    float FadeTimePos = 0.0f;
+    float FadeTime = 0.0f;
+    float FadeDuration = 0.0f;
+
+    // 시간을 진행시킨다.
+    void Advance(float dt);
+    void SetClip(int clipIndex, float timePos = 0.0f) { ClipIndex = clipIndex; TimePos = timePos; FadeClipIndex = -1; }
+    // 지금 재생 중인 포즈에서 duration초 동안 clipIndex로 넘어간다. duration이 0이면 SetClip과 같다.
+    void CrossFade(int clipIndex, float duration, float timePos = 0.0f);
+    bool IsCrossFading() const { return FadeClipIndex != -1; }
+
+    // 현재 시간과 클립으로 FinalTransforms를 계산한다.
+    void UpdateSkinnedAnimation();
+    // UseBakedPose이면 재생할 클립을 캐시에 준비한다. EvaluatePose 전에 한 스레드에서 호출해야 한다.
+    void PreparePoseCache();
+    // 현재 포즈를 out[NumBones()]에 계산한다.
+    void EvaluatePose(XMFLOAT4X4* out);
+};
+
+// 일괄 포즈 계산 항목 하나
+// out이 nullptr이면 인스턴스의 FinalTransforms에 쓰고, 아니면 out에 바로 쓴다. (매핑된 SkinnedCB 등)
+// out에는 최소 max(NumBones(), 4)개의 행렬이 들어갈 공간이 있어야 한다.
+struct PoseJob
+{
+    SkinnedModelInstance* instance = nullptr;
+    XMFLOAT4X4* out = nullptr;
+};
+
+// 여러 인스턴스의 포즈를 스레드 풀에서 나눠 계산한다.
+// 인스턴스마다 UpdateSkinnedAnimation과 같은 결과를 낸다. (crossfade 포함)
+void EvaluatePoses(ThreadPool& threadPool, PoseJob* jobs, int numJobs);
@@ -0,0 +1,246 @@
+#include "SliceKernel.h"
+#include <immintrin.h>
+#include <bit>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+namespace
+{
+    // 정점 8개의 위치를 SSE 레지스터 두 묶음으로 전치한 것
+    struct PositionBlock
+    {
+        __m128 x[2];
+        __m128 y[2];
+        __m128 z[2];
+    };
+
+    struct PlaneVector
+    {
+        __m128 a, b, c, d;
+
+        explicit PlaneVector(const XMFLOAT4& plane)
+            : a(_mm_set1_ps(plane.x)), b(_mm_set1_ps(plane.y)), c(_mm_set1_ps(plane.z)), d(_mm_set1_ps(plane.w)) {}
+    };
+
+    // 위치 4개를 (x, y, z, 다음 값)으로 읽어 전치한다.
+    inline void LoadPositions4(const uint8_t* base, size_t stride, __m128& x, __m128& y, __m128& z)
+    {
+        __m128 p0 = _mm_loadu_ps(reinterpret_cast<const float*>(base));
+        __m128 p1 = _mm_loadu_ps(reinterpret_cast<const float*>(base + stride));
+        __m128 p2 = _mm_loadu_ps(reinterpret_cast<const float*>(base + stride * 2));
+        __m128 p3 = _mm_loadu_ps(reinterpret_cast<const float*>(base + stride * 3));
+        _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+        x = p0;
+        y = p1;
+        z = p2;
+    }
+
+    inline PositionBlock LoadBlock(const uint8_t* base, size_t stride)
+    {
+        PositionBlock block;
+        LoadPositions4(base, stride, block.x[0], block.y[0], block.z[0]);
+        LoadPositions4(base + stride * 4, stride, block.x[1], block.y[1], block.z[1]);
+        return block;
+    }
+
+    inline PositionBlock LoadBlock(const float* x, const float* y, const float* z)
+    {
+        PositionBlock block;
+        for (int half = 0; half < 2; half++)
+        {
+            block.x[half] = _mm_loadu_ps(x + half * 4);
+            block.y[half] = _mm_loadu_ps(y + half * 4);
+            block.z[half] = _mm_loadu_ps(z + half * 4);
+        }
+        return block;
+    }
+
+    // 정점 8개의 거리와 Side를 쓰고, 평면 법선 쪽/반대쪽 정점의 비트 마스크를 반환한다.
+    inline array<unsigned, 2> ClassifyBlock(const PositionBlock& block, const PlaneVector& plane, float* distances, uint8_t* sides)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        __m128i sideCodes[2];
+        unsigned frontBits = 0, backBits = 0;
+        for (int half = 0; half < 2; half++)
+        {
+            // PlaneDistance와 같은 순서로 더한다.
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(block.x[half], plane.a), _mm_mul_ps(block.y[half], plane.b)),
+                _mm_mul_ps(block.z[half], plane.c)), plane.d);
+            _mm_storeu_ps(distances + half * 4, distance);
+
+            // Side = 3 - 2 * front - back, 비교 결과는 참이면 -1
+            __m128 front = _mm_cmpgt_ps(distance, zero);
+            __m128 back = _mm_cmplt_ps(distance, zero);
+            __m128i frontMask = _mm_castps_si128(front);
+            sideCodes[half] = _mm_add_epi32(_mm_set1_epi32(SliceKernel::SideOnPlane), _mm_add_epi32(_mm_add_epi32(frontMask, frontMask), _mm_castps_si128(back)));
+
+            frontBits |= (unsigned)_mm_movemask_ps(front) << (half * 4);
+            backBits |= (unsigned)_mm_movemask_ps(back) << (half * 4);
+        }
+
+        __m128i codes = _mm_packs_epi32(sideCodes[0], sideCodes[1]);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(sides), _mm_packus_epi16(codes, codes));
+        return { frontBits, backBits };
+    }
+
+    // 조각별 정점 수 : 반대쪽이 아니면 첫 조각, 법선 쪽이 아니면 둘째 조각에 들어간다.
+    inline void AddCounts(array<UINT, 2>& counts, const array<unsigned, 2>& bits, UINT numValid)
+    {
+        unsigned validMask = (1u << numValid) - 1;
+        counts[0] += numValid - (UINT)popcount(bits[1] & validMask);
+        counts[1] += numValid - (UINT)popcount(bits[0] & validMask);
+    }
+
+    // 위치, 법선, 텍스처 좌표 (두 정점 구조체 모두 앞의 float 8개)
+    inline void LerpAttributes(const float* a, const float* b, __m128 t, float* out)
+    {
+        for (int half = 0; half < 2; half++)
+        {
+            __m128 start = _mm_loadu_ps(a + half * 4);
+            __m128 end = _mm_loadu_ps(b + half * 4);
+            _mm_storeu_ps(out + half * 4, _mm_add_ps(start, _mm_mul_ps(_mm_sub_ps(end, start), t)));
+        }
+    }
+
+    struct BoneInfluence
+    {
+        float weight;
+        UINT bone;
+    };
+
+    // 4번째 가중치는 1 - 나머지 합 (셰이더와 같다)
+    inline void AddInfluences(BoneInfluence* influences, int& count, const SkinnedVertex& vertex, float scale)
+    {
+        float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z,
+            1.0f - vertex.BoneWeights.x - vertex.BoneWeights.y - vertex.BoneWeights.z };
+        for (int i = 0; i < 4; i++)
+        {
+            float weight = weights[i] * scale;
+            if (weight <= 0.0f)
+                continue;
+
+            int k = 0;
+            while (k < count && influences[k].bone != vertex.BoneIndices[i])
+                k++;
+            if (k == count)
+                influences[count++] = { 0.0f, vertex.BoneIndices[i] };
+            influences[k].weight += weight;
+        }
+    }
+}
+
+array<UINT, 2> SliceKernel::ClassifyPositions(const XMFLOAT3* positions, size_t stride, UINT count, const XMFLOAT4& plane, float* distances, uint8_t* sides)
+{
+    PlaneVector planeVector(plane);
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(positions);
+    array<UINT, 2> counts = { 0, 0 };
+
+    UINT i = 0;
+    for (; i + BlockSize <= count; i += BlockSize)
+        AddCounts(counts, ClassifyBlock(LoadBlock(base + stride * i, stride), planeVector, distances + i, sides + i), BlockSize);
+
+    if (i < count) {
+        // 남는 정점은 16바이트 간격의 임시 묶음으로 옮겨 같은 계산을 한다.
+        XMFLOAT4 tail[BlockSize] = {};
+        float tailDistances[BlockSize];
+        uint8_t tailSides[BlockSize];
+        UINT numValid = count - i;
+        for (UINT k = 0; k < numValid; k++)
+            memcpy(&tail[k], base + stride * (i + k), sizeof(XMFLOAT3));
+
+        AddCounts(counts, ClassifyBlock(LoadBlock(reinterpret_cast<const uint8_t*>(tail), sizeof(XMFLOAT4)), planeVector, tailDistances, tailSides), numValid);
+        memcpy(distances + i, tailDistances, numValid * sizeof(float));
+        memcpy(sides + i, tailSides, numValid);
+    }
+    return counts;
+}
+
+array<UINT, 2> SliceKernel::ClassifyPositions(const float* x, const float* y, const float* z, UINT count, const XMFLOAT4& plane, float* distances, uint8_t* sides)
+{
+    PlaneVector planeVector(plane);
+    array<UINT, 2> counts = { 0, 0 };
+
+    UINT i = 0;
+    for (; i + BlockSize <= count; i += BlockSize)
+        AddCounts(counts, ClassifyBlock(LoadBlock(x + i, y + i, z + i), planeVector, distances + i, sides + i), BlockSize);
+
+    if (i < count) {
+        float tailX[BlockSize] = {}, tailY[BlockSize] = {}, tailZ[BlockSize] = {};
+        float tailDistances[BlockSize];
+        uint8_t tailSides[BlockSize];
+        UINT numValid = count - i;
+        memcpy(tailX, x + i, numValid * sizeof(float));
+        memcpy(tailY, y + i, numValid * sizeof(float));
+        memcpy(tailZ, z + i, numValid * sizeof(float));
+
+        AddCounts(counts, ClassifyBlock(LoadBlock(tailX, tailY, tailZ), planeVector, tailDistances, tailSides), numValid);
+        memcpy(distances + i, tailDistances, numValid * sizeof(float));
+        memcpy(sides + i, tailSides, numValid);
+    }
+    return counts;
+}
+
+Vertex SliceKernel::InterpolateEdge(const Vertex& vertex0, const Vertex& vertex1, float d0, float d1)
+{
+    // Vertex는 float 8개 (위치 3, 법선 3, 텍스처 좌표 2)이므로 두 레지스터로 모든 성분을 보간한다.
+    static_assert(sizeof(Vertex) == sizeof(float) * 8, "Vertex layout");
+
+    __m128 t = _mm_set1_ps(d0 / (d0 - d1));
+    const float* a = &vertex0.Pos.x;
+    const float* b = &vertex1.Pos.x;
+
+    Vertex vertex;
+    LerpAttributes(a, b, t, &vertex.Pos.x);
+    return vertex;
+}
+
+SkinnedVertex SliceKernel::InterpolateEdge(const SkinnedVertex& vertex0, const SkinnedVertex& vertex1, float d0, float d1)
+{
+    static_assert(offsetof(SkinnedVertex, BoneWeights) == sizeof(float) * 8, "SkinnedVertex layout");
+
+    float t = d0 / (d0 - d1);
+    SkinnedVertex vertex;
+    LerpAttributes(&vertex0.Pos.x, &vertex1.Pos.x, _mm_set1_ps(t), &vertex.Pos.x);
+
+    BoneInfluence influences[8];
+    int count = 0;
+    AddInfluences(influences, count, vertex0, 1.0f - t);
+    AddInfluences(influences, count, vertex1, t);
+
+    // 많아야 8개이므로 삽입 정렬
+    for (int i = 1; i < count; i++)
+    {
+        BoneInfluence influence = influences[i];
+        int k = i;
+        for (; k > 0; k--)
+        {
+            const BoneInfluence& prev = influences[k - 1];
+            if (prev.weight > influence.weight || (prev.weight == influence.weight && prev.bone < influence.bone))
+                break;
+            influences[k] = prev;
+        }
+        influences[k] = influence;
+    }
+    count = min(count, 4);
+
+    float sum = 0.0f;
+    for (int i = 0; i < count; i++)
+        sum += influences[i].weight;
+
+    float weights[4] = {};
+    for (int i = 0; i < 4; i++)
+    {
+        bool used = i < count && sum > 0.0f;
+        weights[i] = used ? influences[i].weight / sum : 0.0f;
+        vertex.BoneIndices[i] = used ? (BYTE)influences[i].bone : 0;
+    }
+    // 영향이 하나도 없으면 (원본 가중치가 잘못된 경우) 첫 정점의 첫 뼈에 붙인다.
+    if (count == 0 || sum <= 0.0f)
+    {
+        weights[0] = 1.0f;
+        vertex.BoneIndices[0] = vertex0.BoneIndices[0];
+    }
+    vertex.BoneWeights = XMFLOAT3(weights[0], weights[1], weights[2]);
+    return vertex;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "FrameResource.h"
+#include <array>
+#include <cstdint>
+
+using namespace DirectX;
+using namespace std;
+
+// 평면 절단용 SIMD 커널
+// 한 번에 정점 8개(SSE 4폭 두 묶음)의 평면 거리와 놓인 쪽을 구한다. 남는 정점은 0으로 채운 8개 묶음으로 같은 계산을 한다.
+// 모든 커널과 PlaneDistance는 같은 연산을 같은 순서로 하므로 같은 위치는 어느 함수로 분류해도 비트 단위로 같은 거리를 얻는다.
+namespace SliceKernel
+{
+    constexpr UINT BlockSize = 8;
+
+    // 정점이 놓인 쪽 : 1 = 평면 법선 쪽(half space), 2 = 반대쪽, 3 = 평면 위 (두 비트가 각 조각에 들어가는지를 뜻한다.)
+    enum Side : uint8_t
+    {
+        SideFront = 1,
+        SideBack = 2,
+        SideOnPlane = 3,
+    };
+
+    // 부호 있는 평면 거리 ((x * a + y * b) + z * c) + d
+    inline float PlaneDistance(const XMFLOAT3& pos, const XMFLOAT4& plane)
+    {
+        return pos.x * plane.x + pos.y * plane.y + pos.z * plane.z + plane.w;
+    }
+
+    // AoS 위치 : positions부터 stride 바이트 간격으로 count개의 위치를 읽는다.
+    // 위치 바로 뒤의 4바이트까지 한 번에 읽으므로 위치는 정점 구조체 끝에 있으면 안 된다.
+    // distances와 sides에 정점마다 거리와 Side를 쓰고, 조각별 정점 수(평면 위 정점은 양쪽에 센다)를 반환한다.
+    array<UINT, 2> ClassifyPositions(const XMFLOAT3* positions, size_t stride, UINT count, const XMFLOAT4& plane, float* distances, uint8_t* sides);
+
+    // SoA 위치 : x, y, z 배열
+    array<UINT, 2> ClassifyPositions(const float* x, const float* y, const float* z, UINT count, const XMFLOAT4& plane, float* distances, uint8_t* sides);
+
+    // 평면 거리가 d0, d1인 두 정점 사이의 절단 정점 : t = d0 / (d0 - d1)로 위치, 법선, 텍스처 좌표를 한 번에 보간한다.
+    // 두 정점은 평면 서로 반대쪽에 있어야 한다. (d0 != d1)
+    Vertex InterpolateEdge(const Vertex& vertex0, const Vertex& vertex1, float d0, float d1);
+
+    // 스킨드 정점 : 위치, 법선, 텍스처 좌표는 위와 같이 보간하고, 뼈 가중치는 두 정점의 영향(최대 8개)을 (1 - t), t로 섞어
+    // 같은 뼈끼리 더한 뒤 큰 순서(같으면 뼈 인덱스가 작은 순서)로 4개만 남기고 합이 1이 되도록 다시 정규화한다.
+    // 가중치가 0인 자리의 뼈 인덱스는 0으로 둔다.
+    SkinnedVertex InterpolateEdge(const SkinnedVertex& vertex0, const SkinnedVertex& vertex1, float d0, float d1);
+}
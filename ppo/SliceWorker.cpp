@@ -0,0 +1,73 @@
+#include "SliceWorker.h"
+
+SliceWorker::SliceWorker()
+{
+    mThread = thread(&SliceWorker::WorkerLoop, this);
+}
+
+SliceWorker::~SliceWorker()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+        mRequests.clear();
+    }
+    mWakeCondition.notify_all();
+    mThread.join();
+}
+
+void SliceWorker::Submit(Request request)
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mRequests.push_back(std::move(request));
+    }
+    mWakeCondition.notify_one();
+}
+
+bool SliceWorker::TryPopResult(SliceResult& result)
+{
+    lock_guard<mutex> lock(mMutex);
+    if (mResults.empty())
+        return false;
+
+    result = std::move(mResults.front());
+    mResults.pop_front();
+    return true;
+}
+
+void SliceWorker::WaitIdle()
+{
+    unique_lock<mutex> lock(mMutex);
+    mIdleCondition.wait(lock, [this]() { return mRequests.empty() && !mIsRunning; });
+}
+
+int SliceWorker::NumPendingRequests()
+{
+    lock_guard<mutex> lock(mMutex);
+    return (int)mRequests.size() + (mIsRunning ? 1 : 0);
+}
+
+void SliceWorker::WorkerLoop()
+{
+    while (true)
+    {
+        unique_lock<mutex> lock(mMutex);
+        mWakeCondition.wait(lock, [this]() { return mStop || !mRequests.empty(); });
+        if (mStop)
+            return;
+
+        Request request = std::move(mRequests.front());
+        mRequests.pop_front();
+        mIsRunning = true;
+        lock.unlock();
+
+        SliceResult result = request();
+
+        lock.lock();
+        mResults.push_back(std::move(result));
+        mIsRunning = false;
+        if (mRequests.empty())
+            mIdleCondition.notify_all();
+    }
+}
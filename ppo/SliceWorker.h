@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Mesh.h"
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+// 절단 요청 하나의 결과
+// mesh는 CPU 사본(mVertexBufferCPU, mIndexBufferCPU)과 submesh까지 채운 메시이고, GPU 자원은 메인 스레드에서 올린다.
+struct SliceResult
+{
+    unique_ptr<Mesh> mesh;
+    UINT vertexByteStride = 0;
+
+    // 메인 스레드에서 메시를 올린 뒤 장면에 반영한다. (GameObject 추가, 메시 교체 등)
+    function<void(Mesh* mesh)> onUploaded;
+};
+
+// 절단 요청을 작업 스레드 하나에서 차례로 처리하는 작업자
+// 요청은 작업 스레드에서만 실행되므로 요청끼리 같은 절단 컨텍스트를 잠그지 않고 쓸 수 있다.
+// 요청이 읽는 메시는 요청이 끝날 때까지 바뀌지 않아야 하며, ThreadPool은 다른 스레드와 함께 쓸 수 없으므로 요청 안에서 쓰지 않는다.
+class SliceWorker
+{
+public:
+    using Request = function<SliceResult()>;
+
+    SliceWorker();
+    SliceWorker(const SliceWorker& rhs) = delete;
+    SliceWorker& operator=(const SliceWorker& rhs) = delete;
+    // 실행 중인 요청은 끝까지 처리하고 남은 요청과 결과는 버린다.
+    ~SliceWorker();
+
+    void Submit(Request request);
+    // 끝난 결과를 요청 순서대로 하나 꺼낸다. 없으면 기다리지 않고 false를 반환한다.
+    bool TryPopResult(SliceResult& result);
+    // 모든 요청이 끝날 때까지 기다린다. (측정, 종료용)
+    void WaitIdle();
+
+    // 아직 끝나지 않은 요청 수
+    int NumPendingRequests();
+
+private:
+    void WorkerLoop();
+
+    thread mThread;
+    mutex mMutex;
+    condition_variable mWakeCondition;
+    condition_variable mIdleCondition;
+    bool mStop = false;
+    bool mIsRunning = false;
+
+    deque<Request> mRequests;
+    deque<SliceResult> mResults;
+};
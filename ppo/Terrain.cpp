@@ -1,4 +1,7 @@
 #include "Terrain.h"
+#include <cfloat>
+#include <immintrin.h>
+#include <algorithm>
 
 Terrain::Terrain()
 {
@@ -8,17 +11,57 @@ Terrain::~Terrain()
 {
 }
 
-void Terrain::LoadHeightMap(const wchar_t* filepath, int width, int length, float yScale)
+bool Terrain::LoadHeightMap(const wchar_t* filepath, int width, int length, float yScale)
 {
-	mHeightImage.LoadHeightMapImage(filepath, width, length, yScale);
+	return mHeightImage.LoadHeightMapImage(filepath, width, length, yScale);
 }
 
-void Terrain::CreateTerrain(float width, float length, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+void Terrain::CreateTerrain(float width, float length, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, ThreadPool* threadPool)
+{
+	CreateGridVertices(width, length, vertices);
+	SmoothGridVertices(vertices, mHeightImage.GetHeightMapWidth(), mHeightImage.GetHeightMapLength(), threadPool);
+
+	int imageWidth = mHeightImage.GetHeightMapWidth();
+	int imageLength = mHeightImage.GetHeightMapLength();
+	mImageWidth = imageWidth;
+	mImageLength = imageLength;
+	SetGroundGrid(width, length);
+	indices.resize((imageWidth - 1) * (imageLength - 1) * 6);
+
+	//
+	// Create the indices.
+	//
+
+	uint32_t faceCount = (imageWidth - 1) * (imageLength - 1) * 2;
+
+	// Iterate over each quad and compute indices.
+	uint32_t k = 0;
+	for (uint32_t i = 0; i < imageLength - 1; ++i)
+	{
+		for (uint32_t j = 0; j < imageWidth - 1; ++j)
+		{
+			indices[k] = i * imageWidth + j;
+			indices[k + 1] = i * imageWidth + j + 1;
+			indices[k + 2] = (i + 1) * imageWidth + j;
+
+			indices[k + 3] = (i + 1) * imageWidth + j;
+			indices[k + 4] = i * imageWidth + j + 1;
+			indices[k + 5] = (i + 1) * imageWidth + j + 1;
+
+			k += 6; // next quad
+		}
+	}
+
+	return;
+}
+
+void Terrain::CreateGridVertices(float width, float length, std::vector<Vertex>& vertices)
 {
 	int imageWidth = mHeightImage.GetHeightMapWidth();
 	int imageLength = mHeightImage.GetHeightMapLength();
 
 	uint32_t vertexCount =  imageWidth * imageLength;
+	vertices.resize(vertexCount);
 
 	//
 	// Create the vertices.
@@ -33,16 +76,30 @@ void Terrain::CreateTerrain(float width, float length, std::vector<Vertex>& vert
 	float du = 1.0f / (imageWidth - 1);
 	float dv = 1.0f / (imageLength - 1);
 
-	for (uint32_t i = 0; i < imageLength; ++i)
+	// 높이 맵은 타일 캐시로 읽으므로 점마다 읽지 않고 행 단위로 읽는다.
+	// 법선에는 아래 행(마지막 행은 위 행)이 필요하므로 두 행을 번갈아 쓴다.
+	std::vector<float> rows[2] = { std::vector<float>(imageWidth), std::vector<float>(imageWidth) };
+	if (imageLength > 0)
+		mHeightImage.GetHeightRow(0, 0, imageWidth, rows[0].data());
+
+	for (int i = 0; i < imageLength; ++i)
 	{
+		const std::vector<float>& heights = rows[i % 2];
+		std::vector<float>& nextHeights = rows[(i + 1) % 2];
+		const int nextRow = (i < imageLength - 1) ? i + 1 : i - 1;
+		if (nextRow >= 0)
+			mHeightImage.GetHeightRow(0, nextRow, imageWidth, nextHeights.data());
+
 		float z = halflength - i * dz;
-		for (uint32_t j = 0; j < imageWidth; ++j)
+		for (int j = 0; j < imageWidth; ++j)
 		{
 			float x = -halfWidth + j * dx;
-			float y = mHeightImage.GetHeight(j, i);
+			float y = heights[j];
+			int nextColumn = (j < imageWidth - 1) ? j + 1 : j - 1;
 
 			vertices[i * imageWidth + j].Pos = XMFLOAT3(x, y, z);
-			vertices[i * imageWidth + j].Normal = mHeightImage.GetHeightMapNormal(j, i, dx, dz);
+			vertices[i * imageWidth + j].Normal = HeightMapImage::ComputeNormal(y, heights[std::max<int>(nextColumn, 0)],
+				(nextRow >= 0) ? nextHeights[j] : y, dx, dz);
 			//vertices[i * imageWidth + j].TangentU = XMFLOAT3(1.0f, 0.0f, 0.0f);
 
 			// Stretch texture over grid.
@@ -50,58 +107,814 @@ void Terrain::CreateTerrain(float width, float length, std::vector<Vertex>& vert
 			vertices[i * imageWidth + j].TexC.y = i * dv;
 		}
 	}
-	// terrain y pos  źȭ, normal  źȭ
-	int flattening = 3;
-	for (UINT i = 2; i < imageLength -2; ++i)
+}
+
+void Terrain::SmoothGridVertices(std::vector<Vertex>& vertices, int imageWidth, int imageLength, ThreadPool* threadPool)
+{
+	// 표본은 [SmoothingRadius, image - 1 - SmoothingRadius], 평탄화하는 정점은 그보다 한 줄씩 넓다.
+	const int radius = SmoothingRadius;
+	const int firstSample = radius;
+	const int lastSampleColumn = imageWidth - 1 - radius;
+	const int lastSampleRow = imageLength - 1 - radius;
+	if (lastSampleColumn < firstSample || lastSampleRow < firstSample)
+		return;
+	const int firstColumn = firstSample - 1;
+	const int endColumn = lastSampleColumn + 2;
+	const int numColumns = endColumn - firstColumn;
+
+	// 표본 행마다 열의 가로 합을 (높이, 법선 x, y, z) float 4개로 모은다. 한 열이 SSE 레지스터 하나이다.
+	const int numSampleRows = lastSampleRow - firstSample + 1;
+	std::vector<float> rowSums(4 * (size_t)numSampleRows * numColumns);
+
+	// 열 j의 표본 수 : 창 [j - r, j + r]를 표본 구간으로 자른 길이
+	auto windowCount = [radius](int center, int first, int last) {
+		return std::min<int>(center + radius, last) - std::max<int>(center - radius, first) + 1;
+	};
+	std::vector<float> invColumnCounts(numColumns);
+	for (int j = firstColumn; j < endColumn; ++j)
+		invColumnCounts[j - firstColumn] = 1.0f / windowCount(j, firstSample, lastSampleColumn);
+
+	// (Pos.y, Normal.x, Normal.y, Normal.z) : Normal과 그 뒤 TexC.x를 읽어 TexC.x 자리에 Pos.y를 넣는다.
+	auto loadChannels = [](const Vertex& vertex) {
+		__m128 normal = _mm_loadu_ps(&vertex.Normal.x);
+		return _mm_move_ss(_mm_shuffle_ps(normal, normal, _MM_SHUFFLE(2, 1, 0, 3)), _mm_load_ss(&vertex.Pos.y));
+	};
+
+	// 1. 가로 : 행마다 창을 한 칸씩 밀며 들어오는 값을 더하고 나가는 값을 빼는 double 누적 합
+	//    한 행은 한 스레드가 처리하므로 결과는 행을 나누는 방법과 관계없다.
+	auto sumRows = [&](int begin, int end) {
+		for (int r = begin; r < end; ++r)
+		{
+			const Vertex* row = &vertices[(size_t)(firstSample + r) * imageWidth];
+			float* out = &rowSums[4 * (size_t)r * numColumns];
+			__m128d sumLow = _mm_setzero_pd();		// 높이, 법선 x
+			__m128d sumHigh = _mm_setzero_pd();		// 법선 y, z
+			int a = firstSample;		// 창 [a, b]
+			int b = firstSample - 1;
+			for (int j = firstColumn; j < endColumn; ++j)
+			{
+				for (int last = std::min<int>(j + radius, lastSampleColumn); b < last; )
+				{
+					__m128 in = loadChannels(row[++b]);
+					sumLow = _mm_add_pd(sumLow, _mm_cvtps_pd(in));
+					sumHigh = _mm_add_pd(sumHigh, _mm_cvtps_pd(_mm_movehl_ps(in, in)));
+				}
+				for (int first = std::max<int>(j - radius, firstSample); a < first; )
+				{
+					__m128 outgoing = loadChannels(row[a++]);
+					sumLow = _mm_sub_pd(sumLow, _mm_cvtps_pd(outgoing));
+					sumHigh = _mm_sub_pd(sumHigh, _mm_cvtps_pd(_mm_movehl_ps(outgoing, outgoing)));
+				}
+				_mm_storeu_ps(&out[4 * (j - firstColumn)], _mm_movelh_ps(_mm_cvtpd_ps(sumLow), _mm_cvtpd_ps(sumHigh)));
+			}
+		}
+	};
+
+	// 2. 세로 : 출력 행마다 창 안의 가로 합을 위 행부터 차례로 더한다. 원소마다 더하는 순서가 같으므로 결과는 행을 나누는 방법과 관계없다.
+	const int firstRow = firstSample - 1;
+	const int endRow = lastSampleRow + 2;
+	auto sumColumns = [&](int begin, int end) {
+		std::vector<float> sums(4 * (size_t)numColumns);
+		for (int i = firstRow + begin; i < firstRow + end; ++i)
+		{
+			int a = std::max<int>(i - radius, firstSample) - firstSample;
+			int b = std::min<int>(i + radius, lastSampleRow) - firstSample;
+			float invRowCount = 1.0f / (b - a + 1);
+
+			std::copy_n(&rowSums[4 * (size_t)a * numColumns], 4 * numColumns, sums.begin());
+			for (int r = a + 1; r <= b; ++r)
+			{
+				const float* rowSum = &rowSums[4 * (size_t)r * numColumns];
+				for (int j = 0; j < numColumns; ++j)
+					_mm_storeu_ps(&sums[4 * j], _mm_add_ps(_mm_loadu_ps(&sums[4 * j]), _mm_loadu_ps(&rowSum[4 * j])));
+			}
+
+			// 열 4개씩 전치해 높이를 평균으로 바꾸고 법선을 정규화한다. 남는 열도 같은 연산(곱, 제곱근, 나눗셈)이므로 결과가 같다.
+			Vertex* row = &vertices[(size_t)i * imageWidth + firstColumn];
+			const __m128 invRowCounts = _mm_set1_ps(invRowCount);
+			int j = 0;
+			for (; j + 4 <= numColumns; j += 4)
+			{
+				__m128 height = _mm_loadu_ps(&sums[4 * j]);
+				__m128 normalX = _mm_loadu_ps(&sums[4 * j + 4]);
+				__m128 normalY = _mm_loadu_ps(&sums[4 * j + 8]);
+				__m128 normalZ = _mm_loadu_ps(&sums[4 * j + 12]);
+				_MM_TRANSPOSE4_PS(height, normalX, normalY, normalZ);
+
+				height = _mm_mul_ps(_mm_mul_ps(height, _mm_loadu_ps(&invColumnCounts[j])), invRowCounts);
+				__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX, normalX), _mm_mul_ps(normalY, normalY)), _mm_mul_ps(normalZ, normalZ));
+				__m128 invLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSq));
+				normalX = _mm_mul_ps(normalX, invLength);
+				normalY = _mm_mul_ps(normalY, invLength);
+				normalZ = _mm_mul_ps(normalZ, invLength);
+
+				alignas(16) float heights[4], xs[4], ys[4], zs[4];
+				_mm_store_ps(heights, height);
+				_mm_store_ps(xs, normalX);
+				_mm_store_ps(ys, normalY);
+				_mm_store_ps(zs, normalZ);
+				for (int k = 0; k < 4; ++k)
+				{
+					row[j + k].Pos.y = heights[k];
+					row[j + k].Normal = XMFLOAT3(xs[k], ys[k], zs[k]);
+				}
+			}
+			for (; j < numColumns; ++j)
+			{
+				const float* sum = &sums[4 * j];
+				float invLength = 1.0f / sqrtf(sum[1] * sum[1] + sum[2] * sum[2] + sum[3] * sum[3]);
+				row[j].Pos.y = sum[0] * invColumnCounts[j] * invRowCount;
+				row[j].Normal = XMFLOAT3(sum[1] * invLength, sum[2] * invLength, sum[3] * invLength);
+			}
+		}
+	};
+
+	// 세로 단계는 가로 합만 읽으므로 원래 정점을 덮어써도 된다.
+	constexpr int GrainRows = 32;
+	if (threadPool) {
+		threadPool->ParallelFor(numSampleRows, GrainRows, sumRows);
+		threadPool->ParallelFor(endRow - firstRow, GrainRows, sumColumns);
+	}
+	else {
+		sumRows(0, numSampleRows);
+		sumColumns(0, endRow - firstRow);
+	}
+}
+
+// 조각 격자의 (row, column) 정점
+static UINT PatchGridIndex(int row, int column)
+{
+	return row * Terrain::PatchVertexCount + column;
+}
+
+// 치마가 붙는 변 side(0 : 위 row = 0, 1 : 아래 row = PatchQuads, 2 : 왼쪽 column = 0, 3 : 오른쪽 column = PatchQuads)의 t번째 격자 정점
+static UINT PatchSideIndex(int side, int t)
+{
+	switch (side)
+	{
+	case 0: return PatchGridIndex(0, t);
+	case 1: return PatchGridIndex(Terrain::PatchQuads, t);
+	case 2: return PatchGridIndex(t, 0);
+	default: return PatchGridIndex(t, Terrain::PatchQuads);
+	}
+}
+
+static UINT PatchSkirtIndex(int side, int t)
+{
+	return Terrain::NumPatchGridVertices + side * Terrain::PatchVertexCount + t;
+}
+
+// 팔면체 법선 : y축을 극으로 해 L1 정규화한 (x, z)를 쓰고, 아래 반구는 바깥 삼각형으로 접는다.
+static void EncodeOctahedralNormal(const XMFLOAT3& normal, int8_t encoded[2])
+{
+	float invLength = 1.0f / (fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z));
+	float u = normal.x * invLength;
+	float v = normal.z * invLength;
+	if (normal.y < 0.0f) {
+		float foldedU = (1.0f - fabsf(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+		float foldedV = (1.0f - fabsf(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+		u = foldedU;
+		v = foldedV;
+	}
+	encoded[0] = (int8_t)lroundf(std::min<float>(std::max<float>(u, -1.0f), 1.0f) * 127.0f);
+	encoded[1] = (int8_t)lroundf(std::min<float>(std::max<float>(v, -1.0f), 1.0f) * 127.0f);
+}
+
+void Terrain::CreatePatches(float width, float length, std::vector<TerrainVertex>& vertices, std::vector<uint16_t>& indices, ThreadPool* threadPool)
+{
+	mImageWidth = mHeightImage.GetHeightMapWidth();
+	mImageLength = mHeightImage.GetHeightMapLength();
+
+	std::vector<Vertex> gridVertices;
+	CreateGridVertices(width, length, gridVertices);
+	SmoothGridVertices(gridVertices, mImageWidth, mImageLength, threadPool);
+
+	float dx = width / (mImageWidth - 1);
+	float dz = length / (mImageLength - 1);
+	SetGroundGrid(width, length);
+
+	// 높이 맵 크기가 PatchQuads의 배수 + 1이 아니면 마지막 조각은 끝 행/열을 반복한다.
+	mNumPatchesX = (mImageWidth - 1 + PatchQuads - 1) / PatchQuads;
+	mNumPatchesZ = (mImageLength - 1 + PatchQuads - 1) / PatchQuads;
+	mPatches.assign(mNumPatchesX * mNumPatchesZ, TerrainPatch());
+	vertices.resize(mPatches.size() * NumPatchVertices);
+
+	// 오차와 AABB는 GPU가 그리는 값과 같도록 양자화한 높이로 구한다.
+	std::vector<Vertex> patchVertices(NumPatchGridVertices);
+	for (int pz = 0; pz < mNumPatchesZ; ++pz)
 	{
-		for (UINT j = 2; j < imageWidth - 2; ++j)
+		for (int px = 0; px < mNumPatchesX; ++px)
 		{
-			XMFLOAT3 addNormal = XMFLOAT3(0.0f, 0.0f, 0.0f);
-			float addYPos = 0.0f;
-			int numAdd = 0;
-			for (int x = j - flattening; x <= j + flattening; x++)
+			TerrainPatch& patch = mPatches[pz * mNumPatchesX + px];
+			patch.baseVertex = (UINT)((pz * mNumPatchesX + px) * NumPatchVertices);
+			patch.firstColumn = px * PatchQuads;
+			patch.firstRow = pz * PatchQuads;
+			TerrainVertex* compactVertices = &vertices[patch.baseVertex];
+
+			float minHeight = FLT_MAX;
+			float maxHeight = -FLT_MAX;
+			for (int i = 0; i < PatchVertexCount; ++i)
 			{
-				if (x < 3 || x > imageWidth - 4)
-					continue;
-				for (int y = i - flattening; y <= i + flattening; y++)
+				int row = std::min<int>(patch.firstRow + i, mImageLength - 1);
+				for (int j = 0; j < PatchVertexCount; ++j)
 				{
-					if (y < 3 || y > imageLength -4)
-						continue;
-					addYPos += vertices[x + imageWidth * y].Pos.y;
-					addNormal.x += vertices[x + imageWidth * y].Normal.x;
-					addNormal.y += vertices[x + imageWidth * y].Normal.y;
-					addNormal.z += vertices[x + imageWidth * y].Normal.z;
-					numAdd++;
+					int column = std::min<int>(patch.firstColumn + j, mImageWidth - 1);
+					const Vertex& vertex = gridVertices[row * mImageWidth + column];
+					patchVertices[PatchGridIndex(i, j)] = vertex;
+					minHeight = std::min<float>(minHeight, vertex.Pos.y);
+					maxHeight = std::max<float>(maxHeight, vertex.Pos.y);
 				}
 			}
-			vertices[i * imageWidth + j].Pos.y = addYPos / numAdd;
-			vertices[i * imageWidth + j].Normal = Vector3::Normalize(addNormal);
+			patch.minHeight = minHeight;
+			patch.heightScale = (maxHeight - minHeight) / 65535.0f;
+
+			XMFLOAT3 minPos(FLT_MAX, FLT_MAX, FLT_MAX);
+			XMFLOAT3 maxPos(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+			for (int v = 0; v < NumPatchGridVertices; ++v)
+			{
+				Vertex& vertex = patchVertices[v];
+				TerrainVertex& compact = compactVertices[v];
+				compact.Height = (patch.heightScale > 0.0f) ? (uint16_t)lroundf((vertex.Pos.y - minHeight) / patch.heightScale) : 0;
+				EncodeOctahedralNormal(vertex.Normal, compact.Normal);
+				vertex.Pos.y = minHeight + compact.Height * patch.heightScale;
+
+				minPos = XMFLOAT3(std::min<float>(minPos.x, vertex.Pos.x), std::min<float>(minPos.y, vertex.Pos.y), std::min<float>(minPos.z, vertex.Pos.z));
+				maxPos = XMFLOAT3(std::max<float>(maxPos.x, vertex.Pos.x), std::max<float>(maxPos.y, vertex.Pos.y), std::max<float>(maxPos.z, vertex.Pos.z));
+			}
+			patch.bounds = BoundingBox(XMFLOAT3((minPos.x + maxPos.x) * 0.5f, (minPos.y + maxPos.y) * 0.5f, (minPos.z + maxPos.z) * 0.5f),
+				XMFLOAT3((maxPos.x - minPos.x) * 0.5f, (maxPos.y - minPos.y) * 0.5f, (maxPos.z - minPos.z) * 0.5f));
+
+			ComputeLodErrors(patchVertices.data(), patch);
+
+			// 이웃의 가장자리는 많아야 이웃의 가장 거친 LOD 오차만큼, 이 조각의 가장자리는 이 조각의 오차만큼 원래 높이에서 벗어난다.
+			// 틈은 두 오차의 합보다 크지 않으므로 어느 쪽 치마든 가장 거친 LOD 오차에 칸 하나만큼 더 내린다.
+			// 치마 정점은 변 정점의 높이와 법선을 그대로 두고 셰이더가 skirtDepth만큼 내린다.
+			patch.skirtDepth = patch.lodErrors[NumLods - 1] + std::max<float>(dx, dz);
+			for (int side = 0; side < 4; ++side)
+			{
+				for (int t = 0; t < PatchVertexCount; ++t)
+					compactVertices[PatchSkirtIndex(side, t)] = compactVertices[PatchSideIndex(side, t)];
+			}
 		}
 	}
-	
-	//
-	// Create the indices.
-	//
 
-	uint32_t faceCount = (imageWidth - 1) * (imageLength - 1) * 2;
+	BuildLodIndices(indices);
 
-	// Iterate over each quad and compute indices.
-	uint32_t k = 0;
-	for (uint32_t i = 0; i < imageLength - 1; ++i)
+	mNodes.clear();
+	if (mPatches.empty())
+		return;
+	mNodes.assign(1, QuadTreeNode());
+	BuildQuadTree(0, 0, 0, mNumPatchesX, mNumPatchesZ);
+}
+
+// 치마 사각형 : 지형 면 삼각형의 가장자리 변 u -> v를 뒤집은 v -> u를 윗변으로 하면 바깥을 향한다.
+static void AddSkirtQuad(std::vector<uint16_t>& indices, int side, int tu, int tv)
+{
+	uint16_t u = (uint16_t)PatchSideIndex(side, tu);
+	uint16_t v = (uint16_t)PatchSideIndex(side, tv);
+	indices.push_back(v);
+	indices.push_back(u);
+	indices.push_back((uint16_t)PatchSkirtIndex(side, tu));
+	indices.push_back(v);
+	indices.push_back((uint16_t)PatchSkirtIndex(side, tu));
+	indices.push_back((uint16_t)PatchSkirtIndex(side, tv));
+}
+
+void Terrain::BuildLodIndices(std::vector<uint16_t>& indices)
+{
+	// 인덱스는 조각 안 정점 번호이므로 조각 크기만 16비트에 들어가면 된다.
+	static_assert(NumPatchVertices <= 65536, "terrain patch indices must fit in 16 bits");
+
+	indices.clear();
+	for (int lod = 0; lod < NumLods; ++lod)
 	{
-		for (uint32_t j = 0; j < imageWidth - 1; ++j)
+		int step = 1 << lod;
+		mLodBaseIndices[lod] = (UINT)indices.size();
+
+		// 한 장 격자와 같은 대각선과 감김 순서
+		for (int i = 0; i < PatchQuads; i += step)
 		{
-			indices[k] = i * imageWidth + j;
-			indices[k + 1] = i * imageWidth + j + 1;
-			indices[k + 2] = (i + 1) * imageWidth + j;
+			for (int j = 0; j < PatchQuads; j += step)
+			{
+				indices.push_back((uint16_t)PatchGridIndex(i, j));
+				indices.push_back((uint16_t)PatchGridIndex(i, j + step));
+				indices.push_back((uint16_t)PatchGridIndex(i + step, j));
 
-			indices[k + 3] = (i + 1) * imageWidth + j;
-			indices[k + 4] = i * imageWidth + j + 1;
-			indices[k + 5] = (i + 1) * imageWidth + j + 1;
+				indices.push_back((uint16_t)PatchGridIndex(i + step, j));
+				indices.push_back((uint16_t)PatchGridIndex(i, j + step));
+				indices.push_back((uint16_t)PatchGridIndex(i + step, j + step));
+			}
+		}
 
-			k += 6; // next quad
+		// 각 변에서 지형 면 삼각형이 지나는 방향 : 위 (0, t) -> (0, t + step), 아래 (n, t + step) -> (n, t),
+		// 왼쪽 (t + step, 0) -> (t, 0), 오른쪽 (t, n) -> (t + step, n)
+		for (int t = 0; t < PatchQuads; t += step)
+		{
+			AddSkirtQuad(indices, 0, t, t + step);
+			AddSkirtQuad(indices, 1, t + step, t);
+			AddSkirtQuad(indices, 2, t + step, t);
+			AddSkirtQuad(indices, 3, t, t + step);
+		}
+		mLodNumIndices[lod] = (UINT)indices.size() - mLodBaseIndices[lod];
+	}
+}
+
+void Terrain::ComputeLodErrors(const Vertex* patchVertices, TerrainPatch& patch)
+{
+	// LOD의 칸 하나를 덮는 두 삼각형의 높이를 원래 격자 정점마다 구해 차의 최댓값을 오차로 쓴다.
+	auto height = [patchVertices](int row, int column) { return patchVertices[PatchGridIndex(row, column)].Pos.y; };
+
+	patch.lodErrors[0] = 0.0f;
+	for (int lod = 1; lod < NumLods; ++lod)
+	{
+		int step = 1 << lod;
+		float invStep = 1.0f / step;
+		float error = patch.lodErrors[lod - 1];
+		for (int i = 0; i < PatchQuads; i += step)
+		{
+			for (int j = 0; j < PatchQuads; j += step)
+			{
+				float h00 = height(i, j), h01 = height(i, j + step);
+				float h10 = height(i + step, j), h11 = height(i + step, j + step);
+				for (int a = 0; a <= step; ++a)
+				{
+					for (int b = 0; b <= step; ++b)
+					{
+						float u = b * invStep;
+						float v = a * invStep;
+						float h = (a + b <= step) ? h00 + (h01 - h00) * u + (h10 - h00) * v
+							: h11 + (h10 - h11) * (1.0f - u) + (h01 - h11) * (1.0f - v);
+						error = std::max<float>(error, fabsf(height(i + a, j + b) - h));
+					}
+				}
+			}
 		}
+		patch.lodErrors[lod] = error;
+	}
+}
+
+void Terrain::BuildQuadTree(int node, int x0, int z0, int x1, int z1)
+{
+	if (x1 - x0 == 1 && z1 - z0 == 1) {
+		mNodes[node].patch = z0 * mNumPatchesX + x0;
+		mNodes[node].bounds = mPatches[mNodes[node].patch].bounds;
+		return;
 	}
 
-	return;
+	// 긴 쪽이 1이 될 때까지 반으로 나눈다. 한 변이 1이면 자식은 둘이다.
+	int xs[3] = { x0, x0 + (x1 - x0 + 1) / 2, x1 };
+	int zs[3] = { z0, z0 + (z1 - z0 + 1) / 2, z1 };
+	int numX = (x1 - x0 > 1) ? 2 : 1;
+	int numZ = (z1 - z0 > 1) ? 2 : 1;
+	if (numX == 1)
+		xs[1] = x1;
+	if (numZ == 1)
+		zs[1] = z1;
+
+	int firstChild = (int)mNodes.size();
+	mNodes[node].firstChild = firstChild;
+	mNodes[node].numChildren = numX * numZ;
+	mNodes.resize(firstChild + numX * numZ);
+
+	for (int cz = 0; cz < numZ; ++cz)
+	{
+		for (int cx = 0; cx < numX; ++cx)
+			BuildQuadTree(firstChild + cz * numX + cx, xs[cx], zs[cz], xs[cx + 1], zs[cz + 1]);
+	}
+
+	BoundingBox bounds = mNodes[firstChild].bounds;
+	for (int child = 1; child < numX * numZ; ++child)
+		BoundingBox::CreateMerged(bounds, bounds, mNodes[firstChild + child].bounds);
+	mNodes[node].bounds = bounds;
+}
+
+void Terrain::SetGroundGrid(float width, float length)
+{
+	// CreateGridVertices와 같은 배치 : (0, 0) 정점이 (-width / 2, length / 2), 열은 +x, 행은 -z 방향
+	mOrigin = XMFLOAT2(-0.5f * width, 0.5f * length);
+	mGridSpacing = XMFLOAT2(width / (mImageWidth - 1), -length / (mImageLength - 1));
+	mTexSpacing = XMFLOAT2(1.0f / (mImageWidth - 1), 1.0f / (mImageLength - 1));
+
+	std::lock_guard<std::mutex> lock(mGroundMutex);
+	mNumGroundBlocksX = (mImageWidth - 1 + GroundBlockQuads - 1) / GroundBlockQuads;
+	mGroundBlocks.assign(MaxGroundBlocks, GroundBlock());
+	mGroundBlockSlots.clear();
+	mGroundBlockSlots.reserve(MaxGroundBlocks);
+	mLastGroundSlot = -1;
+	mGroundUseCounter = 0;
+	mNumGroundBlockLoads = 0;
+}
+
+const float* Terrain::LockedGetGroundBlock(int blockX, int blockZ)
+{
+	int index = blockZ * mNumGroundBlocksX + blockX;
+	++mGroundUseCounter;
+
+	if (mLastGroundSlot >= 0 && mGroundBlocks[mLastGroundSlot].index == index) {
+		mGroundBlocks[mLastGroundSlot].lastUse = mGroundUseCounter;
+		return mGroundBlocks[mLastGroundSlot].heights.data();
+	}
+
+	auto found = mGroundBlockSlots.find(index);
+	if (found != mGroundBlockSlots.end()) {
+		mLastGroundSlot = found->second;
+		mGroundBlocks[mLastGroundSlot].lastUse = mGroundUseCounter;
+		return mGroundBlocks[mLastGroundSlot].heights.data();
+	}
+
+	// 빈 자리가 있으면 쓰고, 없으면 가장 오래 안 쓴 블록을 버린다. (HeightMapImage의 타일 캐시와 같다.)
+	int slot = 0;
+	for (int i = 1; i < (int)mGroundBlocks.size() && mGroundBlocks[slot].index >= 0; ++i)
+	{
+		if (mGroundBlocks[i].index < 0 || mGroundBlocks[i].lastUse < mGroundBlocks[slot].lastUse)
+			slot = i;
+	}
+
+	GroundBlock& block = mGroundBlocks[slot];
+	if (block.index >= 0)
+		mGroundBlockSlots.erase(block.index);
+	block.index = index;
+	block.lastUse = mGroundUseCounter;
+	block.heights.resize((GroundBlockQuads + 1) * (GroundBlockQuads + 1));
+	ComputeGroundBlock(blockX, blockZ, block.heights.data());
+
+	mGroundBlockSlots[index] = slot;
+	mLastGroundSlot = slot;
+	++mNumGroundBlockLoads;
+	return block.heights.data();
+}
+
+void Terrain::ComputeGroundBlock(int blockX, int blockZ, float* heights)
+{
+	const int stride = GroundBlockQuads + 1;
+	const int radius = SmoothingRadius;
+	const int x0 = blockX * GroundBlockQuads;
+	const int z0 = blockZ * GroundBlockQuads;
+	const int x1 = std::min<int>(x0 + GroundBlockQuads, mImageWidth - 1);		// 블록의 마지막 열/행
+	const int z1 = std::min<int>(z0 + GroundBlockQuads, mImageLength - 1);
+
+	// 블록과 둘레 radius줄의 높이 맵 표본을 행 단위로 읽는다.
+	const int rawX0 = std::max<int>(x0 - radius, 0);
+	const int rawZ0 = std::max<int>(z0 - radius, 0);
+	const int rawX1 = std::min<int>(x1 + radius, mImageWidth - 1);
+	const int rawZ1 = std::min<int>(z1 + radius, mImageLength - 1);
+	const int numRawColumns = rawX1 - rawX0 + 1;
+	std::vector<float> raw((size_t)(rawZ1 - rawZ0 + 1) * numRawColumns);
+	for (int z = rawZ0; z <= rawZ1; ++z)
+		mHeightImage.GetHeightRow(rawX0, z, numRawColumns, &raw[(size_t)(z - rawZ0) * numRawColumns]);
+	auto rawAt = [&](int z, int x) { return raw[(size_t)(z - rawZ0) * numRawColumns + (x - rawX0)]; };
+
+	for (int z = z0; z <= z1; ++z)
+		for (int x = x0; x <= x1; ++x)
+			heights[(z - z0) * stride + (x - x0)] = rawAt(z, x);
+
+	// SmoothGridVertices와 같은 구간과 같은 덧셈 순서 : 가로는 창을 미는 double 누적 합, 세로는 위 행부터 float로 더한다.
+	const int firstSample = radius;
+	const int lastSampleColumn = mImageWidth - 1 - radius;
+	const int lastSampleRow = mImageLength - 1 - radius;
+	if (lastSampleColumn < firstSample || lastSampleRow < firstSample)
+		return;
+	const int firstColumn = std::max<int>(x0, firstSample - 1);
+	const int lastColumn = std::min<int>(x1, lastSampleColumn + 1);
+	const int firstRow = std::max<int>(z0, firstSample - 1);
+	const int lastRow = std::min<int>(z1, lastSampleRow + 1);
+	if (lastColumn < firstColumn || lastRow < firstRow)
+		return;
+
+	const int firstSumRow = std::max<int>(firstRow - radius, firstSample);
+	const int lastSumRow = std::min<int>(lastRow + radius, lastSampleRow);
+	const int numColumns = lastColumn - firstColumn + 1;
+	std::vector<float> rowSums((size_t)(lastSumRow - firstSumRow + 1) * numColumns);
+	for (int z = firstSumRow; z <= lastSumRow; ++z)
+	{
+		double sum = 0.0;
+		int a = std::max<int>(firstColumn - radius, firstSample);		// 창 [a, b]
+		int b = a - 1;
+		for (int x = firstColumn; x <= lastColumn; ++x)
+		{
+			for (int last = std::min<int>(x + radius, lastSampleColumn); b < last; )
+				sum += rawAt(z, ++b);
+			for (int first = std::max<int>(x - radius, firstSample); a < first; )
+				sum -= rawAt(z, a++);
+			rowSums[(size_t)(z - firstSumRow) * numColumns + (x - firstColumn)] = (float)sum;
+		}
+	}
+
+	std::vector<float> invColumnCounts(numColumns);
+	for (int x = firstColumn; x <= lastColumn; ++x)
+		invColumnCounts[x - firstColumn] = 1.0f / (std::min<int>(x + radius, lastSampleColumn) - std::max<int>(x - radius, firstSample) + 1);
+
+	std::vector<float> sums(numColumns);
+	for (int z = firstRow; z <= lastRow; ++z)
+	{
+		const int a = std::max<int>(z - radius, firstSample);
+		const int b = std::min<int>(z + radius, lastSampleRow);
+		const float invRowCount = 1.0f / (b - a + 1);
+		std::copy_n(&rowSums[(size_t)(a - firstSumRow) * numColumns], numColumns, sums.begin());
+		for (int r = a + 1; r <= b; ++r)
+		{
+			const float* rowSum = &rowSums[(size_t)(r - firstSumRow) * numColumns];
+			for (int j = 0; j < numColumns; ++j)
+				sums[j] += rowSum[j];
+		}
+		for (int j = 0; j < numColumns; ++j)
+			heights[(z - z0) * stride + (firstColumn + j - x0)] = sums[j] * invColumnCounts[j] * invRowCount;
+	}
+}
+
+// 지면 높이 질의의 float 벡터 (PoseKernel과 같이 AVX2로 빌드하면 8개, 아니면 SSE 4개)
+// AVX2는 묶음이 한 블록 안에 있으면 네 모서리 높이를 gather 명령으로 모으고, 아니면(SSE도) 격자 번호를 꺼내 하나씩 모은다.
+namespace
+{
+	constexpr int GroundBlockStride = Terrain::GroundBlockQuads + 1;
+
+#if defined(__AVX2__)
+	constexpr int GroundQueryWidth = 8;
+	using GroundV = __m256;
+
+	inline GroundV Load(const float* p) { return _mm256_load_ps(p); }
+	inline void Store(float* p, GroundV v) { _mm256_store_ps(p, v); }
+	inline GroundV Set(float f) { return _mm256_set1_ps(f); }
+	inline GroundV Add(GroundV a, GroundV b) { return _mm256_add_ps(a, b); }
+	inline GroundV Sub(GroundV a, GroundV b) { return _mm256_sub_ps(a, b); }
+	inline GroundV Mul(GroundV a, GroundV b) { return _mm256_mul_ps(a, b); }
+	inline GroundV Div(GroundV a, GroundV b) { return _mm256_div_ps(a, b); }
+	inline GroundV Sqrt(GroundV a) { return _mm256_sqrt_ps(a); }
+	inline GroundV Min(GroundV a, GroundV b) { return _mm256_min_ps(a, b); }
+	inline GroundV Max(GroundV a, GroundV b) { return _mm256_max_ps(a, b); }
+	inline GroundV Greater(GroundV a, GroundV b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	inline GroundV Select(GroundV a, GroundV b, GroundV mask) { return _mm256_blendv_ps(a, b, mask); }	// mask ? b : a
+	// a >= 0의 정수 부분
+	inline GroundV Truncate(GroundV a) { return _mm256_cvtepi32_ps(_mm256_cvttps_epi32(a)); }
+#else
+	constexpr int GroundQueryWidth = 4;
+	using GroundV = __m128;
+
+	inline GroundV Load(const float* p) { return _mm_load_ps(p); }
+	inline void Store(float* p, GroundV v) { _mm_store_ps(p, v); }
+	inline GroundV Set(float f) { return _mm_set1_ps(f); }
+	inline GroundV Add(GroundV a, GroundV b) { return _mm_add_ps(a, b); }
+	inline GroundV Sub(GroundV a, GroundV b) { return _mm_sub_ps(a, b); }
+	inline GroundV Mul(GroundV a, GroundV b) { return _mm_mul_ps(a, b); }
+	inline GroundV Div(GroundV a, GroundV b) { return _mm_div_ps(a, b); }
+	inline GroundV Sqrt(GroundV a) { return _mm_sqrt_ps(a); }
+	inline GroundV Min(GroundV a, GroundV b) { return _mm_min_ps(a, b); }
+	inline GroundV Max(GroundV a, GroundV b) { return _mm_max_ps(a, b); }
+	inline GroundV Greater(GroundV a, GroundV b) { return _mm_cmpgt_ps(a, b); }
+	inline GroundV Select(GroundV a, GroundV b, GroundV mask) { return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b)); }	// mask ? b : a
+	inline GroundV Truncate(GroundV a) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(a)); }
+#endif
+
+	// 블록 안 칸 (row, column)의 네 모서리 : a (row, column), b (row, column + 1), c (row + 1, column), d (row + 1, column + 1)
+	// blocks[i]는 i번째 점이 놓인 블록의 높이
+	inline void GatherCorners(const float* const* blocks, GroundV row, GroundV column, GroundV& a, GroundV& b, GroundV& c, GroundV& d)
+	{
+		constexpr int W = GroundQueryWidth;
+#if defined(__AVX2__)
+		bool sameBlock = true;
+		for (int i = 1; i < W; ++i)
+			sameBlock = sameBlock && blocks[i] == blocks[0];
+		if (sameBlock) {
+			const float* ground = blocks[0];
+			__m256i index = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvttps_epi32(row), _mm256_set1_epi32(GroundBlockStride)), _mm256_cvttps_epi32(column));
+			a = _mm256_i32gather_ps(ground, index, 4);
+			b = _mm256_i32gather_ps(ground + 1, index, 4);
+			c = _mm256_i32gather_ps(ground + GroundBlockStride, index, 4);
+			d = _mm256_i32gather_ps(ground + GroundBlockStride + 1, index, 4);
+			return;
+		}
+#endif
+		alignas(32) float rows[W], columns[W], as[W], bs[W], cs[W], ds[W];
+		Store(rows, row);
+		Store(columns, column);
+		for (int i = 0; i < W; ++i)
+		{
+			const float* p = blocks[i] + (int)rows[i] * GroundBlockStride + (int)columns[i];
+			as[i] = p[0];
+			bs[i] = p[1];
+			cs[i] = p[GroundBlockStride];
+			ds[i] = p[GroundBlockStride + 1];
+		}
+		a = Load(as);
+		b = Load(bs);
+		c = Load(cs);
+		d = Load(ds);
+	}
+}
+
+void Terrain::GetGroundHeights(const XMFLOAT2* points, UINT numPoints, float* heights, XMFLOAT3* normals)
+{
+	if (mGroundBlocks.empty() || mImageWidth < 2 || mImageLength < 2) {
+		for (UINT p = 0; p < numPoints; ++p)
+		{
+			heights[p] = 0.0f;
+			if (normals)
+				normals[p] = XMFLOAT3(0.0f, 1.0f, 0.0f);
+		}
+		return;
+	}
+
+	const int W = GroundQueryWidth;
+	const GroundV zero = Set(0.0f), one = Set(1.0f);
+	const GroundV originX = Set(mOrigin.x), originZ = Set(mOrigin.y);
+	const GroundV invSpacingX = Set(1.0f / mGridSpacing.x), invSpacingZ = Set(1.0f / mGridSpacing.y);
+	const GroundV lastColumn = Set((float)(mImageWidth - 1)), lastRow = Set((float)(mImageLength - 1));
+	const GroundV lastCellColumn = Set((float)(mImageWidth - 2)), lastCellRow = Set((float)(mImageLength - 2));
+	const GroundV blockQuads = Set((float)GroundBlockQuads), invBlockQuads = Set(1.0f / GroundBlockQuads);
+	// 칸 하나당 높이 차(gu, gv) -> 법선 (-gu / dx, 1, -gv / gz)를 정규화
+	const GroundV slopeX = Set(-1.0f / mGridSpacing.x), slopeZ = Set(-1.0f / mGridSpacing.y);
+
+	// 묶음의 블록 포인터를 모서리를 모을 때까지 쓰므로 질의 전체를 한 번 잠근다.
+	// 캐시가 묶음 폭보다 커서 한 묶음에서 올린 블록은 그 묶음 안에서 버려지지 않는다.
+	static_assert(MaxGroundBlocks > GroundQueryWidth, "a query batch must fit in the ground block cache");
+	std::lock_guard<std::mutex> lock(mGroundMutex);
+
+	alignas(32) float xs[W], zs[W], ys[W], nxs[W], nys[W], nzs[W], blockXs[W], blockZs[W];
+	const float* blocks[W];
+	for (UINT first = 0; first < numPoints; first += W)
+	{
+		// 마지막 묶음은 남은 마지막 점으로 채운다.
+		const UINT count = std::min<UINT>(W, numPoints - first);
+		for (int i = 0; i < W; ++i)
+		{
+			const XMFLOAT2& point = points[first + std::min<UINT>(i, count - 1)];
+			xs[i] = point.x;
+			zs[i] = point.y;
+		}
+
+		// 격자 좌표 (범위 밖은 가장자리), 마지막 행/열은 그 앞 칸의 끝(u, v = 1)으로 본다.
+		GroundV column = Min(Max(Mul(Sub(Load(xs), originX), invSpacingX), zero), lastColumn);
+		GroundV row = Min(Max(Mul(Sub(Load(zs), originZ), invSpacingZ), zero), lastRow);
+		GroundV cellColumn = Min(Truncate(column), lastCellColumn);
+		GroundV cellRow = Min(Truncate(row), lastCellRow);
+		GroundV u = Sub(column, cellColumn);
+		GroundV v = Sub(row, cellRow);
+
+		// 칸이 놓인 블록과 블록 안 칸 (GroundBlockQuads는 2의 거듭제곱이므로 곱셈이 정확하다.)
+		GroundV blockColumn = Truncate(Mul(cellColumn, invBlockQuads));
+		GroundV blockRow = Truncate(Mul(cellRow, invBlockQuads));
+		Store(blockXs, blockColumn);
+		Store(blockZs, blockRow);
+		for (int i = 0; i < W; ++i)
+		{
+			// 이웃한 점은 대개 같은 블록이다.
+			if (i > 0 && blockXs[i] == blockXs[i - 1] && blockZs[i] == blockZs[i - 1])
+				blocks[i] = blocks[i - 1];
+			else
+				blocks[i] = LockedGetGroundBlock((int)blockXs[i], (int)blockZs[i]);
+		}
+
+		GroundV a, b, c, d;
+		GatherCorners(blocks, Sub(cellRow, Mul(blockRow, blockQuads)), Sub(cellColumn, Mul(blockColumn, blockQuads)), a, b, c, d);
+
+		// 한 장 격자와 같은 대각선 b - c : u + v <= 1이면 삼각형 (a, b, c), 아니면 (c, b, d)
+		GroundV lower = Greater(Add(u, v), one);
+		GroundV base = Select(a, d, lower);
+		GroundV gu = Select(Sub(b, a), Sub(d, c), lower);
+		GroundV gv = Select(Sub(c, a), Sub(d, b), lower);
+		GroundV du = Select(u, Sub(u, one), lower);
+		GroundV dv = Select(v, Sub(v, one), lower);
+		Store(ys, Add(base, Add(Mul(du, gu), Mul(dv, gv))));
+		std::copy(ys, ys + count, heights + first);
+
+		if (normals) {
+			GroundV nx = Mul(gu, slopeX);
+			GroundV nz = Mul(gv, slopeZ);
+			GroundV invLength = Div(one, Sqrt(Add(Add(Mul(nx, nx), Mul(nz, nz)), one)));
+			Store(nxs, Mul(nx, invLength));
+			Store(nys, invLength);
+			Store(nzs, Mul(nz, invLength));
+			for (UINT i = 0; i < count; ++i)
+				normals[first + i] = XMFLOAT3(nxs[i], nys[i], nzs[i]);
+		}
+	}
+}
+
+float Terrain::GetGroundHeight(float x, float z, XMFLOAT3* normal)
+{
+	XMFLOAT2 point(x, z);
+	float height;
+	GetGroundHeights(&point, 1, &height, normal);
+	return height;
+}
+
+UINT Terrain::SelectPatches(const XMFLOAT3& eye, const BoundingFrustum* frustum, float projScale, float pixelError, std::vector<TerrainPatchDraw>& draws) const
+{
+	draws.clear();
+	if (mNodes.empty())
+		return 0;
+
+	// 깊이 우선으로 훑는다. 한 단계에 자식 4개까지 쌓이므로 스택은 3 * 깊이 + 1이면 된다.
+	int stack[128];
+	int top = 0;
+	stack[top++] = 0;
+
+	UINT numIndices = 0;
+	while (top > 0)
+	{
+		const QuadTreeNode& node = mNodes[stack[--top]];
+		if (frustum && frustum->Contains(node.bounds) == DISJOINT)
+			continue;
+
+		if (node.patch < 0) {
+			for (int child = node.numChildren - 1; child >= 0; --child)
+				stack[top++] = node.firstChild + child;
+			continue;
+		}
+
+		// 화면 오차 = 높이 오차 * projScale / 거리가 pixelError 이하인 가장 거친 LOD
+		const TerrainPatch& patch = mPatches[node.patch];
+		float distance = DistanceToBox(eye, patch.bounds);
+		UINT lod = 0;
+		for (UINT candidate = NumLods - 1; candidate > 0; --candidate)
+		{
+			if (patch.lodErrors[candidate] * projScale <= pixelError * distance) {
+				lod = candidate;
+				break;
+			}
+		}
+
+		draws.push_back({ (UINT)node.patch, lod });
+		numIndices += mLodNumIndices[lod];
+	}
+	return numIndices / 3;
+}
+
+Submesh Terrain::GetPatchSubmesh(const TerrainPatchDraw& draw) const
+{
+	Submesh submesh;
+	submesh.name = "terrainPatch";
+	submesh.baseVertex = mPatches[draw.patch].baseVertex;
+	submesh.baseIndex = mLodBaseIndices[draw.lod];
+	submesh.numIndices = mLodNumIndices[draw.lod];
+	submesh.bounds = mPatches[draw.patch].bounds;
+	return submesh;
+}
+
+TerrainPatchConstants Terrain::GetPatchConstants(UINT patch) const
+{
+	const TerrainPatch& terrainPatch = mPatches[patch];
+	TerrainPatchConstants constants;
+	constants.Origin = XMFLOAT2(mOrigin.x + terrainPatch.firstColumn * mGridSpacing.x, mOrigin.y + terrainPatch.firstRow * mGridSpacing.y);
+	constants.MinHeight = terrainPatch.minHeight;
+	constants.HeightScale = terrainPatch.heightScale;
+	constants.GridSpacing = mGridSpacing;
+	constants.TexSpacing = mTexSpacing;
+	constants.TexOrigin = XMFLOAT2(terrainPatch.firstColumn * mTexSpacing.x, terrainPatch.firstRow * mTexSpacing.y);
+	constants.LastColumn = (UINT)(mImageWidth - 1 - terrainPatch.firstColumn);
+	constants.LastRow = (UINT)(mImageLength - 1 - terrainPatch.firstRow);
+	constants.SkirtDepth = terrainPatch.skirtDepth;
+	return constants;
+}
+
+XMFLOAT3 Terrain::DecodePosition(UINT patch, UINT vertex, const TerrainVertex& compact) const
+{
+	const TerrainPatch& terrainPatch = mPatches[patch];
+	int index = (int)vertex;
+	int row, column;
+	float depth = 0.0f;
+	if (index < NumPatchGridVertices) {
+		row = index / PatchVertexCount;
+		column = index % PatchVertexCount;
+	}
+	else {
+		int side = (index - NumPatchGridVertices) / PatchVertexCount;
+		int t = (index - NumPatchGridVertices) % PatchVertexCount;
+		row = (side < 2) ? (side == 0 ? 0 : PatchQuads) : t;
+		column = (side < 2) ? t : (side == 2 ? 0 : PatchQuads);
+		depth = terrainPatch.skirtDepth;
+	}
+	column = std::min<int>(terrainPatch.firstColumn + column, mImageWidth - 1);
+	row = std::min<int>(terrainPatch.firstRow + row, mImageLength - 1);
+
+	return XMFLOAT3(mOrigin.x + column * mGridSpacing.x,
+		terrainPatch.minHeight + compact.Height * terrainPatch.heightScale - depth,
+		mOrigin.y + row * mGridSpacing.y);
+}
+
+XMFLOAT3 Terrain::DecodeNormal(const TerrainVertex& compact)
+{
+	float u = std::max<float>(compact.Normal[0] / 127.0f, -1.0f);
+	float v = std::max<float>(compact.Normal[1] / 127.0f, -1.0f);
+	XMFLOAT3 normal(u, 1.0f - fabsf(u) - fabsf(v), v);
+	if (normal.y < 0.0f) {
+		normal.x = (1.0f - fabsf(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+		normal.z = (1.0f - fabsf(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+	}
+	return Vector3::Normalize(normal);
+}
+
+UINT64 Terrain::GetGridByteSize() const
+{
+	UINT64 numVertices = (UINT64)mImageWidth * mImageLength;
+	UINT64 numIndices = (UINT64)(mImageWidth - 1) * (mImageLength - 1) * 6;
+	return numVertices * sizeof(Vertex) + numIndices * sizeof(uint32_t);
+}
+
+float Terrain::DistanceToBox(const XMFLOAT3& eye, const BoundingBox& box)
+{
+	float dx = std::max<float>(fabsf(eye.x - box.Center.x) - box.Extents.x, 0.0f);
+	float dy = std::max<float>(fabsf(eye.y - box.Center.y) - box.Extents.y, 0.0f);
+	float dz = std::max<float>(fabsf(eye.z - box.Center.z) - box.Extents.z, 0.0f);
+	return sqrtf(dx * dx + dy * dy + dz * dz);
 }
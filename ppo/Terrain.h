@@ -2,17 +2,169 @@
 #include "d3dUtil.h"
 #include "HeightMapImage.h"
 #include "FrameResource.h"
+#include "Mesh.h"
+#include "ThreadPool.h"
 
+constexpr int TerrainNumLods = 5;	// 칸 간격 1, 2, 4, 8, 16
+
+// 지형 조각 정점 (4바이트) : 조각의 높이 범위로 양자화한 16비트 높이와 8비트 두 개의 팔면체(octahedral) 법선
+// XZ와 텍스처 좌표는 저장하지 않고 셰이더가 조각 원점과 조각 안 정점 번호(SV_VertexID)로 다시 만든다.
+struct TerrainVertex
+{
+	uint16_t Height;
+	int8_t Normal[2];
+};
+
+// 조각 하나를 그릴 때의 루트 상수 (Terrain.hlsl의 cbTerrainPatch와 같은 배치)
+struct TerrainPatchConstants
+{
+	XMFLOAT2 Origin;		// 조각 (0, 0) 정점의 XZ
+	float MinHeight;
+	float HeightScale;		// 높이 = MinHeight + Height * HeightScale
+	XMFLOAT2 GridSpacing;	// 열 하나, 행 하나만큼의 XZ 변화 (행은 -z 방향)
+	XMFLOAT2 TexSpacing;
+	XMFLOAT2 TexOrigin;
+	UINT LastColumn;		// 높이 맵 끝에서 잘린 조각은 이 열/행 뒤의 정점이 끝 열/행을 반복한다.
+	UINT LastRow;
+	float SkirtDepth;
+};
+
+// 지형 조각 하나 : PatchVertexCount x PatchVertexCount 격자 정점 뒤에 네 변의 치마(skirt) 정점이 붙는다.
+struct TerrainPatch
+{
+	BoundingBox bounds;			// 치마를 뺀 지형 면의 AABB (지형 공간, 양자화한 높이 기준)
+	UINT baseVertex = 0;
+	float lodErrors[TerrainNumLods] = {};	// LOD별로 원래 격자와의 최대 높이 차, 거친 LOD일수록 크거나 같다.
+	float skirtDepth = 0.0f;
+	int firstColumn = 0;		// 조각 (0, 0) 정점의 높이 맵 열/행
+	int firstRow = 0;
+	float minHeight = 0.0f;
+	float heightScale = 0.0f;
+};
+
+// 이번 프레임에 그릴 조각과 LOD
+struct TerrainPatchDraw
+{
+	UINT patch = 0;
+	UINT lod = 0;
+};
+
+// 높이 맵을 고정 크기 조각의 쿼드트리로 나눈 지형
+// 조각은 모두 같은 정점 배치이므로 LOD마다 인덱스 목록 하나를 모든 조각이 함께 쓰고, 조각은 baseVertex로만 구분한다.
+// 이웃 조각의 LOD가 달라 생기는 틈은 조각 가장자리에서 아래로 내린 치마가 가린다. 치마 깊이는 그 조각의 가장 거친 LOD 오차보다 깊다.
 class Terrain
 {
 public:
+	static constexpr int PatchQuads = 64;								// 조각 한 변의 칸 수
+	static constexpr int PatchVertexCount = PatchQuads + 1;
+	static constexpr int NumPatchGridVertices = PatchVertexCount * PatchVertexCount;
+	static constexpr int NumPatchVertices = NumPatchGridVertices + 4 * PatchVertexCount;
+	static constexpr int NumLods = TerrainNumLods;
+
 	Terrain();
 	~Terrain();
 
-	void LoadHeightMap(const wchar_t* fileName, int width, int length, float scale);
-	void CreateTerrain(float width, float length, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+	// 파일이 width x length보다 작으면 false (HeightMapImage::LoadHeightMapImage)
+	bool LoadHeightMap(const wchar_t* fileName, int width, int length, float scale);
+	// 높이 맵 전체를 한 장의 격자로 만든다. (정점은 높이와 법선을 평탄화한 값)
+	// threadPool은 평탄화에 쓴다. ThreadPool 작업 안에서 부를 때는 ParallelFor를 겹쳐 부를 수 없으므로 nullptr로 둔다.
+	void CreateTerrain(float width, float length, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, ThreadPool* threadPool = nullptr);
+	// 조각 순서의 압축 정점과 LOD 순서의 16비트 공유 인덱스를 만들고 조각의 AABB, LOD 오차, 쿼드트리를 준비한다.
+	void CreatePatches(float width, float length, std::vector<TerrainVertex>& vertices, std::vector<uint16_t>& indices, ThreadPool* threadPool = nullptr);
+
+	// 높이 맵 그대로의 격자 정점 (평탄화 전)
+	void CreateGridVertices(float width, float length, std::vector<Vertex>& vertices);
+	// 높이와 법선을 (2 SmoothingRadius + 1)^2 상자 필터로 평탄화한다. 바깥 SmoothingRadius - 1줄은 그대로 두고,
+	// 표본은 바깥 SmoothingRadius줄을 뺀 안쪽에서만 읽는다. (법선은 합을 정규화한다.)
+	// 원래 정점만 읽고 결과를 따로 모았다가 쓰므로 행 순서와 스레드 수에 관계없이 같은 결과를 낸다.
+	// 가로는 행마다 창을 미는 누적 합으로, 세로는 창 안 행의 가로 합을 더한다. 높이와 법선 네 값을 SSE 레지스터 하나로 함께 처리한다. threadPool이 있으면 두 단계를 행 묶음으로 나눠 돌린다.
+	static void SmoothGridVertices(std::vector<Vertex>& vertices, int imageWidth, int imageLength, ThreadPool* threadPool = nullptr);
+	static constexpr int SmoothingRadius = 3;
+
+	// 쿼드트리를 따라 frustum(nullptr이면 컬링하지 않는다)과 겹치는 조각을 모으고, 조각마다 화면 오차가 pixelError 이하인 가장 거친 LOD를 고른다.
+	// eye와 frustum은 지형 공간, projScale = 뷰포트 높이 / (2 tan(fovY / 2)). 선택한 삼각형 수(치마 포함)를 반환한다.
+	UINT SelectPatches(const XMFLOAT3& eye, const BoundingFrustum* frustum, float projScale, float pixelError, std::vector<TerrainPatchDraw>& draws) const;
+
+	// 조각 하나를 그리는 DrawIndexedInstanced 매개변수
+	// 셰이더가 SV_VertexID를 조각 안 정점 번호로 쓰므로 baseVertex는 정점 버퍼 뷰의 시작 위치로 옮기고 BaseVertexLocation은 0으로 그린다.
+	Submesh GetPatchSubmesh(const TerrainPatchDraw& draw) const;
+	TerrainPatchConstants GetPatchConstants(UINT patch) const;
+	// 셰이더와 같은 방법으로 조각의 vertex번째 정점을 푼다.
+	XMFLOAT3 DecodePosition(UINT patch, UINT vertex, const TerrainVertex& compact) const;
+	static XMFLOAT3 DecodeNormal(const TerrainVertex& compact);
+	UINT GetLodNumIndices(UINT lod) const { return mLodNumIndices[lod]; }
+	const std::vector<TerrainPatch>& GetPatches() const { return mPatches; }
+
+	// 높이 맵 전체를 한 장 격자(Vertex, 32비트 인덱스)로 올릴 때의 정점과 인덱스 바이트 수 (CreatePatches 뒤에 쓴다.)
+	UINT64 GetGridByteSize() const;
+	int GetImageWidth() const { return mImageWidth; }
+	int GetImageLength() const { return mImageLength; }
+
+	// eye에서 box까지의 거리 (안에 있으면 0)
+	static float DistanceToBox(const XMFLOAT3& eye, const BoundingBox& box);
 
-	HeightMapImage GetHeightMapImage() { return mHeightImage; }
+	// 지형 공간 XZ 점(x, z) numPoints개의 지면 높이와 면 법선을 한꺼번에 구한다. (CreateTerrain이나 CreatePatches 뒤에 쓴다.)
+	// 높이는 LOD 0으로 그리는 면, 곧 평탄화한 격자를 한 장 격자와 같은 대각선으로 나눈 삼각형 위의 값이다. (압축 정점의 양자화 오차는 빼고)
+	// 범위 밖의 점은 가장자리로 옮겨 구한다. AVX2로 빌드하면 8개, 아니면 4개씩 네 모서리를 모아(gather) 처리한다.
+	// 평탄화한 높이는 지면 블록 캐시에서 읽으므로 const가 아니다. 가까운 점끼리 모아 부를수록 블록을 덜 다시 만든다.
+	void GetGroundHeights(const XMFLOAT2* points, UINT numPoints, float* heights, XMFLOAT3* normals = nullptr);
+	float GetGroundHeight(float x, float z, XMFLOAT3* normal = nullptr);
+
+	// 지면 블록 : GroundBlockQuads x GroundBlockQuads 칸의 평탄화한 높이 (GroundBlockQuads + 1)^2개
+	// 격자 전체를 들고 있지 않고 높이 맵 타일처럼 필요할 때 높이 맵에서 다시 평탄화해 LRU 캐시에 둔다.
+	static constexpr int GroundBlockQuads = 64;
+	static constexpr int MaxGroundBlocks = 64;		// 블록 하나 약 16.5KB, 약 1MB
+	// 만든 지면 블록 수 (벤치마크용)
+	UINT64 GetNumGroundBlockLoads() const { return mNumGroundBlockLoads; }
+
+	// 높이 맵은 타일 캐시를 바꾸며 읽으므로 const가 아니다. (복사할 수 없다.)
+	HeightMapImage& GetHeightMapImage() { return mHeightImage; }
 private:
+	struct QuadTreeNode
+	{
+		BoundingBox bounds;
+		int firstChild = -1;	// 자식은 firstChild부터 numChildren개
+		int numChildren = 0;
+		int patch = -1;			// 잎이면 조각 번호
+	};
+
+	void BuildLodIndices(std::vector<uint16_t>& indices);
+	// patchVertices : 조각의 격자 정점
+	void ComputeLodErrors(const Vertex* patchVertices, TerrainPatch& patch);
+	// 조각 [x0, x1) x [z0, z1)를 덮는 node를 채우고 자식을 이어서 만든다.
+	void BuildQuadTree(int node, int x0, int z0, int x1, int z1);
+	// 지형 공간 -> 격자 변환을 정하고 지면 블록 캐시를 비운다.
+	void SetGroundGrid(float width, float length);
+
+	struct GroundBlock
+	{
+		int index = -1;			// blockZ * mNumGroundBlocksX + blockX, 비었으면 -1
+		UINT64 lastUse = 0;
+		std::vector<float> heights;	// (GroundBlockQuads + 1)^2, 높이 맵 끝의 블록은 앞부분만 쓴다.
+	};
+	// 잠근 상태에서 부른다. 블록 (blockX, blockZ)를 캐시에 올리고 그 높이를 반환한다.
+	const float* LockedGetGroundBlock(int blockX, int blockZ);
+	// SmoothGridVertices와 같은 규칙으로 블록의 높이를 평탄화한다.
+	void ComputeGroundBlock(int blockX, int blockZ, float* heights);
+
 	HeightMapImage mHeightImage;
+
+	std::vector<TerrainPatch> mPatches;		// 행(z) 우선 순서
+	int mNumPatchesX = 0;
+	int mNumPatchesZ = 0;
+	XMFLOAT2 mOrigin = XMFLOAT2(0.0f, 0.0f);		// 높이 맵 (0, 0) 정점의 XZ
+	XMFLOAT2 mGridSpacing = XMFLOAT2(0.0f, 0.0f);
+	XMFLOAT2 mTexSpacing = XMFLOAT2(0.0f, 0.0f);
+	int mImageWidth = 0;
+	int mImageLength = 0;
+	int mNumGroundBlocksX = 0;
+	std::mutex mGroundMutex;
+	std::vector<GroundBlock> mGroundBlocks;
+	std::unordered_map<int, int> mGroundBlockSlots;	// 블록 번호 -> mGroundBlocks 자리
+	int mLastGroundSlot = -1;
+	UINT64 mGroundUseCounter = 0;
+	UINT64 mNumGroundBlockLoads = 0;
+	std::vector<QuadTreeNode> mNodes;		// mNodes[0]이 뿌리
+	UINT mLodBaseIndices[NumLods] = {};
+	UINT mLodNumIndices[NumLods] = {};
 };
@@ -0,0 +1,91 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int numWorkers)
+{
+    if (numWorkers == 0) {
+        unsigned int hardwareThreads = thread::hardware_concurrency();
+        numWorkers = (hardwareThreads > 1) ? hardwareThreads - 1 : 0;
+    }
+
+    for (unsigned int i = 0; i < numWorkers; i++)
+        mWorkers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWakeCondition.notify_all();
+
+    for (thread& worker : mWorkers)
+        worker.join();
+}
+
+void ThreadPool::ParallelFor(int count, int grainSize, const function<void(int, int)>& func)
+{
+    if (count <= 0)
+        return;
+
+    grainSize = max(grainSize, 1);
+
+    // 나눌 만큼 일이 많지 않으면 호출 스레드에서 바로 처리한다.
+    if (mWorkers.empty() || count <= grainSize) {
+        func(0, count);
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        mFunc = &func;
+        mCount = count;
+        mGrainSize = grainSize;
+        mNextIndex = 0;
+        mNumActiveWorkers = (int)mWorkers.size();
+        mGeneration++;
+    }
+    mWakeCondition.notify_all();
+
+    RunChunks();
+
+    // 모든 작업 스레드가 이번 호출을 끝낼 때까지 기다린다.
+    unique_lock<mutex> lock(mMutex);
+    mDoneCondition.wait(lock, [this]() { return mNumActiveWorkers == 0; });
+    mFunc = nullptr;
+}
+
+void ThreadPool::WorkerLoop()
+{
+    unsigned long long seenGeneration = 0;
+
+    while (true)
+    {
+        unique_lock<mutex> lock(mMutex);
+        mWakeCondition.wait(lock, [&]() { return mStop || mGeneration != seenGeneration; });
+        if (mStop)
+            return;
+
+        seenGeneration = mGeneration;
+        lock.unlock();
+
+        RunChunks();
+
+        lock.lock();
+        if (--mNumActiveWorkers == 0)
+            mDoneCondition.notify_one();
+    }
+}
+
+void ThreadPool::RunChunks()
+{
+    while (true)
+    {
+        int begin = mNextIndex.fetch_add(mGrainSize);
+        if (begin >= mCount)
+            return;
+
+        (*mFunc)(begin, min(begin + mGrainSize, mCount));
+    }
+}
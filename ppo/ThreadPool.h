@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+using namespace std;
+
+// 고정된 수의 작업 스레드로 ParallelFor를 실행하는 스레드 풀
+// 호출한 스레드도 작업에 참여하며, ParallelFor는 모든 구간이 끝나야 반환한다.
+// ParallelFor 안에서 다시 ParallelFor를 호출하면 안 된다.
+class ThreadPool
+{
+public:
+    // numWorkers가 0이면 (하드웨어 스레드 수 - 1)개의 작업 스레드를 만든다.
+    explicit ThreadPool(unsigned int numWorkers = 0);
+    ThreadPool(const ThreadPool& rhs) = delete;
+    ThreadPool& operator=(const ThreadPool& rhs) = delete;
+    ~ThreadPool();
+
+    // 호출 스레드를 포함한 스레드 수
+    unsigned int NumThreads() const { return (unsigned int)mWorkers.size() + 1; }
+
+    // [0, count)를 grainSize 크기의 구간으로 나눠 func(begin, end)를 병렬로 실행한다.
+    void ParallelFor(int count, int grainSize, const function<void(int, int)>& func);
+
+private:
+    void WorkerLoop();
+    void RunChunks();
+
+    vector<thread> mWorkers;
+
+    mutex mMutex;
+    condition_variable mWakeCondition;
+    condition_variable mDoneCondition;
+    bool mStop = false;
+    unsigned long long mGeneration = 0;     // ParallelFor를 호출할 때마다 증가
+    int mNumActiveWorkers = 0;
+
+    const function<void(int, int)>* mFunc = nullptr;
+    int mCount = 0;
+    int mGrainSize = 1;
+    atomic<int> mNextIndex = 0;
+};
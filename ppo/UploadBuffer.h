@@ -11,12 +11,12 @@ public:
     {
         mElementByteSize = sizeof(T);
 
-        //    ũ ݵ 256Ʈ  Ѵ.
-        // ̴ ϵ m*256 ¿ ϴ n*256Ʈ  
-        // ڷḸ   ֱ ̴. 
+        // 상수 버퍼 원소의 크기는 반드시 256바이트의 배수여야 한다.
+        // 이는 하드웨어가 m*256 오프셋에서 시작하는 n*256바이트 길이의 
+        // 상수자료만 볼 수 있기 때문이다. 
         // typedef struct D3D12_CONSTANT_BUFFER_VIEW_DESC {
-        // UINT64 OffsetInBytes; // 256 
-        // UINT   SizeInBytes;   // 256 
+        // UINT64 OffsetInBytes; // 256 배수
+        // UINT   SizeInBytes;   // 256 배수
         // } D3D12_CONSTANT_BUFFER_VIEW_DESC;
         if(isConstantBuffer)
             mElementByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(T));
@@ -31,8 +31,8 @@ public:
 
         ThrowIfFailed(mUploadBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mMappedData)));
 
-        // ڿ  ϱ    ʿ䰡 .
-        // ׷, ڿ GPU ϴ ߿ CPU ڿ  ʾƾ Ѵ.
+        // 자원을 다 사용하기 전에는 대응을 해제할 필요가 없다.
+        // 그러나, 자원을 GPU가 사용하는 중에는 CPU에서 자원을 갱신하지 않아야 한다.
     }
 
     UploadBuffer(const UploadBuffer& rhs) = delete;
@@ -55,6 +55,17 @@ public:
         memcpy(&mMappedData[elementIndex*mElementByteSize], &data, sizeof(T));
     }
 
+    // 원소를 임시 객체로 만들지 않고 매핑된 메모리에 바로 쓰기 위한 주소
+    BYTE* MappedData(int elementIndex)
+    {
+        return &mMappedData[elementIndex*mElementByteSize];
+    }
+
+    UINT ElementByteSize()const
+    {
+        return mElementByteSize;
+    }
+
 private:
     Microsoft::WRL::ComPtr<ID3D12Resource> mUploadBuffer;
     BYTE* mMappedData = nullptr;
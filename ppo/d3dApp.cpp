@@ -18,7 +18,7 @@ D3DApp* D3DApp::mApp = nullptr;
 D3DApp::D3DApp(HINSTANCE hInstance)
 {
 	mhAppInst = hInstance;
-	// ϳ D3DApp   Ѵ
+	// 하나의 D3DApp만 만들어 지도록 한다
 	assert(mApp == nullptr);
 	mApp = this;
 }
@@ -60,7 +60,7 @@ void D3DApp::Set4xMsaaState(bool value)
 	{
 		m4xMsaaState = value;
 
-		// ĸ ۿ ü ٽø.
+		// 후면 버퍼와 스왑체인을 다시만든다.
 		CreateSwapChain();
 		OnResize();
 	}
@@ -119,7 +119,7 @@ LRESULT D3DApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
 	switch (msg)
 	{
-	//  α׷ ȰȭǸ α׷ Ÿ̸Ӹ Ѵ.
+	// 응용 프로그램이 비활성화되면 프로그램과 타이머를 정지한다.
 	case WM_ACTIVATE:
 		if (LOWORD(wParam) == WA_INACTIVE)
 		{
@@ -133,9 +133,9 @@ LRESULT D3DApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		}
 		return 0;
 
-	//  α׷ â ũⰡ ٲ  
+	// 응용 프로그램의 창의 크기가 바뀔 때 전달
 	case WM_SIZE:
-		//  Ŭ̾Ʈ  
+		// 새 클라이언트 영역을 저장
 		mClientWidth = LOWORD(lParam);
 		mClientHeight = HIWORD(lParam);
 
@@ -191,23 +191,23 @@ LRESULT D3DApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		}
 		return 0;
 
-	// â ıǷ   
+	// 창이 파괴되려 할 때 전달
 	case WM_DESTROY:
 		PostQuitMessage(0);
 		return 0;
 
-	// ޴ ȰȭǾ ڰ Ű   Ű  Ű ش   
+	// 메뉴가 활성화되어서 사용자가 키를 눌렀지만 그 키가 어떤 단축키에도 해당하지 않을 때 전달
 	case WM_MENUCHAR:
-		// alt-enter    Ҹ  ʰ Ѵ.
+		// alt-enter 를 눌렀을 때 소리가 나지 않게 한다.
 		return MAKELRESULT(0, MNC_CLOSE);
 
-	// â ʹ ۾ ʰ Ѵ.
+	// 창이 너무 작아지지 않게 한다.
 	case WM_GETMINMAXINFO:
 		((MINMAXINFO*)lParam)->ptMinTrackSize.x = 200;
 		((MINMAXINFO*)lParam)->ptMinTrackSize.y = 200;
 		return 0;
 
-	// 콺 ó
+	// 마우스 처리
 	case WM_LBUTTONDOWN:
 	case WM_MBUTTONDOWN:
 	case WM_RBUTTONDOWN:
@@ -222,7 +222,7 @@ LRESULT D3DApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		OnMouseMove(wParam, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
 		return 0;
 
-	// Ű ó
+	// 키보드 처리
 	case WM_KEYDOWN:
 		OnKeyboardMessage(hwnd, msg, wParam, lParam);
 		if (wParam == VK_ESCAPE)
@@ -419,9 +419,9 @@ bool D3DApp::InitMainWindow()
 
 bool D3DApp::InitDirect3D()
 {
-	// 1. D3D12 ̽ 
+	// 1. D3D12 디바이스 생성
 #if defined(DEBUG) || defined(_DEBUG) 
-	// D3D12  Ȱȭ
+	// D3D12 디버그층 활성화
 	{
 		ComPtr<ID3D12Debug> debugController;
 		ThrowIfFailed(D3D12GetDebugInterface(IID_PPV_ARGS(&debugController)));
@@ -431,13 +431,13 @@ bool D3DApp::InitDirect3D()
 
 	ThrowIfFailed(CreateDXGIFactory1(IID_PPV_ARGS(&mdxgiFactory)));
 
-	// ϵ ͸ Ÿ ġ 
+	// 하드웨어 어댑터를 나타내는 장치를 생성
 	HRESULT hardwareResult = D3D12CreateDevice(
-		nullptr,				// ⺻ 
+		nullptr,				// 기본 어댑터
 		D3D_FEATURE_LEVEL_11_0,
 		IID_PPV_ARGS(&md3dDevice));
 
-	// ߴٸ WARP ͸ Ÿ ġ 
+	// 실패했다면 WARP 어댑터를 나타내는 장치를 생성
 	if (FAILED(hardwareResult))
 	{
 		ComPtr<IDXGIAdapter> pWarpAdapter;
@@ -449,7 +449,7 @@ bool D3DApp::InitDirect3D()
 			IID_PPV_ARGS(&md3dDevice)));
 	}
 
-	// 2. Fence    ũ 
+	// 2. Fence 생성 및 서술자 크기 얻기
 	ThrowIfFailed(md3dDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE,
 		IID_PPV_ARGS(&mFence)));
 
@@ -457,8 +457,8 @@ bool D3DApp::InitDirect3D()
 	mDsvDescriptorSize = md3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
 	mCbvSrvUavDescriptorSize = md3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
-	// 3. 4X MSAA ǰ  
-	// 4X MSAA ⺻ 
+	// 3. 4X MSAA 품질 수준 지원점검
+	// 4X MSAA를 기본으로 설정
 	D3D12_FEATURE_DATA_MULTISAMPLE_QUALITY_LEVELS msQualityLevels;
 	msQualityLevels.Format = mBackBufferFormat;
 	msQualityLevels.SampleCount = 4;
@@ -476,19 +476,19 @@ bool D3DApp::InitDirect3D()
 	LogAdapters();
 #endif
 
-	// 4. CommandQueue, CommandAllocator, CommandList 
+	// 4. CommandQueue, CommandAllocator, CommandList 생성
 	CreateCommandObjects();
 
-	// 5. SwapChain  
+	// 5. SwapChain의 서술과 생성
 	CreateSwapChain();
 
-	// 6.   
+	// 6. 서술자 힙 생성
 	CreateRtvAndDsvDescriptorHeaps();
 
 	return true;
 }
 
-// CommandQueue, CommandAllocator, CommandList  1 
+// CommandQueue, CommandAllocator, CommandList 를 1개씩 생성
 void D3DApp::CreateCommandObjects()
 {
 	D3D12_COMMAND_QUEUE_DESC queueDesc = {};
@@ -503,14 +503,14 @@ void D3DApp::CreateCommandObjects()
 	ThrowIfFailed(md3dDevice->CreateCommandList(
 		0,
 		D3D12_COMMAND_LIST_TYPE_DIRECT,
-		mDirectCmdListAlloc.Get(), //   Ҵ
-		nullptr,                   // ʱ   ü
+		mDirectCmdListAlloc.Get(), // 연관된 명령 할당자
+		nullptr,                   // 초기 파이프라인 상태 객체
 		IID_PPV_ARGS(mCommandList.GetAddressOf())));
 
 	
-	//  · Ѵ.
-	//  ɸ   Reet ȣ ϴµ Reset 
-	// ȣ Ϸ ɸ  ־ ϱ⶧̴.
+	// 닫힌 상태로 시작한다.
+	// 이후 명령목록을 참조할 때 Reet을 호출 하는데 Reset을 
+	// 호출 하려면 명령목록이 닫혀 있어야 하기때문이다.
 	mCommandList->Close();
 }
 
@@ -520,11 +520,11 @@ void D3DApp::CreateSwapChain()
 	mSwapChain.Reset();
 
 	DXGI_SWAP_CHAIN_DESC sd;
-	sd.BufferDesc.Width = mClientWidth;			//  ػ ʺ
-	sd.BufferDesc.Height = mClientHeight;		//  ػ 
+	sd.BufferDesc.Width = mClientWidth;			// 버퍼 해상도 너비
+	sd.BufferDesc.Height = mClientHeight;		// 버퍼 해상도 높이
 	sd.BufferDesc.RefreshRate.Numerator = 60;
 	sd.BufferDesc.RefreshRate.Denominator = 1;
-	sd.BufferDesc.Format = mBackBufferFormat;	//  ÷ 
+	sd.BufferDesc.Format = mBackBufferFormat;	// 버퍼 디스플레이 형식
 	sd.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
 	sd.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
 	sd.SampleDesc.Count = m4xMsaaState ? 4 : 1;
@@ -536,7 +536,7 @@ void D3DApp::CreateSwapChain()
 	sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
 	sd.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
 
-	// : swap chain  ⿭ Ͽ flush g
+	// 참고: swap chain은 명령 대기열을 사용하여 flush를 수행g
 	ThrowIfFailed(mdxgiFactory->CreateSwapChain(
 		mCommandQueue.Get(),
 		&sd,
@@ -587,16 +587,16 @@ D3D12_CPU_DESCRIPTOR_HANDLE D3DApp::DepthStencilView() const
 
 void D3DApp::CalculateFrameStats()
 {
-	//  FPS 
-	// ϴ  ɸ սð
-	//   â ٿ ߰
+	// 평균 FPS 계산
+	// 렌더링하는 데 걸리는 평균시간
+	// 위 정보를 창의 제목줄에 추가
 
 	static int frameCnt = 0;
 	static float timeElapsed = 0.0f;
 
 	frameCnt++;
 
-	// 1     
+	// 1초 동안 평균 프레임 수 계산
 	if ((mTimer.TotalTime() - timeElapsed) >= 1.0f)
 	{
 		float fps = (float)frameCnt; // fps = frameCnt / 1
@@ -611,14 +611,14 @@ void D3DApp::CalculateFrameStats()
 
 		SetWindowText(mhMainWnd, windowText.c_str());
 
-		//    ġ ʱȭ
+		// 다음 평균을 위해 수치 초기화
 		frameCnt = 0;
 		timeElapsed += 1.0f;
 	}
 }
 
-// ýۿ ִ  ͸ Ѵ.
-// ¿)
+// 시스템에 있는 모든 어댑터를 열거한다.
+// 출력예시)
 // ***Adapter: NVIDIA GeForece GTX 760
 void D3DApp::LogAdapters()
 {
@@ -648,7 +648,7 @@ void D3DApp::LogAdapters()
 	}
 }
 
-//  Ϳ    
+// 한 어댑터에 연결된 모든 출력을 열거
 void D3DApp::LogAdapterOutputs(IDXGIAdapter* adapter)
 {
 	UINT i = 0;
@@ -671,7 +671,7 @@ void D3DApp::LogAdapterOutputs(IDXGIAdapter* adapter)
 	}
 }
 
-// ش Ͱ  ÷ 带 
+// 해당 어댑터가 지원가는 디스플레이 모드를 열거
 void D3DApp::LogOutputDisplayModes(IDXGIOutput* output, DXGI_FORMAT format)
 {
 	UINT count = 0;
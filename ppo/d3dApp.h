@@ -81,11 +81,11 @@ protected:
 	bool      mResizing = false;		// are the resize bars being dragged?
 	bool      mFullscreenState = false;	// fullscreen enabled
 	
-	// 4x MSAA 
+	// 4x MSAA 지원여부
 	bool m4xMsaaState = false;
 	bool m4xMsaaQuality = 0;
 
-	//  ð  üð 
+	// 경과 시간과 게임 전체시간을 측정
 	GameTimer mTimer;
 
 	Microsoft::WRL::ComPtr<IDXGIFactory4> mdxgiFactory;
@@ -114,7 +114,7 @@ protected:
 	UINT mDsvDescriptorSize = 0;
 	UINT mCbvSrvUavDescriptorSize = 0;
 
-	// ĻŬ  ´ ٸ ʱⰪ ؾ.
+	// 파생클래스는 목적에 맞는 다른 초기값으로 설정해야함.
 	std::wstring mMainWndCaption = L"d3d App";
 	D3D_DRIVER_TYPE md3dDriverType = D3D_DRIVER_TYPE_HARDWARE;
 	DXGI_FORMAT mBackBufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -18,8 +18,8 @@ bool d3dUtil::IsKeyDown(int vkeyCode)
     return (GetAsyncKeyState(vkeyCode) & 0x8000) != 0;
 }
 
-// ϵ ̴ Ʈڵ带 C++ ǥ   ̺귯 ̿ ϴ Լ
-// 뿹)
+// 컴파일된 셰이더 바이트코드를 C++ 표준 파일 입출력 라이브러리를 이용해 적재하는 함수
+// 사용예시)
 // ComPtr<ID3DBlob> mvsByteCode = d3dUtil::LoadBinary(L"Shaders\\color_vs.hlsl");
 ComPtr<ID3DBlob> d3dUtil::LoadBinary(const std::wstring& filename)
 {
@@ -38,11 +38,11 @@ ComPtr<ID3DBlob> d3dUtil::LoadBinary(const std::wstring& filename)
     return blob;
 }
 
-//  ϱ(Ӹ  ʴ ϱ) ׸      ۵ Default Heap ִ´.
-//  ϱ  ʱȭĿ GPU  Ƿ Default Heap ִ  մϴ.
-// CPU ⺻ ۸  Ѵ.
-// , D3D12_HEAP_TYPE_UPLOAD ӽ ε ۸ Ͽ ý ޸𸮿 ִ ڷḦ ε ۿ ϰ, 
-// ε  ڷḦ  ۷ Ѵ.
+// 정적 기하구조(프레임마다 변하지 않는 기하구조)를 그릴 때는 최적의 성능을 위해 정점 버퍼들은 Default Heap에 넣는다.
+// 정적 기하구조의 경우 초기화후에는 GPU만 정보를 읽으므로 Default Heap에 넣는 것이 합당하다.
+// CPU는 기본힙의 정점버퍼를 수정하지 못한다.
+// 따라서, D3D12_HEAP_TYPE_UPLOAD형식의 임시 업로드 버퍼를 생성하여 시스템 메모리에 있는 정점자료를 업로드 버퍼에 복사하고, 
+// 업로드 버퍼의 자료를 실제 정점버퍼로 복사한다.
 Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
     ID3D12Device* device,
     ID3D12GraphicsCommandList* cmdList,
@@ -52,7 +52,7 @@ Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
 {
     ComPtr<ID3D12Resource> defaultBuffer;
 
-    //  ⺻  ڿ Ѵ.
+    // 실제 기본 버퍼 자원을 생성한다.
     ThrowIfFailed(device->CreateCommittedResource(
         &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
         D3D12_HEAP_FLAG_NONE,
@@ -61,8 +61,8 @@ Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
         nullptr,
         IID_PPV_ARGS(defaultBuffer.GetAddressOf())));
 
-    // CPU ޸ ڷḦ ⺻ ۿ ϱ 
-    // ӽ ε  Ѵ.
+    // CPU는 메모리의 자료를 기본 버퍼에 복사하기 위해
+    // 임시 업로드 힙을 생성한다.
     ThrowIfFailed(device->CreateCommittedResource(
         &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
         D3D12_HEAP_FLAG_NONE,
@@ -72,13 +72,13 @@ Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
         IID_PPV_ARGS(uploadBuffer.GetAddressOf())));
 
 
-    // ⺻ ۿ  ڷḦ Ѵ.
+    // 기본 버퍼에 복사할 자료를 서술한다.
     D3D12_SUBRESOURCE_DATA subResourceData = {};
     subResourceData.pData = initData;
     subResourceData.RowPitch = byteSize;
     subResourceData.SlicePitch = byteSize;
 
-    // ε ۿ ⺻  ڿ ڷ 縦 ûѴ.
+    // 업로드 버퍼에서 기본 버퍼 자원으로 자료 복사를 요청한다.
     cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(defaultBuffer.Get(),
         D3D12_RESOURCE_STATE_COMMON, 
         D3D12_RESOURCE_STATE_COPY_DEST));
@@ -89,9 +89,9 @@ Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
         D3D12_RESOURCE_STATE_COPY_DEST, 
         D3D12_RESOURCE_STATE_GENERIC_READ));
 
-    //  Լ ȣ Ŀ uploadBuffer  ؾ Ѵ.
-    //  縦 ϴ ɸ   ʾұ ̴.
-    // 簡 ϷǾ Ȯ Ŀ uploadBuffer ϸ ȴ.
+    // 위의 함수 호출 이후에도 uploadBuffer를 계속 유지해야 한다.
+    // 실제로 복사를 수행하는 명령목록이 아직 실행되지 않았기 때문이다.
+    // 복사가 완료되었음이 확실해진 후에 uploadBuffer를 해제하면 된다.
 
     return defaultBuffer;
 }
@@ -103,7 +103,7 @@ ComPtr<ID3DBlob> d3dUtil::CompileShader(
     const std::string& entrypoint,
     const std::string& target)
 {
-    //  忡   ÷׵ Ѵ.
+    // 디버그 모드에서 디버깅 관련 플래그들을 사용한다.
     UINT compileFlags = 0;
 #if defined(DEBUG) || defined(_DEBUG)  
     compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
@@ -116,7 +116,7 @@ ComPtr<ID3DBlob> d3dUtil::CompileShader(
     hr = D3DCompileFromFile(filename.c_str(), defines, D3D_COMPILE_STANDARD_FILE_INCLUDE,
         entrypoint.c_str(), target.c_str(), compileFlags, 0, &byteCode, &errors);
 
-    //  ޼  â 
+    // 오류 메세지를 디버그 창에 출력
     if (errors != nullptr)
         OutputDebugStringA((char*)errors->GetBufferPointer());
 
@@ -127,7 +127,7 @@ ComPtr<ID3DBlob> d3dUtil::CompileShader(
 
 std::wstring DxException::ToString()const
 {
-    //  ڵ ڿ  ɴϴ
+    // 오류 코드의 문자열 설명을 가져옵니다
     _com_error err(ErrorCode);
     std::wstring msg = err.ErrorMessage();
 
@@ -101,7 +101,7 @@ public:
 
 	static UINT CalcConstantBufferByteSize(UINT byteSize)
 	{
-		//   ũ 256  Ѵ.
+		// 상수의 버퍼의 크기는 256의 배수여야 한다.
 		return (byteSize + 255) & ~255;
 	}
 
@@ -121,8 +121,8 @@ public:
 		const std::string& target);
 };
 
-//  α׷ 𼱰 и ϴ HRESULT  ȯǸ ThrowIfFailed ܸ .
-// ܴ catch ö MessageBox ̿ µȴ.
+// 응용 프로그램 어디선가 실패를 뜻하는 HRESULT 값이 반환되면 ThrowIfFailed이 예외를 던진다.
+// 예외는 catch절까지 올라와 MessageBox를 이용해 출력된다.
 class DxException
 {
 public:
@@ -146,10 +146,10 @@ public:
 }
 #endif
 
-// HLSL ü ä Ģ Ͽ 4   äִ´.
+// HLSL 구조체 채우기 규칙을 고려하여 4차원 벡터 단위로 채워넣는다.
 struct Light
 {
-	DirectX::XMFLOAT3 Strength = { 0.5f, 0.5f, 0.5f };	//  
+	DirectX::XMFLOAT3 Strength = { 0.5f, 0.5f, 0.5f };	// 빛의 색상
 	float FalloffStart = 1.0f;                          // point, spot light only
 	DirectX::XMFLOAT3 Direction = { 0.0f, -1.0f, 0.0f };// directional, spot light only
 	float FalloffEnd = 10.0f;                           // point, spot light only
@@ -170,28 +170,28 @@ struct MaterialConstants
 };
 
 
-//  Ÿ  ̴ ü
+// 재질을 나타내는 데 쓰이는 구조체
 struct Material
 {
-	//   ̸
+	// 고유한 재질 이름
 	std::string Name;
 
-	//   شϴ  
+	// 이 재질에 해당하는 상수버퍼의 색인
 	int MatCBIndex = -1;
 
-	// SRV    شϴ diffuse texture 
+	// SRV 힙에서 이 재질에 해당하는 diffuse texture의 색인
 	int DiffuseSrvHeapIndex = -1;
 
-	// SRV    شϴ normal texture 
+	// SRV 힙에서 이 재질에 해당하는 normal texture의 색인
 	int NormalSrvHeapIndex = -1;
 
-	//  ؼ ش  ۸ ؾ ϴ θ Ÿ  ÷
+	// 재질이 변해서 해당 상수 버퍼를 갱신해야 하는지의 여부를 나타내는 더러움 플래그
 	int NumFramesDirty = gNumFrameResources;
 
-	// ̵ ̴    ڷ.
+	// 셰이딩에 쓰이는 재질 상수 버퍼 자료.
 	DirectX::XMFLOAT4 DiffuseAlbedo = { 1.0f, 1.0f, 1.0f, 1.0f };
 	DirectX::XMFLOAT3 FresnelR0 = { 0.01f, 0.01f, 0.01f };
-	float Roughness = 0.25f;	// ǥ ĥ[0, 1] 0 Ų, 1 ģ
+	float Roughness = 0.25f;	// 표면 거칠기[0, 1] 0 매끄러운, 1 거친
 	DirectX::XMFLOAT4X4 MatTransform = MathHelper::Identity4x4();
 };
 